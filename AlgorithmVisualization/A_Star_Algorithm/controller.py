@@ -36,6 +36,8 @@ class Controller:
             self.solver = PathSolver.AStarSolver(self.grid)
         elif solver_type == "dijkstra":
             self.solver = PathSolver.DijkstraSolver(self.grid)
+        elif solver_type == "jps":
+            self.solver = PathSolver.NativeAStarSolver(self.grid, diagonal=True, jump_points=True)
         else:
             raise ValueError(f"Unknown solver type: {solver_type}")
 
@@ -103,5 +105,6 @@ class Controller:
         
         self.gui.astar_button.config(state='disabled')
         self.gui.dijkstra_button.config(state='disabled')
+        self.gui.jps_button.config(state='disabled')
 
 
@@ -155,6 +155,21 @@ class GridGUI:
         )
         self.dijkstra_button.pack(pady=8, fill='x')
 
+        self.jps_button = tk.Button(
+            self.button_frame,
+            text="Start JPS (native, 8-way)",
+            command=lambda: self.start_pathfinding("jps"),
+            font=button_font,
+            relief="raised",
+            bd=2,
+            padx=10,
+            pady=5,
+            bg="#f0f0f0",
+            activebackground="#d9d9d9",
+            state='disabled'
+        )
+        self.jps_button.pack(pady=8, fill='x')
+
     
     def on_click(self, event):
         col = (event.x - self.start_x) // self.cell_width
@@ -186,6 +201,7 @@ class GridGUI:
                     self.endpoint_init_active = False
                     self.astar_button.config(state='normal')
                     self.dijkstra_button.config(state='normal')
+                    self.jps_button.config(state='normal')
 
     def move_robot(self, row, col) -> None:
         if self.robot_position is None:
@@ -0,0 +1,56 @@
+/**
+ * @brief C entry points of GridAStar (Algorithms/Graph/GridAStar.h) for the Python visualizer (ctypes).
+ *
+ * Build next to this file:
+ *   g++ -std=c++20 -O2 -shared -fPIC grid_astar.cpp -o libgridastar.so
+ *
+ * The grid is passed as rows * cols bytes, row-major, non-zero = obstacle. Exceptions don't cross the C
+ * boundary, they come back as -2.
+ */
+
+#include <vector>
+#include <cstdint>
+#include "../../../Algorithms/Graph/GridAStar.h"
+
+extern "C" {
+
+/**
+ * @param path receives (row, col) pairs from start to goal, room for rows * cols pairs
+ * @param expansions optional (may be null), (row, col) pairs in expansion order, room for rows * cols pairs
+ * @return the path cost (10 per straight step, 14 per diagonal step), -1 if there is no path, -2 on bad input
+ */
+int grid_astar_find_path(const std::uint8_t* cells, int rows, int cols, int startRow, int startCol, int goalRow, int goalCol,
+                         int eightConnected, int jumpPoint, int* path, int* pathLength, int* expansions, int* expansionCount)
+{
+    try {
+        OccupancyGrid grid{rows, cols, cells};
+        GridAStar solver{grid, eightConnected ? GridConnectivity::Eight : GridConnectivity::Four,
+                         jumpPoint ? GridSearch::JumpPoint : GridSearch::AStar};
+
+        std::vector<GridCoordinate> expanded;
+        GridPath result{solver.findPath({startRow, startCol}, {goalRow, goalCol}, expansions ? &expanded : nullptr)};
+
+        *pathLength = static_cast<int>(result.cells.size());
+        for (std::size_t i{}; i < result.cells.size(); ++i) {
+            path[2 * i] = result.cells[i].row;
+            path[2 * i + 1] = result.cells[i].col;
+        }
+
+        if (expansions) {
+            *expansionCount = static_cast<int>(expanded.size());
+            for (std::size_t i{}; i < expanded.size(); ++i) {
+                expansions[2 * i] = expanded[i].row;
+                expansions[2 * i + 1] = expanded[i].col;
+            }
+        }
+
+        return result.cost;
+    } catch (...) {
+        return -2;
+    }
+}
+
+int grid_astar_straight_cost() { return GridAStar::straightCost; }
+int grid_astar_diagonal_cost() { return GridAStar::diagonalCost; }
+
+}
@@ -1,7 +1,9 @@
 from abc import ABC, abstractmethod
 from copy import deepcopy
+import ctypes
 import math
 import heapq
+import os
 from typing import Tuple, Generator, Optional
 
 class Solver(ABC):
@@ -110,4 +112,70 @@ class DijkstraSolver(Solver):
                     self.parents[xx][yy] = (x, y)
                     heapq.heappush(pq, (self.dist[xx][yy], xx, yy))
                     
-        return False
\ No newline at end of file
+        return False
+
+
+class NativeAStarSolver(Solver):
+    """
+    A*/JPS from Algorithms/Graph/GridAStar.h, called through native/libgridastar.so (ctypes).
+
+    The whole search runs in C++ first; solve() then replays the expanded cells so the GUI animates it
+    like the Python solvers, and fills parents along the path for the reconstruction.
+    Costs come back in tenths of a cell (10 straight, 14 diagonal) and are reported in cells.
+
+    Build the library once:
+        g++ -std=c++20 -O2 -shared -fPIC native/grid_astar.cpp -o native/libgridastar.so
+    or point GRID_ASTAR_LIB at a build elsewhere.
+    """
+    _library = None
+
+    def __init__(self, grid: list[list[int]], diagonal: bool = False, jump_points: bool = False):
+        super().__init__(grid)
+        self.diagonal = diagonal
+        self.jump_points = jump_points
+
+    @classmethod
+    def _load_library(cls):
+        if cls._library is None:
+            default = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'native', 'libgridastar.so')
+            path = os.environ.get('GRID_ASTAR_LIB', default)
+            if not os.path.exists(path):
+                raise RuntimeError(f'{path} not found, build it with: '
+                                   'g++ -std=c++20 -O2 -shared -fPIC native/grid_astar.cpp -o native/libgridastar.so')
+
+            library = ctypes.CDLL(path)
+            int_p = ctypes.POINTER(ctypes.c_int)
+            library.grid_astar_find_path.argtypes = [ctypes.POINTER(ctypes.c_uint8)] + [ctypes.c_int] * 8 + [int_p] * 4
+            library.grid_astar_find_path.restype = ctypes.c_int
+            library.grid_astar_straight_cost.restype = ctypes.c_int
+            cls._library = library
+        return cls._library
+
+    def solve(self) -> 'Generator[tuple[int, int], None, bool]':
+        library = self._load_library()
+
+        cells = (ctypes.c_uint8 * (self.n * self.m))(*[1 if value == 1 else 0 for row in self.grid for value in row])
+        path = (ctypes.c_int * (2 * self.n * self.m))()
+        expansions = (ctypes.c_int * (2 * self.n * self.m))()
+        path_length = ctypes.c_int()
+        expansion_count = ctypes.c_int()
+
+        cost = library.grid_astar_find_path(cells, self.n, self.m, self.robot_row, self.robot_col,
+                                            self.endpoint_row, self.endpoint_col, int(self.diagonal), int(self.jump_points),
+                                            path, ctypes.byref(path_length), expansions, ctypes.byref(expansion_count))
+        if cost == -2:
+            raise ValueError('Native solver rejected the grid')
+
+        for i in range(expansion_count.value):
+            yield (expansions[2 * i], expansions[2 * i + 1])
+
+        if cost < 0:
+            return False
+
+        cells_on_path = [(path[2 * i], path[2 * i + 1]) for i in range(path_length.value)]
+        for (x, y), previous in zip(cells_on_path[1:], cells_on_path):
+            self.parents[x][y] = previous
+
+        straight = library.grid_astar_straight_cost()
+        self.shortest_distance = cost // straight if cost % straight == 0 else cost / straight
+        return True
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * @brief Fixed-size, cache-line aligned array of trivially copyable values.
+ *
+ * Used for the flat dynamic programming tables, where std::vector<std::vector<T>> would mean one heap
+ * block per row and std::vector<T> gives no alignment guarantee for SIMD loads.
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "AlignedBuffer holds plain values only");
+
+public:
+    AlignedBuffer() = default;
+
+    explicit AlignedBuffer(std::size_t count) : n{count}, data_{allocate(count)}
+    { }
+
+    AlignedBuffer(std::size_t count, T value) : AlignedBuffer(count)
+    {
+        std::fill(begin(), end(), value);
+    }
+
+    std::size_t size() const noexcept { return n; }
+    T* data() noexcept { return data_.get(); }
+    const T* data() const noexcept { return data_.get(); }
+
+    T& operator[](std::size_t i) noexcept { return data_[i]; }
+    const T& operator[](std::size_t i) const noexcept { return data_[i]; }
+
+    T* begin() noexcept { return data(); }
+    T* end() noexcept { return data() + n; }
+    const T* begin() const noexcept { return data(); }
+    const T* end() const noexcept { return data() + n; }
+
+private:
+    struct Deleter
+    {
+        void operator()(T* p) const noexcept { ::operator delete[](p, std::align_val_t{Alignment}); }
+    };
+
+    static std::unique_ptr<T[], Deleter> allocate(std::size_t count)
+    {
+        if (count == 0) return nullptr;
+        return std::unique_ptr<T[], Deleter>{static_cast<T*>(::operator new[](count * sizeof(T), std::align_val_t{Alignment}))};
+    }
+
+private:
+    std::size_t n{};
+    std::unique_ptr<T[], Deleter> data_;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Enumeration and ranking of the k-element subsets of {0, ..., n-1} as bitmasks, n <= 32.
+ *
+ * Bitmask dynamic programs (Held–Karp, Hamiltonian path counting) only depend on subsets with one element
+ * less, so they can be processed layer by layer, by popcount. Inside a layer every mask is independent:
+ *   - nextCombination() (Gosper's hack) walks a layer in increasing numeric order in O(1) per mask,
+ *   - unrankCombination() jumps to the r-th mask of a layer, so a layer can be split into chunks that
+ *     threads walk independently,
+ *   - rankCombination() is the inverse (combinatorial number system), which gives every mask of a layer
+ *     a dense index in [0, C(n, k)) for layer-sized tables.
+ * The order is the same for all three: colex, which for fixed popcount is increasing numeric order.
+ */
+
+class Combinations
+{
+public:
+    static constexpr int maxBits{32};
+
+    static std::uint64_t binomial(int n, int k) noexcept
+    {
+        if (k < 0 || n < 0 || k > n) return 0;
+        return table().values[n][k];
+    }
+
+    // smallest mask with the same popcount that is greater than mask (mask != 0)
+    static std::uint32_t nextCombination(std::uint32_t mask) noexcept
+    {
+        std::uint32_t lowest{mask & (~mask + 1)};
+        std::uint32_t ripple{mask + lowest};
+        return ripple | (((mask ^ ripple) >> 2) / lowest);
+    }
+
+    // position of mask among the masks with the same popcount, in increasing order
+    static std::uint64_t rankCombination(std::uint32_t mask) noexcept
+    {
+        std::uint64_t rank{};
+        for (int i{1}; mask != 0; ++i) {
+            int bit{std::countr_zero(mask)};
+            rank += binomial(bit, i);
+            mask &= mask - 1;
+        }
+        return rank;
+    }
+
+    // the rank-th k-element mask (of any width), the inverse of rankCombination
+    static std::uint32_t unrankCombination(int k, std::uint64_t rank) noexcept
+    {
+        std::uint32_t mask{};
+        for (int i{k}; i >= 1; --i) {
+            // largest bit with binomial(bit, i) <= rank
+            int bit{i - 1};
+            while (binomial(bit + 1, i) <= rank) ++bit;
+
+            rank -= binomial(bit, i);
+            mask |= std::uint32_t{1} << bit;
+        }
+        return mask;
+    }
+
+private:
+    struct Table
+    {
+        std::array<std::array<std::uint64_t, maxBits + 2>, maxBits + 2> values{};
+    };
+
+    static const Table& table() noexcept
+    {
+        static const Table pascal{[] {
+            Table t;
+            for (int n{}; n <= maxBits + 1; ++n) {
+                t.values[n][0] = 1;
+                for (int k{1}; k <= n; ++k) t.values[n][k] = t.values[n - 1][k - 1] + t.values[n - 1][k];
+            }
+            return t;
+        }()};
+        return pascal;
+    }
+};
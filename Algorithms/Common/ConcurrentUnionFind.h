@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Lock-free disjoint sets over [0, n) for the parallel graph passes.
+ *
+ * A parent pointer always points to a smaller index: unite links the larger root below the smaller one
+ * with a compare-and-swap that only succeeds while it is still a root, and find halves paths by pointing
+ * a vertex to its grandparent, which is smaller again. So no cycles can form, and concurrent unite calls
+ * on the same two sets merge them exactly once: unite returns true for the one call that did it, which
+ * lets callers build a spanning forest (one action per successful merge) from any number of threads.
+ */
+class ConcurrentUnionFind
+{
+public:
+    explicit ConcurrentUnionFind(std::size_t n) : parent(n)
+    {
+        for (std::size_t i{}; i < n; ++i) parent[i].store(static_cast<int>(i), std::memory_order_relaxed);
+    }
+
+    int find(int x) noexcept
+    {
+        while (true) {
+            int p{parent[x].load(std::memory_order_relaxed)};
+            if (p == x) return x;
+            int grandparent{parent[p].load(std::memory_order_relaxed)};
+            if (grandparent != p) parent[x].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+            x = grandparent;
+        }
+    }
+
+    // true if a and b were in different sets and this call merged them
+    bool unite(int a, int b) noexcept
+    {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+            if (a < b) std::swap(a, b);
+
+            int expected{a};
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) return true;
+        }
+    }
+
+    bool same(int a, int b) noexcept { return find(a) == find(b); }
+
+private:
+    std::vector<std::atomic<int>> parent;
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <utility>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief A whole file mapped read-only, as one byte span.
+ *
+ * Lets the compressors and readers work on files of any size without copying them into a std::string:
+ * pages are read in on demand and shared with the page cache. MappedGraphFile (GraphFile.h) is one with a
+ * validated header on top. The fallback without mmap (Windows) reads the file into an owned buffer, whose
+ * allocation is aligned for any fundamental type like a page.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path) { map(path); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { unmap(); }
+
+    std::span<const std::uint8_t> bytes() const noexcept { return {data, size}; }
+
+private:
+#if defined(_WIN32)
+    void map(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("Cannot open " + path);
+        size = static_cast<std::size_t>(in.tellg());
+        buffer.resize(size);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size));
+        data = buffer.data();
+    }
+
+    void unmap() noexcept
+    {
+        buffer.clear();
+        data = nullptr;
+        size = 0;
+    }
+
+    void swap(MappedFile& other) noexcept
+    {
+        std::swap(buffer, other.buffer);
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+    }
+
+    std::vector<std::uint8_t> buffer;
+#else
+    void map(const std::string& path)
+    {
+        int fd{::open(path.c_str(), O_RDONLY)};
+        if (fd == -1) throw std::runtime_error("Cannot open " + path);
+
+        struct stat st{};
+        if (::fstat(fd, &st) == -1) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+
+        size = static_cast<std::size_t>(st.st_size);
+        if (size == 0) { // mmap rejects empty ranges, an empty file is an empty span
+            ::close(fd);
+            return;
+        }
+        void* addr{::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)};
+        ::close(fd); // the mapping keeps its own reference to the file
+
+        if (addr == MAP_FAILED) throw std::runtime_error("Cannot mmap " + path);
+        data = static_cast<const std::uint8_t*>(addr);
+    }
+
+    void unmap() noexcept
+    {
+        if (data) ::munmap(const_cast<std::uint8_t*>(data), size);
+        data = nullptr;
+        size = 0;
+    }
+
+    void swap(MappedFile& other) noexcept
+    {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+    }
+#endif
+
+private:
+    const std::uint8_t* data{nullptr};
+    std::size_t size{};
+};
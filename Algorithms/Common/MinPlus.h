@@ -0,0 +1,367 @@
+#pragma once
+
+#include <limits>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MINPLUS_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Vectorized min-plus ("tropical") kernels for the dynamic programming relaxations
+ *        of Floyd–Warshall and Held–Karp.
+ *
+ * Value convention: an int in [-minPlusInfinity, minPlusInfinity], where minPlusInfinity (INT_MAX / 2)
+ * means "unreachable". The min-plus product of two values is
+ *
+ *     a ⊗ b = a or b unreachable ? minPlusInfinity : max(a + b, -minPlusInfinity)
+ *
+ * which can't overflow, since |a + b| <= INT_MAX - 1. The solvers store the sentinel instead of INT_MAX,
+ * so their loops need no `!= inf` branches, and the kernels below evaluate ⊗ with compares and blends.
+ *
+ * Kernels:
+ *   minPlusRelaxRow(row, through, a, n)                    row[j] = min(row[j], a ⊗ through[j])
+ *   minPlusRelaxRowWithNext(row, next, through, a, na, n)  same, and next[j] = na wherever row[j] improved
+ *   minPlusReduce(x, y, n)                                  min over j of x[j] ⊗ y[j]
+ *   minPlusReduceWithArg(x, y, n)                           same, together with a j that achieves it
+ *
+ * Each kernel has a scalar, an AVX2 and an AVX-512 version. The best one the CPU supports is picked at
+ * runtime on first use (GCC/Clang on x86, through target attributes, so no -mavx2 build flag is needed);
+ * other compilers and architectures get the scalar version, which the auto-vectorizer can still handle.
+ * setMinPlusIsa() forces a version, for benchmarks and tests.
+ */
+
+inline constexpr int minPlusInfinity{std::numeric_limits<int>::max() / 2};
+
+enum class MinPlusIsa
+{
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+namespace minplus_detail
+{
+    inline int product(int a, int b) noexcept
+    {
+        int sum{std::max(a + b, -minPlusInfinity)};
+        return a >= minPlusInfinity || b >= minPlusInfinity ? minPlusInfinity : sum;
+    }
+
+    inline void relaxRowScalar(int* row, const int* through, int a, std::size_t n)
+    {
+        for (std::size_t j{}; j < n; ++j) row[j] = std::min(row[j], product(a, through[j]));
+    }
+
+    inline void relaxRowWithNextScalar(int* row, int* next, const int* through, int a, int aNext, std::size_t n)
+    {
+        for (std::size_t j{}; j < n; ++j) {
+            int candidate{product(a, through[j])};
+            int old{row[j]};
+            row[j] = std::min(old, candidate);
+            next[j] = candidate < old ? aNext : next[j];
+        }
+    }
+
+    inline int reduceScalar(const int* x, const int* y, std::size_t n)
+    {
+        int best{minPlusInfinity};
+        for (std::size_t j{}; j < n; ++j) best = std::min(best, product(x[j], y[j]));
+        return best;
+    }
+
+    inline std::pair<int, int> reduceWithArgScalar(const int* x, const int* y, std::size_t n)
+    {
+        std::pair<int, int> best{minPlusInfinity, -1};
+        for (std::size_t j{}; j < n; ++j) {
+            int candidate{product(x[j], y[j])};
+            if (candidate < best.first) best = {candidate, static_cast<int>(j)};
+        }
+        return best;
+    }
+
+#ifdef MINPLUS_X86_DISPATCH
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push // GCC 12 reports the _mm512_undefined_* placeholders of its own intrinsics (PR 105593)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    // a is finite here (the dispatcher returns early otherwise), so only 'through' needs the mask
+    __attribute__((target("avx2"))) inline __m256i product8(__m256i a, __m256i b)
+    {
+        const __m256i infinity{_mm256_set1_epi32(minPlusInfinity)};
+        __m256i sum{_mm256_max_epi32(_mm256_add_epi32(a, b), _mm256_set1_epi32(-minPlusInfinity))};
+        __m256i unreachable{_mm256_cmpgt_epi32(b, _mm256_set1_epi32(minPlusInfinity - 1))};
+        return _mm256_blendv_epi8(sum, infinity, unreachable);
+    }
+
+    __attribute__((target("avx2"))) inline void relaxRowAvx2(int* row, const int* through, int a, std::size_t n)
+    {
+        const __m256i va{_mm256_set1_epi32(a)};
+        std::size_t j{};
+        for (; j + 8 <= n; j += 8) {
+            __m256i candidate{product8(va, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(through + j)))};
+            __m256i old{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j))};
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + j), _mm256_min_epi32(old, candidate));
+        }
+        relaxRowScalar(row + j, through + j, a, n - j);
+    }
+
+    __attribute__((target("avx2"))) inline void relaxRowWithNextAvx2(int* row, int* next, const int* through, int a, int aNext, std::size_t n)
+    {
+        const __m256i va{_mm256_set1_epi32(a)}, vNext{_mm256_set1_epi32(aNext)};
+        std::size_t j{};
+        for (; j + 8 <= n; j += 8) {
+            __m256i candidate{product8(va, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(through + j)))};
+            __m256i old{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j))};
+            __m256i better{_mm256_cmpgt_epi32(old, candidate)};
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + j), _mm256_min_epi32(old, candidate));
+            __m256i oldNext{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(next + j))};
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(next + j), _mm256_blendv_epi8(oldNext, vNext, better));
+        }
+        relaxRowWithNextScalar(row + j, next + j, through + j, a, aNext, n - j);
+    }
+
+    // x ⊗ y where both sides can be unreachable
+    __attribute__((target("avx2"))) inline __m256i productBoth8(__m256i x, __m256i y)
+    {
+        const __m256i infinity{_mm256_set1_epi32(minPlusInfinity)}, almost{_mm256_set1_epi32(minPlusInfinity - 1)};
+        __m256i sum{_mm256_max_epi32(_mm256_add_epi32(x, y), _mm256_set1_epi32(-minPlusInfinity))};
+        __m256i unreachable{_mm256_or_si256(_mm256_cmpgt_epi32(x, almost), _mm256_cmpgt_epi32(y, almost))};
+        return _mm256_blendv_epi8(sum, infinity, unreachable);
+    }
+
+    __attribute__((target("avx2"))) inline int horizontalMin8(__m256i v)
+    {
+        __m128i m{_mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1))};
+        m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(m);
+    }
+
+    __attribute__((target("avx2"))) inline int reduceAvx2(const int* x, const int* y, std::size_t n)
+    {
+        __m256i best{_mm256_set1_epi32(minPlusInfinity)};
+        std::size_t j{};
+        for (; j + 8 <= n; j += 8) {
+            __m256i vx{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + j))};
+            __m256i vy{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + j))};
+            best = _mm256_min_epi32(best, productBoth8(vx, vy));
+        }
+        return std::min(horizontalMin8(best), reduceScalar(x + j, y + j, n - j));
+    }
+
+    // keeps the index of the lane minimum next to it, then picks the smallest index holding the overall minimum
+    __attribute__((target("avx2"))) inline std::pair<int, int> reduceWithArgAvx2(const int* x, const int* y, std::size_t n)
+    {
+        __m256i best{_mm256_set1_epi32(minPlusInfinity)}, bestIndex{_mm256_set1_epi32(-1)};
+        __m256i index{_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)};
+        std::size_t j{};
+        for (; j + 8 <= n; j += 8) {
+            __m256i vx{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + j))};
+            __m256i vy{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + j))};
+            __m256i candidate{productBoth8(vx, vy)};
+
+            bestIndex = _mm256_blendv_epi8(bestIndex, index, _mm256_cmpgt_epi32(best, candidate));
+            best = _mm256_min_epi32(best, candidate);
+            index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+        }
+
+        std::pair<int, int> result{horizontalMin8(best), -1};
+        if (result.first < minPlusInfinity) {
+            __m256i atMinimum{_mm256_cmpeq_epi32(best, _mm256_set1_epi32(result.first))};
+            __m256i candidates{_mm256_blendv_epi8(_mm256_set1_epi32(std::numeric_limits<int>::max()), bestIndex, atMinimum)};
+            result.second = horizontalMin8(candidates);
+        }
+
+        std::pair<int, int> tail{reduceWithArgScalar(x + j, y + j, n - j)};
+        if (tail.first < result.first) result = {tail.first, tail.second + static_cast<int>(j)};
+        return result;
+    }
+
+    // lanes [j, min(n, j + 16)) of a 16 lane vector
+    __attribute__((target("avx512f"))) inline __mmask16 lanesFrom(std::size_t j, std::size_t n)
+    {
+        return n - j >= 16 ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << (n - j)) - 1);
+    }
+
+    __attribute__((target("avx512f"))) inline __m512i product16(__m512i a, __m512i b)
+    {
+        __m512i sum{_mm512_max_epi32(_mm512_add_epi32(a, b), _mm512_set1_epi32(-minPlusInfinity))};
+        __mmask16 unreachable{_mm512_cmpge_epi32_mask(b, _mm512_set1_epi32(minPlusInfinity))};
+        return _mm512_mask_mov_epi32(sum, unreachable, _mm512_set1_epi32(minPlusInfinity));
+    }
+
+    __attribute__((target("avx512f"))) inline void relaxRowAvx512(int* row, const int* through, int a, std::size_t n)
+    {
+        const __m512i va{_mm512_set1_epi32(a)};
+        std::size_t j{};
+        for (; j + 16 <= n; j += 16) {
+            __m512i candidate{product16(va, _mm512_loadu_si512(through + j))};
+            _mm512_storeu_si512(row + j, _mm512_min_epi32(_mm512_loadu_si512(row + j), candidate));
+        }
+        if (j < n) { // masked tail
+            __mmask16 tail{lanesFrom(j, n)};
+            __m512i candidate{product16(va, _mm512_maskz_loadu_epi32(tail, through + j))};
+            __m512i old{_mm512_maskz_loadu_epi32(tail, row + j)};
+            _mm512_mask_storeu_epi32(row + j, tail, _mm512_min_epi32(old, candidate));
+        }
+    }
+
+    __attribute__((target("avx512f"))) inline void relaxRowWithNextAvx512(int* row, int* next, const int* through, int a, int aNext, std::size_t n)
+    {
+        const __m512i va{_mm512_set1_epi32(a)}, vNext{_mm512_set1_epi32(aNext)};
+        std::size_t j{};
+        for (; j < n; j += 16) {
+            __mmask16 lanes{lanesFrom(j, n)};
+            __m512i candidate{product16(va, _mm512_maskz_loadu_epi32(lanes, through + j))};
+            __m512i old{_mm512_maskz_loadu_epi32(lanes, row + j)};
+            __mmask16 better{_mm512_mask_cmplt_epi32_mask(lanes, candidate, old)};
+
+            _mm512_mask_storeu_epi32(row + j, better, candidate);
+            _mm512_mask_storeu_epi32(next + j, better, vNext);
+        }
+    }
+
+    __attribute__((target("avx512f"))) inline __m512i productBoth16(__m512i x, __m512i y)
+    {
+        const __m512i infinity{_mm512_set1_epi32(minPlusInfinity)};
+        __m512i sum{_mm512_max_epi32(_mm512_add_epi32(x, y), _mm512_set1_epi32(-minPlusInfinity))};
+        __mmask16 unreachable{static_cast<__mmask16>(_mm512_cmpge_epi32_mask(x, infinity) | _mm512_cmpge_epi32_mask(y, infinity))};
+        return _mm512_mask_mov_epi32(sum, unreachable, infinity);
+    }
+
+    __attribute__((target("avx512f"))) inline int horizontalMin16(__m512i v)
+    {
+        return horizontalMin8(_mm256_min_epi32(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1)));
+    }
+
+    __attribute__((target("avx512f"))) inline int reduceAvx512(const int* x, const int* y, std::size_t n)
+    {
+        const __m512i infinity{_mm512_set1_epi32(minPlusInfinity)};
+        __m512i best{infinity};
+        for (std::size_t j{}; j < n; j += 16) {
+            // masked-off lanes load as infinity, which never wins
+            __mmask16 lanes{lanesFrom(j, n)};
+            __m512i vx{_mm512_mask_loadu_epi32(infinity, lanes, x + j)};
+            __m512i vy{_mm512_mask_loadu_epi32(infinity, lanes, y + j)};
+            best = _mm512_min_epi32(best, productBoth16(vx, vy));
+        }
+        return horizontalMin16(best);
+    }
+
+    __attribute__((target("avx512f"))) inline std::pair<int, int> reduceWithArgAvx512(const int* x, const int* y, std::size_t n)
+    {
+        const __m512i infinity{_mm512_set1_epi32(minPlusInfinity)};
+        __m512i best{infinity}, bestIndex{_mm512_set1_epi32(-1)};
+        __m512i index{_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)};
+        for (std::size_t j{}; j < n; j += 16) {
+            __mmask16 lanes{lanesFrom(j, n)};
+            __m512i vx{_mm512_mask_loadu_epi32(infinity, lanes, x + j)};
+            __m512i vy{_mm512_mask_loadu_epi32(infinity, lanes, y + j)};
+            __m512i candidate{productBoth16(vx, vy)};
+
+            bestIndex = _mm512_mask_mov_epi32(bestIndex, _mm512_cmplt_epi32_mask(candidate, best), index);
+            best = _mm512_min_epi32(best, candidate);
+            index = _mm512_add_epi32(index, _mm512_set1_epi32(16));
+        }
+
+        std::pair<int, int> result{horizontalMin16(best), -1};
+        if (result.first < minPlusInfinity) {
+            __mmask16 atMinimum{_mm512_cmpeq_epi32_mask(best, _mm512_set1_epi32(result.first))};
+            __m512i candidates{_mm512_mask_mov_epi32(_mm512_set1_epi32(std::numeric_limits<int>::max()), atMinimum, bestIndex)};
+            result.second = horizontalMin16(candidates);
+        }
+        return result;
+    }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+    struct Kernels
+    {
+        MinPlusIsa isa;
+        void (*relaxRow)(int*, const int*, int, std::size_t);
+        void (*relaxRowWithNext)(int*, int*, const int*, int, int, std::size_t);
+        int (*reduce)(const int*, const int*, std::size_t);
+        std::pair<int, int> (*reduceWithArg)(const int*, const int*, std::size_t);
+    };
+
+    inline MinPlusIsa bestSupportedIsa()
+    {
+#ifdef MINPLUS_X86_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return MinPlusIsa::Avx512;
+        if (__builtin_cpu_supports("avx2")) return MinPlusIsa::Avx2;
+#endif
+        return MinPlusIsa::Scalar;
+    }
+
+    inline Kernels kernelsFor(MinPlusIsa isa)
+    {
+#ifdef MINPLUS_X86_DISPATCH
+        if (isa == MinPlusIsa::Avx512) return {isa, relaxRowAvx512, relaxRowWithNextAvx512, reduceAvx512, reduceWithArgAvx512};
+        if (isa == MinPlusIsa::Avx2) return {isa, relaxRowAvx2, relaxRowWithNextAvx2, reduceAvx2, reduceWithArgAvx2};
+#endif
+        return {MinPlusIsa::Scalar, relaxRowScalar, relaxRowWithNextScalar, reduceScalar, reduceWithArgScalar};
+    }
+
+    inline Kernels& active()
+    {
+        static Kernels kernels{kernelsFor(bestSupportedIsa())};
+        return kernels;
+    }
+}
+
+inline MinPlusIsa minPlusIsa() { return minplus_detail::active().isa; }
+
+inline const char* minPlusIsaName(MinPlusIsa isa)
+{
+    switch (isa) {
+        case MinPlusIsa::Avx512: return "AVX-512";
+        case MinPlusIsa::Avx2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+/**
+ * Forces a kernel version; a version the CPU doesn't support falls back to the best supported one below it.
+ * Not thread safe - call it before starting the solvers.
+ * @return the version actually selected
+ */
+inline MinPlusIsa setMinPlusIsa(MinPlusIsa isa)
+{
+    MinPlusIsa supported{minplus_detail::bestSupportedIsa()};
+    if (static_cast<int>(isa) > static_cast<int>(supported)) isa = supported;
+
+    minplus_detail::active() = minplus_detail::kernelsFor(isa);
+    return isa;
+}
+
+inline void minPlusRelaxRow(int* row, const int* through, int a, std::size_t n)
+{
+    if (a >= minPlusInfinity) return; // nothing is reachable through a
+    minplus_detail::active().relaxRow(row, through, a, n);
+}
+
+inline void minPlusRelaxRowWithNext(int* row, int* next, const int* through, int a, int aNext, std::size_t n)
+{
+    if (a >= minPlusInfinity) return;
+    minplus_detail::active().relaxRowWithNext(row, next, through, a, aNext, n);
+}
+
+inline int minPlusReduce(const int* x, const int* y, std::size_t n)
+{
+    return minplus_detail::active().reduce(x, y, n);
+}
+
+// (min over j of x[j] ⊗ y[j], a j achieving it), or (minPlusInfinity, -1)
+inline std::pair<int, int> minPlusReduceWithArg(const int* x, const int* y, std::size_t n)
+{
+    return minplus_detail::active().reduceWithArg(x, y, n);
+}
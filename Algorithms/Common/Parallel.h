@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * @brief Minimal fork-join helpers shared by the multithreaded algorithms.
+ *
+ * parallelForChunks splits [0, count) into one contiguous chunk per thread and runs
+ * body(begin, end, threadIndex) on each; the calling thread takes chunk 0, so threads == 1
+ * (or a count below minChunk) runs inline without spawning anything.
+ *
+ * Called with a thread count, every call creates and joins threads - 1 std::threads, tens of
+ * microseconds per call. That is noise for one big loop, but not for an algorithm that runs thousands
+ * of short phases (delta-stepping buckets, BFS levels): those keep a ThreadTeam for the whole run and
+ * pass it instead of the count, so a phase only wakes threads that already exist.
+ */
+
+inline unsigned defaultThreadCount()
+{
+    unsigned hw{std::thread::hardware_concurrency()};
+    return hw == 0 ? 1 : hw;
+}
+
+// number of chunks parallelForChunks cuts count into
+inline unsigned usedThreadCount(std::size_t count, unsigned threads, std::size_t minChunk)
+{
+    std::size_t maxThreads{std::max<std::size_t>(1, count / std::max<std::size_t>(1, minChunk))};
+    return static_cast<unsigned>(std::min<std::size_t>(std::max(1u, threads), maxThreads));
+}
+
+template <typename Body>
+void parallelForChunks(std::size_t count, unsigned threads, Body&& body, std::size_t minChunk = 1)
+{
+    if (count == 0) return;
+
+    unsigned used{usedThreadCount(count, threads, minChunk)};
+    if (used == 1) {
+        body(std::size_t{0}, count, 0u);
+        return;
+    }
+
+    std::size_t chunk{(count + used - 1) / used};
+    std::vector<std::thread> workers;
+    workers.reserve(used - 1);
+    for (unsigned t{1}; t < used; ++t) {
+        std::size_t begin{std::min(count, t * chunk)}, end{std::min(count, begin + chunk)};
+        workers.emplace_back([&body, begin, end, t] { body(begin, end, t); });
+    }
+
+    body(std::size_t{0}, std::min(count, chunk), 0u);
+    for (auto& worker : workers) worker.join();
+}
+
+/**
+ * @brief Persistent fork-join team: size() - 1 worker threads plus the calling thread, reused by every
+ *        parallelForChunks(team, ...) call.
+ *
+ * A call publishes the body, bumps a generation counter and wakes the workers; each worker runs its chunk
+ * (or nothing, when the count leaves it idle) and checks in, and the caller returns once all have. The
+ * waits are std::atomic waits, which spin briefly before sleeping, so back-to-back phases rarely reach the
+ * kernel. Only one thread may call into a team at a time, not from inside a body, and bodies must not
+ * throw (as with the spawning overload).
+ */
+class ThreadTeam
+{
+public:
+    // threads: team size including the caller, 0 means all hardware threads
+    explicit ThreadTeam(unsigned threads = 0) : memberCount{threads == 0 ? defaultThreadCount() : threads}
+    {
+        workers.reserve(memberCount - 1);
+        for (unsigned t{1}; t < memberCount; ++t) workers.emplace_back([this, t] { work(t); });
+    }
+
+    ThreadTeam(const ThreadTeam&) = delete;
+    ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+    ~ThreadTeam()
+    {
+        stopping = true;
+        generation.fetch_add(1, std::memory_order_release);
+        generation.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    unsigned size() const noexcept { return memberCount; }
+
+    template <typename Body>
+    void forChunks(std::size_t count, Body&& body, std::size_t minChunk)
+    {
+        if (count == 0) return;
+
+        unsigned used{usedThreadCount(count, memberCount, minChunk)};
+        if (used == 1) {
+            body(std::size_t{0}, count, 0u);
+            return;
+        }
+
+        std::size_t chunk{(count + used - 1) / used};
+        job = Job{&body, [](void* b, std::size_t begin, std::size_t end, unsigned t) {
+            (*static_cast<std::remove_reference_t<Body>*>(b))(begin, end, t);
+        }, count, chunk, used};
+        remaining.store(memberCount - 1, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+        generation.notify_all();
+
+        body(std::size_t{0}, std::min(count, chunk), 0u);
+        for (unsigned left; (left = remaining.load(std::memory_order_acquire)) != 0;) {
+            remaining.wait(left, std::memory_order_acquire);
+        }
+    }
+
+private:
+    struct Job
+    {
+        void* body{};
+        void (*run)(void*, std::size_t, std::size_t, unsigned){};
+        std::size_t count{}, chunk{};
+        unsigned used{};
+    };
+
+    void work(unsigned t)
+    {
+        std::uint64_t seen{};
+        while (true) {
+            generation.wait(seen, std::memory_order_acquire);
+            seen = generation.load(std::memory_order_acquire);
+            if (stopping) return;
+
+            // every worker checks in, even an idle one, so job is not rewritten while it may still be read
+            if (t < job.used) {
+                std::size_t begin{std::min(job.count, t * job.chunk)}, end{std::min(job.count, begin + job.chunk)};
+                job.run(job.body, begin, end, t);
+            }
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) remaining.notify_one();
+        }
+    }
+
+    unsigned memberCount{};
+    std::vector<std::thread> workers;
+    Job job;
+    bool stopping{false}; // written before a generation bump, read after it
+    std::atomic<std::uint64_t> generation{0};
+    std::atomic<unsigned> remaining{0};
+};
+
+template <typename Body>
+void parallelForChunks(ThreadTeam& team, std::size_t count, Body&& body, std::size_t minChunk = 1)
+{
+    team.forChunks(count, body, minChunk);
+}
+
+// body(i, threadIndex) for every i in [0, count)
+template <typename Body>
+void parallelFor(std::size_t count, unsigned threads, Body&& body, std::size_t minChunk = 1)
+{
+    parallelForChunks(count, threads, [&body](std::size_t begin, std::size_t end, unsigned t) {
+        for (std::size_t i{begin}; i < end; ++i) body(i, t);
+    }, minChunk);
+}
+
+template <typename Body>
+void parallelFor(ThreadTeam& team, std::size_t count, Body&& body, std::size_t minChunk = 1)
+{
+    parallelForChunks(team, count, [&body](std::size_t begin, std::size_t end, unsigned t) {
+        for (std::size_t i{begin}; i < end; ++i) body(i, t);
+    }, minChunk);
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+#include "Parallel.h"
+
+/**
+ * @brief Fixed set of worker threads with one task deque each; idle workers steal from the others.
+ *
+ * A task submitted from inside a worker goes to the back of that worker's own deque and the worker pops
+ * from the back again (LIFO: the successor it just made ready is hot in its cache). A worker with an empty
+ * deque steals from the front of the other deques, where the oldest tasks are. Submissions from outside
+ * the pool are spread round-robin.
+ *
+ * wait() blocks until every submitted task, including the tasks those submit, has finished, and rethrows
+ * the first exception a task threw (the remaining tasks still run). It must not be called from a task.
+ *
+ * The deques are plain mutex-protected std::deque: the lock is only contended when a thief and the owner
+ * meet on the same deque.
+ */
+
+class WorkStealingPool
+{
+public:
+    // threads: number of workers, 0 means all hardware threads
+    explicit WorkStealingPool(unsigned threads = 0) : workerCount{threads == 0 ? defaultThreadCount() : threads}
+    {
+        for (unsigned i{}; i < workerCount; ++i) queues.push_back(std::make_unique<Queue>());
+        workers.reserve(workerCount);
+        for (unsigned i{}; i < workerCount; ++i) workers.emplace_back([this, i] { work(i); });
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard lock{sleepMutex};
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    unsigned size() const noexcept { return workerCount; }
+
+    void submit(std::function<void()> task)
+    {
+        unsigned target{currentPool == this ? currentWorker : nextQueue.fetch_add(1, std::memory_order_relaxed) % workerCount};
+        pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            // counted before it is visible, so queued never drops below the real number of tasks, and under
+            // the sleep mutex, so a worker can't check for work and fall asleep in between
+            std::lock_guard lock{sleepMutex};
+            queued.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard lock{queues[target]->mutex};
+            queues[target]->tasks.push_back(std::move(task));
+        }
+        wake.notify_one();
+    }
+
+    void wait()
+    {
+        std::unique_lock lock{sleepMutex};
+        idle.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+
+        std::exception_ptr error{std::exchange(firstError, nullptr)};
+        lock.unlock();
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void work(unsigned self)
+    {
+        currentPool = this;
+        currentWorker = self;
+
+        while (true) {
+            std::function<void()> task;
+            if (!take(self, task)) {
+                std::unique_lock lock{sleepMutex};
+                wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_relaxed) > 0; });
+                if (stopping && queued.load(std::memory_order_relaxed) == 0) return;
+                continue;
+            }
+
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard lock{sleepMutex};
+                if (!firstError) firstError = std::current_exception();
+            }
+
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard lock{sleepMutex};
+                idle.notify_all();
+            }
+        }
+    }
+
+    // own deque from the back, then the others from the front
+    bool take(unsigned self, std::function<void()>& task)
+    {
+        for (unsigned k{}; k < workerCount; ++k) {
+            Queue& queue{*queues[(self + k) % workerCount]};
+            std::lock_guard lock{queue.mutex};
+            if (queue.tasks.empty()) continue;
+
+            if (k == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    static inline thread_local WorkStealingPool* currentPool{nullptr};
+    static inline thread_local unsigned currentWorker{};
+
+    unsigned workerCount{};
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<std::size_t> pending{};   // submitted and not finished
+    std::atomic<std::size_t> queued{};    // sitting in a deque
+    std::atomic<unsigned> nextQueue{};
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    bool stopping{false};
+    std::exception_ptr firstError;
+};
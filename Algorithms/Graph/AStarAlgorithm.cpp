@@ -40,11 +40,24 @@
  * - O(V) for storing distances, parents, heuristic values, and closed nodes.
  *
  * Implementation details:
- * - The graph is represented as an adjacency list with weighted edges.
+ * - The graph is read through a non-owning CSRGraphView (see CSRGraph.h). The edge list constructor
+ *   builds an undirected CSRGraph owned by the solver.
  * - Heuristic values are precomputed using Manhattan distance relative to the destination coordinates.
- * - A priority queue manages nodes ordered by their f-score (estimated total cost).
+ *   The coordinates come either from a grid of vertex ids or from a per-vertex GridCoordinate array,
+ *   e.g. the coordinate section of a memory-mapped graph file (see GraphFile.h).
+ * - A priority queue manages nodes ordered by their f-score (estimated total cost). The queue is a policy
+ *   with decrease-key (PriorityQueues.h): an indexed 4-ary heap by default, or a radix heap / bucket queue.
  * - Closed nodes are tracked in a boolean vector.
  * - Path reconstruction follows parent pointers from destination to source after completion.
+ *
+ * For plain occupancy grids GridAStar (GridAStar.h) needs neither the vertex id matrix nor an edge list: it
+ * reads a bit-packed grid, computes neighbors and the heuristic per visited cell, and has a Jump Point
+ * Search mode for 4- and 8-connectivity. It is also what the Python visualizer calls through its bindings.
+ *
+ * Graphs without coordinates (road networks) take their heuristic from a LandmarkTable (Landmarks.h): the
+ * ALT lower bounds come from precomputed distances to and from a few landmarks via the triangle
+ * inequality. solveBidirectional() runs bidirectional A* (BidirectionalQuery.h, shared with Dijkstra) with
+ * the same heuristic towards the destination and a mirrored one towards the source.
  */
 
 
@@ -52,20 +65,64 @@
 #include <vector>
 #include <iostream>
 #include <exception>
-#include <queue>
 #include <algorithm>
 #include <limits>
 #include <unordered_set>
+#include <cstdio>
+#include <random>
+#include <chrono>
+#include <optional>
+#include "CSRGraph.h"
+#include "GraphFile.h"
+#include "PriorityQueues.h"
+#include "GridAStar.h"
+#include "Landmarks.h"
+#include "BidirectionalQuery.h"
+#include "TestGraphs.h"
 
 class AStarSolver
 {
 public:
+    AStarSolver(const std::vector<std::vector<int>> &grid, CSRGraphView g, int src, int dst)
+        : graph{g}, source{src}, destination{dst}, V{g.size()}
+    {
+        if (V <= 0) throw std::invalid_argument("Number of Vertices should be > 0");
+        checkWeights();
+        initHeuristicValues(grid);
+    }
+
+    AStarSolver(CSRGraphView g, std::span<const GridCoordinate> coordinates, int src, int dst)
+        : graph{g}, source{src}, destination{dst}, V{g.size()}
+    {
+        if (V <= 0) throw std::invalid_argument("Number of Vertices should be > 0");
+        if (coordinates.size() != static_cast<std::size_t>(V)) {
+            throw std::invalid_argument("Coordinates must be given for every vertex");
+        }
+        checkWeights();
+
+        initHeuristicValues(coordinates);
+    }
+
+    // any graph with non-negative weights, the ALT bounds of a table built for it as heuristic
+    AStarSolver(CSRGraphView g, const LandmarkTable& landmarks, int src, int dst)
+        : graph{g}, source{src}, destination{dst}, V{g.size()}
+    {
+        if (V <= 0) throw std::invalid_argument("Number of Vertices should be > 0");
+        if (landmarks.size() != V) throw std::invalid_argument("Landmark table belongs to another graph");
+        checkWeights();
+
+        heuristicValues.assign(V, 0);
+        sourceHeuristicValues.assign(V, 0);
+        for (int u{}; u < V; ++u) {
+            heuristicValues[u] = landmarks.lowerBound(u, destination);
+            sourceHeuristicValues[u] = landmarks.lowerBound(source, u);
+        }
+    }
+
     AStarSolver(const std::vector<std::vector<int>> &grid, const std::vector<std::tuple<int, int, int>>& edges, int src, int dst, int numberOfVertices)
         : source{src}, destination{dst}, V{numberOfVertices}
     {
         if (V <= 0) throw std::invalid_argument("Number of Vertices should be > 0");
-        graph.assign(V, {});
-        heuristicValues.assign(V, 0);
 
         for (auto [u, v, w] : edges) {
             if (u < 0 || u >= V || v < 0 || v >= V) {
@@ -74,22 +131,40 @@ public:
             if (w < 0) {
                 throw std::invalid_argument("Negative edge weights are not supported by A*");
             }
-
-            graph[u].push_back(std::make_pair(v, w));
-            graph[v].push_back(std::make_pair(u, w));
         }
 
+        storage = CSRGraph::fromEdges(V, edges, true/*undirected*/);
+        graph = storage.view();
+        reverse = graph; // undirected: every arc has its twin
+
         initHeuristicValues(grid);
     }
 
+    // graph, reverse and the bidirectional query may point into members, so a copy would view the original's arrays
+    AStarSolver(const AStarSolver&) = delete;
+    AStarSolver& operator=(const AStarSolver&) = delete;
+
     bool solve()
     {
-        std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> pq;
-        
+        IndexedDaryHeap<4> pq;
+        return solve(pq);
+    }
+
+    /**
+     * @brief A* with a pluggable priority queue (see PriorityQueues.h).
+     * RadixHeap and BucketQueue need monotone f-scores, i.e. a consistent heuristic;
+     * for a BucketQueue use a key spread of 2 * max edge weight.
+     */
+    template <typename PriorityQueue>
+    bool solve(PriorityQueue& pq)
+    {
+        pq.reset(V);
+
         std::vector<bool> closed(V);
 
         std::vector<int> dist(V, inf);
         parent.assign(V, -1);
+        settledNodes = 0;
 
         // f(n) = g(n) + h(n)
         auto f = [this, &dist](int node) {
@@ -97,16 +172,12 @@ public:
         };
 
         dist[source] = 0;
-        pq.push(std::make_pair(f(source), source));
+        pq.push(source, f(source));
 
         while (!pq.empty()) {
-            // popping all explored nodes
-            while (!pq.empty() && closed[pq.top().second] == true) pq.pop();
-
-            if (pq.empty()) break;
-
-            auto [f_score, u] = pq.top();
-            pq.pop();
+            // every node is queued at most once (decrease-key), so there are no stale entries to skip
+            auto [f_score, u] = pq.pop();
+            ++settledNodes;
 
             if (u == destination) {
                 std::cout << "Destination found\n";
@@ -115,9 +186,9 @@ public:
             }
 
             closed[u] = true;
-            // if (f_score > dist[u] + heuristicValues[u]) continue; if closed is not used
 
-            for (auto [v, w] : graph[u])  {
+            for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e)  {
+                int v{graph.target(e)}, w{graph.weight(e)};
                 if (closed[v] == true) continue;
 
                 int tentativeGValue{dist[u] + w};
@@ -125,7 +196,7 @@ public:
                     dist[v] = tentativeGValue;
                     parent[v] = u;
 
-                    pq.push(std::make_pair(f(v), v));
+                    pq.push(v, f(v)); // insert or decrease-key
                 }
             }
         }
@@ -134,6 +205,43 @@ public:
         return false;
     }
 
+    /**
+     * @brief Bidirectional A*: searches from the source and, on the reverse graph, from the destination.
+     * On a road graph with landmarks this settles a small fraction of what solve() settles.
+     * reconstructPath() works afterwards as after solve().
+     */
+    bool solveBidirectional()
+    {
+        // the reverse graph and the search buffers are built on the first call and kept for the next ones
+        if (!bidirectional) {
+            PrecomputedHeuristic h{heuristicValues, sourceHeuristicValues};
+            if (reverse.size() == 0) {
+                reverseStorage = CSRGraph::reverse(graph);
+                reverse = reverseStorage.view();
+            }
+            bidirectional.emplace(graph, reverse, h);
+        }
+        BidirectionalQuery<PrecomputedHeuristic>& query{*bidirectional};
+
+        int distance{query.run(source, destination)};
+        settledNodes = query.settledCount();
+        if (distance == inf) {
+            std::cout << "Destination cannot be found\n";
+            return false;
+        }
+
+        std::cout << "Destination found\n";
+        shortestDistance = distance;
+
+        std::vector<int> nodes{query.path()};
+        parent.assign(V, -1);
+        for (std::size_t i{1}; i < nodes.size(); ++i) parent[nodes[i]] = nodes[i - 1];
+        return true;
+    }
+
+    // nodes taken off the queue(s) by the last solve
+    int getSettledCount() const noexcept { return settledNodes; }
+
     int getShortestPath()
     {
         if (shortestDistance == -1) solve();
@@ -178,29 +286,62 @@ public:
         return std::abs(x1 - x2) + std::abs(y1 - y2);
     }
 
+    // one pass over the grid for the cell of every node, then the heuristics from those
     void initHeuristicValues(const std::vector<std::vector<int>> &grid)
     {
-        auto [x, y] = getCoordinates(grid, destination);
-
-        // caching all heuristic values
-        for (int i{}; i < grid.size(); ++i) {
-            for (int j{}; j < grid[0].size(); ++j) {
+        std::vector<GridCoordinate> coordinates(V);
+        bool sourceFound{}, destinationFound{};
+        for (int i{}; i < static_cast<int>(grid.size()); ++i) {
+            for (int j{}; j < static_cast<int>(grid[i].size()); ++j) {
                 int u{grid[i][j]};
-                if (u != -1) {
-                    heuristicValues[u] = getManhattenDistance(i, j, x, y);
-                }
+                if (u < 0 || u >= V) continue;
+                coordinates[u] = {i, j};
+                sourceFound |= u == source;
+                destinationFound |= u == destination;
+            }
+        }
+        if (!sourceFound || !destinationFound) throw std::invalid_argument("The destination node cannot be found in the grid.");
+
+        initHeuristicValues(coordinates);
+    }
+
+    // caching all heuristic values
+    void initHeuristicValues(std::span<const GridCoordinate> coordinates)
+    {
+        heuristicValues.assign(V, 0);
+        sourceHeuristicValues.assign(V, 0);
+        auto [x, y] = coordinates[destination];
+        auto [sx, sy] = coordinates[source];
+        for (int u{}; u < V; ++u) {
+            heuristicValues[u] = getManhattenDistance(coordinates[u].row, coordinates[u].col, x, y);
+            sourceHeuristicValues[u] = getManhattenDistance(coordinates[u].row, coordinates[u].col, sx, sy);
+        }
+    }
+
+private:
+    void checkWeights() const
+    {
+        for (int e{}; e < graph.numberOfEdges; ++e) {
+            if (graph.weight(e) < 0) {
+                throw std::invalid_argument("Negative edge weights are not supported by A*");
             }
         }
     }
 
 private:
-    std::vector<std::vector<std::pair<int, int>>> graph;
-    std::vector<int> heuristicValues;
+    CSRGraph storage; // only used when built from an edge list
+    CSRGraphView graph;
+    CSRGraph reverseStorage; // only after solveBidirectional on a directed graph
+    CSRGraphView reverse{};
+    std::optional<BidirectionalQuery<PrecomputedHeuristic>> bidirectional;
+    std::vector<int> heuristicValues;       // lower bounds on the distance to the destination
+    std::vector<int> sourceHeuristicValues; // lower bounds on the distance from the source (bidirectional)
     int source{};
     int destination{};
     int V{};
 
     int shortestDistance{-1};
+    int settledNodes{};
     std::vector<int> parent;
     std::vector<int> path; // for reconstruction
 
@@ -268,7 +409,244 @@ void test1()
     std::cout << std::endl;
 }
 
+// same graph as test1, written to a binary graph file with coordinates and solved from the mapping
+void testMappedGraphFile()
+{
+    std::vector<std::tuple<int, int, int>> edges {
+        {0, 1, 5}, {0, 2, 5}, {1, 2, 4}, {1, 3, 3}, {2, 3, 7}, {2, 4, 7}, {4, 5, 4}, {5, 6, 9}, {2, 7, 8},
+        {4, 7, 5}, {7, 8, 3}, {8, 9, 4}, {9, 13, 3}, {6, 13, 12}, {3, 12, 14}, {3, 11, 13}, {3, 10, 16},
+        {10, 11, 5}, {11, 12, 9}, {11, 14, 4}, {12, 14, 5}, {10, 15, 4}, {10, 13, 7}, {9, 15, 8}, {13, 15, 7}
+    };
+
+    std::vector<GridCoordinate> coordinates {
+        {8, 0}, {5, 2}, {8, 3}, {4, 4}, {12, 4}, {13, 1}, {15, 6}, {10, 7},
+        {11, 9}, {12, 12}, {8, 12}, {5, 12}, {2, 12}, {13, 14}, {4, 15}, {8, 16}
+    };
+
+    const std::string path{"astar_test_graph.bin"};
+    CSRGraph graph{CSRGraph::fromEdges(16, edges, true/*undirected*/)};
+    writeGraphFile(path, graph.view(), coordinates);
+
+    {
+        MappedGraphFile file{path};
+        AStarSolver solver{file.view(), file.coordinates(), 0, 15};
+
+        std::cout << "mapped: 0 -> 15 = " << solver.getShortestPath() << std::endl;
+        for (int i : solver.reconstructPath()) std::cout << i << " ";
+        std::cout << std::endl;
+    }
+
+    std::remove(path.c_str());
+}
+
+// test1's graph solved with every priority queue backend, all must agree
+int testPriorityQueues()
+{
+    std::vector<std::tuple<int, int, int>> edges {
+        {0, 1, 5}, {0, 2, 5}, {1, 2, 4}, {1, 3, 3}, {2, 3, 7}, {2, 4, 7}, {4, 5, 4}, {5, 6, 9}, {2, 7, 8},
+        {4, 7, 5}, {7, 8, 3}, {8, 9, 4}, {9, 13, 3}, {6, 13, 12}, {3, 12, 14}, {3, 11, 13}, {3, 10, 16},
+        {10, 11, 5}, {11, 12, 9}, {11, 14, 4}, {12, 14, 5}, {10, 15, 4}, {10, 13, 7}, {9, 15, 8}, {13, 15, 7}
+    };
+
+    std::vector<GridCoordinate> coordinates {
+        {8, 0}, {5, 2}, {8, 3}, {4, 4}, {12, 4}, {13, 1}, {15, 6}, {10, 7},
+        {11, 9}, {12, 12}, {8, 12}, {5, 12}, {2, 12}, {13, 14}, {4, 15}, {8, 16}
+    };
+
+    CSRGraph graph{CSRGraph::fromEdges(16, edges, true/*undirected*/)};
+
+    IndexedDaryHeap<2> binaryHeap;
+    IndexedDaryHeap<4> quaternaryHeap;
+    RadixHeap radixHeap;
+    BucketQueue bucketQueue{2 * 16/*max edge weight*/};
+
+    // every queue must find the same cost as the binary heap, for every pair of vertices
+    int mismatches{};
+    auto run = [&](const char* name, auto& pq) {
+        for (int src{}; src < 16; ++src) {
+            for (int dst{}; dst < 16; ++dst) {
+                AStarSolver expected{graph.view(), coordinates, src, dst}, solver{graph.view(), coordinates, src, dst};
+                std::cout.setstate(std::ios::failbit); // silence "Destination found"
+                expected.solve(binaryHeap);
+                solver.solve(pq);
+                std::cout.clear();
+                if (solver.getShortestPath() != expected.getShortestPath()) ++mismatches;
+            }
+        }
+        AStarSolver solver{graph.view(), coordinates, 0, 15};
+        solver.solve(pq);
+        if (solver.getShortestPath() != 28) ++mismatches;
+        std::cout << name << ": 0 -> 15 = " << solver.getShortestPath() << std::endl;
+    };
+
+    run("binary heap", binaryHeap);
+    run("4-ary heap", quaternaryHeap);
+    run("radix heap", radixHeap);
+    run("bucket queue", bucketQueue);
+    std::cout << "priority queues: " << mismatches << " cost mismatches\n";
+    return mismatches;
+}
+
+// a small warehouse: every search mode on the same map, JPS must match plain A*
+void testGridAStar()
+{
+    std::vector<std::vector<int>> map {
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+        {0, 1, 1, 1, 1, 1, 1, 1, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 1, 0, 0},
+        {1, 1, 1, 1, 1, 1, 0, 1, 0, 1},
+        {0, 0, 0, 0, 0, 1, 0, 1, 0, 0},
+        {0, 1, 1, 1, 0, 1, 0, 0, 0, 0},
+        {0, 0, 0, 1, 0, 0, 0, 1, 1, 0},
+        {1, 1, 0, 1, 1, 1, 1, 1, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+    };
+    OccupancyGrid grid{map};
+
+    for (auto connectivity : {GridConnectivity::Four, GridConnectivity::Eight}) {
+        for (auto search : {GridSearch::AStar, GridSearch::JumpPoint}) {
+            GridAStar solver{grid, connectivity, search};
+            GridPath path{solver.findPath({0, 0}, {8, 0})};
+
+            std::cout << (connectivity == GridConnectivity::Four ? "4-connected " : "8-connected ")
+                      << (search == GridSearch::AStar ? "A*" : "JPS") << ": cost " << path.cost << ", "
+                      << path.cells.size() << " cells, " << path.expanded << " expanded\n";
+        }
+    }
+}
+
+// every step of the path is a legal move between free cells and the steps add up to the cost
+bool isValidGridPath(const OccupancyGrid& grid, GridConnectivity connectivity, const GridPath& path)
+{
+    int cost{};
+    for (std::size_t i{1}; i < path.cells.size(); ++i) {
+        auto [r, c] = path.cells[i - 1];
+        int dr{path.cells[i].row - r}, dc{path.cells[i].col - c};
+        if (std::abs(dr) > 1 || std::abs(dc) > 1 || (dr == 0 && dc == 0) || !grid.isFree(r + dr, c + dc)) return false;
+        if (dr != 0 && dc != 0) {
+            if (connectivity == GridConnectivity::Four || !grid.isFree(r + dr, c) || !grid.isFree(r, c + dc)) return false;
+            cost += GridAStar::diagonalCost;
+        } else {
+            cost += GridAStar::straightCost;
+        }
+    }
+    return cost == path.cost;
+}
+
+// random obstacle maps: JPS and A* costs must agree, then 4096 x 4096 timings
+int testGridAStarRandomMaps()
+{
+    std::mt19937 rng{2024};
+    int mismatches{};
+    for (int round{}; round < 200; ++round) {
+        int rows{5 + static_cast<int>(rng() % 40)}, cols{5 + static_cast<int>(rng() % 40)};
+        OccupancyGrid grid{rows, cols};
+        for (int r{}; r < rows; ++r) {
+            for (int c{}; c < cols; ++c) grid.setBlocked(r, c, rng() % 100 < 30);
+        }
+        GridCoordinate start{static_cast<int>(rng() % rows), static_cast<int>(rng() % cols)};
+        GridCoordinate goal{static_cast<int>(rng() % rows), static_cast<int>(rng() % cols)};
+        grid.setBlocked(start.row, start.col, false);
+        grid.setBlocked(goal.row, goal.col, false);
+
+        for (auto connectivity : {GridConnectivity::Four, GridConnectivity::Eight}) {
+            GridAStar plain{grid, connectivity};
+            GridAStar jps{grid, connectivity, GridSearch::JumpPoint};
+            GridPath expected{plain.findPath(start, goal)}, jumped{jps.findPath(start, goal)};
+            if (expected.cost != jumped.cost) ++mismatches;
+            if (jumped.cost != -1 && (!isValidGridPath(grid, connectivity, expected) || !isValidGridPath(grid, connectivity, jumped))) ++mismatches;
+        }
+    }
+    std::cout << "random maps: " << mismatches << " cost mismatches between A* and JPS\n";
+
+    // noise with 20% obstacles, and a warehouse: rows of 2 x 30 shelves between one-cell aisles, 1% noise
+    const int side{4096};
+    OccupancyGrid noise{side, side}, warehouse{side, side};
+    for (int r{}; r < side; ++r) {
+        for (int c{}; c < side; ++c) {
+            noise.setBlocked(r, c, rng() % 100 < 20);
+            bool shelf{r % 3 != 0 && c % 31 != 0};
+            warehouse.setBlocked(r, c, shelf || rng() % 100 < 1);
+        }
+    }
+    for (OccupancyGrid* grid : {&noise, &warehouse}) {
+        grid->setBlocked(0, 0, false);
+        grid->setBlocked(side - 1, side - 1, false);
+    }
+
+    for (auto [name, grid] : {std::pair{"noise", &noise}, std::pair{"warehouse", &warehouse}}) {
+        for (auto search : {GridSearch::AStar, GridSearch::JumpPoint}) {
+            GridAStar solver{*grid, GridConnectivity::Eight, search};
+            auto start{std::chrono::steady_clock::now()};
+            GridPath path{solver.findPath({0, 0}, {side - 1, side - 1})};
+            auto elapsed{std::chrono::steady_clock::now() - start};
+
+            std::cout << name << " " << side << "x" << side << " 8-connected " << (search == GridSearch::AStar ? "A*" : "JPS")
+                      << ": cost " << path.cost << ", " << path.expanded << " expanded, "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms\n";
+        }
+    }
+    return mismatches;
+}
+
+// test1's graph with bidirectional A*, then a road-like graph without coordinates: ALT landmarks as heuristic
+int testBidirectionalLandmarks()
+{
+    std::vector<std::tuple<int, int, int>> edges {
+        {0, 1, 5}, {0, 2, 5}, {1, 2, 4}, {1, 3, 3}, {2, 3, 7}, {2, 4, 7}, {4, 5, 4}, {5, 6, 9}, {2, 7, 8},
+        {4, 7, 5}, {7, 8, 3}, {8, 9, 4}, {9, 13, 3}, {6, 13, 12}, {3, 12, 14}, {3, 11, 13}, {3, 10, 16},
+        {10, 11, 5}, {11, 12, 9}, {11, 14, 4}, {12, 14, 5}, {10, 15, 4}, {10, 13, 7}, {9, 15, 8}, {13, 15, 7}
+    };
+    CSRGraph small{CSRGraph::fromEdges(16, edges, true/*undirected*/)};
+    LandmarkTable smallLandmarks{LandmarkTable::build(small.view(), 4)};
+
+    AStarSolver bidirectional{small.view(), smallLandmarks, 0, 15};
+    bidirectional.solveBidirectional();
+    std::cout << "bidirectional ALT: 0 -> 15 = " << bidirectional.getShortestPath() << ", path ";
+    for (int i : bidirectional.reconstructPath()) std::cout << i << " ";
+    std::cout << std::endl;
+
+    // grid-shaped road network with random travel times, the solver only sees the graph
+    const int side{300};
+    std::mt19937 rng{7};
+    CSRGraph graph{roadGrid(side, 20, 7)};
+    LandmarkTable landmarks{LandmarkTable::build(graph.view(), 16)};
+    std::vector<GridCoordinate> none(graph.size()); // all-zero coordinates: h = 0, plain Dijkstra
+
+    std::uniform_int_distribution<int> vertex(0, graph.size() - 1);
+    long long settled[3]{};
+    int mismatches{};
+    for (int i{}; i < 50; ++i) {
+        int s{vertex(rng)}, t{vertex(rng)};
+        AStarSolver dijkstra{graph.view(), none, s, t}, alt{graph.view(), landmarks, s, t};
+        std::cout.setstate(std::ios::failbit); // silence "Destination found"
+        dijkstra.solve();
+        alt.solve();
+        int unidirectional{alt.getShortestPath()};
+        settled[1] += alt.getSettledCount();
+        alt.solveBidirectional();
+        int bidirectional{alt.getShortestPath()};
+        alt.solveBidirectional(); // reuses the reverse graph and buffers of the first call
+        std::cout.clear();
+
+        settled[0] += dijkstra.getSettledCount();
+        settled[2] += alt.getSettledCount();
+        if (dijkstra.getShortestPath() != unidirectional || unidirectional != bidirectional || bidirectional != alt.getShortestPath()) ++mismatches;
+    }
+    std::cout << "road graph " << side << "x" << side << ", 16 landmarks, settled per query: Dijkstra " << settled[0] / 50
+              << ", ALT A* " << settled[1] / 50 << ", bidirectional ALT " << settled[2] / 50 << ", " << mismatches
+              << " mismatches\n";
+    return mismatches;
+}
+
 int main()
 {
+    int failures{};
     test1();
-}
\ No newline at end of file
+    testMappedGraphFile();
+    failures += testPriorityQueues();
+    testGridAStar();
+    failures += testGridAStarRandomMaps();
+    failures += testBidirectionalLandmarks();
+    return failures == 0 ? 0 : 1;
+}
@@ -1,5 +1,9 @@
 #include <vector>
 #include <iostream>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "Biconnectivity.h"
+#include "gtest/gtest.h"
 
 /*
  * Articulation Point Finder (Graph Algorithm)
@@ -11,70 +15,36 @@
  * Key Components:
  * - `ArticulationPointSolver` class: Implements Tarjan's Algorithm to identify articulation points.
  * - `solve()`: Entry function to find and return articulation points in the given graph.
- * - `dfs(int u)`: Recursive DFS function that computes discovery times and low-link values.
+ * - The DFS (discovery times and low-links on IterativeDFS, so deep graphs don't overflow the call stack)
+ *   is Biconnectivity's (Biconnectivity.h), which also yields the bridges and blocks in the same pass.
  *
- * The program includes three test cases (`test1`, `test2`, `test3`) that demonstrate the algorithm
- * on different graphs, outputting articulation points for each.
+ * The tests run the algorithm on different graphs, including a million-vertex path.
  */
 
 class ArticulationPointSolver
 {
 public:
-    ArticulationPointSolver(const std::vector<std::vector<int>>& adjList) : graph{ adjList }, n{ adjList.size() }
-    {
-        parent.resize(n, -1);
-        lowLink.resize(n);
-        times.resize(n, -1);
-    }
+    explicit ArticulationPointSolver(CSRGraphView adjList, BiconnectivityOptions options = {}) : graph{ adjList }, options{ options } { }
 
-    std::vector<int> solve()
-    {
-        for (int u{}; u < n; ++u) {
-            if (times[u] == -1) {
-                dfs(u);
-            }
-        }
+    ArticulationPointSolver(const std::vector<std::vector<int>>& adjList, BiconnectivityOptions options = {})
+        : storage{ CSRGraph::fromAdjacencyList(adjList) }, graph{ storage.view() }, options{ options } { }
 
-        return articulationPoints;
-    }
+    // graph may point into storage, so a copy would view the original's arrays
+    ArticulationPointSolver(const ArticulationPointSolver&) = delete;
+    ArticulationPointSolver& operator=(const ArticulationPointSolver&) = delete;
 
-    void dfs(int u)
+    std::vector<int> solve()
     {
-        times[u] = lowLink[u] = time++;
-        int childrenCount{};
-
-        for (int v : graph[u]) {
-            if (times[v] == -1) {
-                parent[v] = u;
-                ++childrenCount;
-
-                dfs(v);
-
-                lowLink[u] = std::min(lowLink[u], lowLink[v]);
-
-                // case 1: source is the dfs's root
-                if (parent[u] == -1 && childrenCount > 1) {
-                    articulationPoints.push_back(u);
-                } else if (parent[u] != -1 && lowLink[v] >= times[u]) { // case 2: no back edge from child to any ancestor
-                    articulationPoints.push_back(u);
-                }
-            } else if (v != parent[u]) {
-                lowLink[u] = std::min(lowLink[u], times[v]);
-            }
-        }
+        return Biconnectivity{graph, options}.getArticulationPoints();
     }
-    
+
 private:
-    std::vector<std::vector<int>> graph;
-    std::vector<int> articulationPoints;
-    std::vector<int> parent;
-    std::vector<int> lowLink;
-    std::vector<int> times;
-    int time{};
-    size_t n{};
+    CSRGraph storage; // only used when built from an adjacency list
+    CSRGraphView graph;
+    BiconnectivityOptions options;
 };
 
-void test1()
+TEST(ArticulationPointSolverTest, Test1)
 {
     std::vector<std::vector<int>> adjList {
         {1, 5}, 
@@ -86,17 +56,10 @@ void test1()
     };
 
     ArticulationPointSolver solver{adjList};
-    std::vector<int> points{solver.solve()};
-
-    if (points.empty()) {
-        std::cout << "There are no articulation points" << std::endl;
-    } else {
-        for (int point : points) std::cout << point << " ";
-        std::cout << std::endl;
-    }
+    EXPECT_EQ(solver.solve(), (std::vector<int>{1, 0}));
 }
 
-void test2()
+TEST(ArticulationPointSolverTest, Test2)
 {
     std::vector<std::vector<int>> adjList {
         {1, 3},
@@ -109,17 +72,10 @@ void test2()
     };
 
     ArticulationPointSolver solver{adjList};
-    std::vector<int> points{solver.solve()};
-    
-    if (points.empty()) {
-        std::cout << "There are no articulation points" << std::endl;
-    } else {
-        for (int point : points) std::cout << point << " ";
-        std::cout << std::endl;
-    }
+    EXPECT_EQ(solver.solve(), (std::vector<int>{5}));
 }
 
-void test3()
+TEST(ArticulationPointSolverTest, Test3)
 {
     std::vector<std::vector<int>> adjList {
         {1, 2},
@@ -130,22 +86,46 @@ void test3()
     };
 
     ArticulationPointSolver solver{adjList};
-    std::vector<int> points{solver.solve()};
-    
-    if (points.empty()) {
-        std::cout << "There are no articulation points" << std::endl;
-    } else {
-        for (int point : points) std::cout << point << " ";
-        std::cout << std::endl;
+    EXPECT_EQ(solver.solve(), (std::vector<int>{3, 2}));
+}
+
+TEST(ArticulationPointSolverTest, LongPathDoesNotOverflowTheStack)
+{
+    // every inner vertex of a path is an articulation point, closing it into a cycle leaves none
+    const int n{1'000'000};
+    std::vector<std::pair<int, int>> edges;
+    for (int u{}; u + 1 < n; ++u) edges.push_back({u, u + 1});
+
+    CSRGraph path{CSRGraph::fromEdges(n, edges, true/*undirected*/)};
+    std::vector<int> points{ArticulationPointSolver{path.view()}.solve()};
+    std::sort(points.begin(), points.end());
+
+    ASSERT_EQ(points.size(), static_cast<std::size_t>(n - 2));
+    EXPECT_EQ(points.front(), 1);
+    EXPECT_EQ(points.back(), n - 2);
+
+    edges.push_back({n - 1, 0});
+    CSRGraph cycle{CSRGraph::fromEdges(n, edges, true/*undirected*/)};
+    EXPECT_TRUE(ArticulationPointSolver{cycle.view()}.solve().empty());
+}
+
+TEST(ArticulationPointSolverTest, Multigraph)
+{
+    // 1 = 2 doubled keeps 1 a cut vertex (0 hangs on it) but 2 is one only because of 3; the loop at 0 changes nothing
+    CSRGraph graph{CSRGraph::fromEdges(4, {{0, 1}, {1, 2}, {1, 2}, {2, 3}, {0, 0}}, true/*undirected*/)};
+
+    for (bool parallel : {false, true}) {
+        std::vector<int> points{ArticulationPointSolver(graph.view(), {parallel, 2}).solve()};
+        std::sort(points.begin(), points.end());
+        EXPECT_EQ(points, (std::vector<int>{1, 2}));
     }
+
+    CSRGraph pair{CSRGraph::fromEdges(2, {{0, 1}, {0, 1}}, true/*undirected*/)};
+    EXPECT_TRUE(ArticulationPointSolver{pair.view()}.solve().empty());
 }
 
-int main()
+int main(int argc, char** argv)
 {
-    std::cout << "Test 1\n";
-    test1();
-    std::cout << "Test 2\n";
-    test2();
-    std::cout << "Test 3\n";
-    test3();
-}
\ No newline at end of file
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <span>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "IterativeDFS.h"
+#include "UndirectedEdges.h"
+#include "../Common/ConcurrentUnionFind.h"
+#include "../Common/Parallel.h"
+
+struct BiconnectivityOptions
+{
+    bool parallel{false}; // Tarjan–Vishkin over a BFS spanning forest instead of one DFS
+    unsigned threads{0};  // 0 means all hardware threads
+};
+
+/**
+ * @class Biconnectivity
+ *
+ * @brief Bridges, articulation points and the biconnected components (blocks) of an undirected multigraph,
+ *        all from one traversal.
+ *
+ * The graph is an undirected CSR view (every edge stored as two arcs, CSRGraph::fromEdges(..., true)). Edges
+ * are told apart by id (UndirectedEdges.h), not by their endpoints: the DFS only skips the arc that is the
+ * reverse of the one it entered a vertex by, so a parallel edge to the parent is a back edge, and a pair of
+ * parallel edges is a block, not a bridge. A self-loop is a block of its own and neither a bridge nor a reason
+ * for an articulation point.
+ *
+ * ## Sequential: one DFS (Hopcroft–Tarjan)
+ * On IterativeDFS, with discovery times and low-links. Tree and back arcs go on an edge stack; when a child v
+ * of u finishes with low[v] >= pre[u], the edges above the tree arc u -> v are the block of that arc, u is an
+ * articulation point (the root if it has two DFS children), and low[v] > pre[u] makes u - v a bridge.
+ *
+ * ## Parallel: Tarjan–Vishkin
+ * No DFS, every step is parallel over vertices, arcs or BFS levels:
+ *   1. a BFS forest from the smallest vertex of every connected component (ConcurrentUnionFind), one level
+ *      at a time; siblings are contiguous in the BFS order,
+ *   2. subtree sizes bottom-up and preorder numbers top-down by level, so subtree(v) is the interval
+ *      [pre(v), pre(v) + size(v)),
+ *   3. low(v) / high(v), the smallest / largest preorder number reached from subtree(v) by a non-tree edge,
+ *      bottom-up by level,
+ *   4. blocks as connected components of the tree edges (a tree edge is named by its child): a non-tree
+ *      edge joins the tree edges above its endpoints when neither endpoint is an ancestor of the other, and
+ *      the tree edges p(u) - u and u - w are joined when subtree(w) reaches outside subtree(u). A non-tree edge
+ *      belongs to the block of the tree edge above its later endpoint.
+ * A tree edge p(v) - v is a bridge when nothing leaves subtree(v), and a vertex is an articulation point
+ * when its edges are in more than one block.
+ *
+ * Both modes number the blocks by their smallest edge id, so the partition and the numbering are the same.
+ * The sequential mode lists bridges and articulation points in the order the DFS finds them, the parallel
+ * mode by increasing edge id / vertex. Bridges are given as the tree arc, from parent to child.
+ */
+class Biconnectivity
+{
+public:
+    explicit Biconnectivity(CSRGraphView undirectedGraph, BiconnectivityOptions options = {})
+        : graph{undirectedGraph}, n{undirectedGraph.size()}, m{undirectedGraph.numberOfEdges},
+          threadCount{options.threads == 0 ? defaultThreadCount() : options.threads},
+          mate{pairUndirectedArcs(undirectedGraph, threadCount)}, label(m, -1), cut(n, 0), treeArc(n, -1)
+    {
+        if (options.parallel) tarjanVishkin();
+        else hopcroftTarjan();
+        numberBlocks();
+    }
+
+    // tree arcs (parent -> child) of the bridges
+    const std::vector<int>& getBridges() const noexcept { return bridges; }
+    const std::vector<int>& getArticulationPoints() const noexcept { return articulationPoints; }
+
+    std::vector<std::pair<int, int>> bridgeEndpoints() const
+    {
+        std::vector<std::pair<int, int>> result;
+        result.reserve(bridges.size());
+        for (int e : bridges) result.push_back({graph.target(mate[e]), graph.target(e)});
+        return result;
+    }
+
+    bool isArticulationPoint(int v) const noexcept { return cut[v] != 0; }
+    bool isBridge(int arc) const noexcept
+    {
+        int e{edgeId(mate, arc)};
+        return graph.target(e) != graph.target(mate[e]) && blockSize(block[e]) == 1;
+    }
+
+    int blockCount() const noexcept { return static_cast<int>(blockOffsets.size()) - 1; }
+    int blockOf(int arc) const noexcept { return block[edgeId(mate, arc)]; }
+    int blockSize(int b) const noexcept { return blockOffsets[b + 1] - blockOffsets[b]; }
+
+    // edge ids (the smaller arc of each edge) of block b, increasing
+    std::span<const int> blockEdges(int b) const noexcept
+    {
+        return {blockList.data() + blockOffsets[b], blockList.data() + blockOffsets[b + 1]};
+    }
+
+    const std::vector<int>& mates() const noexcept { return mate; }
+
+private:
+    // ---------------- one DFS ----------------
+
+    struct Visitor : DFSVisitor
+    {
+        Biconnectivity& self;
+        std::vector<int>& pre;
+        std::vector<int>& low;
+        std::vector<int>& entry;
+        std::vector<int> stack{};
+        int time{};
+        int rootChildren{};
+        int blocks{};
+
+        void enter(int v, int e)
+        {
+            pre[v] = low[v] = time++;
+            entry[v] = e;
+            if (e == -1) rootChildren = 0;
+        }
+
+        bool edge(int u, int v, int e)
+        {
+            if (u == v) {
+                if (e < self.mate[e]) self.label[e] = blocks++;
+                return false;
+            }
+            if (entry[u] != -1 && self.mate[e] == entry[u]) return false; // the tree edge itself, not a parallel one
+
+            if (pre[v] == -1) {
+                stack.push_back(e);
+                return true;
+            }
+            if (pre[v] < pre[u]) { // back edge, its other arc is skipped from v
+                low[u] = std::min(low[u], pre[v]);
+                stack.push_back(e);
+            }
+            return false;
+        }
+
+        void retreat(int u, int v, int e)
+        {
+            low[u] = std::min(low[u], low[v]);
+            if (low[v] < pre[u]) return;
+
+            if (low[v] > pre[u]) self.bridges.push_back(e);
+
+            int popped{};
+            do {
+                popped = stack.back();
+                stack.pop_back();
+                self.label[edgeId(self.mate, popped)] = blocks;
+            } while (popped != e);
+            ++blocks;
+
+            bool root{entry[u] == -1};
+            if ((!root || ++rootChildren == 2) && !self.cut[u]) {
+                self.cut[u] = 1;
+                self.articulationPoints.push_back(u);
+            }
+        }
+    };
+
+    void hopcroftTarjan()
+    {
+        std::vector<int> pre(n, -1), low(n), entry(n, -1);
+        IterativeDFS dfs{graph};
+        Visitor visitor{{}, *this, pre, low, entry};
+
+        for (int u{}; u < n; ++u) {
+            if (pre[u] == -1) dfs.run(u, visitor);
+        }
+    }
+
+    // ---------------- Tarjan–Vishkin ----------------
+
+    void tarjanVishkin()
+    {
+        ThreadTeam team{threadCount}; // one per run: the BFS levels below are many short phases
+        // 1. BFS forest from the smallest vertex of every component
+        ConcurrentUnionFind components(n);
+        parallelForChunks(team, n, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (int u{static_cast<int>(begin)}; u < static_cast<int>(end); ++u) {
+                for (int v : graph.neighbors(u)) {
+                    if (v > u) components.unite(u, v);
+                }
+            }
+        }, minChunk);
+
+        std::vector<std::atomic<int>> parentArc(n);
+        std::vector<int> frontier;
+        for (int v{}; v < n; ++v) {
+            parentArc[v].store(-2, std::memory_order_relaxed); // unvisited
+            if (components.find(v) == v) {
+                parentArc[v].store(-1, std::memory_order_relaxed);
+                frontier.push_back(v);
+            }
+        }
+
+        std::vector<int> order;          // BFS order, level by level
+        std::vector<std::size_t> levels; // order[levels[d] .. levels[d + 1]) is level d
+        std::vector<int> childBegin(n, 0), childEnd(n, 0);
+        while (!frontier.empty()) {
+            levels.push_back(order.size());
+            order.insert(order.end(), frontier.begin(), frontier.end());
+            frontier = expand(team, frontier, [&](int u, std::vector<int>& next) {
+                for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e) {
+                    int v{graph.target(e)}, unvisited{-2};
+                    if (parentArc[v].compare_exchange_strong(unvisited, e, std::memory_order_relaxed)) next.push_back(v);
+                }
+            });
+
+            // the children of a vertex are contiguous in the next level
+            const std::size_t base{order.size()};
+            parallelFor(team, frontier.size(), [&](std::size_t i, unsigned) {
+                int p{graph.target(mate[parentArc[frontier[i]].load(std::memory_order_relaxed)])};
+                if (i == 0 || graph.target(mate[parentArc[frontier[i - 1]].load(std::memory_order_relaxed)]) != p) {
+                    childBegin[p] = static_cast<int>(base + i);
+                }
+                if (i + 1 == frontier.size() || graph.target(mate[parentArc[frontier[i + 1]].load(std::memory_order_relaxed)]) != p) {
+                    childEnd[p] = static_cast<int>(base + i + 1);
+                }
+            }, minChunk);
+        }
+        levels.push_back(order.size());
+        const int depth{static_cast<int>(levels.size()) - 1};
+
+        std::vector<int> parent(n, -1);
+        parallelFor(team, n, [&](std::size_t v, unsigned) {
+            int e{parentArc[v].load(std::memory_order_relaxed)};
+            treeArc[v] = e;
+            if (e >= 0) parent[v] = graph.target(mate[e]);
+        }, minChunk);
+
+        auto children = [&](int v) {
+            return std::span<const int>{order.data() + childBegin[v], order.data() + childEnd[v]};
+        };
+        auto byLevel = [&](int d, auto&& body) {
+            parallelFor(team, levels[d + 1] - levels[d], [&](std::size_t i, unsigned) { body(order[levels[d] + i]); }, minChunk);
+        };
+        auto isTree = [&](int v, int e) {
+            return treeArc[graph.target(e)] == e || (treeArc[v] >= 0 && mate[e] == treeArc[v]);
+        };
+
+        // 2. subtree sizes bottom-up, preorder numbers top-down
+        std::vector<int> size(n, 1), pre(n, 0);
+        for (int d{depth - 1}; d >= 0; --d) {
+            byLevel(d, [&](int v) {
+                for (int c : children(v)) size[v] += size[c];
+            });
+        }
+        const std::size_t rootCount{depth > 0 ? levels[1] : 0};
+        for (std::size_t i{}, next{}; i < rootCount; ++i) {
+            pre[order[i]] = static_cast<int>(next);
+            next += size[order[i]];
+        }
+        for (int d{}; d < depth; ++d) {
+            byLevel(d, [&](int v) {
+                int next{pre[v] + 1};
+                for (int c : children(v)) {
+                    pre[c] = next;
+                    next += size[c];
+                }
+            });
+        }
+        auto isAncestor = [&](int a, int v) { return pre[a] <= pre[v] && pre[v] < pre[a] + size[a]; };
+
+        // 3. low / high over the non-tree edges leaving each subtree
+        std::vector<int> low(n), high(n);
+        parallelFor(team, n, [&](std::size_t i, unsigned) {
+            int v{static_cast<int>(i)};
+            low[v] = high[v] = pre[v];
+            for (int e{graph.firstEdge(v)}; e < graph.lastEdge(v); ++e) {
+                int w{graph.target(e)};
+                if (w == v || isTree(v, e)) continue;
+                low[v] = std::min(low[v], pre[w]);
+                high[v] = std::max(high[v], pre[w]);
+            }
+        }, minChunk);
+        for (int d{depth - 1}; d >= 0; --d) {
+            byLevel(d, [&](int v) {
+                for (int c : children(v)) {
+                    low[v] = std::min(low[v], low[c]);
+                    high[v] = std::max(high[v], high[c]);
+                }
+            });
+        }
+
+        // 4. blocks: components of the tree edges, each named by its child vertex
+        ConcurrentUnionFind blocks(n);
+        parallelFor(team, n, [&](std::size_t i, unsigned) {
+            int v{static_cast<int>(i)};
+            for (int e{graph.firstEdge(v)}; e < graph.lastEdge(v); ++e) {
+                int w{graph.target(e)};
+                if (w == v) continue;
+                if (!isTree(v, e)) {
+                    if (v < w && !isAncestor(v, w) && !isAncestor(w, v)) blocks.unite(v, w);
+                } else if (parent[w] == v && parent[v] != -1) {
+                    if (low[w] < pre[v] || high[w] >= pre[v] + size[v]) blocks.unite(v, w);
+                }
+            }
+        }, minChunk);
+
+        std::vector<std::vector<int>> localBridges(threadCount);
+        parallelForChunks(team, n, [&](std::size_t begin, std::size_t end, unsigned t) {
+            for (int v{static_cast<int>(begin)}; v < static_cast<int>(end); ++v) {
+                if (parent[v] != -1 && low[v] >= pre[v] && high[v] < pre[v] + size[v]) localBridges[t].push_back(treeArc[v]);
+
+                for (int e{graph.firstEdge(v)}; e < graph.lastEdge(v); ++e) {
+                    int w{graph.target(e)};
+                    if (e != edgeId(mate, e)) continue;
+                    if (w == v) label[e] = n + e; // a self-loop alone
+                    else if (isTree(v, e)) label[e] = blocks.find(parent[w] == v ? w : v);
+                    else label[e] = blocks.find(pre[w] > pre[v] ? w : v);
+                }
+            }
+        }, minChunk);
+        for (auto& part : localBridges) bridges.insert(bridges.end(), part.begin(), part.end());
+        std::sort(bridges.begin(), bridges.end(), [this](int a, int b) { return edgeId(mate, a) < edgeId(mate, b); });
+
+        // articulation points: edges in more than one block (self-loops aside)
+        parallelFor(team, n, [&](std::size_t i, unsigned) {
+            int v{static_cast<int>(i)}, first{-1};
+            for (int e{graph.firstEdge(v)}; e < graph.lastEdge(v) && !cut[v]; ++e) {
+                if (graph.target(e) == v) continue;
+                int b{label[edgeId(mate, e)]};
+                if (first == -1) first = b;
+                else if (b != first) cut[v] = 1;
+            }
+        }, minChunk);
+        for (int v{}; v < n; ++v) {
+            if (cut[v]) articulationPoints.push_back(v);
+        }
+    }
+
+    // runs step(v, next) for every vertex of the frontier in parallel, returns the concatenated nexts
+    template <typename Step>
+    std::vector<int> expand(ThreadTeam& team, const std::vector<int>& frontier, Step step) const
+    {
+        std::vector<std::vector<int>> local(threadCount);
+        parallelForChunks(team, frontier.size(), [&](std::size_t begin, std::size_t end, unsigned t) {
+            for (std::size_t i{begin}; i < end; ++i) step(frontier[i], local[t]);
+        }, minChunk);
+
+        std::vector<int> next;
+        for (const auto& part : local) next.insert(next.end(), part.begin(), part.end());
+        return next;
+    }
+
+    // block ids by smallest edge id, and the block CSR
+    void numberBlocks()
+    {
+        std::vector<int> id(static_cast<std::size_t>(n) + m, -1);
+        block.assign(m, -1);
+        int count{};
+        for (int e{}; e < m; ++e) {
+            if (e != edgeId(mate, e)) continue;
+            int& b{id[label[e]]};
+            if (b == -1) b = count++;
+            block[e] = block[mate[e]] = b;
+        }
+
+        blockOffsets.assign(count + 1, 0);
+        for (int e{}; e < m; ++e) {
+            if (e == edgeId(mate, e)) ++blockOffsets[block[e] + 1];
+        }
+        for (int b{}; b < count; ++b) blockOffsets[b + 1] += blockOffsets[b];
+
+        blockList.resize(blockOffsets.back());
+        std::vector<int> cursor(blockOffsets.begin(), blockOffsets.end() - 1);
+        for (int e{}; e < m; ++e) {
+            if (e == edgeId(mate, e)) blockList[cursor[block[e]]++] = e;
+        }
+    }
+
+private:
+    static constexpr std::size_t minChunk{1024};
+
+    CSRGraphView graph;
+    int n{};
+    int m{};
+    unsigned threadCount{};
+    std::vector<int> mate;
+    std::vector<int> label;             // label[edge id], any id per block before numberBlocks
+    std::vector<std::uint8_t> cut;      // articulation point flags
+    std::vector<int> treeArc;           // parallel mode: treeArc[v] is the arc into v of the BFS forest
+
+    std::vector<int> bridges;
+    std::vector<int> articulationPoints;
+    std::vector<int> block;        // block[arc]
+    std::vector<int> blockOffsets; // block b: blockList[blockOffsets[b] .. blockOffsets[b + 1])
+    std::vector<int> blockList;
+};
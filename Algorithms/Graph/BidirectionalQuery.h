@@ -0,0 +1,210 @@
+#pragma once
+
+#include <span>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "Landmarks.h"
+#include "PriorityQueues.h"
+
+/**
+ * Heuristics for BidirectionalQuery. prepare(s, t) is called once per query, then
+ *   toTarget(v)   - lower bound on dist(v, t)
+ *   fromSource(v) - lower bound on dist(s, v)
+ * Both have to be consistent (feasible potentials), e.g. exact on an empty grid or landmark bounds.
+ */
+
+// plain bidirectional Dijkstra
+struct NoHeuristic
+{
+    void prepare(int, int) noexcept { }
+    int toTarget(int) const noexcept { return 0; }
+    int fromSource(int) const noexcept { return 0; }
+};
+
+// ALT: triangle-inequality bounds from a LandmarkTable, which has to outlive the heuristic
+class LandmarkHeuristic
+{
+public:
+    explicit LandmarkHeuristic(const LandmarkTable& landmarks) : table{&landmarks} { }
+
+    void prepare(int s, int t) noexcept
+    {
+        source = s;
+        target = t;
+    }
+
+    int toTarget(int v) const noexcept { return table->lowerBound(v, target); }
+    int fromSource(int v) const noexcept { return table->lowerBound(source, v); }
+
+private:
+    const LandmarkTable* table;
+    int source{};
+    int target{};
+};
+
+// two per-vertex arrays computed by the caller for the current (s, t), e.g. the coordinates of AStarSolver
+struct PrecomputedHeuristic
+{
+    std::span<const int> targetBound;
+    std::span<const int> sourceBound;
+
+    void prepare(int, int) noexcept { }
+    int toTarget(int v) const noexcept { return targetBound[v]; }
+    int fromSource(int v) const noexcept { return sourceBound[v]; }
+};
+
+/**
+ * @class BidirectionalQuery
+ *
+ * @brief Point-to-point shortest paths searched from both ends at once, optionally goal directed (bidirectional
+ *        A*, with ALT landmarks on arbitrary graphs).
+ *
+ * A forward search from s on the graph and a backward search from t on the reverse graph run alternately,
+ * always advancing the side with the smaller queue. Every edge that connects the two searched regions gives
+ * a candidate s-t path; mu is the best one so far. On a road network each side covers a ball of half the
+ * radius, which is a fraction of the area a unidirectional search settles; goal direction shrinks both balls
+ * further to the neighbourhood of the shortest path.
+ *
+ * Goal direction uses the average potential p(v) = (toTarget(v) - fromSource(v)) / 2 for the forward side
+ * and -p(v) for the backward side. With reduced costs w(u, v) - p(u) + p(v) both sides search the same
+ * reweighted graph, so the plain bidirectional stopping rule stays correct:
+ *     stop when topForward + topBackward >= mu   (both keys in reduced costs)
+ * To keep integers the keys are doubled, key(v) = 2 * dist(v) ± (toTarget(v) - fromSource(v)), so path
+ * lengths have to stay below INT_MAX / 4.
+ *
+ * Buffers are reused between queries with the epoch stamps of DijkstraQuery, a query costs time proportional
+ * to what it touches.
+ */
+template <typename Heuristic = NoHeuristic>
+class BidirectionalQuery
+{
+public:
+    static constexpr int inf{std::numeric_limits<int>::max()};
+
+    // builds the reverse graph itself
+    explicit BidirectionalQuery(CSRGraphView graph, Heuristic h = Heuristic{})
+        : reverseStorage{CSRGraph::reverse(graph)}, forward{graph}, backward{reverseStorage.view()}, heuristic{std::move(h)}
+    { }
+
+    // backward has to be the reverse of graph (the graph itself if it is undirected)
+    BidirectionalQuery(CSRGraphView graph, CSRGraphView reverse, Heuristic h = Heuristic{})
+        : forward{graph}, backward{reverse}, heuristic{std::move(h)}
+    { }
+
+    // distance from source to target, inf if unreachable
+    int run(int source, int target)
+    {
+        heuristic.prepare(source, target);
+        forward.start();
+        backward.start();
+        settled = 0;
+        best = inf;
+        meeting = source == target ? source : -1;
+        if (source == target) return best = 0;
+
+        forward.relax(source, 0, -1, key(source, 0, +1));
+        backward.relax(target, 0, -1, key(target, 0, -1));
+
+        while (!forward.queue.empty() && !backward.queue.empty()) {
+            long long topForward{forward.queue.minKey()}, topBackward{backward.queue.minKey()};
+            if (best != inf && topForward + topBackward >= 2LL * best) break;
+
+            if (forward.queue.size() <= backward.queue.size()) advance(forward, backward, +1);
+            else advance(backward, forward, -1);
+        }
+
+        return best;
+    }
+
+    // source -> ... -> target of the last query, empty if there is none
+    std::vector<int> path() const
+    {
+        std::vector<int> result;
+        if (meeting == -1) return result;
+
+        for (int v{meeting}; v != -1; v = forward.predecessor(v)) result.push_back(v);
+        std::reverse(result.begin(), result.end());
+        for (int v{backward.predecessor(meeting)}; v != -1; v = backward.predecessor(v)) result.push_back(v);
+        return result;
+    }
+
+    // vertices settled by both sides in the last query
+    int settledCount() const noexcept { return settled; }
+
+    const Heuristic& getHeuristic() const noexcept { return heuristic; }
+
+private:
+    struct Side
+    {
+        explicit Side(CSRGraphView g) : graph{g}, dist(g.size()), parent(g.size()), stamp(g.size(), 0)
+        {
+            queue.reset(g.size());
+        }
+
+        void start()
+        {
+            if (++epoch == 0) { // wrapped around: the stamps are ambiguous again
+                std::fill(stamp.begin(), stamp.end(), 0);
+                epoch = 1;
+            }
+            queue.clear();
+        }
+
+        bool reached(int v) const noexcept { return stamp[v] == epoch; }
+        int distance(int v) const noexcept { return reached(v) ? dist[v] : inf; }
+        int predecessor(int v) const noexcept { return reached(v) ? parent[v] : -1; }
+
+        void relax(int v, int d, int from, int k)
+        {
+            dist[v] = d;
+            parent[v] = from;
+            stamp[v] = epoch;
+            queue.push(v, k);
+        }
+
+        CSRGraphView graph;
+        std::vector<int> dist;
+        std::vector<int> parent;
+        std::vector<std::uint32_t> stamp;
+        std::uint32_t epoch{};
+        IndexedDaryHeap<4> queue;
+    };
+
+    // doubled reduced key, direction +1 forward, -1 backward
+    int key(int v, int d, int direction) const
+    {
+        return 2 * d + direction * (heuristic.toTarget(v) - heuristic.fromSource(v));
+    }
+
+    void advance(Side& side, const Side& other, int direction)
+    {
+        auto [k, u] = side.queue.pop();
+        ++settled;
+        const int du{side.dist[u]};
+
+        for (int e{side.graph.firstEdge(u)}; e < side.graph.lastEdge(u); ++e) {
+            int v{side.graph.target(e)};
+            int candidate{du + side.graph.weight(e)};
+            if (candidate < side.distance(v)) side.relax(v, candidate, u, key(v, candidate, direction));
+
+            // an edge between the two regions closes an s-t path
+            if (other.reached(v) && candidate + static_cast<long long>(other.dist[v]) < best) {
+                best = candidate + other.dist[v];
+                meeting = v;
+            }
+        }
+    }
+
+private:
+    CSRGraph reverseStorage; // only when the reverse graph is built here
+    Side forward;
+    Side backward;
+    Heuristic heuristic;
+
+    int best{inf};
+    int meeting{-1};
+    int settled{};
+};
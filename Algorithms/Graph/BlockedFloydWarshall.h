@@ -0,0 +1,205 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+#include "../Common/AlignedBuffer.h"
+#include "../Common/MinPlus.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @class BlockedFloydWarshallSolver
+ *
+ * @brief Cache-tiled, multithreaded Floyd–Warshall with the same interface and semantics as
+ *        FloydWarshallSolver (FloydWarshall.cpp): inf = no path, negInf = path through a negative cycle,
+ *        reconstructPath() through a 'next' matrix.
+ *
+ * Memory layout:
+ *   dp and next are single row-major, 64-byte aligned buffers of size N * N, where N is n rounded up to a
+ *   multiple of the block size (padding vertices are isolated). Row i of block (I, J) is contiguous.
+ *
+ * Tiling (Venkataraman et al.): the matrix is split into B x B blocks. For every diagonal block K:
+ *   1. the diagonal block (K, K) is updated with the plain algorithm, k running over its B vertices,
+ *   2. the blocks of row K and column K are updated from (K, K) - they are independent of each other,
+ *   3. every remaining block (I, J) is updated from (I, K) and (K, J) - all independent again.
+ * Phases 2 and 3 run in parallel. Each block update touches three B x B blocks, so with the default
+ * B = 64 (16 KB per block) the working set of the innermost loops stays in L1/L2.
+ *
+ * Inner loop: dp[i][j] = min(dp[i][j], dp[i][k] + dp[k][j]) over a contiguous row of the block, done by
+ * the SIMD min-plus kernel (MinPlus.h). Unreachable entries hold its finite sentinel (minPlusInfinity)
+ * instead of INT_MAX, so the kernel needs no branches and can't overflow; candidates are clamped from
+ * below, so negative cycles can't underflow either.
+ *
+ * Negative cycles: instead of repeating the O(n³) relaxation, vertices with dp[k][k] < 0 are collected
+ * and every pair (i, j) with i -> k -> j reachable for such a k is marked negInf, using reachability bitsets
+ * (O(n² * |K| / 64)).
+ */
+
+class BlockedFloydWarshallSolver
+{
+public:
+    static constexpr int inf{std::numeric_limits<int>::max()};
+    static constexpr int negInf{std::numeric_limits<int>::min()};
+
+    /**
+     * @param g adjacency matrix, inf for "no edge"
+     * @param threads number of worker threads, 0 means all hardware threads
+     * @param blockSize edge length of a tile
+     */
+    BlockedFloydWarshallSolver(int numberOfVertices, const std::vector<std::vector<int>>& g, unsigned threads = 0, int blockSize = 64)
+        : BlockedFloydWarshallSolver(numberOfVertices, threads, blockSize)
+    {
+        for (int i{}; i < n; ++i) {
+            for (int j{}; j < n; ++j) set(i, j, g[i][j]);
+        }
+    }
+
+    // row-major n * n input, inf for "no edge"
+    BlockedFloydWarshallSolver(int numberOfVertices, const int* matrix, unsigned threads = 0, int blockSize = 64)
+        : BlockedFloydWarshallSolver(numberOfVertices, threads, blockSize)
+    {
+        for (int i{}; i < n; ++i) {
+            for (int j{}; j < n; ++j) set(i, j, matrix[static_cast<std::size_t>(i) * n + j]);
+        }
+    }
+
+    void solve()
+    {
+        const int blocks{N / B};
+        for (int kb{}; kb < blocks; ++kb) {
+            // phase 1: the diagonal block depends only on itself
+            updateBlock(kb, kb, kb);
+
+            // phase 2: row kb and column kb, each block depends on itself and the diagonal block
+            parallelFor(2 * (blocks - 1), threadCount, [&](std::size_t t, unsigned) {
+                int other{static_cast<int>(t / 2)};
+                if (other >= kb) ++other;
+
+                if (t % 2 == 0) updateBlock(kb, other, kb);
+                else updateBlock(other, kb, kb);
+            });
+
+            // phase 3: everything else, each block depends on its row and column block of phase 2
+            std::size_t rest{static_cast<std::size_t>(blocks - 1)};
+            parallelFor(rest * rest, threadCount, [&](std::size_t t, unsigned) {
+                int ib{static_cast<int>(t / rest)}, jb{static_cast<int>(t % rest)};
+                if (ib >= kb) ++ib;
+                if (jb >= kb) ++jb;
+                updateBlock(ib, jb, kb);
+            });
+        }
+
+        markNegativeCycles();
+    }
+
+    int getShortestPath(int u, int v) const
+    {
+        int d{dp[index(u, v)]};
+        return d >= unreachable ? inf : d;
+    }
+
+    std::vector<int> reconstructPath(int u, int v) const
+    {
+        std::vector<int> path;
+        if (getShortestPath(u, v) == inf) {
+            return path; // no path can be found
+        }
+
+        for (int i{u}; i != v; i = next[index(i, v)]) {
+            if (dp[index(i, v)] == negInf) throw std::logic_error("Path contains negative cycle");
+            if (next[index(i, v)] == -1) return {}; // no valid path forward
+
+            path.push_back(i);
+        }
+
+        path.push_back(v);
+
+        return path;
+    }
+
+    int size() const noexcept { return n; }
+
+private:
+    BlockedFloydWarshallSolver(int numberOfVertices, unsigned threads, int blockSize)
+        : n{numberOfVertices}, B{blockSize}, threadCount{threads == 0 ? defaultThreadCount() : threads}
+    {
+        if (n <= 0) throw std::invalid_argument("Number of Vertices should be > 0");
+        if (B <= 0) throw std::invalid_argument("Block size should be > 0");
+
+        N = (n + B - 1) / B * B;
+        dp = AlignedBuffer<int>(static_cast<std::size_t>(N) * N, unreachable);
+        next = AlignedBuffer<int>(static_cast<std::size_t>(N) * N, -1); // -1 indicates invalid paths
+    }
+
+    std::size_t index(int i, int j) const noexcept { return static_cast<std::size_t>(i) * N + j; }
+
+    void set(int i, int j, int w)
+    {
+        if (w == inf) return;
+        if (w <= -unreachable || w >= unreachable) throw std::out_of_range("Edge weight is too large for the blocked solver");
+
+        dp[index(i, j)] = w;
+        next[index(i, j)] = j; // from i to j
+    }
+
+    /**
+     * dp[i][j] = min(dp[i][j], dp[i][k] + dp[k][j]) for i in block ib, j in block jb, k in block kb.
+     * k is the outer loop, so the update is also correct when (ib, jb) is the row/column/diagonal block of kb.
+     */
+    void updateBlock(int ib, int jb, int kb)
+    {
+        const int i0{ib * B}, j0{jb * B}, k0{kb * B};
+        for (int k{k0}; k < k0 + B; ++k) {
+            const int* rowK{&dp[index(k, j0)]};
+            for (int i{i0}; i < i0 + B; ++i) {
+                // a no-op when dp[i][k] is unreachable; rowK may be the same row as dp[i] (i == k), which
+                // is fine since element j only reads rowK[j] and writes dp[i][j]
+                minPlusRelaxRowWithNext(&dp[index(i, j0)], &next[index(i, j0)], rowK, dp[index(i, k)], next[index(i, k)], B);
+            }
+        }
+    }
+
+    void markNegativeCycles()
+    {
+        std::vector<int> onNegativeCycle;
+        for (int k{}; k < n; ++k) {
+            if (dp[index(k, k)] < 0) onNegativeCycle.push_back(k);
+        }
+        if (onNegativeCycle.empty()) return;
+
+        const std::size_t words{(static_cast<std::size_t>(n) + 63) / 64};
+        std::vector<std::uint64_t> reachableFrom(onNegativeCycle.size() * words);
+        for (std::size_t c{}; c < onNegativeCycle.size(); ++c) {
+            int k{onNegativeCycle[c]};
+            for (int j{}; j < n; ++j) {
+                if (dp[index(k, j)] < unreachable) reachableFrom[c * words + j / 64] |= std::uint64_t{1} << (j % 64);
+            }
+        }
+
+        parallelFor(n, threadCount, [&](std::size_t i, unsigned) {
+            std::vector<std::uint64_t> poisoned(words);
+            for (std::size_t c{}; c < onNegativeCycle.size(); ++c) {
+                if (dp[index(static_cast<int>(i), onNegativeCycle[c])] >= unreachable) continue;
+                for (std::size_t w{}; w < words; ++w) poisoned[w] |= reachableFrom[c * words + w];
+            }
+
+            for (int j{}; j < n; ++j) {
+                if (poisoned[j / 64] >> (j % 64) & 1) {
+                    dp[index(static_cast<int>(i), j)] = negInf; // no "shortest" path available
+                    next[index(static_cast<int>(i), j)] = -1;
+                }
+            }
+        });
+    }
+
+private:
+    static constexpr int unreachable{minPlusInfinity};
+
+    int n{};
+    int N{}; // n rounded up to a multiple of B
+    int B{};
+    unsigned threadCount{};
+    AlignedBuffer<int> dp;
+    AlignedBuffer<int> next; // for path recovery
+};
@@ -1,5 +1,12 @@
 #include <vector>
+#include <random>
+#include <chrono>
 #include <iostream>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "Biconnectivity.h"
+#include "DynamicBridges.h"
+#include "gtest/gtest.h"
 
 /*
  * BridgeSolver: A class for finding all bridges (critical edges) in an undirected graph.
@@ -15,61 +22,48 @@
  * 
  * Output:
  * - A list of bridges (pairs of nodes representing critical edges).
+ *
+ * The work is done by Biconnectivity (Biconnectivity.h), which finds bridges, articulation points and the
+ * biconnected components in one DFS on IterativeDFS, or with Tarjan–Vishkin in parallel. It tells edges apart
+ * by id, so one of two parallel edges is never a bridge.
+ *
+ * DynamicBridges (DynamicBridges.h) keeps the bridges up to date while links come and go, instead of
+ * solving from scratch after every change.
  */
 
 class BridgeSolver
 {
 public:
-    BridgeSolver(const std::vector<std::vector<int>>& adjList) : graph{ adjList }, n{ adjList.size() }
-    {
-        parent.resize(n, -1);
-        lowLink.resize(n);
-        times.resize(n, -1);
-    }
+    explicit BridgeSolver(CSRGraphView adjList, BiconnectivityOptions options = {}) : graph{ adjList }, options{ options } { }
 
-    std::vector<std::pair<int, int>> solve()
-    {
-        for (int u{}; u < n; ++u) {
-            if (times[u] == -1) {
-                dfs(u);
-            }
-        }
+    BridgeSolver(const std::vector<std::vector<int>>& adjList, BiconnectivityOptions options = {})
+        : storage{ CSRGraph::fromAdjacencyList(adjList) }, graph{ storage.view() }, options{ options } { }
 
-        return bridges;
-    }
+    // graph may point into storage, so a copy would view the original's arrays
+    BridgeSolver(const BridgeSolver&) = delete;
+    BridgeSolver& operator=(const BridgeSolver&) = delete;
 
-    void dfs(int u)
+    std::vector<std::pair<int, int>> solve()
     {
-        times[u] = lowLink[u] = time++;
-
-        for (int v : graph[u]) {
-            if (times[v] == -1) {
-                parent[v] = u;
-
-                dfs(v);
-
-                lowLink[u] = std::min(lowLink[u], lowLink[v]);
-                // if no back edge
-                if (lowLink[v] > times[u]) {
-                    bridges.push_back({u, v});
-                }
-            } else if (v != parent[u]) {
-                lowLink[u] = std::min(lowLink[u], times[v]);
-            }
-        }
+        return Biconnectivity{graph, options}.bridgeEndpoints();
     }
-    
+
 private:
-    std::vector<std::vector<int>> graph;
-    std::vector<std::pair<int, int>> bridges;
-    std::vector<int> parent;
-    std::vector<int> lowLink;
-    std::vector<int> times;
-    int time{};
-    size_t n{};
+    CSRGraph storage; // only used when built from an adjacency list
+    CSRGraphView graph;
+    BiconnectivityOptions options;
 };
 
-void test1()
+std::vector<std::pair<int, int>> sorted(std::vector<std::pair<int, int>> edges)
+{
+    for (auto& [u, v] : edges) {
+        if (u > v) std::swap(u, v);
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+TEST(BridgeSolverTest, Test1)
 {
     std::vector<std::vector<int>> adjList {
         {1, 5}, 
@@ -81,17 +75,10 @@ void test1()
     };
 
     BridgeSolver solver{adjList};
-    std::vector<std::pair<int, int>> bridges{solver.solve()};
-
-    if (bridges.empty()) {
-        std::cout << "There are no bridges" << std::endl;
-    } else {
-        for (auto [u, v] : bridges) std::cout << u << " - " << v << ", ";
-        std::cout << std::endl;
-    }
+    EXPECT_EQ(solver.solve(), (std::vector<std::pair<int, int>>{{0, 1}, {0, 5}}));
 }
 
-void test2()
+TEST(BridgeSolverTest, Test2)
 {
     std::vector<std::vector<int>> adjList {
         {1, 3},
@@ -104,17 +91,10 @@ void test2()
     };
 
     BridgeSolver solver{adjList};
-    std::vector<std::pair<int, int>> bridges{solver.solve()};
-
-    if (bridges.empty()) {
-        std::cout << "There are no bridges" << std::endl;
-    } else {
-        for (auto [u, v] : bridges) std::cout << u << " - " << v << ", ";
-        std::cout << std::endl;
-    }
+    EXPECT_EQ(solver.solve(), (std::vector<std::pair<int, int>>{{5, 6}}));
 }
 
-void test3()
+TEST(BridgeSolverTest, Test3)
 {
     std::vector<std::vector<int>> adjList {
         {1, 2},
@@ -125,22 +105,240 @@ void test3()
     };
 
     BridgeSolver solver{adjList};
-    std::vector<std::pair<int, int>> bridges{solver.solve()};
+    EXPECT_EQ(solver.solve(), (std::vector<std::pair<int, int>>{{3, 4}, {2, 3}}));
+}
+
+TEST(BridgeSolverTest, LongPathDoesNotOverflowTheStack)
+{
+    // every edge of a path is a bridge, closing it into a cycle leaves none
+    const int n{1'000'000};
+    std::vector<std::pair<int, int>> edges;
+    for (int u{}; u + 1 < n; ++u) edges.push_back({u, u + 1});
+
+    CSRGraph path{CSRGraph::fromEdges(n, edges, true/*undirected*/)};
+    EXPECT_EQ(sorted(BridgeSolver{path.view()}.solve()), edges);
+
+    edges.push_back({n - 1, 0});
+    CSRGraph cycle{CSRGraph::fromEdges(n, edges, true/*undirected*/)};
+    EXPECT_TRUE(BridgeSolver{cycle.view()}.solve().empty());
+}
+
+TEST(BridgeSolverTest, ParallelEdgesAreNotBridges)
+{
+    // 0 = 1 doubled, 1 - 2 single, 2 - 2 a loop: only 1 - 2 is a bridge
+    CSRGraph graph{CSRGraph::fromEdges(3, {{0, 1}, {0, 1}, {1, 2}, {2, 2}}, true/*undirected*/)};
+
+    for (bool parallel : {false, true}) {
+        EXPECT_EQ(BridgeSolver(graph.view(), {parallel, 2}).solve(), (std::vector<std::pair<int, int>>{{1, 2}}));
+    }
+}
 
-    if (bridges.empty()) {
-        std::cout << "There are no bridges" << std::endl;
-    } else {
-        for (auto [u, v] : bridges) std::cout << u << " - " << v << ", ";
-        std::cout << std::endl;
+TEST(BridgeSolverTest, BlocksPartitionTheEdges)
+{
+    // triangles 0 1 2 and 2 3 4 share vertex 2, then the bridge 4 - 5 and a loop at 5
+    std::vector<std::pair<int, int>> edges{{0, 1}, {1, 2}, {2, 0}, {2, 3}, {3, 4}, {4, 2}, {4, 5}, {5, 5}};
+    CSRGraph graph{CSRGraph::fromEdges(6, edges, true/*undirected*/)};
+
+    for (bool parallel : {false, true}) {
+        Biconnectivity bcc{graph.view(), {parallel, 2}};
+        ASSERT_EQ(bcc.blockCount(), 4);
+
+        std::vector<std::vector<std::pair<int, int>>> blocks(bcc.blockCount());
+        for (int b{}; b < bcc.blockCount(); ++b) {
+            for (int e : bcc.blockEdges(b)) blocks[b].push_back({graph.view().target(bcc.mates()[e]), graph.view().target(e)});
+            blocks[b] = sorted(blocks[b]);
+        }
+        EXPECT_EQ(blocks, (std::vector<std::vector<std::pair<int, int>>>{
+            {{0, 1}, {0, 2}, {1, 2}}, {{2, 3}, {2, 4}, {3, 4}}, {{4, 5}}, {{5, 5}}}));
+
+        std::vector<int> points{bcc.getArticulationPoints()};
+        std::sort(points.begin(), points.end());
+        EXPECT_EQ(points, (std::vector<int>{2, 4}));
+        EXPECT_EQ(bcc.bridgeEndpoints(), (std::vector<std::pair<int, int>>{{4, 5}}));
+        for (int e{}; e < graph.view().numberOfEdges; ++e) {
+            EXPECT_EQ(bcc.isBridge(e), bcc.blockOf(e) == 2);
+        }
     }
 }
 
-int main()
+// n vertices, m random edges (parallel edges and loops included), and a few pendant paths for bridges
+CSRGraph randomMultigraph(int n, int m, std::uint64_t seed)
 {
-    std::cout << "Test 1\n";
-    test1();
-    std::cout << "Test 2\n";
-    test2();
-    std::cout << "Test 3\n";
-    test3();
-}
\ No newline at end of file
+    std::mt19937_64 rng{seed};
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::vector<std::pair<int, int>> edges;
+    for (int i{}; i < m; ++i) edges.push_back({vertex(rng), vertex(rng)});
+    for (int i{}; i < n / 8; ++i) edges.push_back({vertex(rng), vertex(rng)});
+    std::shuffle(edges.begin(), edges.end(), rng);
+    return CSRGraph::fromEdges(n, edges, true/*undirected*/);
+}
+
+TEST(BridgeSolverTest, ParallelMatchesSequentialOnRandomGraphs)
+{
+    // small graphs for the corner cases, a few large ones so the passes split into threads
+    for (std::uint64_t seed{}; seed < 206; ++seed) {
+        const int n{seed < 200 ? 1 + static_cast<int>(seed % 40) : 20'000};
+        CSRGraph graph{randomMultigraph(n, static_cast<int>(seed % 3) * n / 2 + 1, seed)};
+
+        Biconnectivity sequential{graph.view()};
+        Biconnectivity parallel{graph.view(), {true, 3}};
+
+        ASSERT_EQ(parallel.blockCount(), sequential.blockCount()) << "seed " << seed;
+        for (int e{}; e < graph.view().numberOfEdges; ++e) {
+            ASSERT_EQ(parallel.blockOf(e), sequential.blockOf(e)) << "seed " << seed;
+            ASSERT_EQ(parallel.isBridge(e), sequential.isBridge(e)) << "seed " << seed;
+        }
+
+        std::vector<int> points{sequential.getArticulationPoints()};
+        std::sort(points.begin(), points.end());
+        EXPECT_EQ(parallel.getArticulationPoints(), points) << "seed " << seed;
+        EXPECT_EQ(sorted(parallel.bridgeEndpoints()), sorted(sequential.bridgeEndpoints())) << "seed " << seed;
+
+        // a bridge is exactly a block of one edge that is not a loop
+        int bridges{};
+        for (int b{}; b < sequential.blockCount(); ++b) {
+            int e{sequential.blockEdges(b)[0]};
+            bridges += sequential.blockSize(b) == 1 && graph.view().target(e) != graph.view().target(sequential.mates()[e]);
+        }
+        EXPECT_EQ(static_cast<int>(sequential.getBridges().size()), bridges) << "seed " << seed;
+    }
+}
+
+TEST(BridgeSolverTest, BenchmarkLargeGraph)
+{
+    const int n{1'000'000};
+    CSRGraph graph{randomMultigraph(n, n, 7)};
+
+    std::size_t expected{};
+    for (BiconnectivityOptions options : {BiconnectivityOptions{false, 1}, BiconnectivityOptions{true, 1}, BiconnectivityOptions{true, 4}}) {
+        auto start = std::chrono::high_resolution_clock::now();
+        Biconnectivity bcc{graph.view(), options};
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (!options.parallel) expected = bcc.getBridges().size();
+        EXPECT_EQ(bcc.getBridges().size(), expected);
+
+        std::cout << (options.parallel ? "Tarjan-Vishkin, " + std::to_string(options.threads) + " threads" : std::string{"DFS"})
+                  << ": " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms, "
+                  << bcc.getBridges().size() << " bridges, " << bcc.getArticulationPoints().size() << " articulation points, "
+                  << bcc.blockCount() << " blocks\n";
+    }
+}
+
+TEST(DynamicBridgesTest, InsertionsAndDeletions)
+{
+    // the path 0 - 1 - 2 - 3 - 4
+    CSRGraph path{CSRGraph::fromEdges(5, {{0, 1}, {1, 2}, {2, 3}, {3, 4}}, true/*undirected*/)};
+    DynamicBridges bridges{path.view()};
+    EXPECT_EQ(bridges.bridgeCount(), 4);
+    EXPECT_TRUE(bridges.isBridge(2, 1));
+    EXPECT_FALSE(bridges.isBridge(0, 2)); // not an edge
+
+    bridges.addEdge(1, 3); // cycle 1 2 3
+    EXPECT_EQ(bridges.bridgeCount(), 2);
+    EXPECT_FALSE(bridges.isBridge(1, 2));
+    EXPECT_TRUE(bridges.isBridge(3, 4));
+    EXPECT_TRUE(bridges.twoEdgeConnected(1, 3));
+    EXPECT_FALSE(bridges.twoEdgeConnected(0, 1));
+
+    bridges.addEdge(3, 4); // a parallel edge is no bridge
+    EXPECT_FALSE(bridges.isBridge(3, 4));
+    EXPECT_EQ(bridges.bridgeCount(), 1);
+    EXPECT_FALSE(bridges.isStale());
+
+    EXPECT_TRUE(bridges.removeEdge(4, 3));
+    EXPECT_FALSE(bridges.removeEdge(0, 4));
+    EXPECT_TRUE(bridges.removeEdge(2, 3));
+    EXPECT_TRUE(bridges.isStale());
+    EXPECT_EQ(bridges.bridgeCount(), 4); // 1 - 3 - 2 is a path again, 3 - 4 single again
+    EXPECT_FALSE(bridges.isStale());
+    EXPECT_TRUE(bridges.isBridge(1, 3));
+    EXPECT_EQ(sorted(bridges.getBridges()), (std::vector<std::pair<int, int>>{{0, 1}, {1, 2}, {1, 3}, {3, 4}}));
+
+    EXPECT_TRUE(bridges.removeEdge(1, 3));
+    EXPECT_FALSE(bridges.connected(0, 4));
+    EXPECT_THROW(bridges.addEdge(0, 5), std::out_of_range);
+}
+
+TEST(DynamicBridgesTest, MatchesRecomputationOnRandomUpdates)
+{
+    std::mt19937_64 rng{42};
+    for (int round{}; round < 40; ++round) {
+        const int n{2 + round % 20};
+        std::uniform_int_distribution<int> vertex(0, n - 1);
+        std::vector<std::pair<int, int>> edges;
+        DynamicBridges dynamic{n};
+
+        for (int step{}; step < 120; ++step) {
+            if (!edges.empty() && rng() % 3 == 0) {
+                std::size_t i{rng() % edges.size()};
+                ASSERT_TRUE(dynamic.removeEdge(edges[i].first, edges[i].second));
+                edges.erase(edges.begin() + i);
+            } else {
+                edges.push_back({vertex(rng), vertex(rng)});
+                dynamic.addEdge(edges.back().first, edges.back().second);
+            }
+            if (rng() % 2 == 0) continue; // let some updates pile up
+
+            CSRGraph graph{CSRGraph::fromEdges(n, edges, true/*undirected*/)};
+            std::vector<std::pair<int, int>> expected{sorted(BridgeSolver{graph.view()}.solve())};
+            ASSERT_EQ(dynamic.bridgeCount(), static_cast<int>(expected.size())) << "round " << round << ", step " << step;
+            EXPECT_EQ(sorted(dynamic.getBridges()), expected);
+            for (auto [u, v] : edges) {
+                EXPECT_EQ(dynamic.isBridge(u, v), std::binary_search(expected.begin(), expected.end(), std::pair<int, int>{std::minmax(u, v)}));
+            }
+        }
+    }
+}
+
+TEST(DynamicBridgesTest, BenchmarkQueriesAndUpdates)
+{
+    // a 2M-vertex topology: a random tree (every vertex hangs on an earlier one) plus n / 8 random links
+    const int n{2'000'000};
+    std::mt19937_64 rng{3};
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::vector<std::pair<int, int>> edges;
+    for (int u{1}; u < n; ++u) edges.push_back({static_cast<int>(rng() % u), u});
+    for (int i{}; i < n / 8; ++i) edges.push_back({vertex(rng), vertex(rng)});
+    CSRGraph graph{CSRGraph::fromEdges(n, edges, true/*undirected*/)};
+
+    using clock = std::chrono::high_resolution_clock;
+    auto ns = [](auto d) { return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(); };
+
+    auto start = clock::now();
+    DynamicBridges bridges{graph.view()};
+    auto built = clock::now();
+    const int initial{bridges.bridgeCount()};
+
+    const int queries{1'000'000};
+    int found{};
+    for (int i{}; i < queries; ++i) {
+        auto [u, v] = edges[rng() % (n - 1)];
+        found += bridges.isBridge(u, v);
+    }
+    auto queried = clock::now();
+
+    const int insertions{100'000};
+    for (int i{}; i < insertions; ++i) bridges.addEdge(vertex(rng), vertex(rng));
+    const int afterInsertions{bridges.bridgeCount()};
+    auto inserted = clock::now();
+
+    for (int i{}; i < 1000; ++i) bridges.removeEdge(edges[i * 1000].first, edges[i * 1000].second);
+    const int afterDeletions{bridges.bridgeCount()};
+    auto rebuilt = clock::now();
+
+    EXPECT_GT(found, 0);
+    EXPECT_LT(afterInsertions, initial);
+    EXPECT_GE(afterDeletions, afterInsertions);
+
+    std::cout << "build " << ns(built - start) / 1'000'000 << " ms (" << initial << " bridges), "
+              << ns(queried - built) / queries << " ns per query, "
+              << ns(inserted - queried) / insertions << " ns per insertion (" << afterInsertions << " bridges), "
+              << "1000 deletions + rebuild " << ns(rebuilt - inserted) / 1'000'000 << " ms (" << afterDeletions << " bridges)\n";
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
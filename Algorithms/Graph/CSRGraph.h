@@ -0,0 +1,214 @@
+#pragma once
+
+#include <vector>
+#include <tuple>
+#include <span>
+#include <stdexcept>
+
+/**
+ * @brief Compressed Sparse Row (CSR) graph shared by the solvers in Algorithms/Graph.
+ *
+ * A CSR graph stores all adjacency lists back to back in three contiguous arrays:
+ *   - offsets[u] .. offsets[u + 1] is the range of edge indices leaving vertex u (size n + 1)
+ *   - targets[e] is the head of edge e (size m)
+ *   - weights[e] is the weight of edge e (size m, absent for unweighted graphs)
+ *
+ * Compared to std::vector<std::vector<std::pair<int, int>>> this means one allocation per array
+ * instead of one per vertex, and a scan over the neighbors of u is a linear walk over memory.
+ *
+ * Ownership is split in two types:
+ *   - CSRGraph owns the arrays and is immutable once built.
+ *   - CSRGraphView is a trivially copyable, non-owning view over the arrays. The solvers keep only
+ *     a view, so any number of them can share a single graph (or a memory-mapped file) without copying.
+ *     The owner must outlive every view created from it.
+ *
+ * Edge indices are stable: edge e of the view keeps its index in every solver, which lets algorithms
+ * keep per-edge state (used flags, edge ids, ...) in flat arrays.
+ *
+ * Building from an edge list is O(n + m): one counting pass for the degrees, a prefix sum
+ * and one scatter pass. The relative order of the edges of each vertex is preserved.
+ */
+
+// optional per-vertex position, e.g. the grid cell of a vertex used by the A* heuristic
+struct GridCoordinate
+{
+    int row{};
+    int col{};
+};
+
+struct CSRGraphView
+{
+    int numberOfVertices{};
+    int numberOfEdges{};            // stored arcs, an undirected edge is stored twice
+    const int* offsets{nullptr};    // n + 1 entries
+    const int* targets{nullptr};    // m entries
+    const int* weights{nullptr};    // m entries, nullptr if the graph is unweighted
+
+    int size() const noexcept { return numberOfVertices; }
+    bool isWeighted() const noexcept { return weights != nullptr; }
+
+    int degree(int u) const noexcept { return offsets[u + 1] - offsets[u]; }
+
+    // edge index range of u: [firstEdge(u), lastEdge(u))
+    int firstEdge(int u) const noexcept { return offsets[u]; }
+    int lastEdge(int u) const noexcept { return offsets[u + 1]; }
+
+    int target(int e) const noexcept { return targets[e]; }
+    int weight(int e) const noexcept { return weights ? weights[e] : 1; }
+
+    std::span<const int> neighbors(int u) const noexcept
+    {
+        return {targets + offsets[u], targets + offsets[u + 1]};
+    }
+};
+
+class CSRGraph
+{
+public:
+    CSRGraph() = default;
+
+    /**
+     * @brief Builds a weighted graph from (u, v, w) triples.
+     * @param undirected if true every edge is stored in both directions
+     */
+    static CSRGraph fromEdges(int numberOfVertices, const std::vector<std::tuple<int, int, int>>& edges, bool undirected = false)
+    {
+        CSRGraph g{numberOfVertices, true};
+        g.countDegrees(edges, undirected, [](const auto& e) { return std::make_pair(std::get<0>(e), std::get<1>(e)); });
+
+        std::vector<int> cursor(g.offsets.begin(), g.offsets.end() - 1);
+        for (auto [u, v, w] : edges) {
+            g.targets[cursor[u]] = v;
+            g.weights[cursor[u]++] = w;
+            if (undirected) {
+                g.targets[cursor[v]] = u;
+                g.weights[cursor[v]++] = w;
+            }
+        }
+
+        return g;
+    }
+
+    /**
+     * @brief Builds an unweighted graph from (u, v) pairs.
+     * @param undirected if true every edge is stored in both directions
+     */
+    static CSRGraph fromEdges(int numberOfVertices, const std::vector<std::pair<int, int>>& edges, bool undirected = false)
+    {
+        CSRGraph g{numberOfVertices, false};
+        g.countDegrees(edges, undirected, [](const auto& e) { return e; });
+
+        std::vector<int> cursor(g.offsets.begin(), g.offsets.end() - 1);
+        for (auto [u, v] : edges) {
+            g.targets[cursor[u]++] = v;
+            if (undirected) g.targets[cursor[v]++] = u;
+        }
+
+        return g;
+    }
+
+    // adapters for the adjacency list inputs the solvers used to take
+    static CSRGraph fromAdjacencyList(const std::vector<std::vector<int>>& adjList)
+    {
+        CSRGraph g{static_cast<int>(adjList.size()), false};
+        for (std::size_t u{}; u < adjList.size(); ++u) {
+            g.offsets[u + 1] = g.offsets[u] + static_cast<int>(adjList[u].size());
+        }
+
+        g.targets.reserve(g.offsets.back());
+        for (const auto& list : adjList) {
+            for (int v : list) g.targets.push_back(g.checkVertex(v));
+        }
+
+        return g;
+    }
+
+    static CSRGraph fromAdjacencyList(const std::vector<std::vector<std::pair<int, int>>>& adjList)
+    {
+        CSRGraph g{static_cast<int>(adjList.size()), true};
+        for (std::size_t u{}; u < adjList.size(); ++u) {
+            g.offsets[u + 1] = g.offsets[u] + static_cast<int>(adjList[u].size());
+        }
+
+        g.targets.reserve(g.offsets.back());
+        g.weights.reserve(g.offsets.back());
+        for (const auto& list : adjList) {
+            for (auto [v, w] : list) {
+                g.targets.push_back(g.checkVertex(v));
+                g.weights.push_back(w);
+            }
+        }
+
+        return g;
+    }
+
+    /**
+     * @brief The transpose of g: every arc u -> v becomes v -> u, with its weight.
+     * The in-arcs of every vertex keep the order of their tails.
+     */
+    static CSRGraph reverse(CSRGraphView g)
+    {
+        CSRGraph r{g.size(), g.isWeighted()};
+        for (int e{}; e < g.numberOfEdges; ++e) ++r.offsets[g.target(e) + 1];
+        for (int u{}; u < r.n; ++u) r.offsets[u + 1] += r.offsets[u];
+
+        r.targets.resize(g.numberOfEdges);
+        if (r.weighted) r.weights.resize(g.numberOfEdges);
+
+        std::vector<int> cursor(r.offsets.begin(), r.offsets.end() - 1);
+        for (int u{}; u < g.size(); ++u) {
+            for (int e{g.firstEdge(u)}; e < g.lastEdge(u); ++e) {
+                int slot{cursor[g.target(e)]++};
+                r.targets[slot] = u;
+                if (r.weighted) r.weights[slot] = g.weight(e);
+            }
+        }
+
+        return r;
+    }
+
+    CSRGraphView view() const noexcept
+    {
+        return CSRGraphView{n, static_cast<int>(targets.size()), offsets.data(), targets.data(),
+                            weighted ? weights.data() : nullptr};
+    }
+
+    int size() const noexcept { return n; }
+
+private:
+    CSRGraph(int numberOfVertices, bool isWeighted) : n{numberOfVertices}, weighted{isWeighted}
+    {
+        if (n < 0) throw std::invalid_argument("Number of vertices should be >= 0");
+        offsets.assign(n + 1, 0);
+    }
+
+    int checkVertex(int u) const
+    {
+        if (u < 0 || u >= n) throw std::out_of_range("Edge contains node outside [0,V)");
+        return u;
+    }
+
+    // first pass: out-degree histogram turned into offsets by a prefix sum
+    template <typename Edges, typename Endpoints>
+    void countDegrees(const Edges& edges, bool undirected, Endpoints endpoints)
+    {
+        for (const auto& e : edges) {
+            auto [u, v] = endpoints(e);
+            ++offsets[checkVertex(u) + 1];
+            checkVertex(v);
+            if (undirected) ++offsets[v + 1];
+        }
+
+        for (int u{}; u < n; ++u) offsets[u + 1] += offsets[u];
+
+        targets.resize(offsets.back());
+        if (weighted) weights.resize(offsets.back());
+    }
+
+private:
+    int n{};
+    bool weighted{};
+    std::vector<int> offsets{0};
+    std::vector<int> targets;
+    std::vector<int> weights;
+};
@@ -0,0 +1,178 @@
+#include <vector>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include "CSRGraph.h"
+#include "Landmarks.h"
+#include "ShortestPathQuery.h"
+#include "BidirectionalQuery.h"
+#include "ContractionHierarchy.h"
+#include "TestGraphs.h"
+#include "gtest/gtest.h"
+
+/*
+* Contraction Hierarchies answer point-to-point shortest path queries on a static graph after a one-time
+* preprocessing step (ContractionHierarchy.h).
+*
+* Preprocessing
+* Order the vertices by importance and contract them one by one. Contracting v removes it from the graph
+* and adds a shortcut a -> b for every pair of neighbours whose only shortest path goes through v, so all
+* distances between the remaining vertices stay the same. The contraction order is the rank.
+*
+* Query
+* Every shortest path now has a shortcut-equivalent that first only goes up in rank and then only down.
+* A bidirectional Dijkstra that only relaxes arcs to higher ranked vertices (forward from s, backward from
+* t) finds it; the shortcuts on it are unpacked recursively into original edges for the full path.
+*
+* The hierarchy is built in parallel, saved to a binary file and loaded again by the query processes. The
+* benchmark at the end compares query latency with the engines behind Dijkstra (DijkstraQuery) and the
+* bidirectional / ALT searches of Dijkstra and AStarSolver on the same road-like graph and queries.
+*/
+
+TEST(ContractionHierarchyTest, SmallExample)
+{
+    // Cormen's example, chapter 24
+    CSRGraph graph{CSRGraph::fromEdges(5, std::vector<std::tuple<int, int, int>>{
+        {0, 1, 3}, {0, 2, 5}, {1, 3, 6}, {1, 2, 2}, {2, 1, 1}, {2, 4, 6}, {2, 3, 4}, {3, 4, 2}, {4, 3, 7}, {4, 0, 3}})};
+    ContractionHierarchy ch{ContractionHierarchy::build(graph.view())};
+    ContractionHierarchyQuery query{ch};
+
+    EXPECT_EQ(query.run(0, 3), 9);
+    EXPECT_EQ(query.run(3, 1), 8);
+    EXPECT_EQ(query.path(), (std::vector<int>{3, 4, 0, 1}));
+    EXPECT_EQ(query.run(2, 2), 0);
+    EXPECT_EQ(query.path(), (std::vector<int>{2}));
+}
+
+TEST(ContractionHierarchyTest, MatchesDijkstraOnRandomGraphs)
+{
+    for (unsigned seed{1}; seed <= 5; ++seed) {
+        // directed, zero weights, parallel edges, self-loops and unreachable pairs
+        CSRGraph graph{randomGraph(400, 1400, 40, seed)};
+        ContractionHierarchy ch{ContractionHierarchy::build(graph.view())};
+        ContractionHierarchyQuery query{ch};
+        DijkstraQuery reference{graph.view()};
+
+        std::mt19937 rng{seed};
+        std::uniform_int_distribution<int> vertex(0, graph.size() - 1);
+        for (int i{}; i < 300; ++i) {
+            int s{vertex(rng)}, t{vertex(rng)};
+            int expected{reference.run(s, t)};
+            ASSERT_EQ(query.run(s, t), expected) << s << " -> " << t;
+            if (expected != DijkstraQuery::inf) {
+                EXPECT_TRUE(isPath(graph.view(), query.path(), s, t, expected)) << s << " -> " << t;
+            } else {
+                EXPECT_TRUE(query.path().empty());
+            }
+        }
+    }
+}
+
+TEST(ContractionHierarchyTest, IndependentOfThreadCount)
+{
+    CSRGraph graph{roadGrid(60, 20, 9)};
+    ContractionHierarchy single{ContractionHierarchy::build(graph.view(), 1)};
+    ContractionHierarchy parallel{ContractionHierarchy::build(graph.view(), 4)};
+
+    ASSERT_EQ(single.arcCount(), parallel.arcCount());
+    for (int v{}; v < graph.size(); ++v) ASSERT_EQ(single.rank(v), parallel.rank(v));
+}
+
+TEST(ContractionHierarchyTest, SaveAndLoad)
+{
+    CSRGraph graph{roadGrid(50, 20, 4)};
+    ContractionHierarchy built{ContractionHierarchy::build(graph.view())};
+    built.save("contraction_hierarchy.bin");
+    ContractionHierarchy loaded{ContractionHierarchy::load("contraction_hierarchy.bin")};
+    std::remove("contraction_hierarchy.bin");
+
+    ASSERT_EQ(loaded.size(), built.size());
+    EXPECT_EQ(loaded.arcCount(), built.arcCount());
+    EXPECT_EQ(loaded.shortcutCount(), built.shortcutCount());
+
+    ContractionHierarchyQuery fromFile{loaded};
+    DijkstraQuery reference{graph.view()};
+    std::mt19937 rng{4};
+    std::uniform_int_distribution<int> vertex(0, graph.size() - 1);
+    for (int i{}; i < 100; ++i) {
+        int s{vertex(rng)}, t{vertex(rng)};
+        ASSERT_EQ(fromFile.run(s, t), reference.run(s, t));
+        EXPECT_TRUE(isPath(graph.view(), fromFile.path(), s, t, reference.run(s, t)));
+    }
+
+    EXPECT_THROW(ContractionHierarchy::load("missing_hierarchy.bin"), std::runtime_error);
+}
+
+TEST(ContractionHierarchyTest, BenchmarkQueryLatency)
+{
+    const int side{300};
+    CSRGraph graph{roadGrid(side, 20, 3)};
+    CSRGraphView g{graph.view()};
+
+    auto elapsed = [](auto start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    auto start{std::chrono::high_resolution_clock::now()};
+    ContractionHierarchy ch{ContractionHierarchy::build(g)};
+    std::cout << "contraction: " << elapsed(start) << " ms, " << ch.shortcutCount() << " shortcuts for "
+              << g.numberOfEdges << " edges\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    LandmarkTable landmarks{LandmarkTable::build(g, 16)};
+    std::cout << "16 landmarks: " << elapsed(start) << " ms\n";
+
+    std::mt19937 rng{5};
+    std::uniform_int_distribution<int> vertex(0, g.size() - 1);
+    std::vector<std::pair<int, int>> queries;
+    for (int i{}; i < 200; ++i) queries.push_back({vertex(rng), vertex(rng)});
+
+    auto time = [&queries](const char* name, auto&& query) {
+        long long checksum{}, settled{};
+        auto start{std::chrono::high_resolution_clock::now()};
+        for (auto [s, t] : queries) checksum += query(s, t, settled);
+        auto end{std::chrono::high_resolution_clock::now()};
+
+        auto micros{std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()};
+        std::cout << name << ": " << micros / static_cast<long long>(queries.size()) << " us/query, "
+                  << settled / static_cast<long long>(queries.size()) << " settled per query\n";
+        return std::pair{checksum, settled};
+    };
+
+    DijkstraQuery dijkstra{g};
+    BidirectionalQuery<LandmarkHeuristic> alt{g, g, LandmarkHeuristic{landmarks}};
+    ContractionHierarchyQuery hierarchy{ch};
+
+    auto [expected, dijkstraSettled] = time("Dijkstra", [&](int s, int t, long long& settled) {
+        int d{dijkstra.run(s, t)};
+        settled += dijkstra.settledCount();
+        return d;
+    });
+    auto [altSum, altSettled] = time("bidirectional ALT", [&](int s, int t, long long& settled) {
+        int d{alt.run(s, t)};
+        settled += alt.settledCount();
+        return d;
+    });
+    auto [chSum, chSettled] = time("contraction hierarchy", [&](int s, int t, long long& settled) {
+        int d{hierarchy.run(s, t)};
+        settled += hierarchy.settledCount();
+        return d;
+    });
+    auto [pathSum, pathSettled] = time("contraction hierarchy with path", [&](int s, int t, long long& settled) {
+        int d{hierarchy.run(s, t)};
+        settled += hierarchy.settledCount();
+        return hierarchy.path().empty() ? DijkstraQuery::inf : d;
+    });
+
+    EXPECT_EQ(altSum, expected);
+    EXPECT_EQ(chSum, expected);
+    EXPECT_EQ(pathSum, expected);
+    EXPECT_LT(chSettled, altSettled);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,647 @@
+#pragma once
+
+#include <span>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "PriorityQueues.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @brief On-disk layout of a ContractionHierarchy, in the style of GraphFileHeader (every section on a
+ *        64-byte boundary, little-endian):
+ *
+ *   header (128 bytes) | int32 rank[n] | int32 upwardOffsets[n + 1] | Arc upwardArcs[]
+ *                      | int32 downwardOffsets[n + 1] | Arc downwardArcs[]
+ *
+ * An Arc is three int32: target, weight, middle.
+ */
+struct ContractionHierarchyFileHeader
+{
+    static constexpr char expectedMagic[8]{'C', 'O', 'N', 'T', 'R', 'A', 'C', 'T'};
+    static constexpr std::uint32_t currentVersion{1};
+    static constexpr std::uint64_t alignment{64};
+
+    char magic[8]{};
+    std::uint32_t version{};
+    std::uint32_t reserved{};
+    std::uint64_t numberOfVertices{};
+    std::uint64_t numberOfUpwardArcs{};
+    std::uint64_t numberOfDownwardArcs{};
+    std::uint64_t rankPosition{};
+    std::uint64_t upwardOffsetsPosition{};
+    std::uint64_t upwardArcsPosition{};
+    std::uint64_t downwardOffsetsPosition{};
+    std::uint64_t downwardArcsPosition{};
+    std::uint64_t padding[6]{};
+};
+
+static_assert(sizeof(ContractionHierarchyFileHeader) == 2 * ContractionHierarchyFileHeader::alignment,
+              "header must fill exactly two aligned blocks");
+
+/**
+ * @class ContractionHierarchy
+ *
+ * @brief Preprocessed static graph for point-to-point shortest paths in microseconds (Geisberger et al.).
+ *
+ * Preprocessing contracts the vertices one after another in order of "importance": removing v, every
+ * path a -> v -> b that is the only shortest a-b path is replaced by a shortcut a -> b. Whether it is the
+ * only one is decided by a witness search, a Dijkstra from a that avoids v and gives up after a few
+ * hundred settled vertices (a shortcut too many is harmless). The contraction order is the rank.
+ *
+ * Afterwards every shortest path has an up-down shape in rank, so a query is a bidirectional Dijkstra
+ * that only goes upward on both sides (ContractionHierarchyQuery). On road networks each side settles a
+ * few hundred vertices instead of a large part of the graph.
+ *
+ * Ordering: the priority of a vertex is twice its edge difference (shortcuts added minus arcs removed)
+ * plus the number of already contracted neighbours, which spreads the contraction evenly over the graph. Every
+ * round contracts the independent set of vertices whose priority is smaller than that of all their
+ * neighbours, in parallel, against the graph as it was at the start of the round. A witness may pass
+ * through other vertices of the round only if it is strictly shorter: then a shortest path with the
+ * fewest round vertices can always be rerouted around each of them, by a shortcut or by a witness that
+ * avoids the round. Shortcuts are applied and priorities updated between rounds. The result does not
+ * depend on the number of threads.
+ *
+ * Stored arcs always point to the higher ranked vertex:
+ *   upward(v)   - arcs v -> w with rank(w) > rank(v), the forward search
+ *   downward(v) - arcs w -> v with rank(w) > rank(v) (target is w), the backward search
+ * A shortcut remembers the vertex it bypasses (middle) and unpack() expands it recursively into the
+ * original edges.
+ */
+class ContractionHierarchy
+{
+public:
+    static constexpr int inf{std::numeric_limits<int>::max()};
+
+    // middle is the contracted vertex a shortcut bypasses, -1 for an original edge
+    struct Arc
+    {
+        int target;
+        int weight;
+        int middle;
+    };
+
+    static_assert(sizeof(Arc) == 3 * sizeof(std::int32_t), "Arc is stored as three int32 on disk");
+
+    ContractionHierarchy() = default;
+
+    // threads for the witness searches, 0 means all hardware threads
+    static ContractionHierarchy build(CSRGraphView graph, unsigned threads = 0)
+    {
+        ContractionHierarchy hierarchy;
+        Builder{graph, threads == 0 ? defaultThreadCount() : threads}.run(hierarchy);
+        return hierarchy;
+    }
+
+    int size() const noexcept { return n; }
+    int rank(int v) const noexcept { return ranks[v]; }
+
+    std::span<const Arc> upward(int v) const noexcept
+    {
+        return {upwardArcs.data() + upwardOffsets[v], upwardArcs.data() + upwardOffsets[v + 1]};
+    }
+
+    std::span<const Arc> downward(int v) const noexcept
+    {
+        return {downwardArcs.data() + downwardOffsets[v], downwardArcs.data() + downwardOffsets[v + 1]};
+    }
+
+    int arcCount() const noexcept { return static_cast<int>(upwardArcs.size() + downwardArcs.size()); }
+
+    int shortcutCount() const noexcept
+    {
+        auto isShortcut = [](const Arc& arc) { return arc.middle != -1; };
+        return static_cast<int>(std::count_if(upwardArcs.begin(), upwardArcs.end(), isShortcut) +
+                                std::count_if(downwardArcs.begin(), downwardArcs.end(), isShortcut));
+    }
+
+    /**
+     * @brief Appends the original vertices of the arc from -> to (bypassing middle) to path, without from.
+     * Iterative, the nesting of shortcuts can be deep.
+     */
+    void unpack(int from, int to, int middle, std::vector<int>& path) const
+    {
+        struct Segment { int from, to, middle; };
+        std::vector<Segment> stack{{from, to, middle}};
+
+        while (!stack.empty()) {
+            auto [a, b, m] = stack.back();
+            stack.pop_back();
+            if (m == -1) {
+                path.push_back(b);
+                continue;
+            }
+
+            // both halves were arcs of m when m was contracted: a -> m is stored at m as downward, m -> b as upward
+            stack.push_back({m, b, find(upward(m), b).middle});
+            stack.push_back({a, m, find(downward(m), a).middle});
+        }
+    }
+
+    void save(const std::string& path) const
+    {
+        using Header = ContractionHierarchyFileHeader;
+        auto alignUp = [](std::uint64_t pos) {
+            return (pos + Header::alignment - 1) / Header::alignment * Header::alignment;
+        };
+
+        Header header;
+        std::memcpy(header.magic, Header::expectedMagic, sizeof(header.magic));
+        header.version = Header::currentVersion;
+        header.numberOfVertices = static_cast<std::uint64_t>(n);
+        header.numberOfUpwardArcs = upwardArcs.size();
+        header.numberOfDownwardArcs = downwardArcs.size();
+        header.rankPosition = sizeof(Header);
+        header.upwardOffsetsPosition = alignUp(header.rankPosition + ranks.size() * sizeof(int));
+        header.upwardArcsPosition = alignUp(header.upwardOffsetsPosition + upwardOffsets.size() * sizeof(int));
+        header.downwardOffsetsPosition = alignUp(header.upwardArcsPosition + upwardArcs.size() * sizeof(Arc));
+        header.downwardArcsPosition = alignUp(header.downwardOffsetsPosition + downwardOffsets.size() * sizeof(int));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Cannot open " + path + " for writing");
+
+        auto writeSection = [&out](std::uint64_t position, const auto& data) {
+            static const char zeros[Header::alignment]{};
+            out.write(zeros, static_cast<std::streamsize>(position - static_cast<std::uint64_t>(out.tellp()))); // padding
+            out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(data[0])));
+        };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(header.rankPosition, ranks);
+        writeSection(header.upwardOffsetsPosition, upwardOffsets);
+        writeSection(header.upwardArcsPosition, upwardArcs);
+        writeSection(header.downwardOffsetsPosition, downwardOffsets);
+        writeSection(header.downwardArcsPosition, downwardArcs);
+
+        if (!out) throw std::runtime_error("Failed writing " + path);
+    }
+
+    static ContractionHierarchy load(const std::string& path)
+    {
+        using Header = ContractionHierarchyFileHeader;
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open " + path);
+
+        Header header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(header.magic, Header::expectedMagic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("Not a contraction hierarchy file");
+        }
+        if (header.version != Header::currentVersion) throw std::runtime_error("Unsupported contraction hierarchy file version");
+        if (header.numberOfVertices > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+            throw std::runtime_error("Corrupted contraction hierarchy file");
+        }
+
+        ContractionHierarchy hierarchy;
+        hierarchy.n = static_cast<int>(header.numberOfVertices);
+        hierarchy.ranks.resize(hierarchy.n);
+        hierarchy.upwardOffsets.resize(hierarchy.n + 1);
+        hierarchy.upwardArcs.resize(header.numberOfUpwardArcs);
+        hierarchy.downwardOffsets.resize(hierarchy.n + 1);
+        hierarchy.downwardArcs.resize(header.numberOfDownwardArcs);
+
+        auto readSection = [&in, &path](std::uint64_t position, auto& data) {
+            in.seekg(static_cast<std::streamoff>(position));
+            in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(data[0])));
+            if (!in) throw std::runtime_error("Corrupted contraction hierarchy file " + path);
+        };
+        readSection(header.rankPosition, hierarchy.ranks);
+        readSection(header.upwardOffsetsPosition, hierarchy.upwardOffsets);
+        readSection(header.upwardArcsPosition, hierarchy.upwardArcs);
+        readSection(header.downwardOffsetsPosition, hierarchy.downwardOffsets);
+        readSection(header.downwardArcsPosition, hierarchy.downwardArcs);
+
+        hierarchy.validate();
+        return hierarchy;
+    }
+
+private:
+    static const Arc& find(std::span<const Arc> arcs, int target)
+    {
+        auto it{std::find_if(arcs.begin(), arcs.end(), [target](const Arc& arc) { return arc.target == target; })};
+        if (it == arcs.end()) throw std::logic_error("Shortcut without its halves");
+        return *it;
+    }
+
+    // offsets and vertex ids of a loaded file, so a damaged file can't make the queries read out of bounds
+    void validate() const
+    {
+        auto check = [this](const std::vector<int>& offsets, const std::vector<Arc>& arcs) {
+            if (offsets.front() != 0 || offsets.back() != static_cast<int>(arcs.size())) return false;
+            if (!std::is_sorted(offsets.begin(), offsets.end())) return false;
+            return std::all_of(arcs.begin(), arcs.end(), [this](const Arc& arc) {
+                return arc.target >= 0 && arc.target < n && arc.middle >= -1 && arc.middle < n && arc.weight >= 0;
+            });
+        };
+        if (!check(upwardOffsets, upwardArcs) || !check(downwardOffsets, downwardArcs)) {
+            throw std::runtime_error("Corrupted contraction hierarchy file");
+        }
+    }
+
+    // the preprocessing state: the remaining graph with its shortcuts as adjacency lists in both directions
+    class Builder
+    {
+    public:
+        Builder(CSRGraphView graph, unsigned threadCount)
+            : n{graph.size()}, threads{threadCount}, out(n), in(n), contracted(n), inRound(n), priority(n),
+              deletedNeighbors(n), searches(threadCount), scratch(threadCount)
+        {
+            for (int u{}; u < n; ++u) {
+                for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e) {
+                    int v{graph.target(e)}, w{graph.weight(e)};
+                    if (w < 0) throw std::invalid_argument("Negative edge weights are not supported");
+                    if (u != v) addArc(u, v, w, -1); // self-loops are never on a shortest path
+                }
+            }
+        }
+
+        void run(ContractionHierarchy& hierarchy)
+        {
+            hierarchy.n = n;
+            hierarchy.ranks.assign(n, -1);
+            std::vector<std::vector<Arc>> up(n), down(n);
+
+            std::vector<int> remaining(n);
+            std::iota(remaining.begin(), remaining.end(), 0);
+            updatePriorities(remaining);
+
+            int nextRank{};
+            std::vector<int> round, touched;
+            std::vector<std::vector<Shortcut>> shortcuts;
+            while (!remaining.empty()) {
+                selectRound(remaining, round);
+                for (int u : round) inRound[u] = true;
+
+                shortcuts.resize(round.size());
+                parallelFor(round.size(), threads, [&](std::size_t i, unsigned t) {
+                    contract(round[i], search(t), shortcuts[i]);
+                });
+
+                touched.clear();
+                for (std::size_t i{}; i < round.size(); ++i) {
+                    int u{round[i]};
+                    hierarchy.ranks[u] = nextRank++;
+                    up[u] = std::move(out[u]);
+                    down[u] = std::move(in[u]);
+                    detach(u, up[u], down[u], touched);
+                }
+                for (std::size_t i{}; i < round.size(); ++i) {
+                    for (const Shortcut& s : shortcuts[i]) addArc(s.from, s.to, s.weight, round[i]);
+                    inRound[round[i]] = false;
+                }
+
+                std::sort(touched.begin(), touched.end());
+                touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+                updatePriorities(touched);
+                std::erase_if(remaining, [this](int v) { return contracted[v]; });
+            }
+
+            flatten(up, hierarchy.upwardOffsets, hierarchy.upwardArcs);
+            flatten(down, hierarchy.downwardOffsets, hierarchy.downwardArcs);
+        }
+
+    private:
+        static constexpr int witnessSettleLimit{500};
+
+        struct Shortcut { int from, to, weight; };
+
+        // bounded Dijkstra on the remaining graph that avoids the vertex being contracted, it stops once all
+        // out-neighbours of that vertex are settled; among equally long paths it prefers those avoiding the round
+        class WitnessSearch
+        {
+        public:
+            explicit WitnessSearch(int n) : dist(n), stamp(n, 0), targetStamp(n, 0), throughRound(n) { queue.reset(n); }
+
+            void run(const Builder& builder, int source, int skip, int limit)
+            {
+                if (++epoch == 0) {
+                    std::fill(stamp.begin(), stamp.end(), 0);
+                    std::fill(targetStamp.begin(), targetStamp.end(), 0);
+                    epoch = 1;
+                }
+                queue.clear();
+                set(source, 0, false);
+
+                int targets{};
+                for (const Arc& arc : builder.out[skip]) {
+                    if (arc.target != source) {
+                        targetStamp[arc.target] = epoch;
+                        ++targets;
+                    }
+                }
+
+                for (int settled{}; !queue.empty() && settled < witnessSettleLimit; ++settled) {
+                    auto [d, v] = queue.pop();
+                    if (d > limit) break;
+                    if (targetStamp[v] == epoch && --targets == 0) break;
+
+                    for (const Arc& arc : builder.out[v]) {
+                        int w{arc.target};
+                        if (w == skip) continue;
+
+                        int candidate{d + arc.weight};
+                        bool dirty{throughRound[v] || builder.inRound[w]};
+                        if (candidate < distance(w)) set(w, candidate, dirty);
+                        else if (candidate == dist[w] && throughRound[w] && !dirty) throughRound[w] = false;
+                    }
+                }
+            }
+
+            // false if a path found from the source to v is shorter than length, or as long and avoids the round
+            bool needsShortcut(int v, int length) const noexcept
+            {
+                if (stamp[v] != epoch) return true;
+                return dist[v] > length || (dist[v] == length && throughRound[v]);
+            }
+
+        private:
+            int distance(int v) const noexcept { return stamp[v] == epoch ? dist[v] : inf; }
+
+            void set(int v, int d, bool dirty)
+            {
+                dist[v] = d;
+                stamp[v] = epoch;
+                throughRound[v] = dirty;
+                queue.push(v, d);
+            }
+
+            std::vector<int> dist;
+            std::vector<std::uint32_t> stamp;
+            std::vector<std::uint32_t> targetStamp; // out-neighbours of the vertex being contracted
+            std::uint32_t epoch{};
+            std::vector<char> throughRound; // the path found for v passes through a vertex of the round
+            IndexedDaryHeap<4> queue;
+        };
+
+        WitnessSearch& search(unsigned thread)
+        {
+            if (!searches[thread]) searches[thread] = std::make_unique<WitnessSearch>(n);
+            return *searches[thread];
+        }
+
+        // keeps a single arc per ordered pair, the lightest one
+        void addArc(int from, int to, int weight, int middle)
+        {
+            auto it{std::find_if(out[from].begin(), out[from].end(), [to](const Arc& arc) { return arc.target == to; })};
+            if (it == out[from].end()) {
+                out[from].push_back({to, weight, middle});
+                in[to].push_back({from, weight, middle});
+            } else if (weight < it->weight) {
+                *it = {to, weight, middle};
+                auto back{std::find_if(in[to].begin(), in[to].end(), [from](const Arc& arc) { return arc.target == from; })};
+                *back = {from, weight, middle};
+            }
+        }
+
+        // the shortcuts needed when u is removed
+        void contract(int u, WitnessSearch& witness, std::vector<Shortcut>& result) const
+        {
+            result.clear();
+            for (const Arc& incoming : in[u]) {
+                int a{incoming.target}, limit{-1};
+                for (const Arc& outgoing : out[u]) {
+                    if (outgoing.target != a) limit = std::max(limit, incoming.weight + outgoing.weight);
+                }
+                if (limit == -1) continue;
+
+                witness.run(*this, a, u, limit);
+                for (const Arc& outgoing : out[u]) {
+                    int b{outgoing.target}, via{incoming.weight + outgoing.weight};
+                    if (b != a && witness.needsShortcut(b, via)) result.push_back({a, b, via});
+                }
+            }
+        }
+
+        // removes u, whose arcs are in up/down now, from its neighbours' lists
+        void detach(int u, const std::vector<Arc>& up, const std::vector<Arc>& down, std::vector<int>& touched)
+        {
+            contracted[u] = true;
+            auto drop = [u](std::vector<Arc>& arcs) {
+                std::erase_if(arcs, [u](const Arc& arc) { return arc.target == u; });
+            };
+            for (const Arc& arc : up) {
+                drop(in[arc.target]);
+                ++deletedNeighbors[arc.target];
+                touched.push_back(arc.target);
+            }
+            for (const Arc& arc : down) {
+                drop(out[arc.target]);
+                ++deletedNeighbors[arc.target];
+                touched.push_back(arc.target);
+            }
+        }
+
+        void updatePriorities(const std::vector<int>& vertices)
+        {
+            parallelFor(vertices.size(), threads, [&](std::size_t i, unsigned t) {
+                int u{vertices[i]};
+                std::vector<Shortcut>& shortcuts{scratch[t]};
+                contract(u, search(t), shortcuts);
+                int edgeDifference{static_cast<int>(shortcuts.size()) - static_cast<int>(in[u].size() + out[u].size())};
+                priority[u] = 2 * edgeDifference + deletedNeighbors[u];
+            }, 64);
+        }
+
+        // vertices whose (priority, id) is smaller than that of every remaining neighbour: no two are adjacent
+        void selectRound(const std::vector<int>& remaining, std::vector<int>& round)
+        {
+            std::vector<char> selected(remaining.size());
+            parallelFor(remaining.size(), threads, [&](std::size_t i, unsigned) {
+                int u{remaining[i]};
+                auto beats = [this, u](const Arc& arc) {
+                    int w{arc.target};
+                    return priority[w] < priority[u] || (priority[w] == priority[u] && w < u);
+                };
+                selected[i] = std::none_of(out[u].begin(), out[u].end(), beats) && std::none_of(in[u].begin(), in[u].end(), beats);
+            }, 1024);
+
+            round.clear();
+            for (std::size_t i{}; i < remaining.size(); ++i) {
+                if (selected[i]) round.push_back(remaining[i]);
+            }
+        }
+
+        static void flatten(std::vector<std::vector<Arc>>& lists, std::vector<int>& offsets, std::vector<Arc>& arcs)
+        {
+            offsets.assign(lists.size() + 1, 0);
+            for (std::size_t v{}; v < lists.size(); ++v) offsets[v + 1] = offsets[v] + static_cast<int>(lists[v].size());
+            arcs.clear();
+            arcs.reserve(offsets.back());
+            for (auto& list : lists) {
+                arcs.insert(arcs.end(), list.begin(), list.end());
+                std::vector<Arc>{}.swap(list);
+            }
+        }
+
+        int n{};
+        unsigned threads{};
+        std::vector<std::vector<Arc>> out; // out[u]: arcs u -> target
+        std::vector<std::vector<Arc>> in;  // in[u]: arcs target -> u
+        std::vector<char> contracted;
+        std::vector<char> inRound;
+        std::vector<int> priority;
+        std::vector<int> deletedNeighbors;
+        std::vector<std::unique_ptr<WitnessSearch>> searches; // one per thread, created on first use
+        std::vector<std::vector<Shortcut>> scratch;                 // per thread, for the priority simulation
+    };
+
+private:
+    int n{};
+    std::vector<int> ranks;
+    std::vector<int> upwardOffsets{0};
+    std::vector<Arc> upwardArcs;
+    std::vector<int> downwardOffsets{0};
+    std::vector<Arc> downwardArcs;
+};
+
+/**
+ * @class ContractionHierarchyQuery
+ *
+ * @brief Bidirectional upward Dijkstra on a ContractionHierarchy, with stall-on-demand.
+ *
+ * The forward search from s follows upward arcs, the backward search from t follows downward arcs in
+ * reverse; both only climb in rank and meet at the highest vertex of the shortest path. A side stops
+ * once its smallest key reaches the best distance found so far. Stall-on-demand: a vertex that a higher
+ * ranked, already reached vertex reaches more cheaply is not on a shortest up-path and is not expanded.
+ *
+ * Buffers are reused between queries with the epoch stamps of DijkstraQuery. The hierarchy has to
+ * outlive the query.
+ */
+class ContractionHierarchyQuery
+{
+public:
+    static constexpr int inf{ContractionHierarchy::inf};
+
+    explicit ContractionHierarchyQuery(const ContractionHierarchy& ch)
+        : hierarchy{&ch}, forward{ch.size()}, backward{ch.size()}
+    { }
+
+    // distance from source to target, inf if unreachable
+    int run(int source, int target)
+    {
+        forward.start();
+        backward.start();
+        settled = 0;
+        best = inf;
+        meeting = -1;
+
+        forward.relax(source, 0, -1, nullptr);
+        backward.relax(target, 0, -1, nullptr);
+
+        while (true) {
+            bool forwardOpen{!forward.queue.empty() && forward.queue.minKey() < best};
+            bool backwardOpen{!backward.queue.empty() && backward.queue.minKey() < best};
+            if (!forwardOpen && !backwardOpen) break;
+
+            if (forwardOpen && (!backwardOpen || forward.queue.minKey() <= backward.queue.minKey())) {
+                advance(forward, backward, true);
+            } else {
+                advance(backward, forward, false);
+            }
+        }
+
+        return best;
+    }
+
+    // source -> ... -> target of the last query in original edges, empty if there is none
+    std::vector<int> path() const
+    {
+        std::vector<int> result;
+        if (meeting == -1) return result;
+
+        // forward half: arcs collected from the meeting vertex down to the source, unpacked in order
+        std::vector<int> chain;
+        for (int v{meeting}; v != -1; v = forward.parent[v]) chain.push_back(v);
+        std::reverse(chain.begin(), chain.end());
+
+        result.push_back(chain.front());
+        for (std::size_t i{1}; i < chain.size(); ++i) {
+            hierarchy->unpack(chain[i - 1], chain[i], forward.parentArc[chain[i]]->middle, result);
+        }
+
+        // backward half: every vertex points to the next one towards the target
+        for (int v{meeting}; backward.parent[v] != -1; v = backward.parent[v]) {
+            hierarchy->unpack(v, backward.parent[v], backward.parentArc[v]->middle, result);
+        }
+        return result;
+    }
+
+    // vertices settled by both sides in the last query
+    int settledCount() const noexcept { return settled; }
+
+private:
+    using Arc = ContractionHierarchy::Arc;
+
+    struct Side
+    {
+        explicit Side(int n) : dist(n), parent(n), parentArc(n), stamp(n, 0) { queue.reset(n); }
+
+        void start()
+        {
+            if (++epoch == 0) { // wrapped around: the stamps are ambiguous again
+                std::fill(stamp.begin(), stamp.end(), 0);
+                epoch = 1;
+            }
+            queue.clear();
+        }
+
+        bool reached(int v) const noexcept { return stamp[v] == epoch; }
+        int distance(int v) const noexcept { return reached(v) ? dist[v] : inf; }
+
+        void relax(int v, int d, int from, const Arc* arc)
+        {
+            dist[v] = d;
+            parent[v] = from;
+            parentArc[v] = arc;
+            stamp[v] = epoch;
+            queue.push(v, d);
+        }
+
+        std::vector<int> dist;
+        std::vector<int> parent;
+        std::vector<const Arc*> parentArc; // the hierarchy arc between v and parent[v]
+        std::vector<std::uint32_t> stamp;
+        std::uint32_t epoch{};
+        IndexedDaryHeap<4> queue;
+    };
+
+    void advance(Side& side, const Side& other, bool isForward)
+    {
+        auto [d, v] = side.queue.pop();
+        ++settled;
+
+        if (other.reached(v) && d + static_cast<long long>(other.dist[v]) < best) {
+            best = d + other.dist[v];
+            meeting = v;
+        }
+
+        // stall-on-demand looks at the arcs coming from above, in search direction
+        std::span<const Arc> above{isForward ? hierarchy->downward(v) : hierarchy->upward(v)};
+        for (const Arc& arc : above) {
+            if (side.reached(arc.target) && side.dist[arc.target] + static_cast<long long>(arc.weight) < d) return;
+        }
+
+        std::span<const Arc> arcs{isForward ? hierarchy->upward(v) : hierarchy->downward(v)};
+        for (const Arc& arc : arcs) {
+            int w{arc.target}, candidate{d + arc.weight};
+            if (candidate < side.distance(w)) side.relax(w, candidate, v, &arc);
+        }
+    }
+
+private:
+    const ContractionHierarchy* hierarchy;
+    Side forward;
+    Side backward;
+
+    int best{inf};
+    int meeting{-1};
+    int settled{};
+};
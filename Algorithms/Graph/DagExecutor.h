@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "../Common/WorkStealingPool.h"
+
+/**
+ * @class DagExecutor
+ *
+ * @brief Runs a callback per vertex of a DAG on a WorkStealingPool, each vertex as soon as all of its
+ *        predecessors have finished.
+ *
+ * This is Kahn's algorithm without the queue: the in-degrees are atomic, the task of a vertex decrements
+ * the in-degree of each successor after its callback returns, and the task that brings one to zero
+ * submits that successor. Ready successors land on the worker's own deque, so a chain stays on one
+ * thread, and idle workers steal whatever is ready elsewhere. Unlike the level-by-level schedule
+ * (topologicalLevels), a vertex never waits for unrelated vertices of its level.
+ *
+ * run() blocks until everything reachable has run.
+ *   - If a callback throws, no further successors are released, run() waits for the tasks already
+ *     started and rethrows the first exception.
+ *   - If the graph has a cycle, the vertices on or behind it never become ready; everything else runs
+ *     and then run() throws std::invalid_argument.
+ * The in-degrees are counted once in the constructor, run() can be called again (not concurrently).
+ */
+
+class DagExecutor
+{
+public:
+    explicit DagExecutor(CSRGraphView g) : graph{g}, initialInDegree(g.size()), inDegree(g.size())
+    {
+        for (int e{}; e < graph.numberOfEdges; ++e) ++initialInDegree[graph.target(e)];
+    }
+
+    // callback(int vertex), called exactly once per vertex, from the pool's threads
+    template <typename Callback>
+    void run(WorkStealingPool& pool, Callback&& callback)
+    {
+        for (int u{}; u < graph.size(); ++u) inDegree[u].store(initialInDegree[u], std::memory_order_relaxed);
+        executed.store(0, std::memory_order_relaxed);
+        failed.store(false, std::memory_order_relaxed);
+
+        Run<Callback> job{*this, pool, callback};
+        for (int u{}; u < graph.size(); ++u) {
+            if (initialInDegree[u] == 0) job.submit(u);
+        }
+        pool.wait();
+
+        if (executed.load(std::memory_order_relaxed) != graph.size()) {
+            throw std::invalid_argument("Graph contains a cycle");
+        }
+    }
+
+private:
+    // what a task needs besides its vertex, so the task itself is two words and fits std::function's buffer
+    template <typename Callback>
+    struct Run
+    {
+        DagExecutor& self;
+        WorkStealingPool& pool;
+        Callback& callback;
+
+        void submit(int v)
+        {
+            pool.submit([this, v] { execute(v); });
+        }
+
+        void execute(int v)
+        {
+            if (self.failed.load(std::memory_order_relaxed)) return;
+            try {
+                callback(v);
+            } catch (...) {
+                self.failed.store(true, std::memory_order_relaxed);
+                throw;
+            }
+            self.executed.fetch_add(1, std::memory_order_relaxed);
+
+            // acq_rel: the last predecessor to finish publishes the work of all of them to the successor
+            for (int w : self.graph.neighbors(v)) {
+                if (self.inDegree[w].fetch_sub(1, std::memory_order_acq_rel) == 1) submit(w);
+            }
+        }
+    };
+
+    CSRGraphView graph;
+    std::vector<int> initialInDegree;
+    std::vector<std::atomic<int>> inDegree;
+    std::atomic<int> executed{};
+    std::atomic<bool> failed{};
+};
@@ -0,0 +1,256 @@
+/**
+ * @file DeltaStepping.cpp
+ * @brief Parallel single-source shortest paths with Meyer and Sanders' Δ-stepping algorithm.
+ *
+ * @details
+ * ## Idea
+ * Dijkstra settles exactly one vertex at a time, which is inherently serial. Δ-stepping relaxes the order:
+ * tentative distances are kept in buckets of width Δ (bucket i holds vertices with dist in [iΔ, (i+1)Δ)),
+ * and all vertices of the smallest non-empty bucket are processed together, in parallel.
+ *
+ * Edges are split by weight:
+ *   - light edges (w <= Δ) can put their head back into the current bucket, so the current bucket is
+ *     processed in rounds until it stays empty,
+ *   - heavy edges (w > Δ) always land in a later bucket, so they are relaxed once per bucket,
+ *     from the final distances of every vertex that was settled in it.
+ *
+ * Δ = 1 with integer weights gives Dijkstra (one distance per bucket, little parallelism), Δ = ∞ gives
+ * Bellman–Ford (one bucket, much redundant work); a good Δ is around max weight / average degree.
+ *
+ * ## Parallelization
+ * - dist[] is an array of atomics, a relaxation is an atomic fetch-min (CAS loop),
+ * - every thread collects the vertices it improved in its own request list; the lists are merged into
+ *   the buckets after each round, so the buckets themselves are never shared,
+ * - stale bucket entries (vertex improved again and moved) are filtered when a bucket is taken,
+ * - the rounds run on a ThreadTeam (Parallel.h) owned by the solver: a round is often only a few
+ *   thousand relaxations, less than spawning the threads for it would cost.
+ * The final distances are exactly Dijkstra's, independent of the thread count and Δ.
+ *
+ * ## Complexity
+ * O(n + m + reinsertions) work; the number of phases is bounded by (max distance / Δ) times the number
+ * of light-edge rounds per bucket. Buckets are kept in a circular array of max weight / Δ + 2 entries,
+ * which is enough because no tentative distance is more than max weight ahead of the current bucket.
+ */
+
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "ShortestPathQuery.h"
+#include "../Common/Parallel.h"
+#include "TestGraphs.h"
+#include "gtest/gtest.h"
+
+class DeltaSteppingSolver
+{
+public:
+    static constexpr int inf{std::numeric_limits<int>::max()};
+
+    /**
+     * @param delta bucket width; 0 picks max weight / average degree
+     * @param threads number of worker threads, 0 means all hardware threads
+     */
+    DeltaSteppingSolver(CSRGraphView g, int delta = 0, unsigned threads = 0)
+        : graph{g}, n{g.size()}, team{threads}, dist(n), processed(n)
+    {
+        for (int e{}; e < graph.numberOfEdges; ++e) {
+            if (graph.weight(e) < 0) throw std::invalid_argument("Negative edge weights are not supported by delta-stepping");
+            maxWeight = std::max(maxWeight, graph.weight(e));
+        }
+
+        if (delta < 0) throw std::invalid_argument("Bucket width should be > 0");
+        if (delta == 0) {
+            int averageDegree{n > 0 ? std::max(1, graph.numberOfEdges / n) : 1};
+            delta = std::max(1, maxWeight / averageDegree);
+        }
+
+        this->delta = delta;
+        buckets.resize(maxWeight / delta + 2);
+        requests.resize(team.size());
+    }
+
+    std::vector<int> solve(int source)
+    {
+        for (int v{}; v < n; ++v) {
+            dist[v].store(inf, std::memory_order_relaxed);
+            processed[v] = inf;
+        }
+        for (auto& bucket : buckets) bucket.clear();
+
+        dist[source].store(0, std::memory_order_relaxed);
+        buckets[0].push_back(source);
+        long long pending{1};
+
+        for (long long current{}; pending > 0; ++current) {
+            std::vector<int>& bucket{buckets[current % buckets.size()]};
+            if (bucket.empty()) continue;
+
+            settledInBucket.clear();
+            while (!bucket.empty()) {
+                pending -= static_cast<long long>(bucket.size());
+                takeFrontier(bucket, current);
+
+                relaxParallel(frontier, true/*light*/);
+                pending += mergeRequests();
+            }
+
+            relaxParallel(settledInBucket, false/*heavy*/);
+            pending += mergeRequests();
+        }
+
+        std::vector<int> result(n);
+        for (int v{}; v < n; ++v) result[v] = dist[v].load(std::memory_order_relaxed);
+        return result;
+    }
+
+    int getDelta() const noexcept { return delta; }
+
+private:
+    // moves the live entries of the current bucket into the frontier, dropping stale and duplicate ones
+    void takeFrontier(std::vector<int>& bucket, long long current)
+    {
+        frontier.clear();
+        for (int v : bucket) {
+            int d{dist[v].load(std::memory_order_relaxed)};
+            if (d / delta != current || d == processed[v]) continue; // moved to another bucket, or seen at d
+
+            if (processed[v] == inf) settledInBucket.push_back(v);
+            processed[v] = d;
+            frontier.push_back(v);
+        }
+        bucket.clear();
+    }
+
+    void relaxParallel(const std::vector<int>& vertices, bool light)
+    {
+        parallelForChunks(team, vertices.size(), [&](std::size_t begin, std::size_t end, unsigned t) {
+            std::vector<int>& improved{requests[t]};
+            for (std::size_t i{begin}; i < end; ++i) {
+                int u{vertices[i]};
+                int du{dist[u].load(std::memory_order_relaxed)};
+
+                for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e) {
+                    int w{graph.weight(e)};
+                    if ((w <= delta) != light) continue;
+
+                    int v{graph.target(e)};
+                    if (relax(v, du + w)) improved.push_back(v);
+                }
+            }
+        }, minChunk);
+    }
+
+    bool relax(int v, int candidate)
+    {
+        int current{dist[v].load(std::memory_order_relaxed)};
+        while (candidate < current) {
+            if (dist[v].compare_exchange_weak(current, candidate, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+
+    long long mergeRequests()
+    {
+        long long added{};
+        for (auto& improved : requests) {
+            for (int v : improved) {
+                long long b{dist[v].load(std::memory_order_relaxed) / delta};
+                buckets[b % buckets.size()].push_back(v);
+            }
+            added += static_cast<long long>(improved.size());
+            improved.clear();
+        }
+        return added;
+    }
+
+private:
+    static constexpr std::size_t minChunk{256}; // smaller frontiers are relaxed by one thread
+
+    CSRGraphView graph;
+    int n{};
+    int delta{};
+    int maxWeight{};
+    ThreadTeam team;
+
+    std::vector<std::atomic<int>> dist;
+    std::vector<int> processed;              // distance at which a vertex was last expanded
+    std::vector<std::vector<int>> buckets;   // circular
+    std::vector<int> frontier, settledInBucket;
+    std::vector<std::vector<int>> requests;  // per thread: improved vertices of the current round
+};
+
+std::vector<int> serialDistances(CSRGraphView g, int source)
+{
+    DijkstraQuery query{g};
+    query.run(source);
+    return query.distances();
+}
+
+TEST(DeltaSteppingTest, CormenExample)
+{
+    // Cormen's example, chapter 24 (same graph as Dijkstra.cpp)
+    CSRGraph graph{CSRGraph::fromAdjacencyList(std::vector<std::vector<std::pair<int, int>>>{
+        {{1, 3}, {2, 5}}, {{3, 6}, {2, 2}}, {{1, 1}, {4, 6}, {3, 4}}, {{4, 2}}, {{3, 7}, {0, 3}}
+    })};
+
+    for (int delta : {1, 2, 3, 100}) {
+        DeltaSteppingSolver solver{graph.view(), delta, 2};
+        EXPECT_EQ(solver.solve(0), (std::vector<int>{0, 3, 5, 9, 11}));
+        EXPECT_EQ(solver.solve(3), serialDistances(graph.view(), 3));
+    }
+}
+
+TEST(DeltaSteppingTest, UnreachableVertices)
+{
+    CSRGraph graph{CSRGraph::fromEdges(4, std::vector<std::tuple<int, int, int>>{{0, 1, 2}, {1, 0, 0}, {2, 3, 1}})};
+    DeltaSteppingSolver solver{graph.view(), 1, 4};
+
+    EXPECT_EQ(solver.solve(0), (std::vector<int>{0, 2, DeltaSteppingSolver::inf, DeltaSteppingSolver::inf}));
+}
+
+TEST(DeltaSteppingTest, MatchesDijkstraOnRandomGraphs)
+{
+    struct Case { int n, m, maxWeight; unsigned seed; };
+    for (Case c : {Case{1000, 5000, 10, 1}, Case{20000, 200000, 1000, 2}, Case{50000, 400000, 100000, 3}}) {
+        CSRGraph graph{randomGraph(c.n, c.m, c.maxWeight, c.seed)};
+        std::vector<int> expected{serialDistances(graph.view(), 0)};
+
+        for (unsigned threads : {1u, 4u}) {
+            for (int delta : {0, 1, c.maxWeight / 4 + 1, c.maxWeight * 2}) {
+                DeltaSteppingSolver solver{graph.view(), delta, threads};
+                EXPECT_EQ(solver.solve(0), expected) << "n=" << c.n << " delta=" << solver.getDelta() << " threads=" << threads;
+            }
+        }
+    }
+}
+
+TEST(DeltaSteppingTest, BenchmarkAgainstDijkstra)
+{
+    CSRGraph graph{randomGraph(500000, 4000000, 1000, 4)};
+
+    auto startSerial{std::chrono::high_resolution_clock::now()};
+    std::vector<int> expected{serialDistances(graph.view(), 0)};
+    auto endSerial{std::chrono::high_resolution_clock::now()};
+
+    DeltaSteppingSolver solver{graph.view()};
+    auto startParallel{std::chrono::high_resolution_clock::now()};
+    std::vector<int> result{solver.solve(0)};
+    auto endParallel{std::chrono::high_resolution_clock::now()};
+
+    EXPECT_EQ(result, expected);
+
+    std::cout << "Dijkstra: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(endSerial - startSerial).count() << " ms\n";
+    std::cout << "Delta-stepping (delta = " << solver.getDelta() << ", " << defaultThreadCount() << " threads): "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(endParallel - startParallel).count() << " ms\n";
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
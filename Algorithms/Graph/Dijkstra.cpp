@@ -1,7 +1,19 @@
 #include <vector>
-#include <queue>
 #include <iostream>
 #include <limits>
+#include <random>
+#include <queue>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include "CSRGraph.h"
+#include "GraphFile.h"
+#include "Landmarks.h"
+#include "ShortestPathQuery.h"
+#include "BidirectionalQuery.h"
+#include "TestGraphs.h"
+#include "gtest/gtest.h"
 
 /*
 * Dijkstra's algorithm is used to find the shortest path from a source node to all other nodes in a weighted graph with non-negative edges.
@@ -18,55 +30,415 @@
 * For each of its neighbors, update their distance if the current path is shorter.
 * If a shorter path is found, push (new_distance, neighbor) into the priority queue.
 * Repeat until all nodes are processed.
+*
+* The graph is read through a non-owning CSRGraphView, so several solvers can share one CSRGraph.
+* The adjacency list constructor is kept for convenience and converts the input once.
+*
+* The search itself is done by a DijkstraQuery (ShortestPathQuery.h) owned by the solver, so repeated
+* solve() calls reuse the distance/heap buffers instead of reallocating them.
+*
+* getShortestPathBidirectional() searches from both ends at once (BidirectionalQuery.h). After
+* useLandmarks() it is goal directed with ALT lower bounds (Landmarks.h) and settles only a narrow
+* corridor around the shortest path; the landmark table can be built once, saved and loaded again.
 */
 
 class Dijkstra
 {
 public:
-    Dijkstra(const std::vector<std::vector<std::pair<int, int>>>& graph) : m_graph{ graph }, n(graph.size())
+    explicit Dijkstra(CSRGraphView graph) : m_graph{ graph }, n{ graph.size() }, m_query{ m_graph }
+    { }
+
+    Dijkstra(const std::vector<std::vector<std::pair<int, int>>>& graph)
+        : m_storage{ CSRGraph::fromAdjacencyList(graph) }, m_graph{ m_storage.view() }, n{ m_graph.size() }, m_query{ m_graph }
     { }
 
+    // m_graph (and m_query) may point into m_storage, so a copy would view the original's arrays
+    Dijkstra(const Dijkstra&) = delete;
+    Dijkstra& operator=(const Dijkstra&) = delete;
+
+    std::vector<int> getDistances(int sourceVertex)
+    {
+        m_query.run(sourceVertex);
+        return m_query.distances();
+    }
+
+    // point-to-point query, stops as soon as the target is settled; empty path if unreachable
+    std::vector<int> getShortestPath(int sourceVertex, int targetVertex)
+    {
+        m_query.run(sourceVertex, targetVertex);
+        return m_query.path(targetVertex);
+    }
+
+    // point-to-point query from both ends, goal directed once landmarks are set; empty path if unreachable
+    std::vector<int> getShortestPathBidirectional(int sourceVertex, int targetVertex)
+    {
+        if (m_landmarks) {
+            m_alt->run(sourceVertex, targetVertex);
+            return m_alt->path();
+        }
+
+        if (!m_bidirectional) m_bidirectional.emplace(m_graph, reverseGraph());
+        m_bidirectional->run(sourceVertex, targetVertex);
+        return m_bidirectional->path();
+    }
+
+    // a table built for this graph (LandmarkTable::build or LandmarkTable::load)
+    void useLandmarks(LandmarkTable table)
+    {
+        if (table.size() != n) throw std::invalid_argument("Landmark table belongs to another graph");
+
+        m_landmarks = std::make_unique<LandmarkTable>(std::move(table)); // heap allocated: the heuristic points to it
+        m_alt.emplace(m_graph, reverseGraph(), LandmarkHeuristic{*m_landmarks});
+    }
+
+    void useLandmarks(int count) { useLandmarks(LandmarkTable::build(m_graph, count)); }
+
     void solve(int sourceVertex)
     {
-        std::vector<int> dist(n, std::numeric_limits<int>::max());
-        std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> pq;
-        pq.push(std::make_pair(0, sourceVertex));
-        dist[sourceVertex] = 0;
+        for (int i : getDistances(sourceVertex)) std::cout << i << " ";
+        std::cout << std::endl;
+    }
+
+private:
+    CSRGraphView reverseGraph()
+    {
+        if (m_reverse.size() != n) m_reverse = CSRGraph::reverse(m_graph);
+        return m_reverse.view();
+    }
+
+private:
+    CSRGraph m_storage; // only used when the solver is built from an adjacency list
+    CSRGraphView m_graph;
+    int n{};
+    DijkstraQuery m_query;
+
+    // bidirectional queries, created on first use
+    CSRGraph m_reverse;
+    std::optional<BidirectionalQuery<>> m_bidirectional;
+    std::unique_ptr<LandmarkTable> m_landmarks;
+    std::optional<BidirectionalQuery<LandmarkHeuristic>> m_alt;
+};
+
+// Cormen's example, chapter 24
+std::vector<std::vector<std::pair<int, int>>> cormenGraph()
+{
+    return {
+        std::vector<std::pair<int, int>>{{1, 3}, {2, 5}},
+        std::vector<std::pair<int, int>>{{3, 6}, {2, 2}},
+        std::vector<std::pair<int, int>>{{1, 1}, {4, 6}, {3, 4}},
+        std::vector<std::pair<int, int>>{{4, 2}},
+        std::vector<std::pair<int, int>>{{3, 7}, {0, 3}}
+    };
+}
+
+TEST(DijkstraTest, CormenExample)
+{
+    Dijkstra d{cormenGraph()};
+    EXPECT_EQ(d.getDistances(0), (std::vector<int>{0, 3, 5, 9, 11}));
+    EXPECT_EQ(d.getShortestPath(3, 1), (std::vector<int>{3, 4, 0, 1}));
+}
+
+TEST(DijkstraTest, MappedGraphFile)
+{
+    // the same graph stored in a binary graph file and solved straight from the mapping
+    CSRGraph graph{CSRGraph::fromAdjacencyList(cormenGraph())};
+    writeGraphFile("dijkstra_cormen.bin", graph.view());
+    {
+        MappedGraphFile file{"dijkstra_cormen.bin"};
+        Dijkstra mapped{file.view()};
+        EXPECT_EQ(mapped.getDistances(0), (std::vector<int>{0, 3, 5, 9, 11}));
+    }
+    std::remove("dijkstra_cormen.bin");
+}
+
+TEST(DijkstraTest, CorruptGraphFile)
+{
+    CSRGraph graph{CSRGraph::fromAdjacencyList(cormenGraph())};
+    auto corrupt = [&](bool offsets, int value) {
+        writeGraphFile("dijkstra_corrupt.bin", graph.view());
+        GraphFileHeader header;
+        std::fstream file("dijkstra_corrupt.bin", std::ios::binary | std::ios::in | std::ios::out);
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        file.seekp(static_cast<std::streamoff>(offsets ? header.offsetsPosition + sizeof(int) : header.targetsPosition));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    // the cheap open does not look at the adjacency; verify() does
+    corrupt(true, graph.view().numberOfEdges + 1); // offsets[1] > offsets[2]
+    EXPECT_NO_THROW(MappedGraphFile{"dijkstra_corrupt.bin"});
+    EXPECT_THROW(MappedGraphFile{"dijkstra_corrupt.bin"}.verify(), std::runtime_error);
+    corrupt(false, graph.size());
+    EXPECT_THROW((MappedGraphFile{"dijkstra_corrupt.bin", true}), std::runtime_error);
+    corrupt(false, -1);
+    EXPECT_THROW((MappedGraphFile{"dijkstra_corrupt.bin", true}), std::runtime_error);
+    std::remove("dijkstra_corrupt.bin");
+}
+
+TEST(DijkstraQueryTest, EarlyTerminationAndPath)
+{
+    CSRGraph graph{CSRGraph::fromAdjacencyList(cormenGraph())};
+    DijkstraQuery query{graph.view()};
+
+    EXPECT_EQ(query.run(0, 2), 5);
+    EXPECT_EQ(query.path(2), (std::vector<int>{0, 2}));
+    EXPECT_LT(query.settledCount(), graph.size());
+
+    EXPECT_EQ(query.run(3, 1), 8); // 3 -> 4 -> 0 -> 1
+    EXPECT_EQ(query.path(1), (std::vector<int>{3, 4, 0, 1}));
+}
+
+TEST(DijkstraQueryTest, Unreachable)
+{
+    CSRGraph graph{CSRGraph::fromEdges(3, std::vector<std::tuple<int, int, int>>{{0, 1, 4}})};
+    DijkstraQuery query{graph.view()};
+
+    EXPECT_EQ(query.run(0, 2), DijkstraQuery::inf);
+    EXPECT_TRUE(query.path(2).empty());
+    EXPECT_EQ(query.distance(1), 4);
+
+    // nothing from the previous query must leak into this one
+    query.run(2);
+    EXPECT_EQ(query.distance(0), DijkstraQuery::inf);
+    EXPECT_EQ(query.distance(1), DijkstraQuery::inf);
+    EXPECT_EQ(query.predecessor(1), -1);
+}
 
+TEST(DijkstraQueryTest, RunToTargets)
+{
+    CSRGraph graph{randomGraph(2000, 10000, 100, 7)};
+    DijkstraQuery full{graph.view()}, partial{graph.view()};
+    full.run(3);
+
+    std::vector<int> targets{10, 500, 10, 1999};
+    partial.runToTargets(3, targets);
+    for (int t : targets) EXPECT_EQ(partial.distance(t), full.distance(t));
+    EXPECT_LE(partial.settledCount(), full.settledCount());
+}
+
+TEST(DijkstraQueryTest, BatchMatchesFreshQueries)
+{
+    CSRGraph graph{randomGraph(2000, 10000, 100, 42)};
+    DijkstraQuery reused{graph.view()};
+
+    std::vector<int> sources{0, 17, 1999, 17, 512};
+    int checked{};
+    reused.runBatch(sources, [&](int source, const DijkstraQuery& q) {
+        DijkstraQuery fresh{graph.view()};
+        fresh.run(source);
+        EXPECT_EQ(q.distances(), fresh.distances());
+        ++checked;
+    });
+
+    EXPECT_EQ(checked, sources.size());
+}
+
+TEST(DijkstraQueryTest, PriorityQueueBackendsAgree)
+{
+    const int maxWeight{50};
+    CSRGraph graph{randomGraph(3000, 15000, maxWeight, 7)};
+
+    DijkstraQuery reference{graph.view()};
+    BasicDijkstraQuery<IndexedDaryHeap<2>> binary{graph.view()};
+    BasicDijkstraQuery<RadixHeap> radix{graph.view()};
+    BasicDijkstraQuery<BucketQueue> dial{graph.view(), BucketQueue{maxWeight}};
+
+    for (int source : {0, 5, 1234, 2999}) {
+        reference.run(source);
+        binary.run(source);
+        radix.run(source);
+        dial.run(source);
+
+        EXPECT_EQ(binary.distances(), reference.distances());
+        EXPECT_EQ(radix.distances(), reference.distances());
+        EXPECT_EQ(dial.distances(), reference.distances());
+
+        int target{(source * 7 + 11) % graph.size()};
+        int expected{reference.run(source, target)};
+        EXPECT_EQ(radix.run(source, target), expected);
+        EXPECT_EQ(dial.run(source, target), expected);
+    }
+}
+
+TEST(DijkstraQueryTest, BenchmarkPriorityQueues)
+{
+    const int side{400}, maxWeight{20};
+    CSRGraph graph{roadGrid(side, maxWeight, 1)};
+    CSRGraphView g{graph.view()};
+
+    std::mt19937 rng{2};
+    std::uniform_int_distribution<int> vertex(0, g.size() - 1);
+    std::vector<std::pair<int, int>> queries;
+    for (int i{}; i < 100; ++i) queries.push_back({vertex(rng), vertex(rng)});
+
+    // the previous implementation: std::priority_queue with lazy deletion and a fresh dist array per query
+    auto lazyDijkstra = [&g](int source, int target) {
+        std::vector<int> dist(g.size(), std::numeric_limits<int>::max());
+        std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> pq;
+        pq.push({0, source});
+        dist[source] = 0;
         while (!pq.empty()) {
             auto [cost, u] = pq.top();
             pq.pop();
-
             if (cost > dist[u]) continue;
-
-            for (auto [v, w] : m_graph[u]) {
-                if (dist[v] > cost + w) {
-                    dist[v] = cost + w;
-                    pq.push(std::make_pair(dist[v], v));
+            if (u == target) return cost;
+            for (int e{g.firstEdge(u)}; e < g.lastEdge(u); ++e) {
+                int v{g.target(e)};
+                if (dist[v] > cost + g.weight(e)) {
+                    dist[v] = cost + g.weight(e);
+                    pq.push({dist[v], v});
                 }
             }
         }
+        return std::numeric_limits<int>::max();
+    };
 
-        for (int i : dist) std::cout << i << " ";
-        std::cout << std::endl;
+    auto time = [&queries](const char* name, auto&& query) {
+        long long checksum{};
+        auto start{std::chrono::high_resolution_clock::now()};
+        for (auto [s, t] : queries) checksum += query(s, t);
+        auto end{std::chrono::high_resolution_clock::now()};
+
+        std::cout << name << ": "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+        return checksum;
+    };
+
+    DijkstraQuery quaternary{g};
+    BasicDijkstraQuery<RadixHeap> radix{g};
+    BasicDijkstraQuery<BucketQueue> dial{g, BucketQueue{maxWeight}};
+
+    long long expected{time("lazy std::priority_queue", lazyDijkstra)};
+    EXPECT_EQ(time("4-ary heap", [&](int s, int t) { return quaternary.run(s, t); }), expected);
+    EXPECT_EQ(time("radix heap", [&](int s, int t) { return radix.run(s, t); }), expected);
+    EXPECT_EQ(time("bucket queue", [&](int s, int t) { return dial.run(s, t); }), expected);
+}
+
+TEST(BidirectionalQueryTest, MatchesDijkstraOnRandomGraphs)
+{
+    for (unsigned seed{1}; seed <= 5; ++seed) {
+        CSRGraph graph{randomGraph(500, 2000, 50, seed)};
+        DijkstraQuery reference{graph.view()};
+        BidirectionalQuery<> plain{graph.view()};
+        LandmarkTable landmarks{LandmarkTable::build(graph.view(), 8)};
+        BidirectionalQuery<LandmarkHeuristic> alt{graph.view(), LandmarkHeuristic{landmarks}};
+
+        std::mt19937 rng{seed};
+        std::uniform_int_distribution<int> vertex(0, graph.size() - 1);
+        for (int i{}; i < 200; ++i) {
+            int s{vertex(rng)}, t{vertex(rng)};
+            int expected{reference.run(s, t)};
+            ASSERT_EQ(plain.run(s, t), expected) << s << " -> " << t;
+            ASSERT_EQ(alt.run(s, t), expected) << s << " -> " << t;
+            if (expected != DijkstraQuery::inf) {
+                EXPECT_TRUE(isPath(graph.view(), plain.path(), s, t, expected));
+                EXPECT_TRUE(isPath(graph.view(), alt.path(), s, t, expected));
+            } else {
+                EXPECT_TRUE(alt.path().empty());
+            }
+        }
     }
+}
 
-private:
-    std::vector<std::vector<std::pair<int, int>>> m_graph;
-    int n{};
-};
+TEST(BidirectionalQueryTest, LowerBoundsAreAdmissible)
+{
+    CSRGraph graph{randomGraph(300, 1500, 30, 11)};
+    LandmarkTable landmarks{LandmarkTable::build(graph.view(), 6)};
+    DijkstraQuery query{graph.view()};
+
+    for (int s{}; s < graph.size(); s += 7) {
+        query.run(s);
+        for (int t{}; t < graph.size(); ++t) {
+            if (query.distance(t) != DijkstraQuery::inf) {
+                ASSERT_LE(landmarks.lowerBound(s, t), query.distance(t));
+            }
+        }
+    }
+}
 
-int main()
+TEST(BidirectionalQueryTest, SolverAndLandmarkFile)
 {
-    // Cormen's example, chapter 24
-    Dijkstra d{std::vector<std::vector<std::pair<int, int>>>
-                {
-                std::vector<std::pair<int, int>>{{1, 3}, {2, 5}},
-                std::vector<std::pair<int, int>>{{3, 6}, {2, 2}},
-                std::vector<std::pair<int, int>>{{1, 1}, {4, 6}, {3, 4}},
-                std::vector<std::pair<int, int>>{{4, 2}},
-                std::vector<std::pair<int, int>>{{3, 7}, {0, 3}}
-                }
-            };
-    d.solve(0);
-}
\ No newline at end of file
+    Dijkstra d{cormenGraph()};
+    EXPECT_EQ(d.getShortestPathBidirectional(3, 1), (std::vector<int>{3, 4, 0, 1}));
+    EXPECT_EQ(d.getShortestPathBidirectional(2, 2), (std::vector<int>{2}));
+
+    CSRGraph graph{CSRGraph::fromAdjacencyList(cormenGraph())};
+    LandmarkTable built{LandmarkTable::build(graph.view(), 2)};
+    built.save("dijkstra_landmarks.bin");
+    LandmarkTable loaded{LandmarkTable::load("dijkstra_landmarks.bin", graph.view())};
+    std::remove("dijkstra_landmarks.bin");
+
+    ASSERT_EQ(loaded.landmarkCount(), 2);
+    for (int i{}; i < 2; ++i) {
+        EXPECT_EQ(loaded.landmark(i), built.landmark(i));
+        for (int v{}; v < graph.size(); ++v) {
+            EXPECT_EQ(loaded.fromLandmark(i, v), built.fromLandmark(i, v));
+            EXPECT_EQ(loaded.toLandmark(i, v), built.toLandmark(i, v));
+        }
+    }
+
+    d.useLandmarks(std::move(loaded));
+    EXPECT_EQ(d.getShortestPathBidirectional(3, 1), (std::vector<int>{3, 4, 0, 1}));
+
+    CSRGraph other{randomGraph(6, 3, 1, 1)};
+    EXPECT_THROW(LandmarkTable::load("missing_landmarks.bin", other.view()), std::runtime_error);
+    EXPECT_THROW(d.useLandmarks(LandmarkTable::build(other.view(), 1)), std::invalid_argument);
+}
+
+TEST(BidirectionalQueryTest, BenchmarkSettledNodes)
+{
+    const int side{400};
+    CSRGraph graph{roadGrid(side, 20, 3)};
+    CSRGraphView g{graph.view()};
+
+    auto start{std::chrono::high_resolution_clock::now()};
+    LandmarkTable landmarks{LandmarkTable::build(g, 16)};
+    auto end{std::chrono::high_resolution_clock::now()};
+    std::cout << "16 landmarks: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    std::mt19937 rng{5};
+    std::uniform_int_distribution<int> vertex(0, g.size() - 1);
+    std::vector<std::pair<int, int>> queries;
+    for (int i{}; i < 100; ++i) queries.push_back({vertex(rng), vertex(rng)});
+
+    auto time = [&queries](const char* name, auto&& query) {
+        long long checksum{}, settled{};
+        auto start{std::chrono::high_resolution_clock::now()};
+        for (auto [s, t] : queries) checksum += query(s, t, settled);
+        auto end{std::chrono::high_resolution_clock::now()};
+
+        std::cout << name << ": " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                  << " ms, " << settled / static_cast<long long>(queries.size()) << " settled per query\n";
+        return std::pair{checksum, settled};
+    };
+
+    DijkstraQuery unidirectional{g};
+    BidirectionalQuery<> bidirectional{g, g};
+    BidirectionalQuery<LandmarkHeuristic> alt{g, g, LandmarkHeuristic{landmarks}};
+
+    auto [expected, dijkstraSettled] = time("Dijkstra", [&](int s, int t, long long& settled) {
+        int d{unidirectional.run(s, t)};
+        settled += unidirectional.settledCount();
+        return d;
+    });
+    auto [plainSum, plainSettled] = time("bidirectional Dijkstra", [&](int s, int t, long long& settled) {
+        int d{bidirectional.run(s, t)};
+        settled += bidirectional.settledCount();
+        return d;
+    });
+    auto [altSum, altSettled] = time("bidirectional ALT", [&](int s, int t, long long& settled) {
+        int d{alt.run(s, t)};
+        settled += alt.settledCount();
+        return d;
+    });
+
+    EXPECT_EQ(plainSum, expected);
+    EXPECT_EQ(altSum, expected);
+    EXPECT_LT(plainSettled, dijkstraSettled);
+    EXPECT_LT(altSettled * 10, dijkstraSettled);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <span>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "ParallelSCC.h"
+#include "ShortestPathQuery.h"
+#include "BlockedFloydWarshall.h"
+#include "../Common/Parallel.h"
+
+enum class DistanceMatrixStrategy
+{
+    Automatic,
+    FloydWarshall, // BlockedFloydWarshallSolver on the dense n x n matrix
+    Dijkstra,      // one Dijkstra per source, non-negative weights only
+    Johnson        // Bellman-Ford potentials, then one Dijkstra per source on the reweighted graph
+};
+
+/**
+ * @brief Distances from every vertex of sources (rows) to every vertex of targets (columns), row-major.
+ * inf = no path, negInf = a path through a negative cycle, as in FloydWarshallSolver.
+ */
+struct DistanceMatrix
+{
+    static constexpr int inf{std::numeric_limits<int>::max()};
+    static constexpr int negInf{std::numeric_limits<int>::min()};
+
+    std::vector<int> sources;
+    std::vector<int> targets;
+    std::vector<int> distances;
+    DistanceMatrixStrategy strategy{}; // the one that produced the matrix, never Automatic
+
+    int at(std::size_t i, std::size_t j) const noexcept { return distances[i * targets.size() + j]; }
+    std::span<const int> row(std::size_t i) const noexcept { return {distances.data() + i * targets.size(), targets.size()}; }
+};
+
+/**
+ * @brief Picks the cheaper of Floyd–Warshall and repeated Dijkstra (Johnson with negative weights) by a
+ *        rough cost model:
+ *   Floyd–Warshall  n³ / 8       (the SIMD min-plus kernel does several relaxations per instruction),
+ *                                 only while the two n x n tables fit in maxFloydWarshallVertices
+ *   Dijkstra        |S| * (m + n log n) * 4
+ *   Johnson         Dijkstra + m * sqrt(n) for the Bellman-Ford potentials (queue based, far below n * m
+ *                   on typical inputs)
+ * Floyd–Warshall wins on small or dense graphs or when almost every vertex is a source, repeated Dijkstra
+ * on large sparse ones.
+ */
+inline constexpr int maxFloydWarshallVertices{8192}; // 2 * 8192² ints = 512 MB
+
+inline DistanceMatrixStrategy chooseDistanceMatrixStrategy(CSRGraphView graph, std::size_t numberOfSources)
+{
+    const double n{static_cast<double>(graph.size())}, m{static_cast<double>(graph.numberOfEdges)};
+    const double s{static_cast<double>(numberOfSources)};
+
+    bool negative{false};
+    for (int e{}; e < graph.numberOfEdges && !negative; ++e) negative = graph.weight(e) < 0;
+
+    double repeated{s * (m + n * std::log2(n + 2)) * 4};
+    if (negative) repeated += m * std::sqrt(n);
+    double floydWarshall{graph.size() <= maxFloydWarshallVertices ? n * n * n / 8 : std::numeric_limits<double>::infinity()};
+
+    if (floydWarshall <= repeated) return DistanceMatrixStrategy::FloydWarshall;
+    return negative ? DistanceMatrixStrategy::Johnson : DistanceMatrixStrategy::Dijkstra;
+}
+
+namespace detail
+{
+    // vertices reachable from a set of start vertices, a BFS whose buffers are reused between calls
+    class Reachability
+    {
+    public:
+        explicit Reachability(int n) : stamp(n, 0) { }
+
+        template <typename Starts>
+        void run(CSRGraphView graph, const Starts& starts)
+        {
+            if (++epoch == 0) {
+                std::fill(stamp.begin(), stamp.end(), 0);
+                epoch = 1;
+            }
+            frontier.clear();
+            for (int v : starts) visit(v);
+
+            for (std::size_t head{}; head < frontier.size(); ++head) {
+                for (int w : graph.neighbors(frontier[head])) visit(w);
+            }
+        }
+
+        bool reached(int v) const noexcept { return stamp[v] == epoch; }
+        const std::vector<int>& vertices() const noexcept { return frontier; }
+
+    private:
+        void visit(int v)
+        {
+            if (stamp[v] == epoch) return;
+            stamp[v] = epoch;
+            frontier.push_back(v);
+        }
+
+        std::vector<std::uint32_t> stamp;
+        std::uint32_t epoch{};
+        std::vector<int> frontier; // visit order
+    };
+
+    inline void checkVertices(CSRGraphView graph, std::span<const int> vertices)
+    {
+        for (int v : vertices) {
+            if (v < 0 || v >= graph.size()) throw std::out_of_range("Vertex outside [0,V)");
+        }
+    }
+
+    inline void allPairsFloydWarshall(CSRGraphView graph, DistanceMatrix& result, unsigned threads)
+    {
+        const int n{graph.size()};
+        if (n > maxFloydWarshallVertices) throw std::invalid_argument("Graph is too large for Floyd-Warshall");
+
+        // dense matrix, the lightest of parallel edges, 0 on the diagonal unless a self-loop is negative
+        std::vector<int> matrix(static_cast<std::size_t>(n) * n, DistanceMatrix::inf);
+        for (int u{}; u < n; ++u) {
+            matrix[static_cast<std::size_t>(u) * n + u] = 0;
+            for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e) {
+                int& cell{matrix[static_cast<std::size_t>(u) * n + graph.target(e)]};
+                cell = std::min(cell, graph.weight(e));
+            }
+        }
+
+        BlockedFloydWarshallSolver solver{n, matrix.data(), threads};
+        solver.solve();
+
+        for (std::size_t i{}; i < result.sources.size(); ++i) {
+            for (std::size_t j{}; j < result.targets.size(); ++j) {
+                result.distances[i * result.targets.size() + j] = solver.getShortestPath(result.sources[i], result.targets[j]);
+            }
+        }
+    }
+
+    // one Dijkstra per source on graph; distances are shifted by potential(t) - potential(s) (Johnson)
+    inline void repeatedDijkstra(CSRGraphView graph, DistanceMatrix& result, unsigned threads, std::span<const int> potential = {})
+    {
+        std::vector<std::unique_ptr<DijkstraQuery>> queries(threads); // one per thread, buffers reused
+        parallelFor(result.sources.size(), threads, [&](std::size_t i, unsigned t) {
+            if (!queries[t]) queries[t] = std::make_unique<DijkstraQuery>(graph);
+            DijkstraQuery& query{*queries[t]};
+
+            int s{result.sources[i]};
+            query.runToTargets(s, result.targets);
+            for (std::size_t j{}; j < result.targets.size(); ++j) {
+                int target{result.targets[j]}, d{query.distance(target)};
+                if (d != DijkstraQuery::inf && !potential.empty()) d += potential[target] - potential[s];
+                result.distances[i * result.targets.size() + j] = d;
+            }
+        });
+    }
+
+    /**
+     * Johnson's algorithm with FloydWarshallSolver's negative cycle semantics.
+     *
+     * A negative cycle lies inside one strongly connected component, and (s, t) is negInf exactly when s
+     * reaches such a component and t is reachable from it. Those components are found by a queue-based
+     * Bellman-Ford restricted to each component. Every other pair only has paths that avoid them, so the
+     * potentials and the Dijkstra runs use the graph without those components, where no negative cycle is
+     * left; a reachability pass per source then marks the negInf pairs.
+     */
+    inline void johnson(CSRGraphView graph, DistanceMatrix& result, unsigned threads)
+    {
+        const int n{graph.size()};
+        ParallelSCC scc{graph, threads};
+        const std::vector<int>& component{scc.getComponentIds()};
+
+        // queue-based Bellman-Ford from a virtual source with a 0-arc to every vertex of vertices; false if
+        // a negative cycle is found: a shortest path would need as many arcs as there are vertices
+        std::vector<long long> potential(n, 0);
+        std::vector<int> arcs(n, 0);
+        std::vector<char> queued(n, 0);
+        auto bellmanFord = [&](std::span<const int> vertices, auto&& allowed) {
+            std::deque<int> queue;
+            for (int v : vertices) {
+                potential[v] = 0;
+                arcs[v] = 0;
+                queued[v] = 1;
+                queue.push_back(v);
+            }
+            const int limit{static_cast<int>(vertices.size())};
+            while (!queue.empty()) {
+                int u{queue.front()};
+                queue.pop_front();
+                queued[u] = 0;
+                for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e) {
+                    int v{graph.target(e)};
+                    if (!allowed(v) || potential[u] + graph.weight(e) >= potential[v]) continue;
+
+                    potential[v] = potential[u] + graph.weight(e);
+                    if ((arcs[v] = arcs[u] + 1) >= limit) {
+                        for (int w : queue) queued[w] = 0; // leave queued all 0 for the next call
+                        return false;
+                    }
+                    if (!queued[v]) {
+                        queued[v] = 1;
+                        queue.push_back(v);
+                    }
+                }
+            }
+            return true;
+        };
+
+        // components with a negative cycle
+        std::vector<char> negative(n, 0);
+        std::vector<int> negativeVertices;
+        for (int c{}; c < scc.componentCount(); ++c) {
+            std::span<const int> members{scc.members(c)};
+            bool selfLoop{false};
+            for (int e{graph.firstEdge(members[0])}; e < graph.lastEdge(members[0]); ++e) {
+                selfLoop = selfLoop || (graph.target(e) == members[0] && graph.weight(e) < 0);
+            }
+            if (members.size() == 1 && !selfLoop) continue;
+
+            if (selfLoop || !bellmanFord(members, [&](int v) { return component[v] == c; })) {
+                for (int v : members) negative[v] = 1;
+                negativeVertices.insert(negativeVertices.end(), members.begin(), members.end());
+            }
+        }
+
+        // potentials and the reweighted graph without those components
+        std::vector<int> rest;
+        for (int v{}; v < n; ++v) {
+            if (!negative[v]) rest.push_back(v);
+        }
+        if (!bellmanFord(rest, [&](int v) { return !negative[v]; })) throw std::logic_error("Negative cycle outside its component");
+
+        std::vector<int> shift(n, 0);
+        for (int v : rest) shift[v] = static_cast<int>(potential[v]);
+
+        std::vector<std::tuple<int, int, int>> edges;
+        edges.reserve(graph.numberOfEdges);
+        for (int u : rest) {
+            for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e) {
+                int v{graph.target(e)};
+                if (!negative[v]) edges.push_back({u, v, static_cast<int>(shift[u] + graph.weight(e) - shift[v])});
+            }
+        }
+        CSRGraph reweighted{CSRGraph::fromEdges(n, edges)};
+
+        repeatedDijkstra(reweighted.view(), result, threads, shift);
+        if (negativeVertices.empty()) return;
+
+        // negInf: s reaches a negative component, t is reachable from one that s reaches
+        std::vector<std::unique_ptr<Reachability>> scratch(threads);
+        parallelFor(result.sources.size(), threads, [&](std::size_t i, unsigned t) {
+            if (!scratch[t]) scratch[t] = std::make_unique<Reachability>(n);
+            Reachability& reach{*scratch[t]};
+
+            reach.run(graph, std::span<const int>{&result.sources[i], 1});
+            std::vector<int> entered;
+            for (int v : reach.vertices()) {
+                if (negative[v]) entered.push_back(v);
+            }
+            if (entered.empty()) return;
+
+            reach.run(graph, entered);
+            for (std::size_t j{}; j < result.targets.size(); ++j) {
+                if (reach.reached(result.targets[j])) result.distances[i * result.targets.size() + j] = DistanceMatrix::negInf;
+            }
+        });
+    }
+}
+
+/**
+ * @brief Many-to-many shortest path distances on a CSR graph.
+ *
+ * Takes any subsets of sources and targets (an empty targets list means all vertices) and runs the
+ * strategy chosen by chooseDistanceMatrixStrategy, or the one given:
+ *   - FloydWarshall: the tiled, multithreaded solver on the dense matrix built from the graph,
+ *   - Dijkstra: the sources in parallel, one reusable DijkstraQuery per thread, each run stopping once all
+ *     targets are settled,
+ *   - Johnson: for negative weights, reweighted Dijkstra as above.
+ * All three give the same matrix, including negInf for pairs with a path through a negative cycle.
+ *
+ * @param threads worker threads, 0 means all hardware threads
+ * @throws std::invalid_argument for Dijkstra on negative weights, or Floyd–Warshall above maxFloydWarshallVertices
+ */
+inline DistanceMatrix distanceMatrix(CSRGraphView graph, std::span<const int> sources, std::span<const int> targets = {},
+                                     DistanceMatrixStrategy strategy = DistanceMatrixStrategy::Automatic, unsigned threads = 0)
+{
+    detail::checkVertices(graph, sources);
+    detail::checkVertices(graph, targets);
+    if (threads == 0) threads = defaultThreadCount();
+
+    DistanceMatrix result;
+    result.sources.assign(sources.begin(), sources.end());
+    if (targets.empty()) {
+        result.targets.resize(graph.size());
+        for (int v{}; v < graph.size(); ++v) result.targets[v] = v;
+    } else {
+        result.targets.assign(targets.begin(), targets.end());
+    }
+    result.distances.assign(result.sources.size() * result.targets.size(), DistanceMatrix::inf);
+    if (result.distances.empty()) {
+        result.strategy = strategy == DistanceMatrixStrategy::Automatic ? DistanceMatrixStrategy::Dijkstra : strategy;
+        return result;
+    }
+
+    if (strategy == DistanceMatrixStrategy::Automatic) strategy = chooseDistanceMatrixStrategy(graph, sources.size());
+    result.strategy = strategy;
+
+    switch (strategy) {
+    case DistanceMatrixStrategy::FloydWarshall:
+        detail::allPairsFloydWarshall(graph, result, threads);
+        break;
+    case DistanceMatrixStrategy::Dijkstra:
+        for (int e{}; e < graph.numberOfEdges; ++e) {
+            if (graph.weight(e) < 0) throw std::invalid_argument("Negative edge weights need Johnson or Floyd-Warshall");
+        }
+        detail::repeatedDijkstra(graph, result, threads);
+        break;
+    default:
+        detail::johnson(graph, result, threads);
+        break;
+    }
+
+    return result;
+}
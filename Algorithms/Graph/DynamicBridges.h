@@ -0,0 +1,294 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <unordered_map>
+#include "CSRGraph.h"
+#include "Biconnectivity.h"
+#include "UndirectedEdges.h"
+
+/**
+ * @class DynamicBridges
+ *
+ * @brief Bridges and 2-edge-connectivity of an undirected multigraph under edge insertions and deletions.
+ *
+ * ## Insertions: union-find over the 2-edge-connected components and the bridge forest
+ * The 2-edge-connected components (2ECCs) are the sets of a union-find, and contracting them leaves a
+ * forest whose edges are the bridges. Every 2ECC representative keeps its parent in that forest, and a
+ * second union-find over the representatives tracks the trees (connected components) with their sizes.
+ * An edge a - b
+ *   - inside one 2ECC changes nothing,
+ *   - between two trees is a new bridge: the smaller tree is rerooted at a (parent pointers reversed along
+ *     the path) and hung below b, so a vertex is rerooted O(log n) times in total,
+ *   - between two 2ECCs of one tree closes a cycle: the forest path a .. lca .. b, found by walking up from
+ *     both sides alternately, collapses into one 2ECC and all its bridges stop being bridges.
+ * That is O(log n) amortized per insertion, plus the union-find finds.
+ *
+ * ## Deletions: batched rebuilds
+ * Deleting an edge can split a 2ECC, which union-find can't undo. removeEdge only updates the edge
+ * multiset and marks the structure stale; the next query (or rebuild()) recomputes everything in one go
+ * with Biconnectivity (in parallel with BiconnectivityOptions::parallel) and then replays the bridges as
+ * insertions. A burst of link failures between two queries costs one rebuild, and insertions while stale
+ * just go into the multiset.
+ *
+ * ## Queries
+ * isBridge(u, v) is a hash lookup of the multiplicity of u - v plus two finds: an existing edge is a bridge
+ * exactly when its endpoints are in different 2ECCs (then it is the only u - v edge). Paths are compressed,
+ * so between updates a query touches a handful of words; on a large graph each of them is a cache miss, so
+ * the cost is memory latency: 130 to 560 ns per query on the 2M-vertex benchmark in Bridges.cpp, depending
+ * on the machine.
+ */
+class DynamicBridges
+{
+public:
+    explicit DynamicBridges(int numberOfVertices, BiconnectivityOptions rebuildOptions = {})
+        : n{numberOfVertices}, options{rebuildOptions}
+    {
+        if (n < 0) throw std::invalid_argument("Number of vertices should be >= 0");
+        reset();
+    }
+
+    // starts from the bridges the static solver finds in an undirected graph (two arcs per edge)
+    explicit DynamicBridges(CSRGraphView undirectedGraph, BiconnectivityOptions rebuildOptions = {})
+        : n{undirectedGraph.size()}, options{rebuildOptions}
+    {
+        std::vector<int> mate{pairUndirectedArcs(undirectedGraph, options.threads)};
+        for (int e{}; e < undirectedGraph.numberOfEdges; ++e) {
+            if (e < mate[e]) ++multiplicity[key(undirectedGraph.target(mate[e]), undirectedGraph.target(e))];
+        }
+        edgeCount = undirectedGraph.numberOfEdges / 2;
+        build(undirectedGraph);
+    }
+
+    int size() const noexcept { return n; }
+    int numberOfEdges() const noexcept { return edgeCount; }
+    bool isStale() const noexcept { return stale; }
+
+    void addEdge(int u, int v)
+    {
+        check(u);
+        check(v);
+        ++multiplicity[key(u, v)];
+        ++edgeCount;
+        if (!stale) link(u, v);
+    }
+
+    // removes one u - v edge, false if there is none; the structure is rebuilt at the next query
+    bool removeEdge(int u, int v)
+    {
+        check(u);
+        check(v);
+        auto it{multiplicity.find(key(u, v))};
+        if (it == multiplicity.end()) return false;
+
+        if (--it->second == 0) multiplicity.erase(it);
+        --edgeCount;
+        stale = true;
+        return true;
+    }
+
+    // applies the pending deletions now instead of at the next query
+    void rebuild()
+    {
+        std::vector<std::pair<int, int>> edges;
+        edges.reserve(edgeCount);
+        for (auto [k, count] : multiplicity) {
+            for (int i{}; i < count; ++i) edges.push_back({static_cast<int>(k >> 32), static_cast<int>(k & 0xffffffffu)});
+        }
+        CSRGraph graph{CSRGraph::fromEdges(n, edges, true/*undirected*/)};
+        build(graph.view());
+    }
+
+    bool isBridge(int u, int v)
+    {
+        refresh();
+        check(u);
+        check(v);
+        return multiplicity.contains(key(u, v)) && component(u) != component(v);
+    }
+
+    bool twoEdgeConnected(int u, int v)
+    {
+        refresh();
+        check(u);
+        check(v);
+        return component(u) == component(v);
+    }
+
+    bool connected(int u, int v)
+    {
+        refresh();
+        check(u);
+        check(v);
+        return tree(u) == tree(v);
+    }
+
+    int bridgeCount()
+    {
+        refresh();
+        return bridges;
+    }
+
+    // the bridges as (smaller, larger) endpoint pairs, in no particular order
+    std::vector<std::pair<int, int>> getBridges()
+    {
+        refresh();
+        std::vector<std::pair<int, int>> result;
+        for (auto [k, count] : multiplicity) {
+            int u{static_cast<int>(k >> 32)}, v{static_cast<int>(k & 0xffffffffu)};
+            if (component(u) != component(v)) result.push_back({u, v});
+        }
+        return result;
+    }
+
+private:
+    static std::uint64_t key(int u, int v) noexcept
+    {
+        if (u > v) std::swap(u, v);
+        return (static_cast<std::uint64_t>(u) << 32) | static_cast<std::uint32_t>(v);
+    }
+
+    void check(int v) const
+    {
+        if (v < 0 || v >= n) throw std::out_of_range("Vertex is out of range");
+    }
+
+    void refresh()
+    {
+        if (stale) rebuild();
+    }
+
+    void reset()
+    {
+        twoEdge.resize(n);
+        trees.resize(n);
+        treeSize.assign(n, 1);
+        forestParent.assign(n, -1);
+        lastVisit.assign(n, 0);
+        for (int v{}; v < n; ++v) twoEdge[v] = trees[v] = v;
+        bridges = 0;
+        visit = 0;
+        stale = false;
+    }
+
+    // the 2ECCs are the blocks of the static solution glued along their non-bridge edges, the bridges are
+    // then linked one by one, each joining two trees
+    void build(CSRGraphView graph)
+    {
+        reset();
+        Biconnectivity bcc{graph, options};
+        for (int e{}; e < graph.numberOfEdges; ++e) {
+            int u{graph.target(bcc.mates()[e])}, v{graph.target(e)};
+            if (e > bcc.mates()[e] || bcc.isBridge(e)) continue;
+            int a{component(u)}, b{component(v)};
+            if (a != b) twoEdge[a] = b;
+        }
+        for (int b : bcc.getBridges()) link(graph.target(bcc.mates()[b]), graph.target(b));
+    }
+
+    int component(int v)
+    {
+        int root{v};
+        while (twoEdge[root] != root) root = twoEdge[root];
+        while (twoEdge[v] != root) v = std::exchange(twoEdge[v], root);
+        return root;
+    }
+
+    // the tree of the 2ECC of v
+    int tree(int v)
+    {
+        int root{component(v)};
+        while (trees[root] != root) root = trees[root];
+        for (v = component(v); trees[v] != root;) v = std::exchange(trees[v], root);
+        return root;
+    }
+
+    // makes the 2ECC of v the root of its tree
+    void reroot(int v)
+    {
+        v = component(v);
+        const int root{v};
+        int child{-1};
+        while (v != -1) {
+            int parent{forestParent[v] == -1 ? -1 : component(forestParent[v])};
+            forestParent[v] = child;
+            trees[v] = root;
+            child = v;
+            v = parent;
+        }
+        treeSize[root] = treeSize[child]; // child is the old root now
+    }
+
+    void link(int u, int v)
+    {
+        int a{component(u)}, b{component(v)};
+        if (a == b) return;
+
+        int ta{tree(a)}, tb{tree(b)};
+        if (ta != tb) {
+            ++bridges;
+            if (treeSize[ta] > treeSize[tb]) {
+                std::swap(a, b);
+                std::swap(ta, tb);
+            }
+            const int size{treeSize[ta]};
+            reroot(a);
+            forestParent[a] = trees[a] = b;
+            treeSize[tb] += size;
+        } else {
+            collapsePath(a, b);
+        }
+    }
+
+    // merges the 2ECCs on the forest path a .. b into one, the bridges on it are gone
+    void collapsePath(int a, int b)
+    {
+        ++visit;
+        pathA.clear();
+        pathB.clear();
+        int lca{-1};
+        while (lca == -1) {
+            if (a != -1) {
+                a = component(a);
+                pathA.push_back(a);
+                if (lastVisit[a] == visit) lca = a;
+                lastVisit[a] = visit;
+                a = forestParent[a];
+            }
+            if (lca == -1 && b != -1) {
+                b = component(b);
+                pathB.push_back(b);
+                if (lastVisit[b] == visit) lca = b;
+                lastVisit[b] = visit;
+                b = forestParent[b];
+            }
+        }
+
+        for (const auto* path : {&pathA, &pathB}) {
+            for (int v : *path) {
+                if (v == lca) break;
+                twoEdge[v] = lca;
+                --bridges;
+            }
+        }
+    }
+
+private:
+    int n{};
+    BiconnectivityOptions options;
+    std::unordered_map<std::uint64_t, int> multiplicity; // (min, max) endpoints -> number of parallel edges
+    int edgeCount{};
+    bool stale{false};
+
+    std::vector<int> twoEdge;      // union-find over the 2ECCs
+    std::vector<int> trees;        // union-find over 2ECC representatives, one set per tree of the bridge forest
+    std::vector<int> treeSize;     // 2ECCs in the tree, valid at tree roots
+    std::vector<int> forestParent; // parent 2ECC in the bridge forest (any vertex of it), -1 at a root
+    std::vector<int> lastVisit;    // path walk marks for collapsePath
+    std::vector<int> pathA;
+    std::vector<int> pathB;
+    int visit{};
+    int bridges{};
+};
@@ -0,0 +1,362 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "IterativeDFS.h"
+#include "UndirectedEdges.h"
+#include "../Common/ConcurrentUnionFind.h"
+#include "../Common/Parallel.h"
+
+struct EulerianOptions
+{
+    bool undirected{false}; // the view stores every edge in both directions (CSRGraph::fromEdges(..., true))
+    bool splice{false};     // sub-circuits built in parallel and spliced, instead of one Hierholzer walk
+    unsigned threads{0};    // 0 means all hardware threads
+};
+
+/**
+ * @class EulerTour
+ *
+ * @brief Eulerian paths and cycles of directed and undirected multigraphs on a CSR view, without recursion.
+ *
+ * ## Existence
+ * Checked in parallel over vertex ranges: the degree conditions (directed: in == out everywhere except for at
+ * most one start with out = in + 1 and one end with in = out + 1; undirected: zero or two odd vertices) and
+ * connectivity, every vertex with an edge in one weakly connected component. The components come from a
+ * ConcurrentUnionFind over all arcs. The start is the start (odd) vertex, else the smallest vertex with an edge.
+ *
+ * ## Hierholzer
+ * One walk on IterativeDFS: its per-vertex cursors consume every arc once, and a vertex is appended when
+ * it is exited. An undirected edge is stored as two arcs, the walk marks both of them used (mate(e) is the
+ * other arc of the edge of e, matched once up front by pairUndirectedArcs).
+ *
+ * ## Splicing (options.splice)
+ * For very large graphs the tour is built from independent local decisions. A path is first closed into
+ * a circuit with a virtual edge end -> start, then:
+ *   1. Pairing. At every vertex each arriving arc is paired with a leaving one (directed: the arrivals claim
+ *      the out-arcs of their head through an atomic cursor; undirected: the edge ends at a vertex are paired
+ *      two by two). Following the pairs from any arc is a closed walk, so the arcs fall apart into
+ *      sub-circuits.
+ *   2. Labeling. Threads walk the sub-circuits from their arc ranges and claim arcs with a CAS; a walk that
+ *      runs into an arc claimed by another walk unites the two labels (ConcurrentUnionFind over arcs).
+ *      Undirected sub-circuits are found in both orientations, the two are united through mate().
+ *   3. Splicing. At a vertex where two different sub-circuits meet, exchanging their pairs there merges
+ *      them into one. Vertex ranges are spliced in parallel, and a pair is only exchanged when unite()
+ *      reports that it merged two sets. The exchanges form a spanning forest of the sub-circuits, so no
+ *      exchange splits a circuit again, whatever the order, and a connected graph ends with one circuit.
+ *   4. The circuit is read by following the pairs from the start (the only sequential pass), and a path
+ *      drops the virtual edge.
+ * The result is a valid tour, but with several threads the choice among the valid ones depends on the
+ * scheduling. Memory: 16 bytes per arc on top of the graph, against the frame stack (8 bytes per arc in the
+ * worst case) of the single walk.
+ *
+ * Edge and vertex ids are ints, as in CSRGraph: up to 2^31 - 3 stored arcs.
+ */
+class EulerTour
+{
+public:
+    explicit EulerTour(CSRGraphView g, EulerianOptions options = {})
+        : graph{g}, n{g.size()}, undirected{options.undirected}, splicing{options.splice},
+          threadCount{options.threads == 0 ? defaultThreadCount() : options.threads}
+    {
+        if (undirected) mates = pairArcs(graph, threadCount);
+        check();
+    }
+
+    bool exists() const noexcept { return possible; }
+    bool isCycle() const noexcept { return possible && end == -1; }
+    int startVertex() const noexcept { return possible ? start : -1; }
+
+    // arcs of a directed graph, edges of an undirected one (each stored twice)
+    std::size_t edgeCount() const noexcept
+    {
+        return static_cast<std::size_t>(undirected ? graph.numberOfEdges / 2 : graph.numberOfEdges);
+    }
+
+    // the other arc of the undirected edge of arc e
+    int mate(int e) const noexcept { return mates[e]; }
+
+    // vertices of an Eulerian path (edgeCount() + 1 of them, front == back for a cycle), empty if there is none
+    std::vector<int> path() const
+    {
+        if (!possible) return {};
+        if (graph.numberOfEdges == 0) return {start};
+        return splicing ? splicedPath() : walkPath();
+    }
+
+    // see pairUndirectedArcs (UndirectedEdges.h)
+    static std::vector<int> pairArcs(CSRGraphView g, unsigned threads = 0)
+    {
+        return pairUndirectedArcs(g, threads);
+    }
+
+private:
+    // degree conditions and connectivity, in parallel over vertex ranges
+    void check()
+    {
+        if (n == 0) return;
+
+        std::vector<std::atomic<int>> inDegree(undirected ? 0 : n);
+        ConcurrentUnionFind components(n);
+        parallelForChunks(n, threadCount, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (int u{static_cast<int>(begin)}; u < static_cast<int>(end); ++u) {
+                for (int v : graph.neighbors(u)) {
+                    if (!undirected) inDegree[v].fetch_add(1, std::memory_order_relaxed);
+                    components.unite(u, v);
+                }
+            }
+        }, minChunk);
+
+        struct Tally
+        {
+            int starts{}, ends{}, odd{};
+            int start{-1}, end{-1}, first{-1};
+            bool balanced{true};
+        };
+        std::vector<Tally> tallies(threadCount);
+        parallelForChunks(n, threadCount, [&](std::size_t begin, std::size_t end, unsigned t) {
+            Tally& tally{tallies[t]};
+            for (int u{static_cast<int>(begin)}; u < static_cast<int>(end); ++u) {
+                const int out{graph.degree(u)};
+                const int in{undirected ? out : inDegree[u].load(std::memory_order_relaxed)};
+                if (out + in > 0 && tally.first == -1) tally.first = u;
+
+                if (undirected) {
+                    if (out % 2 == 0) continue;
+                    if (++tally.odd == 1) tally.start = u;
+                    else if (tally.odd == 2) tally.end = u;
+                } else if (out == in + 1) {
+                    if (++tally.starts == 1) tally.start = u;
+                } else if (in == out + 1) {
+                    if (++tally.ends == 1) tally.end = u;
+                } else if (in != out) {
+                    tally.balanced = false;
+                }
+            }
+        }, minChunk);
+
+        // combined in vertex order, so the start doesn't depend on the thread count
+        Tally total;
+        for (const Tally& tally : tallies) {
+            total.balanced = total.balanced && tally.balanced;
+            total.starts += tally.starts;
+            total.ends += tally.ends;
+            total.odd += tally.odd;
+            if (total.first == -1) total.first = tally.first;
+
+            if (!undirected) {
+                if (total.start == -1) total.start = tally.start;
+                if (total.end == -1) total.end = tally.end;
+                continue;
+            }
+            for (int v : {tally.start, tally.end}) { // the first two odd vertices
+                if (v == -1) continue;
+                if (total.start == -1) total.start = v;
+                else if (total.end == -1) total.end = v;
+            }
+        }
+
+        if (!total.balanced) return;
+        if (undirected && total.odd != 0 && total.odd != 2) return;
+        if (!undirected && !((total.starts == 0 && total.ends == 0) || (total.starts == 1 && total.ends == 1))) return;
+
+        if (total.start == -1) {
+            start = total.first == -1 ? 0 : total.first;
+            end = -1;
+        } else {
+            start = total.start;
+            end = total.end;
+        }
+
+        // every vertex with an edge in the component of the start
+        std::atomic<bool> connected{true};
+        const int root{components.find(start)};
+        parallelForChunks(n, threadCount, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (int u{static_cast<int>(begin)}; u < static_cast<int>(end); ++u) {
+                bool hasEdge{graph.degree(u) > 0 || (!undirected && inDegree[u].load(std::memory_order_relaxed) > 0)};
+                if (hasEdge && components.find(u) != root) connected.store(false, std::memory_order_relaxed);
+            }
+        }, minChunk);
+
+        possible = connected.load();
+    }
+
+    // Hierholzer: always follow the next unused arc, a vertex is finished once all its arcs are used
+    struct DirectedVisitor : DFSVisitor
+    {
+        std::vector<int>& path;
+
+        void exit(int u) { path.push_back(u); }
+    };
+
+    struct UndirectedVisitor : DFSVisitor
+    {
+        std::vector<int>& path;
+        std::vector<std::uint8_t>& used;
+        const std::vector<int>& mates;
+
+        bool edge(int, int, int e)
+        {
+            if (used[e]) return false; // already walked from the other end
+            used[e] = used[mates[e]] = 1;
+            return true;
+        }
+
+        void exit(int u) { path.push_back(u); }
+    };
+
+    std::vector<int> walkPath() const
+    {
+        std::vector<int> path;
+        path.reserve(edgeCount() + 1);
+        IterativeDFS dfs{graph};
+
+        if (undirected) {
+            std::vector<std::uint8_t> used(graph.numberOfEdges, 0);
+            UndirectedVisitor visitor{{}, path, used, mates};
+            dfs.run(start, visitor);
+        } else {
+            DirectedVisitor visitor{{}, path};
+            dfs.run(start, visitor);
+        }
+
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    std::vector<int> splicedPath() const
+    {
+        const int m{graph.numberOfEdges};
+        const bool open{end != -1};
+
+        // arcs [0, m) and, for a path, the virtual edge: directed m = end -> start, undirected m = start -> end
+        // and m + 1 = end -> start
+        const int arcs{m + (open ? (undirected ? 2 : 1) : 0)};
+        auto head = [&](int e) {
+            if (e < m) return graph.target(e);
+            return e == m && undirected ? end : start;
+        };
+        // the slot-th arc leaving v, the virtual arc of v after the real ones
+        auto outArc = [&](int v, int slot) {
+            if (slot < graph.degree(v)) return graph.firstEdge(v) + slot;
+            return undirected && v == end ? m + 1 : m;
+        };
+        auto slots = [&](int v) {
+            if (!open) return graph.degree(v);
+            bool virtualTail{undirected ? v == start || v == end : v == end};
+            return graph.degree(v) + (virtualTail ? 1 : 0);
+        };
+        auto mateOf = [&](int e) { return e < m ? mates[e] : (e == m ? m + 1 : m); };
+
+        // 1. pairing: succ[e] is the arc taken after arriving through e
+        std::vector<int> succ(arcs), into(undirected ? 0 : arcs); // into[f]: the arc paired with f (directed)
+        std::vector<int> partner(undirected ? arcs : 0);            // the paired end at the same vertex (undirected)
+        if (undirected) {
+            parallelForChunks(n, threadCount, [&](std::size_t begin, std::size_t last, unsigned) {
+                for (int v{static_cast<int>(begin)}; v < static_cast<int>(last); ++v) {
+                    for (int s{}; s + 1 < slots(v); s += 2) {
+                        int a{outArc(v, s)}, b{outArc(v, s + 1)};
+                        partner[a] = b;
+                        partner[b] = a;
+                    }
+                }
+            }, minChunk);
+        } else {
+            std::vector<std::atomic<int>> cursor(n);
+            parallelForChunks(n, threadCount, [&](std::size_t begin, std::size_t last, unsigned) {
+                for (int u{static_cast<int>(begin)}; u < static_cast<int>(last); ++u) {
+                    auto arrive = [&](int e) {
+                        int v{head(e)};
+                        int f{outArc(v, cursor[v].fetch_add(1, std::memory_order_relaxed))};
+                        succ[e] = f;
+                        into[f] = e;
+                    };
+                    for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e) arrive(e);
+                    if (open && u == end) arrive(m);
+                }
+            }, minChunk);
+        }
+        // undirected: arriving through e is leaving its head through the partner of the other end
+        auto next = [&](int e) { return undirected ? partner[mateOf(e)] : succ[e]; };
+
+        // 2. labeling: every arc gets the id of the walk that claimed it, meeting walks are united
+        std::vector<std::atomic<int>> label(arcs);
+        for (auto& l : label) l.store(-1, std::memory_order_relaxed);
+        ConcurrentUnionFind circuits(arcs);
+        parallelForChunks(arcs, threadCount, [&](std::size_t begin, std::size_t last, unsigned) {
+            for (int a{static_cast<int>(begin)}; a < static_cast<int>(last); ++a) {
+                int expected{-1};
+                if (!label[a].compare_exchange_strong(expected, a, std::memory_order_relaxed)) continue;
+                for (int e{next(a)};; e = next(e)) {
+                    expected = -1;
+                    if (label[e].compare_exchange_strong(expected, a, std::memory_order_relaxed)) continue;
+                    if (expected != a) circuits.unite(a, expected);
+                    break;
+                }
+            }
+        }, minChunk);
+        if (undirected) { // both orientations of a closed trail
+            parallelFor(arcs, threadCount, [&](std::size_t e, unsigned) {
+                circuits.unite(label[e].load(std::memory_order_relaxed), label[mateOf(static_cast<int>(e))].load(std::memory_order_relaxed));
+            }, minChunk);
+        }
+        auto circuitOf = [&](int e) { return label[e].load(std::memory_order_relaxed); };
+
+        // 3. splicing: at every vertex, merge the circuit of the first pair with each other one passing by
+        parallelForChunks(n, threadCount, [&](std::size_t begin, std::size_t last, unsigned) {
+            for (int v{static_cast<int>(begin)}; v < static_cast<int>(last); ++v) {
+                const int first{slots(v) > 0 ? outArc(v, 0) : -1};
+                for (int s{1}; s < slots(v); ++s) {
+                    if (undirected && s % 2 == 1) continue; // one end per pair
+                    const int f{outArc(v, s)};
+                    if (!circuits.unite(circuitOf(first), circuitOf(f))) continue;
+
+                    if (undirected) {
+                        const int a{partner[first]}, b{partner[f]};
+                        partner[first] = b;
+                        partner[b] = first;
+                        partner[f] = a;
+                        partner[a] = f;
+                    } else {
+                        const int a{into[first]}, b{into[f]};
+                        succ[a] = f;
+                        succ[b] = first;
+                        into[first] = b;
+                        into[f] = a;
+                    }
+                }
+            }
+        }, minChunk);
+
+        // 4. one circuit: read it from the start, a path leaves out the virtual edge
+        std::vector<int> path;
+        path.reserve(edgeCount() + 1);
+        path.push_back(start);
+        if (open) {
+            const int last{undirected ? m + 1 : m}; // arriving at start through the virtual edge
+            for (int e{next(last)}; e != last; e = next(e)) path.push_back(head(e));
+        } else {
+            int e{graph.firstEdge(start)};
+            for (std::size_t i{}; i < edgeCount(); ++i, e = next(e)) path.push_back(head(e));
+        }
+        return path;
+    }
+
+private:
+    static constexpr std::size_t minChunk{1024};
+
+    CSRGraphView graph;
+    int n{};
+    bool undirected{};
+    bool splicing{};
+    unsigned threadCount{};
+    std::vector<int> mates; // undirected only
+
+    bool possible{false};
+    int start{-1};
+    int end{-1}; // the other end of a path, -1 for a cycle
+};
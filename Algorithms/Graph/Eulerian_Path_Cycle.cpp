@@ -1,7 +1,7 @@
 /**
- * @brief Eulerian Path / Cycle Solver for directed graphs.
+ * @brief Eulerian Path / Cycle Solver for directed and undirected graphs.
  *
- * This class finds an Eulerian path or cycle in a directed graph using a modified
+ * This class finds an Eulerian path or cycle in a directed or undirected multigraph using
  * Hierholzer's algorithm. An Eulerian path is a path that visits every edge exactly
  * once. An Eulerian cycle is an Eulerian path that starts and ends at the same vertex.
  *
@@ -11,29 +11,30 @@
  *   exactly one vertex has in-degree = out-degree + 1 (end node), all other vertices
  *   have equal in-degree and out-degree.
  *
- * Undirected Graph Note:
- * - This implementation currently only works for directed graphs.
- * - In an undirected graph:
- *     - Eulerian cycle: All vertices must have even degree.
- *     - Eulerian path: Exactly two vertices have odd degree (start and end), all others even.
- *   Adapting this algorithm for undirected graphs would require tracking edge usage
- *   in DFS to avoid traversing the same edge twice.
+ * Undirected Graph Rules:
+ * - Eulerian cycle: All vertices have even degree.
+ * - Eulerian path: Exactly two vertices have odd degree (start and end), all others even.
+ *
+ * In both cases all vertices with an edge have to be in one (weakly) connected component.
  *
  * Implementation Details:
- * - Graph is stored as an adjacency list (`std::vector<std::vector<int>> graph`).
- * - `inDegree` and `outDegree` vectors track in/out degrees for each vertex.
- * - Hierholzer's algorithm is implemented via a DFS (`dfs` function) using a cloned
- *   outDegree vector to mark edges as visited.
- * - The algorithm checks that all edges are used by comparing the number of edges in
- *   the path with the original number of edges.
- * - Time complexity: O(E), where E is the number of edges.
- * - Space complexity: O(V + E), for the adjacency list, degree arrays, and recursion stack.
+ * - The engine is EulerTour (EulerTour.h), on a CSRGraphView (see CSRGraph.h); the edge list
+ *   constructor builds and owns the CSRGraph.
+ * - pathExists checks the degrees and the connectivity in parallel over vertex ranges
+ *   (a lock-free union-find over all edges).
+ * - Hierholzer's algorithm runs on IterativeDFS (explicit frame stack, see IterativeDFS.h): its per-vertex
+ *   edge cursors mark edges as visited, and a vertex is appended to the path when it is exited.
+ *   Paths of millions of edges don't overflow the call stack. An undirected edge is stored as two
+ *   arcs, and the walk marks both of them as used.
+ * - For very large inputs (e.g. 10^8 edges of a sequence-assembly graph) the splice option builds
+ *   sub-circuits in parallel from local pairings of the edges at every vertex and splices them into
+ *   one circuit; only reading the final circuit is sequential.
+ * - Time complexity: O(V + E), where E is the number of edges.
+ * - Space complexity: O(V + E), for the degree arrays and the frame stack (or the splice arrays).
  *
  * Key Methods:
  * - pathExists(int& source): Checks if an Eulerian path/cycle exists and determines
  *   the start vertex if applicable.
- * - dfs(std::vector<int>& path, std::vector<int>& out, int u): Performs DFS to construct
- *   the Eulerian path.
  * - solve(): Returns the Eulerian path as a vector of vertex indices, empty if none exists.
  *
  * Usage:
@@ -44,99 +45,124 @@
  * if (!path.empty()) {
  *     // Eulerian path found
  * }
+ *
+ * EulerianPathSolver parallel(3, edges, {.undirected = true, .splice = true, .threads = 8});
  * @endcode
  */
 
 #include <iostream>
 #include <vector>
+#include <random>
+#include <chrono>
+#include <string>
 #include <algorithm>
+#include "CSRGraph.h"
+#include "EulerTour.h"
+#include "gtest/gtest.h"
 
 class EulerianPathSolver
 {
-private:
-    bool pathExists(int& source)
-    {
-        int startNodes{}, endNodes{};
-        int possibleStartNode{};
-        for (std::size_t i{}; i < n; ++i) {
-            if (std::abs(inDegree[i] - outDegree[i]) > 1) return false;
-    
-            if (inDegree[i] - outDegree[i] == 1) ++endNodes;
-            else if (outDegree[i] - inDegree[i] == 1) {
-                ++startNodes;
-                source = i;
-            }
-    
-            if (outDegree[i] > 0) possibleStartNode = i;
-        }
-    
-        // if all outs and ins were equal, then it doesn't matter what is the source vertex
-        if (source == -1) source = possibleStartNode;
-        
-        return (startNodes == 0 && endNodes == 0) || (startNodes == 1 && endNodes == 1);
-    }
-    
-    void dfs(std::vector<int>& path, std::vector<int>& out, int u)
-    {
-        while (out[u] > 0) {
-            int index{--out[u]};
-            int v{graph[u][index]};
-            dfs(path, out, v);
-        }
-    
-        path.push_back(u);
-    }
-
 public:
-    EulerianPathSolver(std::size_t numOfVertices, const std::vector<std::pair<int, int>>& edges) : n{numOfVertices}, numberOfEdges{edges.size()}
-    {
-        graph.assign(n, {});
-        inDegree.assign(n, 0);
-        outDegree.assign(n, 0);
-
-        for (auto [u, v] : edges) {
-            graph[u].push_back(v);
-            ++inDegree[v];
-            ++outDegree[u];
-        }
-    }
-
-    std::vector<int> solve()
-    {
-        int source{-1};
-        bool exists{pathExists(source)};
+    explicit EulerianPathSolver(CSRGraphView g, EulerianOptions options = {})
+        : graph{g}, n{static_cast<std::size_t>(g.size())}, euler{g, options}
+    { }
 
-        if (!exists) return {};
+    EulerianPathSolver(std::size_t numOfVertices, const std::vector<std::pair<int, int>>& edges, EulerianOptions options = {})
+        : storage{CSRGraph::fromEdges(static_cast<int>(numOfVertices), edges, options.undirected)}, graph{storage.view()},
+          n{numOfVertices}, euler{graph, options}
+    { }
 
-        std::vector<int> path;
-        auto outClone{outDegree};
-        dfs(path, outClone, source);
+    // graph (and euler) may point into storage, so a copy would view the original's arrays
+    EulerianPathSolver(const EulerianPathSolver&) = delete;
+    EulerianPathSolver& operator=(const EulerianPathSolver&) = delete;
 
-        if (path.empty() || getNumberOfEdges() != path.size() - 1) return {};
-        std::reverse(path.begin(), path.end());
+    /**
+     * @brief Degree conditions and connectivity (checked once, in parallel, on construction).
+     * @param source set to the start vertex of the Eulerian path if there is one
+     */
+    bool pathExists(int& source) const
+    {
+        source = euler.startVertex();
+        return euler.exists();
+    }
 
-        return path;
+    std::vector<int> solve() const
+    {
+        return euler.path();
     }
 
-    std::size_t getNumberOfEdges() const { return numberOfEdges; }
+    // directed arcs, or undirected edges
+    std::size_t getNumberOfEdges() const { return euler.edgeCount(); }
 
     void print()
     {
         for (std::size_t i{}; i < n; ++i) {
             std::cout << "Vertex: " << i << " -> ";
-            for (int v : graph[i]) std::cout << v << ", ";
+            for (int v : graph.neighbors(i)) std::cout << v << ", ";
             std::cout << std::endl;
         }
     }
 
 private:
-    std::vector<std::vector<int>> graph;
-    std::vector<int> inDegree, outDegree;
+    CSRGraph storage; // only used when built from an edge list
+    CSRGraphView graph;
     std::size_t n{};
-    std::size_t numberOfEdges{};
+    EulerTour euler;
 };
 
-void test1()
+// path uses every edge exactly once, in order
+bool isEulerianPath(const std::vector<int>& path, std::vector<std::pair<int, int>> edges)
+{
+    if (path.size() != edges.size() + 1) return false;
+
+    std::sort(edges.begin(), edges.end());
+    std::vector<std::pair<int, int>> used;
+    for (std::size_t i{1}; i < path.size(); ++i) used.push_back({path[i - 1], path[i]});
+    std::sort(used.begin(), used.end());
+
+    return used == edges;
+}
+
+// undirected: every edge used exactly once, in either direction
+bool isUndirectedEulerianPath(const std::vector<int>& path, std::vector<std::pair<int, int>> edges)
+{
+    if (path.size() != edges.size() + 1) return false;
+
+    for (auto& [u, v] : edges) {
+        if (u > v) std::swap(u, v);
+    }
+    std::sort(edges.begin(), edges.end());
+    std::vector<std::pair<int, int>> used;
+    for (std::size_t i{1}; i < path.size(); ++i) used.push_back({std::min(path[i - 1], path[i]), std::max(path[i - 1], path[i])});
+    std::sort(used.begin(), used.end());
+
+    return used == edges;
+}
+
+// a closed random walk on n vertices, repeated: an Eulerian multigraph with self-loops and parallel edges
+std::vector<std::pair<int, int>> randomEulerian(int n, int walks, int length, unsigned seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+
+    std::vector<std::pair<int, int>> edges;
+    int u{vertex(rng)};
+    for (int w{}; w < walks; ++w) {
+        const int first{u};
+        for (int i{1}; i < length; ++i) {
+            int v{vertex(rng)};
+            edges.push_back({u, v});
+            u = v;
+        }
+        edges.push_back({u, first});
+    }
+    std::shuffle(edges.begin(), edges.end(), rng);
+    return edges;
+}
+
+const EulerianOptions walk{}, splice1{.splice = true, .threads = 1}, splice4{.splice = true, .threads = 4};
+
+TEST(EulerianPathSolverTest, Test1)
 {
     std::vector<std::pair<int, int>> edges {
         {1, 2}, {1, 3}, {3, 1}, {2, 2}, {2, 4}, {2, 4}, {4, 3}, {3, 2}, {3, 5}, {6, 3}, {4, 6}, {5, 6}
@@ -145,19 +171,12 @@ void test1()
     EulerianPathSolver solver(7, edges);
     auto path = solver.solve();
 
-    if (path.empty()) {
-        std::cout << "Eulerian Path does not exist" << std::endl;
-        return;
-    }
-
-    std::cout << "The path\n";
-    for (int v : path) std::cout << v << " ";
-    std::cout << std::endl;
-
-    if (path.front() == path.back()) std::cout << "The Eulerian path is also an Eulerian cycle\n";
+    EXPECT_TRUE(isEulerianPath(path, edges));
+    EXPECT_EQ(path.front(), 1);
+    EXPECT_EQ(path.back(), 6);
 }
 
-void test2()
+TEST(EulerianPathSolverTest, Test2)
 {
     std::vector<std::pair<int, int>> edges {
         {0, 1}, {1, 2}, {2, 0}
@@ -166,22 +185,142 @@ void test2()
     EulerianPathSolver solver(3, edges);
     auto path{solver.solve()};
 
-    if (path.empty()) {
-        std::cout << "Eulerian Path does not exist" << std::endl;
-        return;
+    EXPECT_TRUE(isEulerianPath(path, edges));
+    EXPECT_EQ(path.front(), path.back()); // the Eulerian path is also an Eulerian cycle
+}
+
+TEST(EulerianPathSolverTest, NoPath)
+{
+    EulerianPathSolver unbalanced(3, {{0, 1}, {0, 2}});
+    EXPECT_TRUE(unbalanced.solve().empty());
+
+    EulerianPathSolver disconnected(4, {{0, 1}, {1, 0}, {2, 3}, {3, 2}});
+    EXPECT_TRUE(disconnected.solve().empty());
+}
+
+TEST(EulerianPathSolverTest, LongCycleDoesNotOverflowTheStack)
+{
+    const int n{1'000'000};
+    std::vector<std::pair<int, int>> edges;
+    for (int u{}; u < n; ++u) edges.push_back({u, (u + 1) % n});
+
+    EulerianPathSolver solver(n, edges);
+    auto path{solver.solve()};
+
+    EXPECT_EQ(path.size(), static_cast<std::size_t>(n + 1));
+    EXPECT_EQ(path.front(), path.back());
+}
+
+TEST(EulerianPathSolverTest, UndirectedGraphs)
+{
+    // house: a square with a roof, odd vertices 0 and 1
+    std::vector<std::pair<int, int>> house{{0, 1}, {1, 2}, {2, 3}, {3, 0}, {2, 4}, {3, 4}, {0, 2}, {1, 3}};
+    for (EulerianOptions options : {walk, splice1, splice4}) {
+        options.undirected = true;
+        EulerianPathSolver solver(5, house, options);
+        auto path{solver.solve()};
+
+        EXPECT_TRUE(isUndirectedEulerianPath(path, house));
+        EXPECT_EQ(path.front(), 0);
+        EXPECT_EQ(path.back(), 1);
+
+        int source{};
+        EXPECT_TRUE(solver.pathExists(source));
+        EXPECT_EQ(source, 0);
+        EXPECT_EQ(solver.getNumberOfEdges(), house.size());
     }
 
-    std::cout << "The path\n";
-    for (int v : path) std::cout << v << " ";
-    std::cout << std::endl;
+    // the directed cycle of Test2 read both ways, a self-loop and a parallel edge
+    std::vector<std::pair<int, int>> multi{{0, 1}, {1, 2}, {2, 0}, {1, 1}, {2, 3}, {3, 2}};
+    EulerianPathSolver cycle(4, multi, {.undirected = true});
+    auto path{cycle.solve()};
+    EXPECT_TRUE(isUndirectedEulerianPath(path, multi));
+    EXPECT_EQ(path.front(), path.back());
+
+    // Koenigsberg: four odd vertices
+    EulerianPathSolver bridges(4, {{0, 1}, {0, 1}, {0, 2}, {0, 2}, {0, 3}, {1, 3}, {2, 3}}, {.undirected = true});
+    EXPECT_TRUE(bridges.solve().empty());
 
-    if (path.front() == path.back()) std::cout << "The Eulerian path is also an Eulerian cycle\n";
+    EulerianPathSolver disconnected(6, {{0, 1}, {1, 2}, {2, 0}, {3, 4}, {4, 5}, {5, 3}}, {.undirected = true});
+    EXPECT_TRUE(disconnected.solve().empty());
 }
 
-int main()
+TEST(EulerianPathSolverTest, SplicedMatchesWalkOnRandomMultigraphs)
 {
-    std::cout << "----------------test1\n";
-    test1();
-    std::cout << "----------------test2\n";
-    test2();
-}
\ No newline at end of file
+    for (unsigned seed{1}; seed <= 20; ++seed) {
+        int n{static_cast<int>(2 + seed * 7)};
+        std::vector<std::pair<int, int>> edges{randomEulerian(n, 1 + seed % 4, 3 * n, seed)};
+        std::vector<std::pair<int, int>> open(edges.begin() + 1, edges.end()); // drop one edge: a path
+
+        for (EulerianOptions options : {walk, splice1, splice4}) {
+            EulerianPathSolver directed(n, edges, options);
+            EXPECT_TRUE(isEulerianPath(directed.solve(), edges)) << "seed " << seed;
+
+            EulerianPathSolver directedPath(n, open, options);
+            auto path{directedPath.solve()};
+            EXPECT_TRUE(isEulerianPath(path, open)) << "seed " << seed;
+            if (edges[0].first != edges[0].second) {
+                EXPECT_EQ(path.front(), edges[0].second);
+                EXPECT_EQ(path.back(), edges[0].first);
+            }
+
+            options.undirected = true;
+            EulerianPathSolver undirected(n, edges, options);
+            EXPECT_TRUE(isUndirectedEulerianPath(undirected.solve(), edges)) << "seed " << seed;
+
+            EulerianPathSolver undirectedPath(n, open, options);
+            EXPECT_TRUE(isUndirectedEulerianPath(undirectedPath.solve(), open)) << "seed " << seed;
+        }
+    }
+}
+
+TEST(EulerianPathSolverTest, PairArcsRejectsDirectedGraphs)
+{
+    CSRGraph directed{CSRGraph::fromEdges(3, std::vector<std::pair<int, int>>{{0, 1}, {1, 2}, {2, 0}})};
+    EXPECT_THROW(EulerTour(directed.view(), {.undirected = true}), std::invalid_argument);
+
+    CSRGraph undirected{CSRGraph::fromEdges(3, std::vector<std::pair<int, int>>{{0, 1}, {1, 2}, {2, 0}, {1, 1}}, true)};
+    std::vector<int> mate{EulerTour::pairArcs(undirected.view())};
+    for (int e{}; e < undirected.view().numberOfEdges; ++e) {
+        EXPECT_NE(mate[e], e);
+        EXPECT_EQ(mate[mate[e]], e);
+    }
+}
+
+TEST(EulerianPathSolverTest, BenchmarkDeBruijnSequence)
+{
+    // de Bruijn graph B(2, k): vertices are (k - 1)-bit words, an edge per k-bit word; its Eulerian cycle
+    // spells a de Bruijn sequence, every k-bit word exactly once
+    const int k{22};
+    const int n{1 << (k - 1)};
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(2 * n);
+    for (int u{}; u < n; ++u) {
+        for (int bit{}; bit < 2; ++bit) edges.push_back({u, ((u << 1) | bit) & (n - 1)});
+    }
+    CSRGraph graph{CSRGraph::fromEdges(n, edges)};
+
+    for (EulerianOptions options : {walk, splice1, splice4}) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto path{EulerianPathSolver(graph.view(), options).solve()};
+        auto end = std::chrono::high_resolution_clock::now();
+
+        ASSERT_EQ(path.size(), edges.size() + 1);
+        std::vector<bool> seen(2 * n);
+        for (std::size_t i{1}; i < path.size(); ++i) {
+            int word{(path[i - 1] << 1) | (path[i] & 1)};
+            EXPECT_FALSE(seen[word]);
+            seen[word] = true;
+        }
+
+        std::cout << (options.splice ? "spliced, " + std::to_string(options.threads) + " threads" : std::string{"Hierholzer walk"})
+                  << ": " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms for "
+                  << edges.size() << " edges\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,14 @@
 #include <vector>
 #include <iostream>
 #include <limits>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+#include <cstdlib>
+#include "BlockedFloydWarshall.h"
+#include "DistanceMatrix.h"
+#include "../Common/MinPlus.h"
+#include "gtest/gtest.h"
 
 /**
  * @class FloydWarshallSolver
@@ -24,6 +32,13 @@
  *   - Call solve() to compute shortest distances.
  *   - Use getShortestPath(u, v) to retrieve shortest distance from u to v.
  *   - Use reconstructPath(u, v) to retrieve the actual path as a list of vertices.
+ *
+ * For large graphs use BlockedFloydWarshallSolver (BlockedFloydWarshall.h): same interface, a contiguous
+ * cache-tiled table and multithreaded block updates.
+ *
+ * For sparse graphs, or when only some sources and targets are needed, distanceMatrix() (DistanceMatrix.h)
+ * takes a CSRGraphView and chooses between the blocked solver and parallel repeated Dijkstra (Johnson's
+ * reweighting for negative weights), with the same inf / negInf semantics.
  */
 
 class FloydWarshallSolver
@@ -35,13 +50,19 @@ private:
     std::vector<std::vector<int>> next; // for path recovery
     const int inf{std::numeric_limits<int>::max()};
     const int negInf{std::numeric_limits<int>::min()};
+    const int unreachable{minPlusInfinity}; // inf while solving, see MinPlus.h
 
     void propagateNegativeCycle()
     {
         for (std::size_t k{}; k < n; ++k) {
             for (std::size_t i{}; i < n; ++i) {
+                if (dp[i][k] >= unreachable) continue;
+
                 for (std::size_t j{}; j < n; ++j) {
-                    if (dp[i][k] != inf && dp[k][j] != inf && dp[i][k] + dp[k][j] < dp[i][j]) {
+                    if (dp[k][j] >= unreachable) continue;
+
+                    bool poisoned{dp[i][k] == negInf || dp[k][j] == negInf};
+                    if (poisoned || dp[i][k] + dp[k][j] < dp[i][j]) {
                         dp[i][j] = negInf; // no "shortest" path available
                         next[i][j] = -1;
                     }
@@ -58,6 +79,8 @@ public:
             for (std::size_t j{}; j < n; ++j) {
                 if (graph[i][j] != inf) {
                     next[i][j] = j; // from i to j
+                } else {
+                    dp[i][j] = unreachable;
                 }
             }
         }
@@ -67,12 +90,8 @@ public:
     {
         for (std::size_t k{}; k < n; ++k) {
             for (std::size_t i{}; i < n; ++i) {
-                for (std::size_t j{}; j < n; ++j) {
-                    if (dp[i][k] != inf && dp[k][j] != inf && dp[i][k] + dp[k][j] < dp[i][j]) {
-                        dp[i][j] = dp[i][k] + dp[k][j];
-                        next[i][j] = next[i][k];
-                    }
-                }
+                // dp[i][j] = min(dp[i][j], dp[i][k] + dp[k][j]) for every j, next[i][j] = next[i][k] where it improved
+                minPlusRelaxRowWithNext(dp[i].data(), next[i].data(), dp[k].data(), dp[i][k], next[i][k], n);
             }
         }
 
@@ -81,6 +100,12 @@ public:
 
         // additional step
         propagateNegativeCycle();
+
+        for (auto& row : dp) {
+            for (int& d : row) {
+                if (d >= unreachable) d = inf;
+            }
+        }
     }
 
     int getShortestPath(int u, int v) const { return dp[u][v]; }
@@ -105,11 +130,35 @@ public:
     }
 };
 
-// normal testcase
-void normalTest()
+const int INF{std::numeric_limits<int>::max()};
+
+std::vector<std::vector<int>> randomMatrix(int n, int density, int minWeight, int maxWeight, unsigned seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> percent(0, 99), weight(minWeight, maxWeight);
+
+    std::vector<std::vector<int>> graph(n, std::vector<int>(n, INF));
+    for (int i{}; i < n; ++i) {
+        for (int j{}; j < n; ++j) {
+            if (i == j) graph[i][j] = 0;
+            else if (percent(rng) < density) graph[i][j] = weight(rng);
+        }
+    }
+    return graph;
+}
+
+template <typename Solver>
+int pathCost(const Solver& solver, const std::vector<std::vector<int>>& graph, int u, int v)
 {
-    const int INF{std::numeric_limits<int>::max()};
+    std::vector<int> path{solver.reconstructPath(u, v)};
+    int cost{};
+    for (std::size_t i{1}; i < path.size(); ++i) cost += graph[path[i - 1]][path[i]];
+    return cost;
+}
 
+// normal testcase
+TEST(FloydWarshallTest, NormalTest)
+{
     std::vector<std::vector<int>> graph = {
         {  0,  4, INF, INF, INF, INF, INF,  8, INF },
         {  4,  0,  8, INF, INF, INF, INF, 11, INF },
@@ -124,16 +173,19 @@ void normalTest()
 
     FloydWarshallSolver solver(9, graph);
     solver.solve();
+    EXPECT_EQ(solver.getShortestPath(0, 4), 21);
+    EXPECT_EQ(solver.reconstructPath(0, 4), (std::vector<int>{0, 7, 6, 5, 4}));
 
-    auto path = solver.reconstructPath(0, 4);
-    std::cout << "From 0 -> 4 = " << solver.getShortestPath(0, 4) << std::endl;
-    for (int v : path) std::cout << v << " ";
-    std::cout << "\n";
+    for (int blockSize : {1, 4, 64}) {
+        BlockedFloydWarshallSolver blocked(9, graph, 2, blockSize);
+        blocked.solve();
+        EXPECT_EQ(blocked.getShortestPath(0, 4), 21);
+        EXPECT_EQ(blocked.reconstructPath(0, 4), (std::vector<int>{0, 7, 6, 5, 4}));
+    }
 }
 
-void testNegativeCycle()
+TEST(FloydWarshallTest, NegativeCycle)
 {
-    const int INF{std::numeric_limits<int>::max()};
     std::vector<std::vector<int>> graph = {
         {0,    1,    INF},
         {INF,  0,   -1  },
@@ -143,19 +195,16 @@ void testNegativeCycle()
     solver.solve();
 
     // shortest path between nodes, should detect negative cycle
-    try {
-        auto path = solver.reconstructPath(0, 2);
-        for (int v : path) std::cout << v << " ";
-        std::cout << "\n";
-    }
-    catch (const std::logic_error& e) {
-        std::cout << "Negative cycle detected in path reconstruction.\n";
-    }
+    EXPECT_THROW(solver.reconstructPath(0, 2), std::logic_error);
+
+    BlockedFloydWarshallSolver blocked(3, graph, 2, 2);
+    blocked.solve();
+    EXPECT_EQ(blocked.getShortestPath(0, 2), BlockedFloydWarshallSolver::negInf);
+    EXPECT_THROW(blocked.reconstructPath(0, 2), std::logic_error);
 }
 
-void testNoPath()
+TEST(FloydWarshallTest, NoPath)
 {
-    const int INF{std::numeric_limits<int>::max()};
     std::vector<std::vector<int>> graph = {
         {0,   5,   INF, INF},
         {INF, 0,   3,   INF},
@@ -168,28 +217,351 @@ void testNoPath()
     solver.solve();
 
     // There should be no path from node 0 to node 3
-    int dist = solver.getShortestPath(0, 3);
-    if (dist == INF) {
-        std::cout << "No path from 0 to 3\n";
+    EXPECT_EQ(solver.getShortestPath(0, 3), INF);
+    EXPECT_TRUE(solver.reconstructPath(0, 3).empty());
+
+    BlockedFloydWarshallSolver blocked(4, graph, 2, 3);
+    blocked.solve();
+    EXPECT_EQ(blocked.getShortestPath(0, 3), INF);
+    EXPECT_TRUE(blocked.reconstructPath(0, 3).empty());
+    EXPECT_EQ(blocked.getShortestPath(0, 2), 8);
+}
+
+TEST(FloydWarshallTest, BlockedMatchesTextbook)
+{
+    // sizes that are not multiples of the block size, negative edges but no negative cycles
+    // (the weights are shifted by a potential: w'(u, v) = w(u, v) + p(u) - p(v))
+    for (int n : {1, 37, 150}) {
+        std::vector<std::vector<int>> graph{randomMatrix(n, 10, 1, 100, n)};
+        std::mt19937 rng{static_cast<unsigned>(n)};
+        std::vector<int> potential(n);
+        for (int& p : potential) p = static_cast<int>(rng() % 50);
+        for (int i{}; i < n; ++i) {
+            for (int j{}; j < n; ++j) {
+                if (graph[i][j] != INF) graph[i][j] += potential[i] - potential[j];
+            }
+        }
+
+        FloydWarshallSolver solver(n, graph);
+        solver.solve();
+
+        for (unsigned threads : {1u, 4u}) {
+            for (int blockSize : {8, 32, 64}) {
+                BlockedFloydWarshallSolver blocked(n, graph, threads, blockSize);
+                blocked.solve();
+
+                for (int u{}; u < n; ++u) {
+                    for (int v{}; v < n; ++v) {
+                        ASSERT_EQ(blocked.getShortestPath(u, v), solver.getShortestPath(u, v)) << u << " -> " << v;
+                        if (u != v && blocked.getShortestPath(u, v) != INF) {
+                            ASSERT_EQ(pathCost(blocked, graph, u, v), blocked.getShortestPath(u, v));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(FloydWarshallTest, BlockedMarksEverythingThroughANegativeCycle)
+{
+    // 0 -> 1 -> {2 <-> 3 negative cycle} -> 4, 5 -> 0, 6 isolated, 7 only reachable from 4
+    std::vector<std::vector<int>> graph(8, std::vector<int>(8, INF));
+    for (int v{}; v < 8; ++v) graph[v][v] = 0;
+    graph[0][1] = 1;
+    graph[1][2] = 1;
+    graph[2][3] = 2;
+    graph[3][2] = -3;
+    graph[3][4] = 1;
+    graph[5][0] = 1;
+    graph[4][7] = 1;
+
+    BlockedFloydWarshallSolver blocked(8, graph, 2, 2);
+    blocked.solve();
+
+    const std::vector<int> reachesCycle{0, 1, 2, 3, 5}, reachedFromCycle{2, 3, 4, 7};
+    for (int u : reachesCycle) {
+        for (int v : reachedFromCycle) EXPECT_EQ(blocked.getShortestPath(u, v), BlockedFloydWarshallSolver::negInf) << u << " -> " << v;
+    }
+
+    EXPECT_EQ(blocked.getShortestPath(5, 1), 2);
+    EXPECT_EQ(blocked.getShortestPath(4, 7), 1);
+    EXPECT_EQ(blocked.getShortestPath(6, 6), 0);
+    EXPECT_EQ(blocked.getShortestPath(4, 2), INF);
+    EXPECT_EQ(blocked.reconstructPath(5, 1), (std::vector<int>{5, 0, 1}));
+    EXPECT_THROW(blocked.reconstructPath(0, 7), std::logic_error);
+}
+
+TEST(FloydWarshallTest, BenchmarkBlockedAgainstTextbook)
+{
+    auto milliseconds = [](auto start, auto end) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    };
+
+    const int n{1024};
+    std::vector<std::vector<int>> graph{randomMatrix(n, 5, 1, 1000, 7)};
+
+    FloydWarshallSolver solver(n, graph);
+    auto startTextbook{std::chrono::high_resolution_clock::now()};
+    solver.solve();
+    auto endTextbook{std::chrono::high_resolution_clock::now()};
+
+    BlockedFloydWarshallSolver blocked(n, graph);
+    auto startBlocked{std::chrono::high_resolution_clock::now()};
+    blocked.solve();
+    auto endBlocked{std::chrono::high_resolution_clock::now()};
+
+    for (int u{}; u < n; u += 7) {
+        for (int v{}; v < n; v += 5) ASSERT_EQ(blocked.getShortestPath(u, v), solver.getShortestPath(u, v));
     }
-    else {
-        std::cout << "Shortest path from 0 to 3 = " << dist << "\n";
+
+    std::cout << "n = " << n << ", textbook: " << milliseconds(startTextbook, endTextbook) << " ms, blocked ("
+              << defaultThreadCount() << " threads): " << milliseconds(startBlocked, endBlocked) << " ms\n";
+
+    const int large{2048};
+    BlockedFloydWarshallSolver largeSolver(large, randomMatrix(large, 2, 1, 1000, 8));
+    auto startLarge{std::chrono::high_resolution_clock::now()};
+    largeSolver.solve();
+    auto endLarge{std::chrono::high_resolution_clock::now()};
+
+    std::cout << "n = " << large << ", blocked: " << milliseconds(startLarge, endLarge) << " ms\n";
+}
+
+CSRGraph toCSR(const std::vector<std::vector<int>>& matrix)
+{
+    std::vector<std::tuple<int, int, int>> edges;
+    for (std::size_t i{}; i < matrix.size(); ++i) {
+        for (std::size_t j{}; j < matrix.size(); ++j) {
+            if (i != j && matrix[i][j] != INF) edges.push_back({static_cast<int>(i), static_cast<int>(j), matrix[i][j]});
+        }
     }
+    return CSRGraph::fromEdges(static_cast<int>(matrix.size()), edges);
+}
 
-    auto path = solver.reconstructPath(0, 3);
-    if (path.empty()) {
-        std::cout << "Path is empty, as expected.\n";
+void expectMatchesTextbook(const DistanceMatrix& matrix, const FloydWarshallSolver& solver)
+{
+    for (std::size_t i{}; i < matrix.sources.size(); ++i) {
+        for (std::size_t j{}; j < matrix.targets.size(); ++j) {
+            ASSERT_EQ(matrix.at(i, j), solver.getShortestPath(matrix.sources[i], matrix.targets[j]))
+                << matrix.sources[i] << " -> " << matrix.targets[j];
+        }
     }
-    else {
-        std::cout << "Unexpected path found: ";
-        for (int v : path) std::cout << v << " ";
+}
+
+TEST(DistanceMatrixTest, StrategiesMatchTextbook)
+{
+    // non-negative, negative without cycles (shifted by a potential) and negative with cycles
+    for (int variant{}; variant < 3; ++variant) {
+        const int n{120};
+        std::vector<std::vector<int>> graph{randomMatrix(n, 3, variant == 2 ? -8 : 1, 60, 40 + variant)};
+        if (variant == 1) {
+            std::mt19937 rng{3};
+            std::vector<int> potential(n);
+            for (int& p : potential) p = static_cast<int>(rng() % 50);
+            for (int i{}; i < n; ++i) {
+                for (int j{}; j < n; ++j) {
+                    if (graph[i][j] != INF) graph[i][j] += potential[i] - potential[j];
+                }
+            }
+        }
+
+        FloydWarshallSolver solver(n, graph);
+        solver.solve();
+        CSRGraph csr{toCSR(graph)};
+
+        std::vector<int> sources{0, 5, 17, 17, 63, 119}, targets{1, 2, 3, 50, 0, 119, 64};
+        std::vector<DistanceMatrixStrategy> strategies{DistanceMatrixStrategy::FloydWarshall, DistanceMatrixStrategy::Johnson};
+        if (variant == 0) strategies.push_back(DistanceMatrixStrategy::Dijkstra);
+
+        for (auto strategy : strategies) {
+            for (unsigned threads : {1u, 3u}) {
+                expectMatchesTextbook(distanceMatrix(csr.view(), sources, targets, strategy, threads), solver);
+            }
+        }
+        expectMatchesTextbook(distanceMatrix(csr.view(), sources), solver);
+    }
+}
+
+TEST(DistanceMatrixTest, NegativeCycleSemantics)
+{
+    // 0 -> 1 -> {2 <-> 3 negative cycle} -> 4, 5 -> 0, 6 has a negative self-loop, 7 only reachable from 4
+    CSRGraph graph{CSRGraph::fromEdges(8, std::vector<std::tuple<int, int, int>>{
+        {0, 1, 1}, {1, 2, 1}, {2, 3, 2}, {3, 2, -3}, {3, 4, 1}, {5, 0, 1}, {4, 7, 1}, {6, 6, -1}})};
+    std::vector<int> all{0, 1, 2, 3, 4, 5, 6, 7};
+
+    for (auto strategy : {DistanceMatrixStrategy::FloydWarshall, DistanceMatrixStrategy::Johnson}) {
+        DistanceMatrix matrix{distanceMatrix(graph.view(), all, all, strategy)};
+        for (int u : {0, 1, 2, 3, 5}) {
+            for (int v : {2, 3, 4, 7}) EXPECT_EQ(matrix.at(u, v), DistanceMatrix::negInf) << u << " -> " << v;
+        }
+        EXPECT_EQ(matrix.at(6, 6), DistanceMatrix::negInf);
+        EXPECT_EQ(matrix.at(5, 1), 2);
+        EXPECT_EQ(matrix.at(4, 7), 1);
+        EXPECT_EQ(matrix.at(4, 2), DistanceMatrix::inf);
+        EXPECT_EQ(matrix.at(7, 7), 0);
+    }
+
+    EXPECT_THROW(distanceMatrix(graph.view(), all, all, DistanceMatrixStrategy::Dijkstra), std::invalid_argument);
+    EXPECT_THROW(distanceMatrix(graph.view(), std::vector<int>{8}), std::out_of_range);
+}
+
+TEST(DistanceMatrixTest, AutomaticChoice)
+{
+    CSRGraph dense{toCSR(randomMatrix(200, 50, 1, 100, 1))};
+    EXPECT_EQ(chooseDistanceMatrixStrategy(dense.view(), 200), DistanceMatrixStrategy::FloydWarshall);
+
+    // sparse grid with a few sources: repeated Dijkstra, or Johnson once a weight is negative
+    std::vector<std::tuple<int, int, int>> edges;
+    const int side{100};
+    for (int u{}; u < side * side; ++u) {
+        if (u % side + 1 < side) edges.push_back({u, u + 1, 3});
+        if (u + side < side * side) edges.push_back({u, u + side, 3});
+    }
+    CSRGraph sparse{CSRGraph::fromEdges(side * side, edges, true/*undirected*/)};
+    EXPECT_EQ(chooseDistanceMatrixStrategy(sparse.view(), 100), DistanceMatrixStrategy::Dijkstra);
+
+    edges.push_back({0, side * side - 1, -1});
+    CSRGraph negative{CSRGraph::fromEdges(side * side, edges)};
+    EXPECT_EQ(chooseDistanceMatrixStrategy(negative.view(), 100), DistanceMatrixStrategy::Johnson);
+}
+
+TEST(DistanceMatrixTest, BenchmarkStrategies)
+{
+    auto milliseconds = [](auto start, auto end) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    };
+
+    // road-like grid: 2304 vertices, 200 sources x 200 targets and all pairs
+    const int side{48};
+    std::mt19937 rng{9};
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int u{}; u < side * side; ++u) {
+        if (u % side + 1 < side) edges.push_back({u, u + 1, 1 + static_cast<int>(rng() % 20)});
+        if (u + side < side * side) edges.push_back({u, u + side, 1 + static_cast<int>(rng() % 20)});
+    }
+    CSRGraph graph{CSRGraph::fromEdges(side * side, edges, true/*undirected*/)};
+
+    std::vector<int> sources, targets, all;
+    for (int i{}; i < 200; ++i) {
+        sources.push_back(static_cast<int>(rng() % (side * side)));
+        targets.push_back(static_cast<int>(rng() % (side * side)));
+    }
+    for (int v{}; v < side * side; ++v) all.push_back(v);
+
+    for (auto [name, rows] : {std::pair{"200 x 200", &sources}, std::pair{"all pairs", &all}}) {
+        std::span<const int> columns{rows == &all ? std::span<const int>{} : std::span<const int>{targets}};
+        std::vector<int> reference;
+        for (auto strategy : {DistanceMatrixStrategy::FloydWarshall, DistanceMatrixStrategy::Dijkstra, DistanceMatrixStrategy::Johnson}) {
+            auto start{std::chrono::high_resolution_clock::now()};
+            DistanceMatrix matrix{distanceMatrix(graph.view(), *rows, columns, strategy)};
+            auto end{std::chrono::high_resolution_clock::now()};
+
+            if (reference.empty()) reference = matrix.distances;
+            EXPECT_EQ(matrix.distances, reference);
+            std::cout << name << ", " << (strategy == DistanceMatrixStrategy::FloydWarshall ? "Floyd-Warshall" :
+                                          strategy == DistanceMatrixStrategy::Dijkstra ? "Dijkstra" : "Johnson")
+                      << ": " << milliseconds(start, end) << " ms\n";
+        }
+        std::cout << name << ", automatic picks "
+                  << (chooseDistanceMatrixStrategy(graph.view(), rows->size()) == DistanceMatrixStrategy::FloydWarshall ? "Floyd-Warshall" : "Dijkstra")
+                  << "\n";
+    }
+}
+
+TEST(MinPlusKernelTest, AllVersionsAgree)
+{
+    std::mt19937 rng{11};
+    std::uniform_int_distribution<int> pick(0, 9), weight(-1000, 1000);
+    auto value = [&] {
+        int p{pick(rng)};
+        if (p == 0) return minPlusInfinity;
+        if (p == 1) return -minPlusInfinity + 1;
+        return weight(rng);
+    };
+
+    const MinPlusIsa best{minPlusIsa()};
+    for (std::size_t n{}; n <= 70; ++n) {
+        std::vector<int> row(n), next(n), through(n);
+        for (std::size_t j{}; j < n; ++j) {
+            row[j] = value();
+            through[j] = value();
+            next[j] = static_cast<int>(j);
+        }
+
+        for (int a : {0, -5, 17, minPlusInfinity, -minPlusInfinity + 1}) {
+            setMinPlusIsa(MinPlusIsa::Scalar);
+            std::vector<int> expectedRow{row}, expectedNext{next}, plainRow{row};
+            minPlusRelaxRowWithNext(expectedRow.data(), expectedNext.data(), through.data(), a, -7, n);
+            minPlusRelaxRow(plainRow.data(), through.data(), a, n);
+            int expectedMin{minPlusReduce(row.data(), through.data(), n)};
+            auto [scalarMin, scalarArg] {minPlusReduceWithArg(row.data(), through.data(), n)};
+            EXPECT_EQ(plainRow, expectedRow);
+            EXPECT_EQ(scalarMin, expectedMin);
+
+            for (MinPlusIsa isa : {MinPlusIsa::Avx2, MinPlusIsa::Avx512}) {
+                if (setMinPlusIsa(isa) != isa) continue; // not supported by this CPU
+
+                std::vector<int> r{row}, nx{next}, plain{row};
+                minPlusRelaxRowWithNext(r.data(), nx.data(), through.data(), a, -7, n);
+                minPlusRelaxRow(plain.data(), through.data(), a, n);
+                EXPECT_EQ(r, expectedRow) << minPlusIsaName(isa) << " n=" << n;
+                EXPECT_EQ(nx, expectedNext) << minPlusIsaName(isa) << " n=" << n;
+                EXPECT_EQ(plain, expectedRow) << minPlusIsaName(isa) << " n=" << n;
+                EXPECT_EQ(minPlusReduce(row.data(), through.data(), n), expectedMin) << minPlusIsaName(isa) << " n=" << n;
+
+                // ties may pick another index, but it has to achieve the minimum
+                auto [best, arg] {minPlusReduceWithArg(row.data(), through.data(), n)};
+                EXPECT_EQ(best, expectedMin) << minPlusIsaName(isa) << " n=" << n;
+                if (expectedMin < minPlusInfinity) {
+                    ASSERT_GE(arg, 0);
+                    EXPECT_EQ(std::min(minPlusInfinity, std::max(row[arg] + through[arg], -minPlusInfinity)), expectedMin);
+                } else {
+                    EXPECT_EQ(arg, -1);
+                }
+            }
+        }
+    }
+    setMinPlusIsa(best);
+}
+
+TEST(FloydWarshallTest, BenchmarkMinPlusKernels)
+{
+    const MinPlusIsa best{minPlusIsa()};
+    for (int n : {256, 512, 1024}) {
+        std::vector<std::vector<int>> graph{randomMatrix(n, 5, -10, 1000, n)};
+        for (auto& row : graph) {
+            for (int& w : row) {
+                if (w != INF) w = std::abs(w); // no negative cycles
+            }
+        }
+
+        std::cout << "n = " << n << ":";
+        std::vector<int> reference;
+        for (MinPlusIsa isa : {MinPlusIsa::Scalar, MinPlusIsa::Avx2, MinPlusIsa::Avx512}) {
+            if (setMinPlusIsa(isa) != isa) continue;
+
+            BlockedFloydWarshallSolver solver(n, graph, 1);
+            auto start{std::chrono::high_resolution_clock::now()};
+            solver.solve();
+            auto end{std::chrono::high_resolution_clock::now()};
+
+            std::vector<int> distances;
+            for (int u{}; u < n; ++u) {
+                for (int v{}; v < n; ++v) distances.push_back(solver.getShortestPath(u, v));
+            }
+            if (reference.empty()) reference = distances;
+            EXPECT_EQ(distances, reference);
+
+            std::cout << " " << minPlusIsaName(isa) << " "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms";
+        }
         std::cout << "\n";
     }
+    setMinPlusIsa(best);
 }
 
-int main()
+int main(int argc, char** argv)
 {
-    // normalTest();
-    // testNegativeCycle();
-    testNoPath();
-}
\ No newline at end of file
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
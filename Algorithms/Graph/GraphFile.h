@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <span>
+#include <fstream>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "../Common/MappedFile.h"
+
+
+/**
+ * @brief Binary on-disk format for CSR graphs that can be memory mapped and handed to the solvers as is.
+ *
+ * Layout (little-endian, every section starts on a 64-byte boundary):
+ *
+ *   +--------------------+  0
+ *   | GraphFileHeader    |  64 bytes
+ *   +--------------------+  header.offsetsPosition
+ *   | int32 offsets[n+1] |
+ *   +--------------------+  header.targetsPosition
+ *   | int32 targets[m]   |
+ *   +--------------------+  header.weightsPosition      (0 if the graph is unweighted)
+ *   | int32 weights[m]   |
+ *   +--------------------+  header.coordinatesPosition  (0 if there are no coordinates)
+ *   | GridCoordinate[n]  |  (row, col) per vertex, used as A* heuristic input
+ *   +--------------------+
+ *
+ * The sections are exactly the arrays of a CSRGraphView, so MappedGraphFile::view() points straight
+ * into the mapping: there is no parsing and no per-vertex allocation, and all processes mapping the same
+ * file share the page cache. Opening a file checks only the header and the section bounds, so a large graph is
+ * ready without reading it. The offsets and targets themselves are trusted: call MappedGraphFile::verify() once
+ * (O(n + m), reads the whole adjacency) on files that may be corrupt, so they throw instead of being indexed
+ * out of bounds by the solvers.
+ *
+ * The version field is bumped on any incompatible layout change; readers reject unknown versions.
+ */
+
+struct GraphFileHeader
+{
+    static constexpr char expectedMagic[8]{'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+    static constexpr std::uint32_t currentVersion{1};
+    static constexpr std::uint64_t alignment{64};
+
+    enum Flags : std::uint32_t { Weighted = 1u << 0, HasCoordinates = 1u << 1 };
+
+    char magic[8]{};
+    std::uint32_t version{};
+    std::uint32_t flags{};
+    std::uint64_t numberOfVertices{};
+    std::uint64_t numberOfEdges{};
+    std::uint64_t offsetsPosition{};
+    std::uint64_t targetsPosition{};
+    std::uint64_t weightsPosition{};
+    std::uint64_t coordinatesPosition{};
+};
+
+static_assert(sizeof(GraphFileHeader) == GraphFileHeader::alignment, "header must fill exactly one aligned block");
+
+/**
+ * @brief Writes a graph (and optional per-vertex grid coordinates) in the GraphFileHeader format.
+ */
+inline void writeGraphFile(const std::string& path, CSRGraphView graph, std::span<const GridCoordinate> coordinates = {})
+{
+    if (!coordinates.empty() && coordinates.size() != static_cast<std::size_t>(graph.size())) {
+        throw std::invalid_argument("Coordinates must be given for every vertex");
+    }
+
+    auto alignUp = [](std::uint64_t pos) {
+        return (pos + GraphFileHeader::alignment - 1) / GraphFileHeader::alignment * GraphFileHeader::alignment;
+    };
+
+    const std::uint64_t n{static_cast<std::uint64_t>(graph.size())};
+    const std::uint64_t m{static_cast<std::uint64_t>(graph.numberOfEdges)};
+
+    GraphFileHeader header;
+    std::memcpy(header.magic, GraphFileHeader::expectedMagic, sizeof(header.magic));
+    header.version = GraphFileHeader::currentVersion;
+    header.numberOfVertices = n;
+    header.numberOfEdges = m;
+
+    std::uint64_t pos{sizeof(GraphFileHeader)};
+    header.offsetsPosition = pos;
+    pos = alignUp(pos + (n + 1) * sizeof(int));
+    header.targetsPosition = pos;
+    pos = alignUp(pos + m * sizeof(int));
+    if (graph.isWeighted()) {
+        header.flags |= GraphFileHeader::Weighted;
+        header.weightsPosition = pos;
+        pos = alignUp(pos + m * sizeof(int));
+    }
+    if (!coordinates.empty()) {
+        header.flags |= GraphFileHeader::HasCoordinates;
+        header.coordinatesPosition = pos;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot open " + path + " for writing");
+
+    auto writeSection = [&out](std::uint64_t position, const void* data, std::uint64_t bytes) {
+        static const char zeros[GraphFileHeader::alignment]{};
+        out.write(zeros, static_cast<std::streamsize>(position - static_cast<std::uint64_t>(out.tellp()))); // padding
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeSection(header.offsetsPosition, graph.offsets, (n + 1) * sizeof(int));
+    writeSection(header.targetsPosition, graph.targets, m * sizeof(int));
+    if (graph.isWeighted()) writeSection(header.weightsPosition, graph.weights, m * sizeof(int));
+    if (!coordinates.empty()) writeSection(header.coordinatesPosition, coordinates.data(), n * sizeof(GridCoordinate));
+
+    if (!out) throw std::runtime_error("Failed writing " + path);
+}
+
+/**
+ * @brief Read-only memory mapping of a graph file (a validated MappedFile). Move-only; the mapping lives as
+ *        long as the object, so it must outlive every solver that was given its view().
+ *
+ * The constructor validates the header and section bounds in O(1). The adjacency of an unverified file is
+ * trusted; pass verifyContents (or call verify()) for files that did not come from writeGraphFile.
+ */
+class MappedGraphFile
+{
+public:
+    explicit MappedGraphFile(const std::string& path, bool verifyContents = false) : file{path}
+    {
+        validate();
+        if (verifyContents) verify();
+    }
+
+    /**
+     * @brief Checks that the offsets are non-decreasing and every target is a vertex, so the solvers never
+     *        index out of bounds. O(n + m) and faults in the offsets and targets sections.
+     */
+    void verify() const
+    {
+        const GraphFileHeader& h{header()};
+        const int* offsets{section<int>(h.offsetsPosition)};
+        for (std::uint64_t u{}; u < h.numberOfVertices; ++u) {
+            if (offsets[u] > offsets[u + 1]) throw std::runtime_error("Corrupted graph file offsets");
+        }
+        const int* targets{section<int>(h.targetsPosition)};
+        const auto n{static_cast<std::uint32_t>(h.numberOfVertices)};
+        for (std::uint64_t e{}; e < h.numberOfEdges; ++e) {
+            if (static_cast<std::uint32_t>(targets[e]) >= n) throw std::runtime_error("Corrupted graph file targets");
+        }
+    }
+
+    const GraphFileHeader& header() const noexcept { return *reinterpret_cast<const GraphFileHeader*>(file.bytes().data()); }
+
+    CSRGraphView view() const noexcept
+    {
+        const GraphFileHeader& h{header()};
+        return CSRGraphView{static_cast<int>(h.numberOfVertices), static_cast<int>(h.numberOfEdges),
+                            section<int>(h.offsetsPosition), section<int>(h.targetsPosition),
+                            (h.flags & GraphFileHeader::Weighted) ? section<int>(h.weightsPosition) : nullptr};
+    }
+
+    bool hasCoordinates() const noexcept { return header().flags & GraphFileHeader::HasCoordinates; }
+
+    std::span<const GridCoordinate> coordinates() const noexcept
+    {
+        if (!hasCoordinates()) return {};
+        return {section<GridCoordinate>(header().coordinatesPosition), static_cast<std::size_t>(header().numberOfVertices)};
+    }
+
+private:
+    template <typename T>
+    const T* section(std::uint64_t position) const noexcept
+    {
+        return reinterpret_cast<const T*>(file.bytes().data() + position);
+    }
+
+    void validate() const
+    {
+        const std::size_t bytes{file.bytes().size()};
+        if (bytes < sizeof(GraphFileHeader)) throw std::runtime_error("Graph file is too small");
+
+        const GraphFileHeader& h{header()};
+        if (std::memcmp(h.magic, GraphFileHeader::expectedMagic, sizeof(h.magic)) != 0) {
+            throw std::runtime_error("Not a graph file");
+        }
+        if (h.version != GraphFileHeader::currentVersion) throw std::runtime_error("Unsupported graph file version");
+        if (h.numberOfVertices > static_cast<std::uint64_t>(std::numeric_limits<int>::max()) ||
+            h.numberOfEdges > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+            throw std::runtime_error("Graph file is too large for 32-bit vertex and edge indices");
+        }
+
+        auto checkSection = [bytes](std::uint64_t position, std::uint64_t count, std::uint64_t elementSize) {
+            if (position % GraphFileHeader::alignment != 0 || position > bytes || count * elementSize > bytes - position) {
+                throw std::runtime_error("Corrupted graph file section");
+            }
+        };
+
+        checkSection(h.offsetsPosition, h.numberOfVertices + 1, sizeof(int));
+        checkSection(h.targetsPosition, h.numberOfEdges, sizeof(int));
+        if (h.flags & GraphFileHeader::Weighted) checkSection(h.weightsPosition, h.numberOfEdges, sizeof(int));
+        if (h.flags & GraphFileHeader::HasCoordinates) {
+            checkSection(h.coordinatesPosition, h.numberOfVertices, sizeof(GridCoordinate));
+        }
+
+        // two reads; the per-vertex and per-edge checks are left to verify()
+        const int* offsets{section<int>(h.offsetsPosition)};
+        if (offsets[0] != 0 || static_cast<std::uint64_t>(offsets[h.numberOfVertices]) != h.numberOfEdges) {
+            throw std::runtime_error("Corrupted graph file offsets");
+        }
+    }
+
+private:
+    MappedFile file;
+};
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "PriorityQueues.h"
+
+/**
+ * @brief Occupancy grid with one bit per cell (1 = blocked), rows padded to whole 64-bit words.
+ *
+ * A 4096 x 4096 map is 2 MB, instead of a vertex id matrix plus an explicit edge list. Cells outside the
+ * grid read as blocked, so the searches need no separate bounds checks.
+ */
+class OccupancyGrid
+{
+public:
+    OccupancyGrid(int rows, int cols) : numberOfRows{rows}, numberOfCols{cols}, wordsPerRow{(cols + 63) / 64}
+    {
+        if (rows <= 0 || cols <= 0) throw std::invalid_argument("Grid dimensions should be > 0");
+        bits.assign(static_cast<std::size_t>(rows) * wordsPerRow, 0);
+    }
+
+    // cells[r * cols + c] != 0 means blocked
+    OccupancyGrid(int rows, int cols, const std::uint8_t* cells) : OccupancyGrid(rows, cols)
+    {
+        for (int r{}; r < rows; ++r) {
+            for (int c{}; c < cols; ++c) {
+                if (cells[static_cast<std::size_t>(r) * cols + c]) setBlocked(r, c, true);
+            }
+        }
+    }
+
+    // value == blocked marks an obstacle, anything else is free
+    explicit OccupancyGrid(const std::vector<std::vector<int>>& grid, int blocked = 1)
+        : OccupancyGrid(static_cast<int>(grid.size()), grid.empty() ? 0 : static_cast<int>(grid[0].size()))
+    {
+        for (int r{}; r < numberOfRows; ++r) {
+            for (int c{}; c < numberOfCols; ++c) {
+                if (grid[r][c] == blocked) setBlocked(r, c, true);
+            }
+        }
+    }
+
+    int rows() const noexcept { return numberOfRows; }
+    int cols() const noexcept { return numberOfCols; }
+    bool contains(int r, int c) const noexcept { return r >= 0 && c >= 0 && r < numberOfRows && c < numberOfCols; }
+
+    bool isFree(int r, int c) const noexcept
+    {
+        if (!contains(r, c)) return false;
+        return ((word(r, c) >> (c & 63)) & 1) == 0;
+    }
+
+    void setBlocked(int r, int c, bool blocked)
+    {
+        if (!contains(r, c)) throw std::out_of_range("Cell outside the grid");
+        std::uint64_t& w{bits[static_cast<std::size_t>(r) * wordsPerRow + (c >> 6)]};
+        const std::uint64_t bit{std::uint64_t{1} << (c & 63)};
+        w = blocked ? w | bit : w & ~bit;
+    }
+
+private:
+    std::uint64_t word(int r, int c) const noexcept { return bits[static_cast<std::size_t>(r) * wordsPerRow + (c >> 6)]; }
+
+private:
+    int numberOfRows{};
+    int numberOfCols{};
+    int wordsPerRow{};
+    std::vector<std::uint64_t> bits;
+};
+
+enum class GridConnectivity
+{
+    Four,  // up, down, left, right
+    Eight  // plus diagonals; a diagonal step needs both cells it passes between to be free (no corner cutting)
+};
+
+enum class GridSearch
+{
+    AStar,
+    JumpPoint
+};
+
+/**
+ * @brief Result of a grid search: cost -1 (and no cells) if the goal is unreachable, otherwise every cell of
+ *        the path from start to goal, and the number of cells taken from the open list.
+ */
+struct GridPath
+{
+    int cost{-1};
+    std::vector<GridCoordinate> cells;
+    int expanded{};
+};
+
+/**
+ * @class GridAStar
+ *
+ * @brief A* directly on an OccupancyGrid: the neighbors and the heuristic are computed on the fly.
+ *
+ * Costs are integers: a straight step costs 10, a diagonal one 14 (≈ 10·√2), so the 4-connected cost is ten
+ * times the number of steps. The heuristic is the Manhattan distance (4-connected) or the octile distance
+ * 10·(max - min) + 14·min of the row and column differences (8-connected). Both are exactly the cost on an
+ * empty grid, hence consistent, so a popped cell is final and no closed set is needed.
+ *
+ * Jump Point Search (GridSearch::JumpPoint) returns the same cost. Instead of queueing every neighbor it
+ * follows each direction in a straight line, without touching the open list, until the goal, an obstacle,
+ * or a cell with a "forced" neighbor: one that only an optimal path through this cell can reach. Only those
+ * jump points are queued. On open warehouse maps that is a few cells per corridor instead of every cell.
+ * Pruning rules (row/col form of the no-corner-cutting variants):
+ *   - horizontal move: forced if a cell above or below is free while the one diagonally behind it is not,
+ *   - vertical move: the same with left/right; in the 4-connected variant a vertical scan also stops
+ *     where a horizontal scan finds a jump point,
+ *   - diagonal move (8-connected): stops where a horizontal or vertical scan finds a jump point.
+ * The path between two jump points is a straight or diagonal line and is filled in afterwards.
+ *
+ * Per-cell state (g and parent) is allocated once per solver and invalidated per search by a stamp, so a
+ * query only touches the cells it visits. The open list is a 4-ary heap with decrease-key.
+ */
+class GridAStar
+{
+public:
+    static constexpr int straightCost{10};
+    static constexpr int diagonalCost{14};
+
+    // the grid has to outlive the solver
+    GridAStar(const OccupancyGrid& occupancy, GridConnectivity connectivity = GridConnectivity::Four,
+              GridSearch search = GridSearch::AStar)
+        : grid{occupancy}, diagonal{connectivity == GridConnectivity::Eight}, jumping{search == GridSearch::JumpPoint},
+          cols{occupancy.cols()}, cellCount{occupancy.rows() * occupancy.cols()},
+          g(cellCount), parent(cellCount), stamp(cellCount, 0)
+    {
+        open.reset(cellCount);
+    }
+
+    /**
+     * @param expansions if given, receives the cells in the order they were taken from the open list
+     *        (for visualization)
+     */
+    GridPath findPath(GridCoordinate start, GridCoordinate goal, std::vector<GridCoordinate>* expansions = nullptr)
+    {
+        if (!grid.contains(start.row, start.col) || !grid.contains(goal.row, goal.col)) {
+            throw std::out_of_range("Start or goal outside the grid");
+        }
+        if (expansions) expansions->clear();
+
+        GridPath result;
+        if (!grid.isFree(start.row, start.col) || !grid.isFree(goal.row, goal.col)) return result;
+
+        nextSearch();
+        target = goal;
+        const int source{index(start.row, start.col)}, destination{index(goal.row, goal.col)};
+
+        open.clear();
+        relax(source, -1, 0);
+
+        while (!open.empty()) {
+            auto [f, u] = open.pop();
+            ++result.expanded;
+            if (expansions) expansions->push_back(coordinate(u));
+
+            if (u == destination) {
+                result.cost = g[u];
+                result.cells = tracePath(destination);
+                return result;
+            }
+
+            if (jumping) expandJumpPoint(u);
+            else expandNeighbors(u);
+        }
+
+        return result;
+    }
+
+private:
+    int index(int r, int c) const noexcept { return r * cols + c; }
+    GridCoordinate coordinate(int cell) const noexcept { return {cell / cols, cell % cols}; }
+
+    bool passable(int r, int c) const noexcept { return grid.isFree(r, c); }
+
+    void nextSearch()
+    {
+        if (++currentStamp == 0) { // wrapped around, old stamps could match again
+            std::fill(stamp.begin(), stamp.end(), 0);
+            currentStamp = 1;
+        }
+    }
+
+    int cost(int dr, int dc) const noexcept
+    {
+        int a{std::abs(dr)}, b{std::abs(dc)};
+        if (!diagonal) return straightCost * (a + b);
+        return straightCost * (std::max(a, b) - std::min(a, b)) + diagonalCost * std::min(a, b);
+    }
+
+    int heuristic(int cell) const noexcept
+    {
+        GridCoordinate p{coordinate(cell)};
+        return cost(target.row - p.row, target.col - p.col);
+    }
+
+    void relax(int v, int from, int gValue)
+    {
+        if (stamp[v] == currentStamp && g[v] <= gValue) return;
+        stamp[v] = currentStamp;
+        g[v] = gValue;
+        parent[v] = from;
+        open.push(v, gValue + heuristic(v));
+    }
+
+    // a diagonal step between (r, c) and (r + dr, c + dc) needs both cells it passes between
+    bool canStep(int r, int c, int dr, int dc) const noexcept
+    {
+        if (!passable(r + dr, c + dc)) return false;
+        return dr == 0 || dc == 0 || (passable(r + dr, c) && passable(r, c + dc));
+    }
+
+    void expandNeighbors(int u)
+    {
+        auto [r, c] = coordinate(u);
+        const int directions{diagonal ? 8 : 4};
+        for (int d{}; d < directions; ++d) {
+            auto [dr, dc] = steps[d];
+            if (canStep(r, c, dr, dc)) relax(index(r + dr, c + dc), u, g[u] + cost(dr, dc));
+        }
+    }
+
+    void expandJumpPoint(int u)
+    {
+        auto [r, c] = coordinate(u);
+        auto tryDirection = [&](int dr, int dc) {
+            if (!canStep(r, c, dr, dc)) return;
+            int jumpPoint{jump(r, c, dr, dc)};
+            if (jumpPoint == -1) return;
+            GridCoordinate p{coordinate(jumpPoint)};
+            relax(jumpPoint, u, g[u] + cost(p.row - r, p.col - c));
+        };
+
+        if (parent[u] == -1) {
+            const int directions{diagonal ? 8 : 4};
+            for (int d{}; d < directions; ++d) tryDirection(steps[d].first, steps[d].second);
+            return;
+        }
+
+        GridCoordinate from{coordinate(parent[u])};
+        const int dr{sign(r - from.row)}, dc{sign(c - from.col)};
+
+        if (!diagonal) {
+            if (dc != 0) {
+                tryDirection(0, dc);
+                tryDirection(-1, 0);
+                tryDirection(1, 0);
+            } else {
+                tryDirection(dr, 0);
+                tryDirection(0, -1);
+                tryDirection(0, 1);
+            }
+            return;
+        }
+
+        if (dr != 0 && dc != 0) {
+            tryDirection(dr, 0);
+            tryDirection(0, dc);
+            tryDirection(dr, dc);
+        } else if (dc != 0) {
+            tryDirection(0, dc);
+            tryDirection(-1, dc);
+            tryDirection(1, dc);
+            tryDirection(-1, 0);
+            tryDirection(1, 0);
+        } else {
+            tryDirection(dr, 0);
+            tryDirection(dr, -1);
+            tryDirection(dr, 1);
+            tryDirection(0, -1);
+            tryDirection(0, 1);
+        }
+    }
+
+    // scans from (r, c) in direction (dr, dc); returns the first jump point or -1
+    int jump(int r, int c, int dr, int dc) const
+    {
+        while (true) {
+            if (!canStep(r, c, dr, dc)) return -1;
+            r += dr;
+            c += dc;
+            if (r == target.row && c == target.col) return index(r, c);
+
+            if (dr != 0 && dc != 0) {
+                if (jump(r, c, dr, 0) != -1 || jump(r, c, 0, dc) != -1) return index(r, c);
+            } else if (dc != 0) {
+                if ((passable(r - 1, c) && !passable(r - 1, c - dc)) || (passable(r + 1, c) && !passable(r + 1, c - dc))) return index(r, c);
+            } else {
+                if ((passable(r, c - 1) && !passable(r - dr, c - 1)) || (passable(r, c + 1) && !passable(r - dr, c + 1))) return index(r, c);
+                if (!diagonal && (jump(r, c, 0, 1) != -1 || jump(r, c, 0, -1) != -1)) return index(r, c);
+            }
+        }
+    }
+
+    // parent pointers lead from jump point to jump point, the cells in between lie on a line
+    std::vector<GridCoordinate> tracePath(int destination) const
+    {
+        std::vector<GridCoordinate> cells;
+        for (int v{destination}; parent[v] != -1; v = parent[v]) {
+            GridCoordinate to{coordinate(v)}, from{coordinate(parent[v])};
+            const int dr{sign(from.row - to.row)}, dc{sign(from.col - to.col)};
+            for (GridCoordinate p{to}; p.row != from.row || p.col != from.col; p.row += dr, p.col += dc) {
+                cells.push_back(p);
+            }
+        }
+        int source{destination};
+        while (parent[source] != -1) source = parent[source];
+        cells.push_back(coordinate(source));
+
+        std::reverse(cells.begin(), cells.end());
+        return cells;
+    }
+
+    static int sign(int x) noexcept { return (x > 0) - (x < 0); }
+
+private:
+    // the four straight directions first, so 4-connectivity uses a prefix
+    static constexpr std::pair<int, int> steps[8]{{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+
+    const OccupancyGrid& grid;
+    bool diagonal{};
+    bool jumping{};
+    int cols{};
+    int cellCount{};
+    GridCoordinate target;
+
+    std::vector<int> g;
+    std::vector<int> parent;
+    std::vector<std::uint32_t> stamp; // g and parent of a cell are valid if stamp == currentStamp
+    std::uint32_t currentStamp{};
+    IndexedDaryHeap<4> open;
+};
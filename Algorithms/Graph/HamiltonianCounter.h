@@ -0,0 +1,222 @@
+#pragma once
+
+#include <bit>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "../Common/AlignedBuffer.h"
+#include "../Common/Combinations.h"
+#include "../Common/Parallel.h"
+
+struct HamiltonianCounterOptions
+{
+    std::uint64_t modulus{0}; // 0 means exact counts modulo 2^64, otherwise at most maxModulus
+    unsigned threads{0};      // 0 means all hardware threads
+    bool saturate{false};     // counts stop at UINT64_MAX instead of wrapping (modulus has to be 0)
+};
+
+/**
+ * @class HamiltonianPathCounter
+ *
+ * @brief Number of Hamiltonian paths and cycles of a graph with up to 32 vertices, by a bottom-up bitmask DP
+ *        over one flat table of 64-bit counts, parallel by popcount layers.
+ *
+ * ## Table
+ *     dp[mask * n + v] = number of paths that start at v and visit exactly the vertices of mask
+ * in one 64-byte aligned allocation, rows of n counts (0 for v outside mask). A path starting at v goes on to
+ * some out-neighbour u and covers mask \ v from there, so every row is computed in pull form:
+ *     dp[mask][v] = sum over u in out(v) & (mask \ v) of dp[mask \ v][u]
+ * with the out-neighbours of v as one bitmask, the sum only visits the set bits of out(v) & mask.
+ *
+ * A mask depends on masks with one vertex less only: the masks of a popcount layer are independent, a layer is
+ * split into contiguous rank ranges (one per thread), and each range is walked with Gosper's hack from its
+ * unranked first mask (Combinations.h), as in HeldKarpSolver.
+ *
+ * The number of Hamiltonian paths is the sum of the last row. Any other row answers "in how many ways can a
+ * partial path be completed": with the vertices of visited behind it and v as its last vertex, the rest is a
+ * path from v through all unvisited vertices, i.e. dp[~visited | v][v].
+ *
+ * ## Cycles
+ * A directed Hamiltonian cycle is counted once from its vertex h = n - 1: h -> a -> ... -> b -> h, where
+ * a ... b is a Hamiltonian path of the other vertices that ends at an in-neighbour b of h. The same table is
+ * built for the n - 1 other vertices with the one-vertex paths seeded by "is an in-neighbour of h" instead of 1,
+ * and the cycles are the sum over the out-neighbours a of h of its last row. This second table has half the
+ * rows, it is built on demand and released afterwards.
+ * An undirected graph has each cycle in both directions (n >= 3); the Hamiltonian paths whose last vertex is
+ * adjacent to the first (the cycles of HamiltonSolver::simpleSolver) are n * cycles.
+ *
+ * ## Counts
+ * Paths are vertex sequences, parallel edges don't multiply them and self-loops are ignored (except for the
+ * one-vertex cycle). Counts wrap modulo 2^64, e.g. the 21! paths of K21 don't fit, or are reduced modulo a
+ * given modulus up to 2^58 (a row sums at most 32 reduced counts in 64 bits before one reduction). Saturating
+ * counts stop at UINT64_MAX ("at least that many"), so that a zero always means "no path", which is what
+ * the pruning of HamiltonianPathEnumerator relies on.
+ *
+ * Memory: n * 2^n * 8 bytes, 3.2 GB for n = 24 (requiredBytes). Time: O(2^n * sum of the degrees within a mask),
+ * at most n² 2^n / 4 additions.
+ */
+class HamiltonianPathCounter
+{
+public:
+    static constexpr int maxVertices{32};
+    static constexpr std::uint64_t maxModulus{std::uint64_t{1} << 58};
+
+    // adjacency[v] = bitmask of the out-neighbours of v
+    explicit HamiltonianPathCounter(std::vector<std::uint32_t> adjacency, HamiltonianCounterOptions options = {})
+        : HamiltonianPathCounter(std::move(adjacency), options, true)
+    { }
+
+    explicit HamiltonianPathCounter(CSRGraphView graph, HamiltonianCounterOptions options = {})
+        : HamiltonianPathCounter(adjacencyOf(graph), options, true)
+    { }
+
+    // cycleCount() without building the path table
+    static std::uint64_t countCycles(CSRGraphView graph, HamiltonianCounterOptions options = {})
+    {
+        return HamiltonianPathCounter{adjacencyOf(graph), options, false}.cycleCount();
+    }
+
+    // bytes of the table for n vertices
+    static std::size_t requiredBytes(int n) noexcept
+    {
+        return (std::size_t{1} << n) * static_cast<std::size_t>(n) * sizeof(std::uint64_t);
+    }
+
+    int size() const noexcept { return n; }
+    std::uint64_t fullMask() const noexcept { return n == 0 ? 0 : (std::uint64_t{1} << n) - 1; }
+
+    // paths that start at v and visit exactly the vertices of mask (v in mask)
+    std::uint64_t completions(std::uint32_t mask, int v) const noexcept
+    {
+        return table[static_cast<std::size_t>(mask) * n + v];
+    }
+
+    // all Hamiltonian paths (every start vertex, both directions of an undirected path)
+    std::uint64_t pathCount() const noexcept
+    {
+        std::uint64_t total{};
+        for (int v{}; v < n; ++v) total = add(total, pathCountFrom(v));
+        return total;
+    }
+
+    std::uint64_t pathCountFrom(int v) const noexcept
+    {
+        return completions(static_cast<std::uint32_t>(fullMask()), v);
+    }
+
+    // directed Hamiltonian cycles, each counted once (an undirected cycle twice for n >= 3)
+    std::uint64_t cycleCount() const
+    {
+        if (n == 0) return 0;
+        if (n == 1) return reduce(out[0] & 1u);
+
+        const int h{n - 1}, m{n - 1};
+        std::vector<std::uint32_t> rest(out.begin(), out.begin() + m);
+        for (auto& bits : rest) bits &= (std::uint32_t{1} << m) - 1;
+
+        AlignedBuffer<std::uint64_t> closing{(std::size_t{1} << m) * static_cast<std::size_t>(m)};
+        fill(closing, m, rest, [this, h](int v) { return ((out[v] >> h) & 1u) != 0; });
+
+        const std::uint32_t all{(std::uint32_t{1} << m) - 1};
+        std::uint64_t total{};
+        for (std::uint32_t a{out[h] & all}; a != 0; a &= a - 1) {
+            total = add(total, closing[static_cast<std::size_t>(all) * m + std::countr_zero(a)]);
+        }
+        return total;
+    }
+
+private:
+    HamiltonianPathCounter(std::vector<std::uint32_t> adjacency, HamiltonianCounterOptions options, bool buildTable)
+        : n{static_cast<int>(adjacency.size())}, out{std::move(adjacency)}, modulus{options.modulus},
+          saturating{options.saturate}, threadCount{options.threads == 0 ? defaultThreadCount() : options.threads}
+    {
+        if (n > maxVertices) throw std::invalid_argument("Number of Vertices should be <= 32");
+        if (modulus > maxModulus) throw std::invalid_argument("Modulus should be <= 2^58");
+        if (saturating && modulus != 0) throw std::invalid_argument("Saturating counts can't be modular");
+        for (int v{}; v < n; ++v) {
+            if (n < maxVertices && (out[v] >> n) != 0) throw std::out_of_range("Vertex out of range");
+        }
+
+        if (n == 0 || !buildTable) return;
+        table = AlignedBuffer<std::uint64_t>{(std::size_t{1} << n) * static_cast<std::size_t>(n)};
+        fill(table, n, out, [](int) { return true; });
+    }
+
+    static std::vector<std::uint32_t> adjacencyOf(CSRGraphView graph)
+    {
+        if (graph.size() > maxVertices) throw std::invalid_argument("Number of Vertices should be <= 32");
+
+        std::vector<std::uint32_t> adjacency(graph.size());
+        for (int u{}; u < graph.size(); ++u) {
+            for (int v : graph.neighbors(u)) adjacency[u] |= std::uint32_t{1} << v;
+        }
+        return adjacency;
+    }
+
+    std::uint64_t reduce(std::uint64_t x) const noexcept { return modulus == 0 ? x : x % modulus; }
+    std::uint64_t add(std::uint64_t x, std::uint64_t y) const noexcept
+    {
+        if (saturating) return __builtin_add_overflow(x, y, &x) ? std::numeric_limits<std::uint64_t>::max() : x;
+        return reduce(x + y);
+    }
+
+    // fills dp over the masks of width vertices, seed(v) says whether the one-vertex path v counts
+    template <typename Seed>
+    void fill(AlignedBuffer<std::uint64_t>& dp, int width, const std::vector<std::uint32_t>& adjacency, Seed seed) const
+    {
+        const std::size_t w{static_cast<std::size_t>(width)};
+        for (std::size_t v{}; v < w; ++v) dp[v] = 0; // empty mask
+        for (int v{}; v < width; ++v) {
+            std::uint64_t* row{&dp[(std::size_t{1} << v) * w]};
+            for (std::size_t u{}; u < w; ++u) row[u] = 0;
+            row[v] = reduce(seed(v) ? 1 : 0);
+        }
+
+        for (int k{2}; k <= width; ++k) {
+            std::uint64_t layerSize{Combinations::binomial(width, k)};
+            parallelForChunks(layerSize, threadCount, [&](std::size_t begin, std::size_t end, unsigned) {
+                std::uint32_t mask{Combinations::unrankCombination(k, begin)};
+                for (std::size_t r{begin}; r < end; ++r) {
+                    computeRow(dp, w, adjacency, mask);
+                    if (r + 1 < end) mask = Combinations::nextCombination(mask);
+                }
+            }, minChunk);
+        }
+    }
+
+    void computeRow(AlignedBuffer<std::uint64_t>& dp, std::size_t w, const std::vector<std::uint32_t>& adjacency,
+                    std::uint32_t mask) const noexcept
+    {
+        std::uint64_t* row{&dp[mask * w]};
+        for (std::size_t v{}; v < w; ++v) {
+            if (((mask >> v) & 1u) == 0) {
+                row[v] = 0;
+                continue;
+            }
+
+            const std::uint32_t rest{mask & ~(std::uint32_t{1} << v)};
+            const std::uint64_t* from{&dp[rest * w]};
+            std::uint64_t sum{};
+            if (saturating) {
+                for (std::uint32_t next{adjacency[v] & rest}; next != 0; next &= next - 1) sum = add(sum, from[std::countr_zero(next)]);
+                row[v] = sum;
+                continue;
+            }
+            for (std::uint32_t next{adjacency[v] & rest}; next != 0; next &= next - 1) sum += from[std::countr_zero(next)];
+            row[v] = reduce(sum);
+        }
+    }
+
+private:
+    static constexpr std::size_t minChunk{64};
+
+    int n{};
+    std::vector<std::uint32_t> out; // out[v] = bitmask of the out-neighbours of v
+    std::uint64_t modulus{};
+    bool saturating{};
+    unsigned threadCount{};
+    AlignedBuffer<std::uint64_t> table;
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "CSRGraph.h"
+#include "HamiltonianCounter.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @class HamiltonianPathEnumerator
+ *
+ * @brief Streams the Hamiltonian paths of a graph one at a time to a visitor instead of storing them.
+ *
+ * A visitor is called as visit(path, closable) for every path, where path is a std::span<const int> over the
+ * one buffer the search extends and shrinks in place (valid during the call only, copy it to keep it) and
+ * closable says whether the last vertex has an edge back to the first, i.e. the path is a Hamiltonian cycle
+ * (the areCycles flag of HamiltonSolver::simpleSolver). A visitor returning bool stops the enumeration by
+ * returning false; a void visitor sees every path. A limit caps the number of paths delivered as well.
+ *
+ * ## Pruning
+ * The search is a DFS over vertex bitmasks, and it only steps to a vertex u if the unvisited vertices can
+ * still be covered by a path from u. That is the DP table of HamiltonianPathCounter:
+ *     completions(unvisited | u, u) != 0
+ * built once with saturating counts, so every branch of the search ends in at least one path and the work
+ * is proportional to the output (O(n) candidate checks per path vertex) instead of to the dead ends, which
+ * dominate a plain DFS on sparse graphs. The table costs n * 2^n * 8 bytes (3 GiB at n = 24), so pruning
+ * throws above maxPrunedVertices and has to be switched off for larger graphs.
+ *
+ * ## Threads
+ * enumerateParallel takes one sink (visitor) per thread. Worker t takes start vertices one after another
+ * from a shared counter and reports the paths from them to sinks[t] only, so a sink needs no locking;
+ * the order of paths between sinks is unspecified. If any sink stops, all workers stop at their next path,
+ * and the limit is shared (every delivered path claims one slot first), so exactly min(limit, paths) paths
+ * are delivered in total.
+ *
+ * Paths are vertex sequences: parallel edges don't repeat them.
+ */
+class HamiltonianPathEnumerator
+{
+public:
+    static constexpr int maxVertices{HamiltonianPathCounter::maxVertices};
+    static constexpr int maxPrunedVertices{24};
+
+    /**
+     * @param prune build the completion table (n * 2^n * 8 bytes) to cut dead ends
+     * @param threads threads for building the table, 0 means all hardware threads
+     * @throws std::invalid_argument for prune above maxPrunedVertices
+     */
+    explicit HamiltonianPathEnumerator(CSRGraphView graph, bool prune = true, unsigned threads = 0)
+        : n{graph.size()}, out(adjacencyOf(graph))
+    {
+        if (prune && n > maxPrunedVertices) throw std::invalid_argument("Pruning needs Number of Vertices <= 24");
+        if (prune) completions = std::make_unique<HamiltonianPathCounter>(out, HamiltonianCounterOptions{0, threads, true});
+    }
+
+    int size() const noexcept { return n; }
+    bool isPruning() const noexcept { return completions != nullptr; }
+
+    /**
+     * @brief Calls visit for every Hamiltonian path (or the first limit ones), start vertices in order.
+     * @param limit maximum number of paths, 0 means no limit
+     * @return number of paths delivered
+     */
+    template <typename Visitor>
+    std::uint64_t enumerate(Visitor&& visit, std::uint64_t limit = 0) const
+    {
+        Shared shared{limit};
+        Search<Visitor> search{*this, visit, shared};
+        for (int start{}; start < n && !shared.stopped(); ++start) search.from(start);
+        return shared.delivered();
+    }
+
+    /**
+     * @brief Enumerates with one thread per sink, the paths found by thread t go to sinks[t].
+     * @return number of paths delivered to all sinks together
+     */
+    template <typename Sink>
+    std::uint64_t enumerateParallel(std::vector<Sink>& sinks, std::uint64_t limit = 0) const
+    {
+        if (sinks.empty()) throw std::invalid_argument("At least one sink is needed");
+
+        Shared shared{limit};
+        std::atomic<int> nextStart{0};
+        parallelFor(sinks.size(), static_cast<unsigned>(sinks.size()), [&](std::size_t t, unsigned) {
+            Search<Sink> search{*this, sinks[t], shared};
+            for (int start{nextStart++}; start < n && !shared.stopped(); start = nextStart++) search.from(start);
+        });
+        return shared.delivered();
+    }
+
+private:
+    static std::vector<std::uint32_t> adjacencyOf(CSRGraphView graph)
+    {
+        if (graph.size() > maxVertices) throw std::invalid_argument("Number of Vertices should be <= 32");
+
+        std::vector<std::uint32_t> adjacency(graph.size());
+        for (int u{}; u < graph.size(); ++u) {
+            for (int v : graph.neighbors(u)) adjacency[u] |= std::uint32_t{1} << v;
+        }
+        return adjacency;
+    }
+
+    // the limit and the stop flag, common to all threads of one enumeration
+    class Shared
+    {
+    public:
+        explicit Shared(std::uint64_t limit) : cap{limit == 0 ? ~std::uint64_t{} : limit} { }
+
+        // a slot for one more path, false once the limit is reached
+        bool claim() noexcept
+        {
+            if (count.fetch_add(1, std::memory_order_relaxed) < cap) return true;
+            stop();
+            return false;
+        }
+
+        void stop() noexcept { halted.store(true, std::memory_order_relaxed); }
+        bool stopped() const noexcept { return halted.load(std::memory_order_relaxed); }
+        std::uint64_t delivered() const noexcept { return std::min(count.load(), cap); }
+
+    private:
+        std::uint64_t cap;
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<bool> halted{false};
+    };
+
+    // DFS state of one thread: the path buffer and its visited mask
+    template <typename Visitor>
+    class Search
+    {
+    public:
+        Search(const HamiltonianPathEnumerator& e, Visitor& v, Shared& s)
+            : owner{e}, visit{v}, shared{s}, path(e.n),
+              all{e.n == 0 ? 0 : static_cast<std::uint32_t>((std::uint64_t{1} << e.n) - 1)}
+        { }
+
+        void from(int start)
+        {
+            if (!canComplete(0, start)) return;
+            path[0] = start;
+            extend(1, std::uint32_t{1} << start);
+        }
+
+    private:
+        // can a path from u cover u and everything outside visited
+        bool canComplete(std::uint32_t visited, int u) const noexcept
+        {
+            return owner.completions == nullptr || owner.completions->completions(all & ~visited, u) != 0;
+        }
+
+        void extend(int length, std::uint32_t visited)
+        {
+            const int last{path[length - 1]};
+            if (length == owner.n) {
+                report((owner.out[last] >> path[0]) & 1u);
+                return;
+            }
+
+            for (std::uint32_t next{owner.out[last] & ~visited}; next != 0 && !shared.stopped(); next &= next - 1) {
+                const int u{std::countr_zero(next)};
+                if (!canComplete(visited, u)) continue;
+                path[length] = u;
+                extend(length + 1, visited | (std::uint32_t{1} << u));
+            }
+        }
+
+        void report(bool closable)
+        {
+            if (shared.stopped() || !shared.claim()) return;
+
+            std::span<const int> view{path};
+            if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::span<const int>, bool>>) {
+                visit(view, closable);
+            } else {
+                if (!visit(view, closable)) shared.stop();
+            }
+        }
+
+    private:
+        const HamiltonianPathEnumerator& owner;
+        Visitor& visit;
+        Shared& shared;
+        std::vector<int> path;
+        std::uint32_t all;
+    };
+
+private:
+    int n{};
+    std::vector<std::uint32_t> out;                      // out[v] = bitmask of the out-neighbours of v
+    std::unique_ptr<HamiltonianPathCounter> completions; // saturating DP table, null without pruning
+};
@@ -25,33 +25,60 @@
  *       Time complexity: O(n!) as it explores all permutations of vertices.
  * 
  *   - dpSolver():
- *       Dynamic programming approach using bitmasking to count all Hamiltonian 
- *       paths while caching dead-end states to avoid redundant computations.
- *       This reduces redundant DFS calls compared to simpleSolver.
+ *       Bottom-up bitmask dynamic programming (HamiltonianPathCounter, HamiltonianCounter.h)
+ *       that counts all Hamiltonian paths in 64 bits, optionally modulo a given number.
+ *       The table is one flat array of counts, neighbours are iterated through adjacency
+ *       bitmasks and the masks are processed in parallel, one popcount layer at a time.
  *       Time complexity: O(n^2 * 2^n) for counting all paths in the worst case.
- *       Space complexity: O(n * 2^n) for storing the DP table.
+ *       Space complexity: O(n * 2^n) for storing the DP table (3.2 GB for n = 24).
+ *
+ *   - enumerate() / enumerateParallel():
+ *       Streams the Hamiltonian paths one at a time to a callback instead of storing them
+ *       (HamiltonianPathEnumerator, HamiltonianEnumerator.h). One path buffer is reused,
+ *       the DFS is pruned by the DP table of dpSolver so it never enters a dead end, and
+ *       it stops early on request or after a limit. In parallel, the start vertices are
+ *       split across threads, each with its own output sink.
+ *
+ *   - dpCycleSolver():
+ *       Counts the Hamiltonian paths whose last vertex is adjacent to the first one
+ *       (the cycles of simpleSolver) with the same DP, without enumerating them.
  * 
  * Note:
  *   - simpleSolver and pureSimpleSolver are primarily educational and for verification.
  *   - dpSolver is recommended for counting paths efficiently on moderately sized graphs.
- *   - Graphs with more than ~20 vertices may be infeasible due to exponential growth.
+ *   - The DFS solvers are infeasible beyond ~12 vertices on dense graphs, the DP counts
+ *     n = 24 in seconds; it is limited by memory rather than time.
  */
 
 
 #include <iostream>
 #include <vector>
+#include <span>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include "CSRGraph.h"
+#include "HamiltonianCounter.h"
+#include "HamiltonianEnumerator.h"
 #include "gtest/gtest.h"
 
 class HamiltonSolver{
 public:
-    HamiltonSolver(int numOfVertices, const std::vector<std::pair<int, int>>& edges) : n{numOfVertices}, graph(n)
+    explicit HamiltonSolver(CSRGraphView g) : n{g.size()}, graph{g}
     {
         total = (1 << n) - 1; // all vertices visited mask
-        for (auto [u, v] : edges) {
-            graph[u].push_back(v);
-            graph[v].push_back(u); // undirected graph
-        }
-    }    
+    }
+
+    HamiltonSolver(int numOfVertices, const std::vector<std::pair<int, int>>& edges)
+        : n{numOfVertices}, storage{CSRGraph::fromEdges(numOfVertices, edges, true/*undirected*/)}, graph{storage.view()}
+    {
+        total = (1 << n) - 1; // all vertices visited mask
+    }
+
+    // graph may point into storage, so a copy would view the original's arrays
+    HamiltonSolver(const HamiltonSolver&) = delete;
+    HamiltonSolver& operator=(const HamiltonSolver&) = delete;
 
     /**
      * @brief Brute-force DFS: finds and stores all Hamiltonian paths + cycle info
@@ -82,26 +109,62 @@ public:
     }
 
     /**
-     * @brief Bitmask DP solution: counts Hamiltonian paths with memoization.
-     * Avoids recomputation of dead-end states.
+     * @brief Bitmask DP solution: counts Hamiltonian paths bottom-up over a flat 64-bit table.
+     * @param modulus 0 for counts modulo 2^64, otherwise the counts are reduced modulo it (<= 2^58)
+     * @param threads number of worker threads, 0 means all hardware threads
      */
-    int dpSolver()
+    std::uint64_t dpSolver(std::uint64_t modulus = 0, unsigned threads = 0)
     {
-        std::vector<std::vector<int>> dp((1 << n), std::vector<int>(n, -1)); 
-        // dp[mask][u] = number of Hamiltonian paths from state (mask, u)
+        return HamiltonianPathCounter{graph, {modulus, threads}}.pathCount();
+    }
 
-        int numberOfPaths{};
-        for (int u{}; u < n; ++u) {
-            numberOfPaths += dfs(u, 0/*mask*/, dp);
-        }
+    /**
+     * @brief Counts the Hamiltonian paths that can be closed into a cycle (last vertex adjacent to the first),
+     * i.e. the number of true values of getCycles() after simpleSolver().
+     */
+    std::uint64_t dpCycleSolver(std::uint64_t modulus = 0, unsigned threads = 0)
+    {
+        std::uint64_t cycles{HamiltonianPathCounter::countCycles(graph, {modulus, threads})};
+        // every cycle gives one closable path per starting vertex
+        if (modulus == 0) return cycles * static_cast<std::uint64_t>(n);
+        return static_cast<std::uint64_t>(static_cast<unsigned __int128>(cycles) * static_cast<std::uint64_t>(n) % modulus);
+    }
 
-        return numberOfPaths;
+    /**
+     * @brief Streams every Hamiltonian path to visit(std::span<const int> path, bool isCycle) without storing
+     * them; the span is only valid during the call. A visitor returning false stops the enumeration.
+     * @param limit maximum number of paths, 0 means all of them
+     * @return number of paths visited
+     */
+    template <typename Visitor>
+    std::uint64_t enumerate(Visitor&& visit, std::uint64_t limit = 0)
+    {
+        return getEnumerator().enumerate(visit, limit);
+    }
+
+    /**
+     * @brief enumerate() with one thread per sink, sinks[t] receives the paths of thread t.
+     */
+    template <typename Sink>
+    std::uint64_t enumerateParallel(std::vector<Sink>& sinks, std::uint64_t limit = 0)
+    {
+        return getEnumerator().enumerateParallel(sinks, limit);
     }
 
     const std::vector<std::vector<int>>& getPaths() const { return paths; }
     const std::vector<bool>& getCycles() const { return areCycles; }
     
 private:
+    // built on first use, it holds the pruning table
+    const HamiltonianPathEnumerator& getEnumerator()
+    {
+        if (!enumerator) {
+            // the completion table is only affordable up to maxPrunedVertices
+            enumerator = std::make_unique<HamiltonianPathEnumerator>(graph, n <= HamiltonianPathEnumerator::maxPrunedVertices);
+        }
+        return *enumerator;
+    }
+
     /**
      * @brief DFS used by simpleSolver.
      * Stores all Hamiltonian paths and marks whether they form cycles.
@@ -116,7 +179,7 @@ private:
 
             // check if it's a cycle (last vertex connected to starting one)
             bool isCycle{false};
-            for (int v : graph[u]) {
+            for (int v : graph.neighbors(u)) {
                 if (v == startingVertex) {
                     isCycle = true;
                     break;
@@ -129,7 +192,7 @@ private:
         }
 
         // explore neighbors
-        for (int v : graph[u]) {
+        for (int v : graph.neighbors(u)) {
             if ((mask & (1 << v)) == 0) { // not visited
                 dfs(v, mask, path, startingVertex);
             }
@@ -151,40 +214,21 @@ private:
             return;
         }
 
-        for (int v : graph[u]) {
+        for (int v : graph.neighbors(u)) {
             if ((mask & (1 << v)) == 0) {
                 dfs(v, mask, numberOfPaths);
             }
         }
     }
 
-    /**
-     * @brief DFS + DP (bitmasking).
-     * Returns number of Hamiltonian paths starting from (mask, u).
-     */
-    int dfs(int u, int mask, std::vector<std::vector<int>>& dp)
-    {
-        mask |= (1 << u);
-
-        if (mask == total) return 1; // base case: valid Hamiltonian path
-        if (dp[mask][u] != -1) return dp[mask][u]; // memoized
-
-        int numberOfPaths{};
-        for (int v : graph[u]) {
-            if ((mask & (1 << v)) == 0) { // not visited
-                numberOfPaths += dfs(v, mask, dp);
-            }
-        }
-
-        return dp[mask][u] = numberOfPaths;
-    }
-
 private:
     int n{};                        // number of vertices
     int total{};                    // bitmask with all vertices visited
-    std::vector<std::vector<int>> graph; // adjacency list
+    CSRGraph storage;                    // only used when built from an edge list
+    CSRGraphView graph;                  // adjacency list
     std::vector<std::vector<int>> paths; // all Hamiltonian paths (simpleSolver)
     std::vector<bool> areCycles;         // cycle info for each path
+    std::unique_ptr<HamiltonianPathEnumerator> enumerator; // streaming enumeration (enumerate)
 };
 
 // ---------------- Google Tests ------------------
@@ -196,7 +240,7 @@ TEST(HamiltonSolver, CompleteGraph4)
     HamiltonSolver solver{n, edges};
     solver.simpleSolver();
 
-    int numberOfPaths{solver.dpSolver()};
+    std::uint64_t numberOfPaths{solver.dpSolver()};
     EXPECT_EQ(solver.getPaths().size(), numberOfPaths);
 
     EXPECT_EQ(solver.getPaths().size(), 24); // 4! permutations
@@ -212,7 +256,7 @@ TEST(HamiltonSolver, CompleteGraph3)
     HamiltonSolver solver{n, edges};
     solver.simpleSolver();
 
-    int numberOfPaths{solver.dpSolver()};
+    std::uint64_t numberOfPaths{solver.dpSolver()};
     EXPECT_EQ(solver.getPaths().size(), numberOfPaths);
 
     EXPECT_EQ(solver.getPaths().size(), 6); // 3! permutations
@@ -226,7 +270,7 @@ TEST(HamiltonSolver, LineGraph5)
     HamiltonSolver solver{n, edges};
     solver.simpleSolver();
 
-    int numberOfPaths{solver.dpSolver()};
+    std::uint64_t numberOfPaths{solver.dpSolver()};
     EXPECT_EQ(solver.getPaths().size(), numberOfPaths);
 
     EXPECT_EQ(solver.getPaths().size(), 1 * 2); // only 2 valid Hamiltonian paths
@@ -240,7 +284,7 @@ TEST(HamiltonSolver, SingleCycle)
     HamiltonSolver solver{n, edges};
     solver.simpleSolver();
 
-    int numberOfPaths{solver.dpSolver()};
+    std::uint64_t numberOfPaths{solver.dpSolver()};
     EXPECT_EQ(solver.getPaths().size(), numberOfPaths);
 
     EXPECT_EQ(solver.getPaths().size(), n * 2); // each start has 2 orientations
@@ -253,6 +297,185 @@ TEST(HamiltonSolver, SingleCycle)
     EXPECT_EQ(numberOfCycles, n * 2); // all paths are cycles here
 }
 
+// random undirected graph on n vertices, every edge with probability p
+std::vector<std::pair<int, int>> randomEdges(int n, double p, unsigned seed)
+{
+    std::mt19937 rng{seed};
+    std::bernoulli_distribution coin(p);
+
+    std::vector<std::pair<int, int>> edges;
+    for (int u{}; u < n; ++u) {
+        for (int v{u + 1}; v < n; ++v) {
+            if (coin(rng)) edges.push_back({u, v});
+        }
+    }
+    return edges;
+}
+
+std::vector<std::pair<int, int>> completeEdges(int n)
+{
+    return randomEdges(n, 1.0, 0);
+}
+
+TEST(HamiltonSolver, DPMatchesDFSOnRandomGraphs)
+{
+    for (unsigned seed{1}; seed <= 20; ++seed) {
+        int n{static_cast<int>(4 + seed % 6)};
+        HamiltonSolver solver{n, randomEdges(n, 0.5, seed)};
+        solver.simpleSolver();
+
+        std::uint64_t closable{};
+        for (auto c : solver.getCycles()) closable += c;
+
+        EXPECT_EQ(solver.dpSolver(), solver.getPaths().size()) << "seed " << seed;
+        EXPECT_EQ(solver.dpCycleSolver(), closable) << "seed " << seed;
+    }
+}
+
+TEST(HamiltonSolver, CompleteGraphCounts)
+{
+    // K_n: n! paths, (n - 1)! directed cycles, i.e. (n - 1)! / 2 undirected ones
+    std::uint64_t factorial{1};
+    for (int n{1}; n <= 20; ++n) {
+        factorial *= static_cast<std::uint64_t>(n);
+        if (n < 3 || n % 4 != 0) continue;
+
+        CSRGraph graph{CSRGraph::fromEdges(n, completeEdges(n), true/*undirected*/)};
+        HamiltonianPathCounter counter{graph.view()};
+        EXPECT_EQ(counter.pathCount(), factorial) << "K" << n;
+        EXPECT_EQ(counter.pathCountFrom(0), factorial / n) << "K" << n;
+        EXPECT_EQ(counter.cycleCount(), factorial / n) << "K" << n;
+    }
+}
+
+TEST(HamiltonSolver, DirectedGraphs)
+{
+    // directed cycle 0 -> 1 -> ... -> 9 -> 0: one path per start vertex, one cycle
+    const int n{10};
+    std::vector<std::uint32_t> ring(n);
+    for (int v{}; v < n; ++v) ring[v] = std::uint32_t{1} << ((v + 1) % n);
+
+    HamiltonianPathCounter counter{ring};
+    EXPECT_EQ(counter.pathCount(), n);
+    EXPECT_EQ(counter.cycleCount(), 1);
+    EXPECT_EQ(counter.completions(0b1110, 1), 1); // 1 -> 2 -> 3
+    EXPECT_EQ(counter.completions(0b1110, 2), 0); // 2 -> 3 can't go back to 1
+
+    // a single vertex is a path, and a cycle with a self-loop only
+    EXPECT_EQ(HamiltonianPathCounter{std::vector<std::uint32_t>{0}}.pathCount(), 1);
+    EXPECT_EQ(HamiltonianPathCounter{std::vector<std::uint32_t>{0}}.cycleCount(), 0);
+    EXPECT_EQ(HamiltonianPathCounter{std::vector<std::uint32_t>{1}}.cycleCount(), 1);
+    EXPECT_EQ(HamiltonianPathCounter{std::vector<std::uint32_t>{}}.pathCount(), 0);
+
+    EXPECT_THROW(HamiltonianPathCounter{std::vector<std::uint32_t>(33)}, std::invalid_argument);
+    EXPECT_THROW((HamiltonianPathCounter{ring, {HamiltonianPathCounter::maxModulus + 1}}), std::invalid_argument);
+}
+
+TEST(HamiltonSolver, ModularCounts)
+{
+    // 21! doesn't fit 64 bits: counts wrap modulo 2^64 or are reduced modulo a prime
+    const int n{21};
+    const std::uint64_t prime{1'000'000'007};
+    std::uint64_t wrapped{1}, reduced{1};
+    for (int i{2}; i <= n; ++i) {
+        wrapped *= static_cast<std::uint64_t>(i);
+        reduced = reduced * i % prime;
+    }
+
+    HamiltonSolver solver{n, completeEdges(n)};
+    EXPECT_EQ(solver.dpSolver(), wrapped);
+    EXPECT_EQ(solver.dpSolver(prime), reduced);
+    EXPECT_EQ(solver.dpCycleSolver(prime), reduced); // n * (n - 1)! closable paths
+}
+
+TEST(HamiltonSolver, IndependentOfThreadCount)
+{
+    const int n{18};
+    HamiltonSolver solver{n, randomEdges(n, 0.4, 7)};
+
+    std::uint64_t single{solver.dpSolver(0, 1)};
+    EXPECT_GT(single, 0);
+    EXPECT_EQ(solver.dpSolver(0, 4), single);
+    EXPECT_EQ(solver.dpCycleSolver(0, 1), solver.dpCycleSolver(0, 4));
+}
+
+// every path as a vector, with its cycle flag, sorted
+std::vector<std::pair<std::vector<int>, bool>> collectSorted(HamiltonSolver& solver)
+{
+    std::vector<std::pair<std::vector<int>, bool>> result;
+    solver.enumerate([&result](std::span<const int> path, bool isCycle) {
+        result.push_back({std::vector<int>(path.begin(), path.end()), isCycle});
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST(HamiltonSolver, EnumerateMatchesSimpleSolver)
+{
+    for (unsigned seed{1}; seed <= 20; ++seed) {
+        int n{static_cast<int>(4 + seed % 6)};
+        HamiltonSolver solver{n, randomEdges(n, 0.5, seed)};
+        solver.simpleSolver();
+
+        std::vector<std::pair<std::vector<int>, bool>> expected;
+        for (std::size_t i{}; i < solver.getPaths().size(); ++i) expected.push_back({solver.getPaths()[i], solver.getCycles()[i]});
+        std::sort(expected.begin(), expected.end());
+
+        EXPECT_EQ(collectSorted(solver), expected) << "seed " << seed;
+    }
+}
+
+TEST(HamiltonSolver, EnumerateLimitAndEarlyStop)
+{
+    const int n{10}; // 10! paths, never stored
+    HamiltonSolver solver{n, completeEdges(n)};
+
+    std::uint64_t seen{};
+    EXPECT_EQ(solver.enumerate([&seen](std::span<const int>, bool) { ++seen; }, 1000), 1000);
+    EXPECT_EQ(seen, 1000);
+
+    std::vector<int> fifth;
+    std::uint64_t visited{solver.enumerate([&](std::span<const int> path, bool) {
+        if (++seen < 1005) return true;
+        fifth.assign(path.begin(), path.end());
+        return false; // stop
+    })};
+    EXPECT_EQ(visited, 5);
+    EXPECT_EQ(fifth, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 9, 7, 8})); // lexicographic order
+
+    // all of them, one buffer
+    std::uint64_t total{solver.enumerate([](std::span<const int>, bool) { })};
+    EXPECT_EQ(total, solver.dpSolver());
+}
+
+TEST(HamiltonSolver, EnumerateParallelSinks)
+{
+    const int n{11};
+    HamiltonSolver solver{n, randomEdges(n, 0.6, 5)};
+    std::vector<std::pair<std::vector<int>, bool>> expected{collectSorted(solver)};
+
+    struct Sink
+    {
+        std::vector<std::pair<std::vector<int>, bool>> paths;
+        void operator()(std::span<const int> path, bool isCycle) { paths.push_back({{path.begin(), path.end()}, isCycle}); }
+    };
+
+    std::vector<Sink> sinks(4);
+    EXPECT_EQ(solver.enumerateParallel(sinks), expected.size());
+
+    std::vector<std::pair<std::vector<int>, bool>> merged;
+    for (auto& sink : sinks) merged.insert(merged.end(), sink.paths.begin(), sink.paths.end());
+    std::sort(merged.begin(), merged.end());
+    EXPECT_EQ(merged, expected);
+
+    // the limit is shared by all sinks
+    std::vector<Sink> limited(3);
+    EXPECT_EQ(solver.enumerateParallel(limited, 100), 100);
+    std::size_t delivered{};
+    for (auto& sink : limited) delivered += sink.paths.size();
+    EXPECT_EQ(delivered, 100);
+}
+
 TEST(HamiltonSolver, BenchmarkDPvsSimple)
 {
     int n{12}; // bigger graph to see performance difference
@@ -260,11 +483,11 @@ TEST(HamiltonSolver, BenchmarkDPvsSimple)
     HamiltonSolver solver{n, edges};
 
     auto start1 = std::chrono::high_resolution_clock::now();
-    int paths1{solver.pureSimpleSolver()};
+    std::uint64_t paths1(solver.pureSimpleSolver());
     auto end1 = std::chrono::high_resolution_clock::now();
 
     auto start2 = std::chrono::high_resolution_clock::now();
-    int paths2{solver.dpSolver()};
+    std::uint64_t paths2{solver.dpSolver()};
     auto end2 = std::chrono::high_resolution_clock::now();
 
     EXPECT_EQ(paths1, paths2);
@@ -278,6 +501,60 @@ TEST(HamiltonSolver, BenchmarkDPvsSimple)
               << " ms\n";
 }
 
+TEST(HamiltonSolver, BenchmarkDPLargeGraph)
+{
+    const int n{22}; // n = 24 works the same way, with 3.2 GB for the table
+    CSRGraph graph{CSRGraph::fromEdges(n, randomEdges(n, 0.5, 3), true/*undirected*/)};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    HamiltonianPathCounter counter{graph.view()};
+    std::uint64_t paths{counter.pathCount()};
+    auto end = std::chrono::high_resolution_clock::now();
+
+    EXPECT_GT(paths, 0);
+    std::cout << "dp n = " << n << ": " << paths << " paths, "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms, "
+              << HamiltonianPathCounter::requiredBytes(n) / (1 << 20) << " MB\n";
+}
+
+TEST(HamiltonSolver, PruningTableIsBounded)
+{
+    // a path on 25 vertices: the table would take 6.25 GiB, the plain DFS finds both directions at once
+    const int n{HamiltonianPathEnumerator::maxPrunedVertices + 1};
+    std::vector<std::pair<int, int>> edges;
+    for (int v{1}; v < n; ++v) edges.push_back({v - 1, v});
+    CSRGraph graph{CSRGraph::fromEdges(n, edges, true/*undirected*/)};
+
+    EXPECT_THROW(HamiltonianPathEnumerator{graph.view()}, std::invalid_argument);
+    EXPECT_EQ(HamiltonianPathEnumerator(graph.view(), false).enumerate([](std::span<const int>, bool) { }), 2);
+
+    HamiltonSolver solver{n, edges};
+    EXPECT_EQ(solver.enumerate([](std::span<const int>, bool) { }), 2); // falls back to the plain DFS
+}
+
+TEST(HamiltonSolver, BenchmarkEnumerationPruning)
+{
+    // sparse graph: few Hamiltonian paths, many dead ends for a plain DFS
+    const int n{21};
+    CSRGraph graph{CSRGraph::fromEdges(n, randomEdges(n, 0.2, 11), true/*undirected*/)};
+
+    auto time = [](const HamiltonianPathEnumerator& enumerator, const char* name) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::uint64_t paths{enumerator.enumerate([](std::span<const int>, bool) { })};
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << name << ": " << paths << " paths, "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+        return paths;
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    HamiltonianPathEnumerator pruned{graph.view()};
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "pruning table: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    EXPECT_EQ(time(pruned, "pruned"), time(HamiltonianPathEnumerator{graph.view(), false}, "plain DFS"));
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <bit>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include "../Common/AlignedBuffer.h"
+#include "../Common/Combinations.h"
+#include "../Common/MinPlus.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @brief Optimal tour of a traveling salesman problem: cost -1 (and an empty order) if there is no
+ *        Hamiltonian cycle, otherwise order = start, ..., start.
+ */
+struct TSPTour
+{
+    int cost{-1};
+    std::vector<int> order;
+};
+
+/**
+ * @class HeldKarpSolver
+ *
+ * @brief Held–Karp dynamic programming over one flat table, parallel by popcount layers, with tour recovery.
+ *
+ * The start vertex is in every path, so it is dropped from the masks: with m = n - 1 remaining vertices
+ *     dp[mask * m + v] = cost of the cheapest path start -> ... -> v visiting exactly the vertices of mask
+ * which is m * 2^m entries instead of n * 2^n, in one 64-byte aligned allocation.
+ *
+ * Every mask only depends on masks with one vertex less, so the masks are processed by popcount: all masks
+ * of a layer are independent and a layer is split into contiguous rank ranges, one per thread (each thread
+ * unranks the first mask of its range and walks the rest with Gosper's hack, see Combinations.h).
+ *
+ * A mask is computed in pull form, which writes one contiguous row and reads earlier rows only:
+ *     dp[mask][v] = min over u of dp[mask \ v][u] + cost(u, v)
+ * Entries of vertices outside a mask are kept at the sentinel, so this is a dense min-plus reduction over a
+ * dp row and a column of the cost matrix (MinPlus.h), without testing membership of u.
+ *
+ * parent[mask * m + v] (one byte) is the u that achieved the minimum (the reduction returns it along with
+ * the minimum), which gives the tour in O(n).
+ *
+ * Memory: m * 2^m * 5 bytes, e.g. 2 GB for n = 25. Time: O(n² 2^n) with vectorized inner loops.
+ * Path costs have to stay below minPlusInfinity (INT_MAX / 2), larger sums read as "unreachable".
+ */
+
+class HeldKarpSolver
+{
+public:
+    static constexpr int maxVertices{32};
+
+    /**
+     * @param cost dense n x n matrix, minPlusInfinity (or larger) for "no edge"; may be asymmetric
+     * @param threads number of worker threads, 0 means all hardware threads
+     */
+    HeldKarpSolver(const std::vector<std::vector<int>>& cost, int start = 0, unsigned threads = 0)
+        : n{static_cast<int>(cost.size())}, m{n - 1}, startPoint{start}, threadCount{threads == 0 ? defaultThreadCount() : threads}
+    {
+        if (n == 0) throw std::invalid_argument("Number of Vertices should be > 0");
+        if (n > maxVertices) throw std::length_error("HeldKarpSolver supports at most 32 vertices");
+        if (start < 0 || start >= n) throw std::out_of_range("Start vertex outside [0,V)");
+
+        // vertex ids without the start: index i < m stands for vertex i + (i >= start)
+        incoming.assign(static_cast<std::size_t>(m) * std::max(m, 1), minPlusInfinity);
+        fromStart.assign(m, minPlusInfinity);
+        toStart.assign(m, minPlusInfinity);
+        for (int i{}; i < m; ++i) {
+            fromStart[i] = std::min(cost[startPoint][vertex(i)], minPlusInfinity);
+            toStart[i] = std::min(cost[vertex(i)][startPoint], minPlusInfinity);
+            for (int j{}; j < m; ++j) {
+                if (i != j) incoming[static_cast<std::size_t>(j) * m + i] = std::min(cost[vertex(i)][vertex(j)], minPlusInfinity);
+            }
+        }
+        selfLoop = n == 1 ? std::min(cost[startPoint][startPoint], minPlusInfinity) : minPlusInfinity;
+    }
+
+    // bytes of the dp and parent tables for n vertices
+    static std::size_t requiredBytes(int n) noexcept
+    {
+        if (n <= 1) return 0;
+        return static_cast<std::size_t>(n - 1) * (std::size_t{1} << (n - 1)) * (sizeof(int) + sizeof(std::uint8_t));
+    }
+
+    TSPTour solve()
+    {
+        if (m == 0) {
+            if (selfLoop == minPlusInfinity) return {};
+            return TSPTour{selfLoop, {startPoint, startPoint}};
+        }
+
+        const std::size_t states{static_cast<std::size_t>(m) << m};
+        dp = AlignedBuffer<int>(states);
+        parent = AlignedBuffer<std::uint8_t>(states);
+
+        for (int k{1}; k <= m; ++k) {
+            std::uint64_t layerSize{Combinations::binomial(m, k)};
+            parallelForChunks(layerSize, threadCount, [&](std::size_t begin, std::size_t end, unsigned) {
+                std::uint32_t mask{Combinations::unrankCombination(k, begin)};
+                for (std::size_t r{begin}; r < end; ++r) {
+                    computeMask(mask, k);
+                    if (r + 1 < end) mask = Combinations::nextCombination(mask);
+                }
+            }, minChunk);
+        }
+
+        // close the cycle
+        const std::uint32_t full{(std::uint32_t{1} << m) - 1};
+        int bestCost{minPlusInfinity}, last{-1};
+        for (int v{}; v < m; ++v) {
+            int d{dp[index(full, v)]};
+            if (d >= minPlusInfinity || toStart[v] >= minPlusInfinity || d + toStart[v] >= bestCost) continue;
+            bestCost = d + toStart[v];
+            last = v;
+        }
+        if (last == -1) return {};
+
+        TSPTour tour{bestCost, {}};
+        tour.order.push_back(startPoint);
+        for (std::uint32_t mask{full}; mask != 0;) {
+            tour.order.push_back(vertex(last));
+            int previous{parent[index(mask, last)]};
+            mask &= ~(std::uint32_t{1} << last);
+            last = previous;
+        }
+        tour.order.push_back(startPoint);
+        std::reverse(tour.order.begin() + 1, tour.order.end() - 1);
+
+        return tour;
+    }
+
+private:
+    std::size_t index(std::uint32_t mask, int v) const noexcept { return static_cast<std::size_t>(mask) * m + v; }
+    int vertex(int i) const noexcept { return i + (i >= startPoint); }
+
+    void computeMask(std::uint32_t mask, int k)
+    {
+        int* current{&dp[index(mask, 0)]};
+        std::uint8_t* currentParent{&parent[index(mask, 0)]};
+        std::fill(current, current + m, minPlusInfinity);
+
+        if (k == 1) {
+            int v{std::countr_zero(mask)};
+            current[v] = fromStart[v];
+            currentParent[v] = noParent;
+            return;
+        }
+
+        for (std::uint32_t rest{mask}; rest != 0; rest &= rest - 1) {
+            int v{std::countr_zero(rest)};
+            const int* previous{&dp[index(mask & ~(std::uint32_t{1} << v), 0)]};
+            const int* into{&incoming[static_cast<std::size_t>(v) * m]};
+
+            auto [best, u] {minPlusReduceWithArg(previous, into, m)};
+            current[v] = best;
+            currentParent[v] = best < minPlusInfinity ? static_cast<std::uint8_t>(u) : noParent;
+        }
+    }
+
+private:
+    static constexpr std::size_t minChunk{64}; // masks per thread at least
+    static constexpr std::uint8_t noParent{0xFF};
+
+    int n{};
+    int m{}; // vertices without the start
+    int startPoint{};
+    unsigned threadCount{};
+    int selfLoop{};
+
+    std::vector<int> incoming;  // incoming[v * m + u] = cost(u, v), a contiguous column per v
+    std::vector<int> fromStart; // cost(start, v)
+    std::vector<int> toStart;   // cost(v, start)
+
+    AlignedBuffer<int> dp;
+    AlignedBuffer<std::uint8_t> parent;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include "CSRGraph.h"
+
+/**
+ * @brief Depth-first search with an explicit frame stack, shared by Tarjan, BridgeSolver,
+ *        ArticulationPointSolver and EulerianPathSolver.
+ *
+ * The recursive versions use one native stack frame per tree level, which overflows on long paths (a
+ * million-vertex chain needs a million frames). Here a frame is two ints in a contiguous vector that is
+ * reserved for n frames up front, and the position in the adjacency list of every vertex is a cursor
+ * into the CSR edge range instead of an iterator living in a stack frame.
+ *
+ * The cursors belong to the vertices, not to the frames: an edge is consumed once, no matter how often
+ * its tail is entered. For the classic DFS every vertex is entered at most once, so this is the same
+ * thing; Hierholzer's algorithm re-enters vertices and relies on exactly this.
+ *
+ * Hooks (a visitor derives from DFSVisitor and hides the ones it needs):
+ *   void enter(int v, int edge)          v is pushed; edge is the edge it was reached by, -1 for the root
+ *   bool edge(int u, int v, int edge)    an edge u -> v is scanned; return true to descend into v (tree edge),
+ *                                        false to skip it (back, forward or cross edge, handled by the visitor)
+ *   void retreat(int u, int v, int edge) back at u after v, entered through edge, was finished
+ *   void exit(int u)                     all edges of u are scanned, u is popped
+ */
+
+struct DFSVisitor
+{
+    void enter(int, int) { }
+    bool edge(int, int, int) { return true; }
+    void retreat(int, int, int) { }
+    void exit(int) { }
+};
+
+class IterativeDFS
+{
+public:
+    explicit IterativeDFS(CSRGraphView g) : graph{g}, cursor(g.size())
+    {
+        for (int u{}; u < graph.size(); ++u) cursor[u] = graph.firstEdge(u);
+        frames.reserve(graph.size());
+    }
+
+    template <typename Visitor>
+    void run(int root, Visitor& visitor)
+    {
+        visitor.enter(root, -1);
+        frames.push_back(Frame{root, -1});
+
+        while (!frames.empty()) {
+            const int u{frames.back().vertex};
+
+            if (cursor[u] < graph.lastEdge(u)) {
+                int e{cursor[u]++};
+                int v{graph.target(e)};
+
+                if (visitor.edge(u, v, e)) {
+                    visitor.enter(v, e);
+                    frames.push_back(Frame{v, e});
+                }
+                continue;
+            }
+
+            const int entryEdge{frames.back().edge};
+            frames.pop_back();
+            visitor.exit(u);
+            if (!frames.empty()) visitor.retreat(frames.back().vertex, u, entryEdge);
+        }
+    }
+
+private:
+    struct Frame
+    {
+        int vertex{};
+        int edge{}; // the edge vertex was entered by
+    };
+
+    CSRGraphView graph;
+    std::vector<int> cursor;
+    std::vector<Frame> frames;
+};
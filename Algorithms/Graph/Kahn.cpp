@@ -1,6 +1,13 @@
+#include <mutex>
+#include <atomic>
 #include <vector>
-#include <queue>
+#include <random>
+#include <chrono>
 #include <iostream>
+#include "CSRGraph.h"
+#include "TopologicalOrder.h"
+#include "DagExecutor.h"
+#include "gtest/gtest.h"
 
 /*
     Kahn's algorithm is a graph traversal algorithm used to find a topological ordering of a Directed Acyclic Graph (DAG).
@@ -10,48 +17,322 @@
     Cycle Detection – If the algorithm processes all nodes, the graph is a DAG. If there are leftover nodes with nonzero in-degree,
         the graph contains a cycle, making topological sorting impossible.
     This method is widely used in task scheduling, dependency resolution (e.g., package managers), and compiler optimizations.
+
+    The queue loop itself is topologicalOrder() in TopologicalOrder.h, which returns the order. When edges keep arriving,
+    DynamicTopologicalOrder (same header) is seeded once by it and repairs the order per insertion instead of rerunning it.
+
+    For scheduling, one serial order hides the parallelism: topologicalLevels() returns the wavefronts (every level can run
+    concurrently), and DagExecutor runs a callback per vertex on a work-stealing pool as soon as its in-degree reaches zero.
 */
 
 
 // Function to perform Kahn's algorithm for topological sorting
-// If a cycle is detected, the function will print an appropriate message.
-void KahnAlgorithm(int n/*number of vertices*/, const std::vector<std::pair<int, int>>& edges) {
-    std::vector<std::vector<int>> graph(n);
-    std::vector<int> inDegree(n); // Stores the in-degree of each vertex
+// Returns the order, empty if a cycle is detected (and then prints an appropriate message).
+std::vector<int> KahnAlgorithm(CSRGraphView graph) {
+    std::vector<int> topSort{topologicalOrder(graph)};
+
+    // If we visited all nodes, a topological sort is possible
+    if (static_cast<int>(topSort.size()) == graph.size()) {
+        std::cout << "Topological Order: ";
+        for (int v : topSort) std::cout << v << " ";
+        std::cout << std::endl;
+        return topSort;
+    }
 
+    std::cout << "Cycle detected! No valid topological sorting." << std::endl;
+    return {};
+}
+
+std::vector<int> KahnAlgorithm(int n/*number of vertices*/, const std::vector<std::pair<int, int>>& edges) {
+    CSRGraph graph{CSRGraph::fromEdges(n, edges)}; // directed edges u -> v
+    return KahnAlgorithm(graph.view());
+}
+
+// every edge goes forward in the order, and the order is a permutation
+bool isTopologicalOrder(int n, const std::vector<std::pair<int, int>>& edges, const std::vector<int>& order)
+{
+    if (static_cast<int>(order.size()) != n) return false;
+    std::vector<int> position(n, -1);
+    for (int i{}; i < n; ++i) {
+        if (order[i] < 0 || order[i] >= n || position[order[i]] != -1) return false;
+        position[order[i]] = i;
+    }
     for (auto [u, v] : edges) {
-        graph[u].push_back(v); // Add directed edge u -> v
-        ++inDegree[v]; // Increase in-degree of v
+        if (position[u] >= position[v]) return false;
     }
+    return true;
+}
 
-    std::queue<int> q;
-    // Push all nodes with in-degree 0 into the queue (starting points)
-    for (int u{}; u < n; ++u) {
-        if (inDegree[u] == 0) q.push(u); 
+// plain BFS, the reference for the cycle check
+bool reaches(int n, const std::vector<std::pair<int, int>>& edges, int from, int to)
+{
+    CSRGraph g{CSRGraph::fromEdges(n, edges)};
+    std::vector<bool> seen(n);
+    std::vector<int> queue{from};
+    seen[from] = true;
+    for (std::size_t head{}; head < queue.size(); ++head) {
+        if (queue[head] == to) return true;
+        for (int w : g.view().neighbors(queue[head])) {
+            if (!seen[w]) {
+                seen[w] = true;
+                queue.push_back(w);
+            }
+        }
     }
+    return false;
+}
+
+TEST(KahnTest, Dag)
+{
+    std::vector<std::pair<int, int>> edges{{5, 2}, {5, 0}, {4, 0}, {4, 1}, {2, 3}, {3, 1}};
+    std::vector<int> order{KahnAlgorithm(6, edges)};
+    EXPECT_EQ(order, (std::vector<int>{4, 5, 2, 0, 3, 1}));
+    EXPECT_TRUE(isTopologicalOrder(6, edges, order));
+}
+
+TEST(KahnTest, Cycle)
+{
+    EXPECT_TRUE(KahnAlgorithm(3, {{0, 1}, {1, 2}, {2, 0}}).empty());
+    EXPECT_EQ(topologicalOrder(CSRGraph::fromEdges(4, {{3, 0}, {0, 1}, {1, 0}}).view()), (std::vector<int>{2, 3}));
+}
+
+TEST(DynamicTopologicalOrderTest, InsertionsReorderTheAffectedRegion)
+{
+    // 0 -> 1 -> 2, 3 -> 4: Kahn gives 0 3 1 4 2
+    DynamicTopologicalOrder topo{5, {{0, 1}, {1, 2}, {3, 4}}};
+    EXPECT_EQ(topo.order(), (std::vector<int>{0, 3, 1, 4, 2}));
 
-    int visitedNodes{}; // Counter for cycle detection
-    std::vector<int> topSort{}; // Stores topologically sorted order
+    EXPECT_TRUE(topo.addEdge(0, 4)); // already forward, nothing moves
+    EXPECT_EQ(topo.order(), (std::vector<int>{0, 3, 1, 4, 2}));
 
-    while (!q.empty()) {
-        int u{q.front()};
-        q.pop();
-        ++visitedNodes;
-        topSort.push_back(u); // Add vertex to the topological order
+    EXPECT_TRUE(topo.addEdge(2, 3)); // 3 and 4 have to go behind 2
+    EXPECT_TRUE(isTopologicalOrder(5, {{0, 1}, {1, 2}, {3, 4}, {0, 4}, {2, 3}}, topo.order()));
+    EXPECT_EQ(topo.order(), (std::vector<int>{0, 1, 2, 3, 4}));
+    for (int v{}; v < 5; ++v) EXPECT_EQ(topo.order()[topo.rank(v)], v);
+    EXPECT_TRUE(topo.cycle().empty());
+}
 
-        // Reduce the in-degree of neighboring nodes
-        for (int v : graph[u]) {
-            --inDegree[v];
-            if (!inDegree[v]) q.push(v); 
+TEST(DynamicTopologicalOrderTest, RejectsEdgesClosingACycle)
+{
+    DynamicTopologicalOrder topo{4, {{0, 1}, {1, 2}, {2, 3}}};
+    std::vector<int> before{topo.order()};
+
+    EXPECT_FALSE(topo.addEdge(3, 0));
+    EXPECT_EQ(topo.cycle(), (std::vector<int>{3, 0, 1, 2, 3}));
+    EXPECT_EQ(topo.order(), before);
+
+    EXPECT_FALSE(topo.addEdge(2, 2));
+    EXPECT_EQ(topo.cycle(), (std::vector<int>{2, 2}));
+
+    EXPECT_TRUE(topo.addEdge(0, 3));
+    EXPECT_TRUE(topo.cycle().empty());
+
+    EXPECT_THROW(topo.addEdge(0, 4), std::out_of_range);
+    EXPECT_THROW((DynamicTopologicalOrder{2, {{0, 1}, {1, 0}}}), std::invalid_argument);
+}
+
+TEST(DynamicTopologicalOrderTest, RandomInsertionsKeepAValidOrder)
+{
+    std::mt19937 rng{42};
+    const int n{300};
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+
+    // seed: random forward edges of a hidden permutation, so it is acyclic
+    std::vector<std::pair<int, int>> edges;
+    for (int i{}; i < 400; ++i) {
+        int a{vertex(rng)}, b{vertex(rng)};
+        if (a != b) edges.push_back({std::min(a, b), std::max(a, b)});
+    }
+
+    DynamicTopologicalOrder topo{n, edges};
+    for (int i{}; i < 1000; ++i) {
+        int u{vertex(rng)}, v{vertex(rng)};
+        bool closesCycle{u == v || reaches(n, edges, v, u)};
+
+        ASSERT_EQ(topo.addEdge(u, v), !closesCycle) << u << " -> " << v;
+        if (closesCycle) {
+            const std::vector<int>& cycle{topo.cycle()};
+            ASSERT_GE(cycle.size(), 2u);
+            EXPECT_EQ(cycle.front(), u);
+            EXPECT_EQ(cycle.back(), u);
+        } else {
+            edges.push_back({u, v});
         }
+        ASSERT_TRUE(isTopologicalOrder(n, edges, topo.order()));
     }
+}
 
-    // If we visited all nodes, a topological sort is possible
-    if (visitedNodes == n) {
-        std::cout << "Topological Order: ";
-        for (int v : topSort) std::cout << v << " ";
-        std::cout << std::endl;
-    } else {
-        std::cout << "Cycle detected! No valid topological sorting." << std::endl;
+TEST(DynamicTopologicalOrderTest, BenchmarkAgainstRecomputing)
+{
+    // layered random DAG, 1M vertices, 4M edges, then 1000 insertions
+    const int n{1'000'000};
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::vector<std::pair<int, int>> edges;
+    for (int i{}; i < 4 * n; ++i) {
+        int a{vertex(rng)}, b{vertex(rng)};
+        if (a != b) edges.push_back({std::min(a, b), std::max(a, b)});
+    }
+
+    DynamicTopologicalOrder topo{n, edges};
+    std::vector<std::pair<int, int>> insertions;
+    for (int i{}; i < 1000; ++i) {
+        // short back-and-forth ranges, like a dependency added between neighbouring jobs
+        int a{vertex(rng)};
+        int b{std::min(n - 1, a + 1 + static_cast<int>(rng() % 64))};
+        insertions.push_back({b, a});
+    }
+
+    auto start{std::chrono::steady_clock::now()};
+    int accepted{};
+    for (auto [u, v] : insertions) accepted += topo.addEdge(u, v);
+    auto incremental{std::chrono::steady_clock::now() - start};
+
+    start = std::chrono::steady_clock::now();
+    CSRGraph g{CSRGraph::fromEdges(n, edges)};
+    std::vector<int> once{topologicalOrder(g.view())};
+    auto recompute{std::chrono::steady_clock::now() - start};
+    EXPECT_EQ(static_cast<int>(once.size()), n);
+
+    std::cout << accepted << " of " << insertions.size() << " insertions accepted, incremental total "
+              << std::chrono::duration_cast<std::chrono::microseconds>(incremental).count() << " us, one full rebuild "
+              << std::chrono::duration_cast<std::chrono::microseconds>(recompute).count() << " us" << std::endl;
+}
+
+// random DAG: edges from smaller to larger vertex ids
+std::vector<std::pair<int, int>> randomDag(int n, int m, unsigned seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::vector<std::pair<int, int>> edges;
+    for (int i{}; i < m; ++i) {
+        int a{vertex(rng)}, b{vertex(rng)};
+        if (a != b) edges.push_back({std::min(a, b), std::max(a, b)});
+    }
+    return edges;
+}
+
+TEST(TopologicalLevelsTest, Wavefronts)
+{
+    // 5 -> 2 -> 3 -> 1, 5 -> 0, 4 -> 0, 4 -> 1
+    CSRGraph g{CSRGraph::fromEdges(6, {{5, 2}, {5, 0}, {4, 0}, {4, 1}, {2, 3}, {3, 1}})};
+    TopologicalLevels levels{topologicalLevels(g.view(), 2)};
+
+    ASSERT_TRUE(levels.isComplete());
+    ASSERT_EQ(levels.count(), 4);
+    EXPECT_EQ(std::vector<int>(levels.level(0).begin(), levels.level(0).end()), (std::vector<int>{4, 5}));
+    EXPECT_EQ(std::vector<int>(levels.level(1).begin(), levels.level(1).end()), (std::vector<int>{0, 2}));
+    EXPECT_EQ(std::vector<int>(levels.level(2).begin(), levels.level(2).end()), (std::vector<int>{3}));
+    EXPECT_EQ(std::vector<int>(levels.level(3).begin(), levels.level(3).end()), (std::vector<int>{1}));
+
+    CSRGraph cyclic{CSRGraph::fromEdges(4, {{3, 0}, {0, 1}, {1, 0}, {1, 2}})};
+    TopologicalLevels partial{topologicalLevels(cyclic.view())};
+    EXPECT_FALSE(partial.isComplete());
+    EXPECT_EQ(partial.vertices, (std::vector<int>{3}));
+}
+
+TEST(TopologicalLevelsTest, LevelIsTheLongestPathToTheVertex)
+{
+    const int n{50'000};
+    std::vector<std::pair<int, int>> edges{randomDag(n, 200'000, 5)};
+    CSRGraph g{CSRGraph::fromEdges(n, edges)};
+
+    // reference: longest path over a serial topological order
+    std::vector<int> depth(n);
+    for (int u : topologicalOrder(g.view())) {
+        for (int v : g.view().neighbors(u)) depth[v] = std::max(depth[v], depth[u] + 1);
+    }
+
+    for (unsigned threads : {1u, 4u}) {
+        TopologicalLevels levels{topologicalLevels(g.view(), threads)};
+        ASSERT_TRUE(levels.isComplete());
+        for (int i{}; i < levels.count(); ++i) {
+            EXPECT_TRUE(std::is_sorted(levels.level(i).begin(), levels.level(i).end()));
+            for (int v : levels.level(i)) ASSERT_EQ(depth[v], i);
+        }
     }
-}
\ No newline at end of file
+}
+
+TEST(DagExecutorTest, EveryVertexRunsOnceAfterItsPredecessors)
+{
+    const int n{20'000};
+    std::vector<std::pair<int, int>> edges{randomDag(n, 80'000, 9)};
+    CSRGraph g{CSRGraph::fromEdges(n, edges)};
+
+    WorkStealingPool pool{4};
+    DagExecutor executor{g.view()};
+
+    for (int round{}; round < 2; ++round) {
+        std::vector<std::atomic<int>> runs(n);
+        std::vector<int> finishedAt(n, -1);
+        std::atomic<int> clock{};
+        executor.run(pool, [&](int v) {
+            runs[v].fetch_add(1);
+            finishedAt[v] = clock.fetch_add(1);
+        });
+
+        for (int v{}; v < n; ++v) ASSERT_EQ(runs[v].load(), 1);
+        for (auto [u, v] : edges) ASSERT_LT(finishedAt[u], finishedAt[v]);
+    }
+}
+
+TEST(DagExecutorTest, StopsOnTheFirstErrorAndOnCycles)
+{
+    // 0 -> 1 -> 2 -> 3: the callback of 1 throws, 2 and 3 never run
+    CSRGraph chain{CSRGraph::fromEdges(4, {{0, 1}, {1, 2}, {2, 3}})};
+    WorkStealingPool pool{2};
+    DagExecutor executor{chain.view()};
+
+    std::mutex m;
+    std::vector<int> ran;
+    EXPECT_THROW(executor.run(pool, [&](int v) {
+        if (v == 1) throw std::runtime_error("job failed");
+        std::lock_guard lock{m};
+        ran.push_back(v);
+    }), std::runtime_error);
+    EXPECT_EQ(ran, (std::vector<int>{0}));
+
+    // 3 -> 0 <-> 1: only 3 can run
+    CSRGraph cyclic{CSRGraph::fromEdges(4, {{3, 0}, {0, 1}, {1, 0}})};
+    ran.clear();
+    EXPECT_THROW(DagExecutor{cyclic.view()}.run(pool, [&](int v) {
+        std::lock_guard lock{m};
+        ran.push_back(v);
+    }), std::invalid_argument);
+    std::sort(ran.begin(), ran.end());
+    EXPECT_EQ(ran, (std::vector<int>{2, 3}));
+}
+
+TEST(DagExecutorTest, BenchmarkAgainstLevels)
+{
+    // uneven jobs: a level-synchronous schedule waits for the slowest job of every level
+    const int n{2'000};
+    std::vector<std::pair<int, int>> edges{randomDag(n, 6'000, 13)};
+    CSRGraph g{CSRGraph::fromEdges(n, edges)};
+    auto job = [](int v) {
+        volatile unsigned x{};
+        for (int i{}; i < (v % 17 == 0 ? 200'000 : 2'000); ++i) x = x + i;
+    };
+
+    WorkStealingPool pool;
+    auto start{std::chrono::steady_clock::now()};
+    DagExecutor{g.view()}.run(pool, job);
+    auto executorTime{std::chrono::steady_clock::now() - start};
+
+    start = std::chrono::steady_clock::now();
+    TopologicalLevels levels{topologicalLevels(g.view())};
+    for (int i{}; i < levels.count(); ++i) {
+        parallelFor(levels.level(i).size(), defaultThreadCount(), [&](std::size_t k, unsigned) { job(levels.level(i)[k]); });
+    }
+    auto levelTime{std::chrono::steady_clock::now() - start};
+
+    std::cout << levels.count() << " levels, " << pool.size() << " threads: executor "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(executorTime).count() << " ms, level by level "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(levelTime).count() << " ms" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "ShortestPathQuery.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @brief On-disk layout of a LandmarkTable, in the style of GraphFileHeader (64-byte header, every section
+ *        on a 64-byte boundary, little-endian):
+ *
+ *   GraphFileHeader-like header | int32 landmarks[k] | int32 fromLandmark[n * k] | int32 toLandmark[n * k]
+ *
+ * The table belongs to one graph and is only valid for it; the vertex count is checked on load.
+ */
+struct LandmarkFileHeader
+{
+    static constexpr char expectedMagic[8]{'L', 'A', 'N', 'D', 'M', 'A', 'R', 'K'};
+    static constexpr std::uint32_t currentVersion{1};
+    static constexpr std::uint64_t alignment{64};
+
+    char magic[8]{};
+    std::uint32_t version{};
+    std::uint32_t reserved{};
+    std::uint64_t numberOfVertices{};
+    std::uint64_t numberOfLandmarks{};
+    std::uint64_t landmarksPosition{};
+    std::uint64_t fromPosition{};
+    std::uint64_t toPosition{};
+    std::uint64_t padding{};
+};
+
+static_assert(sizeof(LandmarkFileHeader) == LandmarkFileHeader::alignment, "header must fill exactly one aligned block");
+
+/**
+ * @class LandmarkTable
+ *
+ * @brief Distances from and to K landmarks, the precomputation of the ALT heuristic (A*, Landmarks, Triangle
+ *        inequality).
+ *
+ * For a landmark L the triangle inequality gives two lower bounds on dist(v, w):
+ *     dist(L, w) - dist(L, v)   and   dist(v, L) - dist(w, L)
+ * and lowerBound(v, w) is the largest of them over all landmarks. These bounds are consistent, so they can
+ * drive A* (and bidirectional A*) on any graph with non-negative weights, not only on grids.
+ *
+ * Landmarks are chosen by farthest selection: each new landmark is the vertex farthest from the landmarks
+ * so far (vertices no landmark reaches come first), so they end up on the periphery, where the bounds are
+ * tight for the queries that pass "behind" them.
+ *
+ * The tables are vertex-major, fromLandmark[v * k + i], so the bound for v reads two contiguous rows of k
+ * ints. Memory: 8 * k bytes per vertex. Unreachable pairs are stored as inf and give no bound.
+ */
+class LandmarkTable
+{
+public:
+    static constexpr int inf{std::numeric_limits<int>::max()};
+
+    LandmarkTable() = default;
+
+    /**
+     * @param count number of landmarks (at most n)
+     * @param threads threads for the backward tables, 0 means all hardware threads
+     */
+    static LandmarkTable build(CSRGraphView graph, int count, unsigned threads = 0)
+    {
+        const int n{graph.size()};
+        if (count <= 0 || count > n) throw std::invalid_argument("Number of landmarks should be in [1, V]");
+        if (threads == 0) threads = defaultThreadCount();
+
+        LandmarkTable table{n, count};
+        CSRGraph reverse{CSRGraph::reverse(graph)};
+
+        // farthest selection needs the forward distances of the landmarks chosen so far
+        DijkstraQuery forward{graph};
+        std::vector<int> nearest(n, inf); // distance from the closest landmark
+        std::vector<bool> covered(n);     // reached by some landmark
+
+        int next{0};
+        for (int i{}; i < count; ++i) {
+            table.landmarks[i] = next;
+            forward.run(next);
+            for (int v{}; v < n; ++v) {
+                int d{forward.distance(v)};
+                table.from[table.index(v, i)] = d;
+                if (d != inf) {
+                    covered[v] = true;
+                    nearest[v] = std::min(nearest[v], d);
+                }
+            }
+            nearest[next] = 0;
+            next = table.farthest(nearest, covered);
+        }
+
+        // backward: dist(v, L) = distance from L in the reverse graph, independent per landmark
+        std::vector<std::unique_ptr<DijkstraQuery>> owned(threads); // one query (and its buffers) per thread
+        parallelFor(count, threads, [&](std::size_t i, unsigned t) {
+            if (!owned[t]) owned[t] = std::make_unique<DijkstraQuery>(reverse.view());
+            owned[t]->run(table.landmarks[i]);
+            for (int v{}; v < n; ++v) table.to[table.index(v, static_cast<int>(i))] = owned[t]->distance(v);
+        });
+
+        return table;
+    }
+
+    int size() const noexcept { return n; }
+    int landmarkCount() const noexcept { return k; }
+    int landmark(int i) const noexcept { return landmarks[i]; }
+
+    int fromLandmark(int i, int v) const noexcept { return from[index(v, i)]; }
+    int toLandmark(int i, int v) const noexcept { return to[index(v, i)]; }
+
+    // the best triangle-inequality lower bound on dist(v, w), 0 if no landmark gives one
+    int lowerBound(int v, int w) const noexcept
+    {
+        const int* fromV{&from[index(v, 0)]};
+        const int* fromW{&from[index(w, 0)]};
+        const int* toV{&to[index(v, 0)]};
+        const int* toW{&to[index(w, 0)]};
+
+        int best{};
+        for (int i{}; i < k; ++i) {
+            if (fromV[i] != inf && fromW[i] != inf) best = std::max(best, fromW[i] - fromV[i]);
+            if (toV[i] != inf && toW[i] != inf) best = std::max(best, toV[i] - toW[i]);
+        }
+        return best;
+    }
+
+    void save(const std::string& path) const
+    {
+        auto alignUp = [](std::uint64_t pos) {
+            return (pos + LandmarkFileHeader::alignment - 1) / LandmarkFileHeader::alignment * LandmarkFileHeader::alignment;
+        };
+
+        LandmarkFileHeader header;
+        std::memcpy(header.magic, LandmarkFileHeader::expectedMagic, sizeof(header.magic));
+        header.version = LandmarkFileHeader::currentVersion;
+        header.numberOfVertices = static_cast<std::uint64_t>(n);
+        header.numberOfLandmarks = static_cast<std::uint64_t>(k);
+        header.landmarksPosition = sizeof(LandmarkFileHeader);
+        header.fromPosition = alignUp(header.landmarksPosition + landmarks.size() * sizeof(int));
+        header.toPosition = alignUp(header.fromPosition + from.size() * sizeof(int));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Cannot open " + path + " for writing");
+
+        auto writeSection = [&out](std::uint64_t position, const std::vector<int>& data) {
+            static const char zeros[LandmarkFileHeader::alignment]{};
+            out.write(zeros, static_cast<std::streamsize>(position - static_cast<std::uint64_t>(out.tellp()))); // padding
+            out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(int)));
+        };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(header.landmarksPosition, landmarks);
+        writeSection(header.fromPosition, from);
+        writeSection(header.toPosition, to);
+
+        if (!out) throw std::runtime_error("Failed writing " + path);
+    }
+
+    // graph is the graph the table was built for, its vertex count has to match
+    static LandmarkTable load(const std::string& path, CSRGraphView graph)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open " + path);
+
+        LandmarkFileHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(header.magic, LandmarkFileHeader::expectedMagic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("Not a landmark file");
+        }
+        if (header.version != LandmarkFileHeader::currentVersion) throw std::runtime_error("Unsupported landmark file version");
+        if (header.numberOfVertices != static_cast<std::uint64_t>(graph.size())) {
+            throw std::runtime_error("Landmark file belongs to a graph of another size");
+        }
+        if (header.numberOfLandmarks == 0 || header.numberOfLandmarks > header.numberOfVertices) {
+            throw std::runtime_error("Corrupted landmark file");
+        }
+
+        LandmarkTable table{graph.size(), static_cast<int>(header.numberOfLandmarks)};
+        auto readSection = [&in, &path](std::uint64_t position, std::vector<int>& data) {
+            in.seekg(static_cast<std::streamoff>(position));
+            in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(int)));
+            if (!in) throw std::runtime_error("Corrupted landmark file " + path);
+        };
+        readSection(header.landmarksPosition, table.landmarks);
+        readSection(header.fromPosition, table.from);
+        readSection(header.toPosition, table.to);
+
+        return table;
+    }
+
+private:
+    LandmarkTable(int vertices, int count)
+        : n{vertices}, k{count}, landmarks(count), from(static_cast<std::size_t>(vertices) * count),
+          to(static_cast<std::size_t>(vertices) * count)
+    { }
+
+    std::size_t index(int v, int i) const noexcept { return static_cast<std::size_t>(v) * k + i; }
+
+    // a vertex no landmark reaches, else the one with the largest distance to its closest landmark
+    int farthest(const std::vector<int>& nearest, const std::vector<bool>& covered) const
+    {
+        int best{-1};
+        for (int v{}; v < n; ++v) {
+            if (!covered[v] && nearest[v] != 0) return v;
+            if (nearest[v] != inf && (best == -1 || nearest[v] > nearest[best])) best = v;
+        }
+        return best;
+    }
+
+private:
+    int n{};
+    int k{};
+    std::vector<int> landmarks;
+    std::vector<int> from; // from[v * k + i] = dist(landmark i, v)
+    std::vector<int> to;   // to[v * k + i] = dist(v, landmark i)
+};
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <bit>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+#include "HeldKarp.h"
+#include "../Common/Combinations.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @brief Memory-lean Held–Karp: two popcount layers live at a time, narrow cost storage, and tour
+ *        recovery without the full table.
+ *
+ * ## Layers
+ * Masks are over the m = n - 1 vertices other than the start (as in HeldKarpSolver). Layer k holds the masks
+ * with k bits, and for each of them only the k values dp[mask][v], v in mask:
+ *     layer_k[rank(mask) * k + (position of v among the bits of mask)]
+ * where rank() is the mask's index in the combinatorial number system (Combinations.h). Masks of a layer are
+ * walked with Gosper's hack and split across threads by rank range, and a predecessor mask \ v is found in
+ * the previous layer by its rank, which is derived from the bits of mask in O(k).
+ *
+ * Only layers k - 1 and k exist at a time: the peak is max over k of C(m, k) * k + C(m, k - 1) * (k - 1) values,
+ * e.g. 123 MB for n = 25 with 16-bit costs, against 1.9 GB for HeldKarpSolver (n = 30: 4.3 GB against 74 GB).
+ *
+ * ## Cost width
+ * Costs are stored as uint16_t or uint32_t, the maximum value meaning "unreachable". Automatic picks 16 bits
+ * when n * max edge weight fits, 32 bits otherwise. Sums are computed in 64 bits and a finite path cost that
+ * doesn't fit the chosen width throws std::overflow_error (instead of wrapping), so a forced narrow width is safe.
+ * Only stored path costs are limited by the width; the closed tour is summed in 64 bits and has to fit an int.
+ *
+ * ## Tour recovery
+ * The last layer gives the optimal cost and the last vertex v; the vertex before v is a u minimizing
+ * dp[S \ v][u] + cost(u, v), with S = every vertex. The values of S \ v come from:
+ *   - Recompute: the layered DP run again over the vertices of S \ v only (dp of a set depends on its subsets
+ *     only); repeated for the shrinking set, the runs cost 2^(m-1) + 2^(m-2) + ... < 2^m masks, i.e. about one
+ *     more forward pass, with no extra memory,
+ *   - Checkpoint: every layer is appended to a file during the forward pass (m * 2^(m-1) values in total), and
+ *     recovery reads the m rows it needs back; the file is removed afterwards,
+ *   - None: only the cost is computed.
+ */
+
+enum class CostWidth
+{
+    Automatic,
+    Bits16,
+    Bits32
+};
+
+enum class TourRecovery
+{
+    None,
+    Recompute,
+    Checkpoint
+};
+
+struct LeanHeldKarpOptions
+{
+    CostWidth width{CostWidth::Automatic};
+    TourRecovery recovery{TourRecovery::Recompute};
+    std::filesystem::path checkpointFile{"held_karp_layers.bin"}; // Checkpoint only
+    unsigned threads{0};                                           // 0 means all hardware threads
+};
+
+class LeanHeldKarpSolver
+{
+public:
+    static constexpr int maxVertices{32};
+
+    /**
+     * @param cost dense n x n matrix of non-negative weights, minPlusInfinity (or larger) for "no edge"
+     */
+    LeanHeldKarpSolver(const std::vector<std::vector<int>>& cost, int start = 0, LeanHeldKarpOptions options = {})
+        : n{static_cast<int>(cost.size())}, m{n - 1}, startPoint{start}, settings{std::move(options)}
+    {
+        if (n == 0) throw std::invalid_argument("Number of Vertices should be > 0");
+        if (n > maxVertices) throw std::length_error("LeanHeldKarpSolver supports at most 32 vertices");
+        if (start < 0 || start >= n) throw std::out_of_range("Start vertex outside [0,V)");
+        if (settings.threads == 0) settings.threads = defaultThreadCount();
+
+        weights.assign(n, std::vector<std::uint32_t>(n, missing));
+        std::int64_t maxWeight{};
+        for (int u{}; u < n; ++u) {
+            for (int v{}; v < n; ++v) {
+                if (u == v || cost[u][v] >= minPlusInfinity) continue;
+                if (cost[u][v] < 0) throw std::invalid_argument("LeanHeldKarpSolver needs non-negative weights");
+
+                weights[u][v] = static_cast<std::uint32_t>(cost[u][v]);
+                maxWeight = std::max<std::int64_t>(maxWeight, cost[u][v]);
+            }
+        }
+
+        if (settings.width == CostWidth::Automatic) {
+            bool fits16{maxWeight * n < std::numeric_limits<std::uint16_t>::max()};
+            settings.width = fits16 ? CostWidth::Bits16 : CostWidth::Bits32;
+        }
+    }
+
+    CostWidth costWidth() const noexcept { return settings.width; }
+
+    // bytes of the two live layers at their largest, for n vertices
+    static std::size_t peakLayerBytes(int n, CostWidth width)
+    {
+        const int m{n - 1};
+        std::uint64_t values{};
+        for (int k{1}; k <= m; ++k) {
+            values = std::max(values, Combinations::binomial(m, k) * k + Combinations::binomial(m, k - 1) * (k - 1));
+        }
+        return values * (width == CostWidth::Bits16 ? sizeof(std::uint16_t) : sizeof(std::uint32_t));
+    }
+
+    TSPTour solve()
+    {
+        if (settings.width == CostWidth::Bits16) return solveWith<std::uint16_t>();
+        return solveWith<std::uint32_t>();
+    }
+
+private:
+    static constexpr std::uint32_t missing{std::numeric_limits<std::uint32_t>::max()};
+
+    int vertex(int i) const noexcept { return i + (i >= startPoint); } // index without the start -> vertex id
+
+    template <typename Cost>
+    class Engine
+    {
+    public:
+        static constexpr Cost unreachable{std::numeric_limits<Cost>::max()};
+
+        Engine(const LeanHeldKarpSolver& owner, std::ofstream* checkpoint) : solver{owner}, sink{checkpoint}
+        { }
+
+        /**
+         * Runs the layers over the given vertices (indices without the start, increasing) and returns the top
+         * layer: dp[all of them][universe[i]] at position i.
+         */
+        std::vector<Cost> topLayer(const std::vector<int>& universe)
+        {
+            const int s{static_cast<int>(universe.size())};
+            localCost.assign(static_cast<std::size_t>(s) * s, missing);
+            for (int i{}; i < s; ++i) {
+                for (int j{}; j < s; ++j) {
+                    localCost[static_cast<std::size_t>(j) * s + i] = solver.weights[solver.vertex(universe[i])][solver.vertex(universe[j])];
+                }
+            }
+
+            previous.resize(s);
+            for (int i{}; i < s; ++i) previous[i] = narrow(solver.weights[solver.startPoint][solver.vertex(universe[i])]);
+            write(previous);
+
+            for (int k{2}; k <= s; ++k) {
+                std::uint64_t layerSize{Combinations::binomial(s, k)};
+                current.resize(layerSize * k);
+
+                parallelForChunks(layerSize, solver.settings.threads, [&](std::size_t begin, std::size_t end, unsigned) {
+                    std::uint32_t mask{Combinations::unrankCombination(k, begin)};
+                    for (std::size_t r{begin}; r < end; ++r) {
+                        computeMask(mask, k, s, &current[r * k]);
+                        if (r + 1 < end) mask = Combinations::nextCombination(mask);
+                    }
+                }, minChunk);
+
+                if (overflow.load(std::memory_order_relaxed)) {
+                    throw std::overflow_error("Path cost doesn't fit the chosen cost width");
+                }
+                write(current);
+                previous.swap(current);
+            }
+
+            return previous;
+        }
+
+        static constexpr std::uint64_t noPath{std::numeric_limits<std::uint64_t>::max()};
+
+        // x + w in 64 bits, noPath if either is unreachable
+        std::uint64_t add(Cost x, std::uint32_t w) const noexcept
+        {
+            if (x == unreachable || w == missing) return noPath;
+            return static_cast<std::uint64_t>(x) + w;
+        }
+
+        Cost narrow(std::uint32_t weight) const
+        {
+            if (weight == missing) return unreachable;
+            if (weight >= unreachable) throw std::overflow_error("Path cost doesn't fit the chosen cost width");
+            return static_cast<Cost>(weight);
+        }
+
+    private:
+        void computeMask(std::uint32_t mask, int k, int s, Cost* out)
+        {
+            int bits[maxVertices];
+            for (int i{}; i < k; ++i) {
+                bits[i] = std::countr_zero(mask);
+                mask &= mask - 1;
+            }
+
+            // prefix[p] = rank contribution of bits[0..p), suffix[p] = rank of bits(p..k) shifted down one position
+            std::uint64_t prefix[maxVertices + 1], suffix[maxVertices + 1];
+            prefix[0] = 0;
+            for (int i{}; i < k; ++i) prefix[i + 1] = prefix[i] + Combinations::binomial(bits[i], i + 1);
+            suffix[k] = 0;
+            for (int i{k - 1}; i >= 0; --i) suffix[i] = suffix[i + 1] + Combinations::binomial(bits[i], i);
+
+            for (int p{}; p < k; ++p) {
+                const int v{bits[p]};
+                const Cost* row{&previous[(prefix[p] + suffix[p + 1]) * (k - 1)]};
+                const std::uint32_t* into{&localCost[static_cast<std::size_t>(v) * s]};
+
+                std::uint64_t best{noPath};
+                for (int q{}; q < k - 1; ++q) {
+                    int u{bits[q < p ? q : q + 1]};
+                    best = std::min(best, add(row[q], into[u]));
+                }
+
+                if (best != noPath && best >= unreachable) overflow.store(true, std::memory_order_relaxed);
+                out[p] = best >= unreachable ? unreachable : static_cast<Cost>(best);
+            }
+        }
+
+        void write(const std::vector<Cost>& layer)
+        {
+            if (sink == nullptr) return;
+            sink->write(reinterpret_cast<const char*>(layer.data()), static_cast<std::streamsize>(layer.size() * sizeof(Cost)));
+            if (!*sink) throw std::runtime_error("Failed to write the layer checkpoint");
+        }
+
+    private:
+        static constexpr std::size_t minChunk{64};
+
+        const LeanHeldKarpSolver& solver;
+        std::ofstream* sink{};
+        std::vector<std::uint32_t> localCost; // localCost[j * s + i] = cost(universe[i] -> universe[j])
+        std::vector<Cost> previous, current;
+        std::atomic<bool> overflow{false};
+    };
+
+    template <typename Cost>
+    TSPTour solveWith()
+    {
+        if (m == 0) {
+            std::uint32_t loop{weights[startPoint][startPoint]};
+            return loop == missing ? TSPTour{} : TSPTour{static_cast<int>(loop), {startPoint, startPoint}};
+        }
+
+        std::vector<int> everything(m);
+        for (int i{}; i < m; ++i) everything[i] = i;
+
+        std::ofstream checkpoint;
+        if (settings.recovery == TourRecovery::Checkpoint) {
+            checkpoint.open(settings.checkpointFile, std::ios::binary | std::ios::trunc);
+            if (!checkpoint) throw std::runtime_error("Can't open the layer checkpoint file");
+        }
+
+        Engine<Cost> engine{*this, checkpoint.is_open() ? &checkpoint : nullptr};
+        std::vector<Cost> top{engine.topLayer(everything)};
+        if (checkpoint.is_open()) checkpoint.close();
+
+        // close the cycle
+        std::uint64_t bestCost{Engine<Cost>::noPath};
+        int last{-1};
+        for (int v{}; v < m; ++v) {
+            std::uint64_t total{engine.add(top[v], weights[vertex(v)][startPoint])};
+            if (total < bestCost) {
+                bestCost = total;
+                last = v;
+            }
+        }
+        if (last == -1) {
+            removeCheckpoint();
+            return {};
+        }
+        if (bestCost > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+            throw std::overflow_error("Tour cost doesn't fit an int");
+        }
+
+        TSPTour tour{static_cast<int>(bestCost), {}};
+        if (settings.recovery == TourRecovery::None) return tour;
+
+        std::vector<int> backwards{recoverPath<Cost>(engine, top[last], last)};
+        removeCheckpoint();
+
+        tour.order.push_back(startPoint);
+        for (auto it{backwards.rbegin()}; it != backwards.rend(); ++it) tour.order.push_back(vertex(*it));
+        tour.order.push_back(startPoint);
+        return tour;
+    }
+
+    // the vertices of an optimal path ending at last, from last back to the first one (indices without the start)
+    template <typename Cost>
+    std::vector<int> recoverPath(Engine<Cost>& engine, Cost value, int last)
+    {
+        std::vector<int> path{last};
+        std::uint32_t remaining{(std::uint32_t{1} << m) - 1}; // S, last is in it
+
+        std::ifstream checkpoint;
+        std::vector<std::uint64_t> layerOffset(m + 1);
+        if (settings.recovery == TourRecovery::Checkpoint) {
+            checkpoint.open(settings.checkpointFile, std::ios::binary);
+            if (!checkpoint) throw std::runtime_error("Can't open the layer checkpoint file");
+            for (int k{1}; k < m; ++k) layerOffset[k + 1] = layerOffset[k] + Combinations::binomial(m, k) * k * sizeof(Cost);
+        }
+
+        int v{last};
+        while (std::popcount(remaining) > 1) {
+            remaining &= ~(std::uint32_t{1} << v);
+
+            std::vector<int> rest;
+            for (std::uint32_t bits{remaining}; bits != 0; bits &= bits - 1) rest.push_back(std::countr_zero(bits));
+            const int k{static_cast<int>(rest.size())};
+
+            // dp[S \ v][rest[i]] for every i
+            std::vector<Cost> row(k);
+            if (settings.recovery == TourRecovery::Checkpoint) {
+                std::uint64_t offset{layerOffset[k] + Combinations::rankCombination(remaining) * k * sizeof(Cost)};
+                checkpoint.seekg(static_cast<std::streamoff>(offset));
+                checkpoint.read(reinterpret_cast<char*>(row.data()), static_cast<std::streamsize>(k * sizeof(Cost)));
+                if (!checkpoint) throw std::runtime_error("Failed to read the layer checkpoint");
+            } else {
+                row = engine.topLayer(rest);
+            }
+
+            int previous{-1};
+            for (int i{}; i < k; ++i) {
+                if (engine.add(row[i], weights[vertex(rest[i])][vertex(v)]) == static_cast<std::uint64_t>(value)) {
+                    previous = i;
+                    break;
+                }
+            }
+            if (previous == -1) throw std::logic_error("Tour recovery found no predecessor");
+
+            value = row[previous];
+            v = rest[previous];
+            path.push_back(v);
+        }
+        return path;
+    }
+
+    void removeCheckpoint() const
+    {
+        if (settings.recovery != TourRecovery::Checkpoint) return;
+        std::error_code ignored;
+        std::filesystem::remove(settings.checkpointFile, ignored);
+    }
+
+private:
+    int n{};
+    int m{};
+    int startPoint{};
+    LeanHeldKarpOptions settings;
+    std::vector<std::vector<std::uint32_t>> weights; // missing for "no edge"
+};
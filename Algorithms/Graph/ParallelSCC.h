@@ -0,0 +1,356 @@
+#pragma once
+
+#include <span>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @class ParallelSCC
+ *
+ * @brief Multithreaded strongly connected components: trimming, one forward-backward round and coloring.
+ *
+ * Tarjan needs one DFS, which is inherently sequential. The decomposition here only uses steps that
+ * parallelize over vertices or over BFS frontiers:
+ *
+ *   1. Trimming. A vertex without live in-arcs or without live out-arcs is an SCC on its own. Removing it
+ *      can expose more such vertices, so trimming peels frontier by frontier with atomic degree counters.
+ *      Sources, sinks and all the tree-like parts of a call graph disappear here.
+ *   2. Forward-backward. Real graphs usually have one giant SCC. A forward BFS from a pivot (the vertex
+ *      with the largest in * out degree) marks what the pivot reaches; a backward BFS restricted to those
+ *      marks is exactly the SCC of the pivot. Both BFS are level synchronous, each level runs in parallel.
+ *   3. Coloring. Every live vertex starts with its own id as color and the maximum is propagated along the
+ *      arcs until nothing changes. A vertex that keeps its own color is a root, and its SCC is what reaches
+ *      it backwards inside its color. Roots are independent, their backward searches run in parallel.
+ *      Repeat (trimming first) until every vertex is assigned.
+ *
+ * The representative of a component is a vertex of it (the vertex itself after trimming, the pivot, the
+ * root). Components are numbered by increasing representative, so the result does not depend on the
+ * number of threads or the scheduling.
+ *
+ * Result layout:
+ *   - getComponentIds()[v] is the component of v, in [0, componentCount()),
+ *   - members(c) lists the vertices of component c in increasing order, a slice of one flat array
+ *     (memberOffsets() / memberList() are the CSR arrays themselves),
+ *   - condensation() is the DAG of the components without duplicate arcs and self-loops, e.g. the input
+ *     of KahnAlgorithm for an order in which to process the components.
+ *
+ * The phases run on a ThreadTeam that lives for the decomposition only. The reverse graph is built once (O(n + m) memory on top of the input).
+ */
+
+class ParallelSCC
+{
+public:
+    // threads: number of worker threads, 0 means all hardware threads
+    explicit ParallelSCC(CSRGraphView graph, unsigned threads = 0)
+        : forward{graph}, reverseStorage{CSRGraph::reverse(graph)}, backward{reverseStorage.view()}, n{graph.size()},
+          threadCount{threads == 0 ? defaultThreadCount() : threads}, team{std::make_unique<ThreadTeam>(threadCount)},
+          representative(n), inDegree(n), outDegree(n), color(n), mark(n)
+    {
+        solve();
+        team.reset();
+    }
+
+    int componentCount() const noexcept { return count; }
+
+    const std::vector<int>& getComponentIds() const { return component; }
+
+    std::span<const int> members(int c) const noexcept
+    {
+        return {memberVertices.data() + offsets[c], memberVertices.data() + offsets[c + 1]};
+    }
+
+    const std::vector<int>& memberOffsets() const { return offsets; }
+    const std::vector<int>& memberList() const { return memberVertices; }
+
+    // DAG over the components: an arc c -> d for every pair with an arc from c into d
+    CSRGraph condensation() const
+    {
+        std::vector<std::vector<std::pair<int, int>>> local(threadCount);
+        parallelForChunks(n, threadCount, [&](std::size_t begin, std::size_t end, unsigned t) {
+            for (int u{static_cast<int>(begin)}; u < static_cast<int>(end); ++u) {
+                for (int v : forward.neighbors(u)) {
+                    if (component[u] != component[v]) local[t].emplace_back(component[u], component[v]);
+                }
+            }
+        }, minChunk);
+
+        std::vector<std::pair<int, int>> arcs{concatenate(local)};
+        std::sort(arcs.begin(), arcs.end());
+        arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+        return CSRGraph::fromEdges(count, arcs);
+    }
+
+private:
+    void solve()
+    {
+        parallelFor(*team, n, [&](std::size_t v, unsigned) { representative[v].store(unassigned, std::memory_order_relaxed); }, minChunk);
+
+        std::vector<int> live(n);
+        for (int v{}; v < n; ++v) live[v] = v;
+
+        trim(live);
+        live = stillLive(live);
+        if (!live.empty()) {
+            forwardBackward(live);
+            live = stillLive(live);
+        }
+
+        while (!live.empty()) {
+            trim(live);
+            live = stillLive(live);
+            if (live.empty()) break;
+
+            colorAndCollect(live);
+            live = stillLive(live);
+        }
+
+        label();
+    }
+
+    /*
+     * Live degrees (self-loops don't count, a vertex with only a self-loop is still alone), then peel
+     * vertices whose in- or out-degree dropped to zero, one frontier at a time.
+     */
+    void trim(const std::vector<int>& live)
+    {
+        parallelFor(*team, live.size(), [&](std::size_t i, unsigned) {
+            int v{live[i]};
+            inDegree[v].store(liveNeighbours(backward, v), std::memory_order_relaxed);
+            outDegree[v].store(liveNeighbours(forward, v), std::memory_order_relaxed);
+        }, minChunk);
+
+        std::vector<int> frontier{expand(live, [&](int v, std::vector<int>& next) {
+            if ((inDegree[v].load(std::memory_order_relaxed) == 0 || outDegree[v].load(std::memory_order_relaxed) == 0) && claim(v, v)) {
+                next.push_back(v);
+            }
+        })};
+
+        while (!frontier.empty()) {
+            frontier = expand(frontier, [&](int v, std::vector<int>& next) {
+                // v is gone: its heads lose an in-arc, its tails an out-arc
+                for (int w : forward.neighbors(v)) {
+                    if (w != v && isLive(w) && inDegree[w].fetch_sub(1, std::memory_order_relaxed) == 1 && claim(w, w)) next.push_back(w);
+                }
+                for (int w : backward.neighbors(v)) {
+                    if (w != v && isLive(w) && outDegree[w].fetch_sub(1, std::memory_order_relaxed) == 1 && claim(w, w)) next.push_back(w);
+                }
+            });
+        }
+    }
+
+    /*
+     * SCC of the pivot = forward reachable and backward reachable. Every vertex on a backward path from a
+     * forward reached vertex to the pivot is forward reached too, so the backward search never has to
+     * leave the marked set, and claiming a vertex doubles as its visited flag.
+     */
+    void forwardBackward(const std::vector<int>& live)
+    {
+        int pivot{choosePivot(live)};
+
+        std::vector<int> reached{pivot};
+        mark[pivot].store(1, std::memory_order_relaxed);
+        for (std::vector<int> frontier{pivot}; !frontier.empty();) {
+            frontier = expand(frontier, [&](int u, std::vector<int>& next) {
+                for (int w : forward.neighbors(u)) {
+                    if (isLive(w) && mark[w].exchange(1, std::memory_order_relaxed) == 0) next.push_back(w);
+                }
+            });
+            reached.insert(reached.end(), frontier.begin(), frontier.end());
+        }
+
+        claim(pivot, pivot);
+        for (std::vector<int> frontier{pivot}; !frontier.empty();) {
+            frontier = expand(frontier, [&](int u, std::vector<int>& next) {
+                for (int w : backward.neighbors(u)) {
+                    if (mark[w].load(std::memory_order_relaxed) == 1 && claim(w, pivot)) next.push_back(w);
+                }
+            });
+        }
+
+        parallelFor(*team, reached.size(), [&](std::size_t i, unsigned) { mark[reached[i]].store(0, std::memory_order_relaxed); }, minChunk);
+    }
+
+    /*
+     * After the propagation color[v] is the largest id that reaches v within the live vertices. A root r
+     * (color[r] == r) reaches all of its SCC and nothing with a larger id reaches r, so its SCC is
+     * exactly the vertices of color r that reach r.
+     */
+    void colorAndCollect(const std::vector<int>& live)
+    {
+        parallelFor(*team, live.size(), [&](std::size_t i, unsigned) { color[live[i]].store(live[i], std::memory_order_relaxed); }, minChunk);
+
+        for (std::vector<int> frontier{live}; !frontier.empty();) {
+            frontier = expand(frontier, [&](int u, std::vector<int>& next) {
+                int c{color[u].load(std::memory_order_relaxed)};
+                for (int w : forward.neighbors(u)) {
+                    if (!isLive(w) || !raiseColor(w, c)) continue;
+                    if (mark[w].exchange(1, std::memory_order_relaxed) == 0) next.push_back(w);
+                }
+            });
+            // clear only after the level, a vertex raised twice in one level is queued once
+            parallelFor(*team, frontier.size(), [&](std::size_t i, unsigned) { mark[frontier[i]].store(0, std::memory_order_relaxed); }, minChunk);
+        }
+
+        std::vector<int> roots{expand(live, [&](int v, std::vector<int>& next) {
+            if (color[v].load(std::memory_order_relaxed) == v) next.push_back(v);
+        })};
+
+        // color regions are disjoint, one sequential backward search per root
+        parallelFor(*team, roots.size(), [&](std::size_t i, unsigned) {
+            int root{roots[i]};
+            claim(root, root);
+            std::vector<int> queue{root};
+            for (std::size_t head{}; head < queue.size(); ++head) {
+                for (int w : backward.neighbors(queue[head])) {
+                    if (color[w].load(std::memory_order_relaxed) == root && claim(w, root)) queue.push_back(w);
+                }
+            }
+        });
+    }
+
+    // representatives -> dense ids by increasing representative, then the members as CSR
+    void label()
+    {
+        std::vector<int> chunkFirstId(threadCount + 1, 0);
+        parallelForChunks(*team, n, [&](std::size_t begin, std::size_t end, unsigned t) {
+            int found{};
+            for (std::size_t v{begin}; v < end; ++v) found += representative[v].load(std::memory_order_relaxed) == static_cast<int>(v);
+            chunkFirstId[t + 1] = found;
+        }, minChunk);
+        for (unsigned t{}; t < threadCount; ++t) chunkFirstId[t + 1] += chunkFirstId[t];
+        count = chunkFirstId[threadCount];
+
+        // the chunking is deterministic, the same call sees the same ranges
+        std::vector<int> idOfRepresentative(n, -1);
+        parallelForChunks(*team, n, [&](std::size_t begin, std::size_t end, unsigned t) {
+            int id{chunkFirstId[t]};
+            for (std::size_t v{begin}; v < end; ++v) {
+                if (representative[v].load(std::memory_order_relaxed) == static_cast<int>(v)) idOfRepresentative[v] = id++;
+            }
+        }, minChunk);
+
+        component.assign(n, -1);
+        std::vector<std::atomic<int>> cursor(count + 1);
+        parallelFor(*team, n, [&](std::size_t v, unsigned) {
+            component[v] = idOfRepresentative[representative[v].load(std::memory_order_relaxed)];
+            cursor[component[v] + 1].fetch_add(1, std::memory_order_relaxed);
+        }, minChunk);
+
+        offsets.assign(count + 1, 0);
+        for (int c{}; c < count; ++c) offsets[c + 1] = offsets[c] + cursor[c + 1].load(std::memory_order_relaxed);
+        for (int c{}; c < count; ++c) cursor[c].store(offsets[c], std::memory_order_relaxed);
+
+        memberVertices.resize(n);
+        parallelFor(*team, n, [&](std::size_t v, unsigned) {
+            memberVertices[cursor[component[v]].fetch_add(1, std::memory_order_relaxed)] = static_cast<int>(v);
+        }, minChunk);
+        parallelFor(*team, count, [&](std::size_t c, unsigned) {
+            std::sort(memberVertices.begin() + offsets[c], memberVertices.begin() + offsets[c + 1]);
+        });
+    }
+
+    int choosePivot(const std::vector<int>& live) const
+    {
+        std::vector<std::pair<long long, int>> best(threadCount, {-1, -1});
+        parallelForChunks(*team, live.size(), [&](std::size_t begin, std::size_t end, unsigned t) {
+            for (std::size_t i{begin}; i < end; ++i) {
+                int v{live[i]};
+                long long score{static_cast<long long>(forward.degree(v)) * backward.degree(v)};
+                if (score > best[t].first) best[t] = {score, v};
+            }
+        }, minChunk);
+
+        // ties go to the smaller vertex whatever the chunking
+        std::pair<long long, int> pivot{-1, -1};
+        for (auto [score, v] : best) {
+            if (v != -1 && (score > pivot.first || (score == pivot.first && v < pivot.second))) pivot = {score, v};
+        }
+        return pivot.second;
+    }
+
+    // runs step(v, next) for every vertex of the frontier in parallel, returns the concatenated nexts
+    template <typename Step>
+    std::vector<int> expand(const std::vector<int>& frontier, Step step) const
+    {
+        std::vector<std::vector<int>> local(threadCount);
+        parallelForChunks(*team, frontier.size(), [&](std::size_t begin, std::size_t end, unsigned t) {
+            for (std::size_t i{begin}; i < end; ++i) step(frontier[i], local[t]);
+        }, minChunk);
+        return concatenate(local);
+    }
+
+    std::vector<int> stillLive(const std::vector<int>& live) const
+    {
+        return expand(live, [&](int v, std::vector<int>& next) {
+            if (isLive(v)) next.push_back(v);
+        });
+    }
+
+    template <typename T>
+    static std::vector<T> concatenate(std::vector<std::vector<T>>& parts)
+    {
+        std::size_t total{};
+        for (const auto& part : parts) total += part.size();
+        if (parts.size() == 1) return std::move(parts.front());
+
+        std::vector<T> all;
+        all.reserve(total);
+        for (const auto& part : parts) all.insert(all.end(), part.begin(), part.end());
+        return all;
+    }
+
+    int liveNeighbours(CSRGraphView g, int v) const
+    {
+        int live{};
+        for (int w : g.neighbors(v)) live += w != v && isLive(w);
+        return live;
+    }
+
+    bool isLive(int v) const noexcept { return representative[v].load(std::memory_order_relaxed) == unassigned; }
+
+    // first claim wins, only the winner queues the vertex
+    bool claim(int v, int rep)
+    {
+        int expected{unassigned};
+        return representative[v].compare_exchange_strong(expected, rep, std::memory_order_relaxed);
+    }
+
+    // atomic max, true if the color of v went up
+    bool raiseColor(int v, int c)
+    {
+        int current{color[v].load(std::memory_order_relaxed)};
+        while (current < c) {
+            if (color[v].compare_exchange_weak(current, c, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+
+private:
+    static constexpr int unassigned{-1};
+    static constexpr std::size_t minChunk{1024}; // vertices per thread at least
+
+    CSRGraphView forward;
+    CSRGraph reverseStorage;
+    CSRGraphView backward;
+    int n{};
+    unsigned threadCount{};
+    std::unique_ptr<ThreadTeam> team; // runs the many short phases of solve(), released after it
+
+    std::vector<std::atomic<int>> representative;
+    std::vector<std::atomic<int>> inDegree;
+    std::vector<std::atomic<int>> outDegree;
+    std::vector<std::atomic<int>> color;
+    std::vector<std::atomic<std::uint8_t>> mark;
+
+    int count{};
+    std::vector<int> component;
+    std::vector<int> offsets{0};
+    std::vector<int> memberVertices;
+};
@@ -0,0 +1,325 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <bit>
+
+/**
+ * @brief Addressable min-priority queues over vertex ids, used as the queue policy of
+ *        DijkstraQuery (ShortestPathQuery.h) and AStarSolver.
+ *
+ * std::priority_queue has no decrease-key, so the solvers used to push a new entry on every
+ * improvement and skip stale ones on pop ("lazy deletion"): the heap grows to O(E) entries.
+ * All queues here keep at most one entry per vertex, so their size is bounded by n.
+ *
+ * Common interface (keys are non-negative ints, vertices are ids in [0, n)):
+ *   void reset(int n)              - sizes the per-vertex index (O(n), once per graph)
+ *   void clear()                   - empties the queue in O(size), the index stays allocated
+ *   bool empty() const / size()
+ *   bool contains(int v) const
+ *   void push(int v, int key)      - inserts v, or decreases its key if v is already queued
+ *   std::pair<int, int> pop()      - removes and returns (key, vertex) with the minimum key
+ *
+ * Backends:
+ *   - IndexedDaryHeap<D>: general purpose d-ary heap with real decrease-key. A 4-ary heap is shallower
+ *     than a binary one and its children share a cache line. O(log_D n) push/decrease, O(D log_D n) pop.
+ *   - RadixHeap: monotone integer queue (keys pushed are never below the last popped key, which holds for
+ *     Dijkstra with non-negative weights and A* with a consistent heuristic). Keys live in 33 buckets by the
+ *     highest bit in which they differ from the last popped key; each key moves down at most 32 times,
+ *     so a pop is amortized O(log C). Decrease-key is O(1).
+ *   - BucketQueue: Dial's algorithm, a circular array of maxKeySpread + 1 buckets. O(1) push/decrease and
+ *     pop in O(1) amortized plus the number of empty buckets skipped. Best for small integer weights, where
+ *     maxKeySpread is the maximum edge weight (for A*: 2 * max weight, the largest jump of f = g + h).
+ *
+ * RadixHeap and BucketQueue throw std::logic_error on a non-monotone push.
+ */
+
+template <int D = 4>
+class IndexedDaryHeap
+{
+    static_assert(D >= 2, "the heap arity must be at least 2");
+
+public:
+    void reset(int n)
+    {
+        heap.clear();
+        position.assign(n, absent);
+    }
+
+    void clear()
+    {
+        for (auto [key, v] : heap) position[v] = absent;
+        heap.clear();
+    }
+
+    bool empty() const noexcept { return heap.empty(); }
+    std::size_t size() const noexcept { return heap.size(); }
+    bool contains(int v) const noexcept { return position[v] != absent; }
+
+    // smallest key without popping it (the queue must not be empty)
+    int minKey() const noexcept { return heap.front().first; }
+
+    void push(int v, int key)
+    {
+        int i{position[v]};
+        if (i == absent) {
+            i = static_cast<int>(heap.size());
+            heap.emplace_back(key, v);
+        } else {
+            heap[i].first = key; // decrease-key
+        }
+
+        siftUp(i);
+    }
+
+    std::pair<int, int> pop()
+    {
+        std::pair<int, int> top{heap.front()};
+        position[top.second] = absent;
+
+        std::pair<int, int> last{heap.back()};
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+
+        return top;
+    }
+
+private:
+    void siftUp(int i)
+    {
+        std::pair<int, int> item{heap[i]};
+        while (i > 0) {
+            int p{(i - 1) / D};
+            if (heap[p].first <= item.first) break;
+            place(i, heap[p]);
+            i = p;
+        }
+        place(i, item);
+    }
+
+    void siftDown(int i)
+    {
+        const int n{static_cast<int>(heap.size())};
+        std::pair<int, int> item{heap[i]};
+
+        while (true) {
+            int first{i * D + 1};
+            if (first >= n) break;
+
+            int last{first + D < n ? first + D : n};
+            int best{first};
+            for (int c{first + 1}; c < last; ++c) {
+                if (heap[c].first < heap[best].first) best = c;
+            }
+
+            if (heap[best].first >= item.first) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, item);
+    }
+
+    void place(int i, std::pair<int, int> item)
+    {
+        heap[i] = item;
+        position[item.second] = i;
+    }
+
+private:
+    static constexpr int absent{-1};
+    std::vector<std::pair<int, int>> heap; // (key, vertex)
+    std::vector<int> position;             // index in heap or absent
+};
+
+/**
+ * Shared bookkeeping of the bucket based queues: every queued vertex remembers its bucket and its slot
+ * inside the bucket, so it can be removed in O(1) by swapping with the bucket's last element.
+ */
+class BucketIndex
+{
+protected:
+    struct Location
+    {
+        int bucket{-1};
+        int slot{-1};
+    };
+
+    void resetIndex(int n) { location.assign(n, Location{}); }
+
+    void insertInto(std::vector<std::pair<int, int>>& bucket, int bucketIndex, int v, int key)
+    {
+        location[v] = Location{bucketIndex, static_cast<int>(bucket.size())};
+        bucket.emplace_back(key, v);
+    }
+
+    void eraseFrom(std::vector<std::pair<int, int>>& bucket, int v)
+    {
+        int slot{location[v].slot};
+        bucket[slot] = bucket.back();
+        location[bucket[slot].second].slot = slot;
+        bucket.pop_back();
+        location[v] = Location{};
+    }
+
+    std::vector<Location> location;
+};
+
+class RadixHeap : private BucketIndex
+{
+public:
+    void reset(int n)
+    {
+        resetIndex(n);
+        for (auto& bucket : buckets) bucket.clear();
+        count = 0;
+        last = 0;
+    }
+
+    void clear()
+    {
+        for (auto& bucket : buckets) {
+            for (auto [key, v] : bucket) location[v] = Location{};
+            bucket.clear();
+        }
+        count = 0;
+        last = 0;
+    }
+
+    bool empty() const noexcept { return count == 0; }
+    std::size_t size() const noexcept { return count; }
+    bool contains(int v) const noexcept { return location[v].bucket != -1; }
+
+    void push(int v, int key)
+    {
+        if (key < 0 || static_cast<std::uint32_t>(key) < last) {
+            throw std::logic_error("RadixHeap requires monotone non-negative keys");
+        }
+
+        if (contains(v)) {
+            eraseFrom(buckets[location[v].bucket], v);
+            --count;
+        }
+
+        int b{bucketOf(static_cast<std::uint32_t>(key))};
+        insertInto(buckets[b], b, v, key);
+        ++count;
+    }
+
+    std::pair<int, int> pop()
+    {
+        if (buckets[0].empty()) {
+            int b{1};
+            while (buckets[b].empty()) ++b;
+
+            // the new minimum becomes the reference key, everything in bucket b moves to lower buckets
+            std::uint32_t minKey{static_cast<std::uint32_t>(buckets[b][0].first)};
+            for (auto [key, v] : buckets[b]) minKey = std::min(minKey, static_cast<std::uint32_t>(key));
+            last = minKey;
+
+            std::vector<std::pair<int, int>> moving;
+            moving.swap(buckets[b]);
+            for (auto [key, v] : moving) {
+                int nb{bucketOf(static_cast<std::uint32_t>(key))};
+                insertInto(buckets[nb], nb, v, key);
+            }
+            moving.clear();
+            moving.swap(buckets[b]); // give the capacity back to the bucket
+        }
+
+        std::pair<int, int> top{buckets[0].back()};
+        eraseFrom(buckets[0], top.second);
+        --count;
+        return top;
+    }
+
+private:
+    int bucketOf(std::uint32_t key) const noexcept
+    {
+        return key == last ? 0 : 32 - std::countl_zero(key ^ last);
+    }
+
+private:
+    std::array<std::vector<std::pair<int, int>>, 33> buckets;
+    std::size_t count{};
+    std::uint32_t last{}; // last popped key
+};
+
+class BucketQueue : private BucketIndex
+{
+public:
+    explicit BucketQueue(int maxKeySpread) : buckets(static_cast<std::size_t>(maxKeySpread) + 1)
+    {
+        if (maxKeySpread < 0) throw std::invalid_argument("maxKeySpread should be >= 0");
+    }
+
+    void reset(int n)
+    {
+        resetIndex(n);
+        for (auto& bucket : buckets) bucket.clear();
+        count = 0;
+        current = 0;
+        anchored = false;
+    }
+
+    void clear()
+    {
+        for (auto& bucket : buckets) {
+            for (auto [key, v] : bucket) location[v] = Location{};
+            bucket.clear();
+        }
+        count = 0;
+        current = 0;
+        anchored = false;
+    }
+
+    bool empty() const noexcept { return count == 0; }
+    std::size_t size() const noexcept { return count; }
+    bool contains(int v) const noexcept { return location[v].bucket != -1; }
+
+    void push(int v, int key)
+    {
+        const long long spread{static_cast<long long>(buckets.size()) - 1};
+        if (!anchored) { // the first key after reset/clear can be anything
+            current = key;
+            anchored = true;
+        }
+        if (key < current || key - current > spread) {
+            throw std::logic_error("BucketQueue key outside [current, current + maxKeySpread]");
+        }
+
+        if (contains(v)) {
+            eraseFrom(buckets[location[v].bucket], v);
+            --count;
+        }
+
+        int b{static_cast<int>(key % static_cast<long long>(buckets.size()))};
+        insertInto(buckets[b], b, v, key);
+        ++count;
+    }
+
+    std::pair<int, int> pop()
+    {
+        std::size_t b{static_cast<std::size_t>(current % static_cast<long long>(buckets.size()))};
+        while (buckets[b].empty()) {
+            ++current;
+            if (++b == buckets.size()) b = 0;
+        }
+
+        std::pair<int, int> top{buckets[b].back()};
+        eraseFrom(buckets[b], top.second);
+        --count;
+        return top;
+    }
+
+private:
+    std::vector<std::vector<std::pair<int, int>>> buckets;
+    std::size_t count{};
+    long long current{}; // smallest key that can still be in the queue
+    bool anchored{};
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "PriorityQueues.h"
+
+/**
+ * @brief Reusable Dijkstra query engine for many point-to-point or single-source queries on one graph.
+ *
+ * A plain Dijkstra run allocates and fills an n-sized distance array for every query, which dominates
+ * short queries on large graphs. DijkstraQuery keeps all scratch buffers (distances, predecessors and
+ * the priority queue) alive between queries and never refills them:
+ *
+ *   - every vertex carries the epoch (query number) in which its distance was last written,
+ *   - starting a query just increments the epoch, so all entries from older queries read as "unreached".
+ *
+ * A query therefore costs time proportional to the part of the graph it touches, not to n.
+ * Only when the 32-bit epoch counter wraps around the stamps are cleared once.
+ *
+ * The priority queue is a policy (see PriorityQueues.h). The default is an indexed 4-ary heap with
+ * decrease-key; RadixHeap and BucketQueue are faster on integer weights:
+ *   BasicDijkstraQuery<RadixHeap> radix{graph.view()};
+ *   BasicDijkstraQuery<BucketQueue> dial{graph.view(), BucketQueue{maxEdgeWeight}};
+ * With decrease-key every vertex is in the queue at most once, so there are no stale entries.
+ *
+ * Usage:
+ * @code
+ * DijkstraQuery query{graph.view()}; // BasicDijkstraQuery<IndexedDaryHeap<4>>
+ * int d{query.run(source, target)};    // stops as soon as target is settled
+ * query.runToTargets(source, targets); // stops once all targets are settled
+ * std::vector<int> path{query.path(target)};
+ * query.runBatch(sources, [](int source, const DijkstraQuery& q) { ... }); // buffers reused
+ * @endcode
+ *
+ * After a run with a target, distance(v) is exact for settled vertices (dist <= dist(target))
+ * and an upper bound for the others.
+ */
+
+template <typename PriorityQueue = IndexedDaryHeap<4>>
+class BasicDijkstraQuery
+{
+public:
+    static constexpr int inf{std::numeric_limits<int>::max()};
+
+    explicit BasicDijkstraQuery(CSRGraphView g, PriorityQueue pq = PriorityQueue{})
+        : graph{g}, n{g.size()}, dist(n), parent(n), stamp(n, 0), queue{std::move(pq)}
+    {
+        queue.reset(n);
+    }
+
+    /**
+     * @brief Runs Dijkstra from source. If target != -1 the search stops once target is settled.
+     * @return distance to target (or 0 for a full run), inf if target is unreachable
+     */
+    int run(int source, int target = -1)
+    {
+        nextEpoch();
+        settled = 0;
+
+        queue.clear();
+        relax(source, 0, -1);
+
+        while (!queue.empty()) {
+            auto [cost, u] = queue.pop();
+            ++settled;
+
+            if (u == target) return cost;
+
+            for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e) {
+                int v{graph.target(e)};
+                int candidate{cost + graph.weight(e)};
+                if (candidate < distance(v)) relax(v, candidate, u);
+            }
+        }
+
+        return target == -1 ? 0 : inf;
+    }
+
+    /**
+     * @brief Runs Dijkstra from source until every vertex of targets is settled, so distance(t) is exact
+     *        for all of them afterwards (inf if unreachable). Duplicates in targets are fine.
+     */
+    void runToTargets(int source, std::span<const int> targets)
+    {
+        nextEpoch();
+        settled = 0;
+        if (targetStamp.size() != stamp.size()) targetStamp.assign(stamp.size(), 0);
+
+        int remaining{};
+        for (int t : targets) {
+            if (targetStamp[t] != epoch) {
+                targetStamp[t] = epoch;
+                ++remaining;
+            }
+        }
+
+        queue.clear();
+        relax(source, 0, -1);
+
+        while (!queue.empty() && remaining > 0) {
+            auto [cost, u] = queue.pop();
+            ++settled;
+            if (targetStamp[u] == epoch) --remaining; // every vertex is popped at most once
+
+            for (int e{graph.firstEdge(u)}; e < graph.lastEdge(u); ++e) {
+                int v{graph.target(e)};
+                int candidate{cost + graph.weight(e)};
+                if (candidate < distance(v)) relax(v, candidate, u);
+            }
+        }
+    }
+
+    /**
+     * @brief Processes each source as a full single-source run, reusing the buffers between them.
+     * @param onQueryDone called as onQueryDone(source, *this) while the result of source is available
+     */
+    template <typename Callback>
+    void runBatch(std::span<const int> sources, Callback&& onQueryDone)
+    {
+        for (int source : sources) {
+            run(source);
+            onQueryDone(source, static_cast<const BasicDijkstraQuery&>(*this));
+        }
+    }
+
+    int distance(int v) const noexcept { return stamp[v] == epoch ? dist[v] : inf; }
+    bool reached(int v) const noexcept { return stamp[v] == epoch; }
+    int predecessor(int v) const noexcept { return reached(v) ? parent[v] : -1; }
+
+    // number of vertices settled by the last query, a measure of the work it did
+    int settledCount() const noexcept { return settled; }
+
+    // materializes the distances of the last query, O(n)
+    std::vector<int> distances() const
+    {
+        std::vector<int> result(n);
+        for (int v{}; v < n; ++v) result[v] = distance(v);
+        return result;
+    }
+
+    // source -> ... -> target of the last query, empty if target was not reached
+    std::vector<int> path(int target) const
+    {
+        std::vector<int> result;
+        if (!reached(target)) return result;
+
+        for (int v{target}; v != -1; v = parent[v]) result.push_back(v);
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    CSRGraphView getGraph() const noexcept { return graph; }
+
+private:
+    void nextEpoch()
+    {
+        if (++epoch == 0) { // wrapped around: the stamps are ambiguous again
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(targetStamp.begin(), targetStamp.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    void relax(int v, int d, int from)
+    {
+        dist[v] = d;
+        parent[v] = from;
+        stamp[v] = epoch;
+
+        queue.push(v, d); // insert or decrease-key
+    }
+
+private:
+    CSRGraphView graph;
+    int n{};
+
+    std::vector<int> dist;
+    std::vector<int> parent;
+    std::vector<std::uint32_t> stamp;
+    std::vector<std::uint32_t> targetStamp; // targets of runToTargets(), allocated on first use
+    std::uint32_t epoch{};
+
+    PriorityQueue queue; // capacity survives between queries
+    int settled{};
+};
+
+using DijkstraQuery = BasicDijkstraQuery<>;
@@ -1,6 +1,12 @@
 #include <vector>
 #include <iostream>
-#include <stack>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include "CSRGraph.h"
+#include "IterativeDFS.h"
+#include "ParallelSCC.h"
+#include "gtest/gtest.h"
 
 /*
 * A Strongly Connected Component (SCC) in a directed graph is a maximal set of nodes where every node is reachable from every other node in that SCC.
@@ -14,16 +20,29 @@
 * Each node is assigned a unique discovery time when visited. ids[u] is set to a running counter id++, ensuring unique timestamps.
 * 
 * Note: for "another implementation" - need to find a test case where one line update is not working - who finds, ping me.
+* 
+* The DFS runs on IterativeDFS (explicit frame stack), so long paths don't overflow the call stack. The SCC stack is a
+* preallocated vector, and "on the stack" means visited but not assigned to a component yet.
 */
 
 class Tarjan
 {
 public:
-	Tarjan(const std::vector<std::vector<int>>& graph) : m_graph{ graph }, n( graph.size() ), ids(n, -1), lowLink(n), onStack(n, false)
+	explicit Tarjan(CSRGraphView graph) : m_graph{ graph }, n{ graph.size() }, ids(n, -1), lowLink(n), component(n, -1)
+	{
+		solve();
+	}
+
+	Tarjan(const std::vector<std::vector<int>>& graph) : m_storage{ CSRGraph::fromAdjacencyList(graph) }, m_graph{ m_storage.view() },
+		n{ m_graph.size() }, ids(n, -1), lowLink(n), component(n, -1)
 	{
 		solve();
 	}
 
+	// m_graph may point into m_storage, so a copy would view the original's arrays
+	Tarjan(const Tarjan&) = delete;
+	Tarjan& operator=(const Tarjan&) = delete;
+
 	const std::vector<std::vector<int>>& getSCC() const { return sccs; }
 
 	void printSCC()
@@ -38,64 +57,276 @@ public:
 			std::cout << std::endl;
 		}
 	}
+	// index of the SCC (in getSCC()) of every vertex
+	const std::vector<int>& getComponentIds() const { return component; }
+
 private:
-	void solve()
+	struct Visitor : DFSVisitor
 	{
-		for (int u{}; u < n; ++u) {
-			if (ids[u] == -1) {
-				dfs(u);
-			}
+		Tarjan& self;
+
+		void enter(int u, int)
+		{
+			self.ids[u] = self.lowLink[u] = self.id++;
+			self.st.push_back(u);
 		}
-	}
 
-	void dfs(int u)
-	{
-		ids[u] = lowLink[u] = id++;
-		onStack[u] = true;
-		st.push(u);
-
-		for (int v : m_graph[u]) {
-			if (ids[v] == -1) {
-				dfs(v);
-				//lowLink[u] = std::min(lowLink[u], lowLink[v]); // another implementation
-			}
+		bool edge(int u, int v, int)
+		{
+			if (self.ids[v] == -1) return true; // tree edge, lowLink[u] is updated in retreat
 
 			// back edge
-			if (onStack[v]) {
-				lowLink[u] = std::min(lowLink[u], lowLink[v]);
+			if (self.onStack(v)) {
+				self.lowLink[u] = std::min(self.lowLink[u], self.lowLink[v]);
 				//lowLink[u] = std::min(lowLink[u], ids[v]); // another implementation
 			}
+			return false;
+		}
+
+		void retreat(int u, int v, int)
+		{
+			if (self.onStack(v)) self.lowLink[u] = std::min(self.lowLink[u], self.lowLink[v]);
+			//lowLink[u] = std::min(lowLink[u], lowLink[v]); // another implementation
 		}
 
-		if (ids[u] == lowLink[u]) {
+		void exit(int u)
+		{
+			if (self.ids[u] != self.lowLink[u]) return;
+
 			std::vector<int> scc;
-			for (int top{ st.top() }; ; top = st.top()) {
+			for (int top{ self.st.back() }; ; top = self.st.back()) {
 				scc.push_back(top);
-				st.pop();
-				onStack[top] = false;
+				self.st.pop_back();
+				self.component[top] = static_cast<int>(self.sccs.size());
 
 				if (top == u) break;
 			}
 
-			sccs.push_back(scc);
+			self.sccs.push_back(scc);
 		}
+	};
+
+	void solve()
+	{
+		st.reserve(n);
+		IterativeDFS dfs{ m_graph };
+		Visitor visitor{ {}, *this };
 
+		for (int u{}; u < n; ++u) {
+			if (ids[u] == -1) {
+				dfs.run(u, visitor);
+			}
+		}
 	}
+
+	bool onStack(int v) const { return ids[v] != -1 && component[v] == -1; }
+
 private:
-	std::vector<std::vector<int>> m_graph;
+	CSRGraph m_storage; // only used when built from an adjacency list
+	CSRGraphView m_graph;
 	int n{};
 	std::vector<int> ids, lowLink;
-	std::vector<bool> onStack;
-	std::stack<int> st;
-	
+	std::vector<int> component; // -1 while the vertex has no SCC yet
+	std::vector<int> st;        // the SCC stack
+
 
 	std::vector<std::vector<int>> sccs;
 	int id{};
 };
 
-int main()
+TEST(TarjanTest, SmallGraph)
 {
 	std::vector<std::vector<int>> graph{ {1}, {2}, {3, 5}, {0}, {1}, {4} };
 	Tarjan t{ graph };
 	t.printSCC();
-}
\ No newline at end of file
+
+	EXPECT_EQ(t.getSCC(), (std::vector<std::vector<int>>{ {4, 5, 3, 2, 1, 0} }));
+}
+
+TEST(TarjanTest, SeveralComponents)
+{
+	// {0, 1, 2} -> {3, 4} -> {5}, 6 alone
+	std::vector<std::vector<int>> graph{ {1}, {2}, {0, 3}, {4}, {3, 5}, {}, {6} };
+	Tarjan t{ graph };
+
+	std::vector<std::vector<int>> sccs{ t.getSCC() };
+	for (auto& scc : sccs) std::sort(scc.begin(), scc.end());
+	EXPECT_EQ(sccs, (std::vector<std::vector<int>>{ {5}, {3, 4}, {0, 1, 2}, {6} }));
+
+	const std::vector<int>& component{ t.getComponentIds() };
+	EXPECT_EQ(component[0], component[2]);
+	EXPECT_EQ(component[3], component[4]);
+	EXPECT_NE(component[0], component[3]);
+}
+
+TEST(TarjanTest, LongPathDoesNotOverflowTheStack)
+{
+	// a million-vertex chain closed into one cycle, and the same chain open (every vertex its own SCC)
+	const int n{ 1'000'000 };
+	std::vector<std::pair<int, int>> edges;
+	for (int u{}; u + 1 < n; ++u) edges.push_back({ u, u + 1 });
+
+	CSRGraph path{ CSRGraph::fromEdges(n, edges) };
+	EXPECT_EQ(Tarjan{ path.view() }.getSCC().size(), static_cast<std::size_t>(n));
+
+	edges.push_back({ n - 1, 0 });
+	CSRGraph cycle{ CSRGraph::fromEdges(n, edges) };
+	Tarjan t{ cycle.view() };
+	ASSERT_EQ(t.getSCC().size(), 1u);
+	EXPECT_EQ(t.getSCC()[0].size(), static_cast<std::size_t>(n));
+}
+
+// the partition as sorted sets, so component numbering doesn't matter
+std::vector<std::vector<int>> canonicalSCC(std::vector<std::vector<int>> sccs)
+{
+	for (auto& scc : sccs) std::sort(scc.begin(), scc.end());
+	std::sort(sccs.begin(), sccs.end());
+	return sccs;
+}
+
+std::vector<std::vector<int>> canonicalSCC(const ParallelSCC& p)
+{
+	std::vector<std::vector<int>> sccs;
+	for (int c{}; c < p.componentCount(); ++c) sccs.emplace_back(p.members(c).begin(), p.members(c).end());
+	return canonicalSCC(sccs);
+}
+
+// clusters closed into random cycles plus random arcs between them, so there are big, small and trivial SCCs
+CSRGraph randomClusteredGraph(int n, int extraArcs, unsigned seed)
+{
+	std::mt19937 rng{ seed };
+	std::vector<int> perm(n);
+	for (int i{}; i < n; ++i) perm[i] = i;
+	std::shuffle(perm.begin(), perm.end(), rng);
+
+	std::vector<std::pair<int, int>> edges;
+	for (int begin{}; begin < n;) {
+		int size{ std::min<int>(n - begin, 1 + static_cast<int>(rng() % 40)) };
+		if (rng() % 4 != 0) {
+			for (int i{}; i < size; ++i) edges.push_back({ perm[begin + i], perm[begin + (i + 1) % size] });
+		}
+		begin += size;
+	}
+	std::uniform_int_distribution<int> vertex(0, n - 1);
+	for (int i{}; i < extraArcs; ++i) edges.push_back({ vertex(rng), vertex(rng) });
+
+	return CSRGraph::fromEdges(n, edges);
+}
+
+TEST(ParallelSCCTest, MatchesTarjanOnSmallGraphs)
+{
+	std::vector<std::vector<std::vector<int>>> graphs{
+		{ {1}, {2}, {3, 5}, {0}, {1}, {4} },
+		{ {1}, {2}, {0, 3}, {4}, {3, 5}, {}, {6} },
+		{ {}, {}, {} },
+		{ {0}, {0, 2}, {1} },
+		{}
+	};
+
+	for (const auto& adjList : graphs) {
+		CSRGraph g{ CSRGraph::fromAdjacencyList(adjList) };
+		Tarjan t{ g.view() };
+		for (unsigned threads : { 1u, 4u }) {
+			ParallelSCC p{ g.view(), threads };
+			EXPECT_EQ(canonicalSCC(p), canonicalSCC(t.getSCC()));
+		}
+	}
+}
+
+TEST(ParallelSCCTest, MatchesTarjanOnRandomGraphs)
+{
+	for (unsigned seed{ 1 }; seed <= 20; ++seed) {
+		int n{ 50 + static_cast<int>(seed) * 150 };
+		CSRGraph g{ randomClusteredGraph(n, static_cast<int>(seed % 5) * n / 4, seed) };
+		Tarjan t{ g.view() };
+		auto expected{ canonicalSCC(t.getSCC()) };
+
+		for (unsigned threads : { 1u, 3u }) {
+			ParallelSCC p{ g.view(), threads };
+			ASSERT_EQ(canonicalSCC(p), expected) << "seed " << seed << ", threads " << threads;
+
+			// ids and members describe the same partition
+			for (int c{}; c < p.componentCount(); ++c) {
+				for (int v : p.members(c)) EXPECT_EQ(p.getComponentIds()[v], c);
+			}
+		}
+	}
+}
+
+TEST(ParallelSCCTest, ResultDoesNotDependOnThreads)
+{
+	CSRGraph g{ randomClusteredGraph(20'000, 10'000, 7) };
+	ParallelSCC one{ g.view(), 1 };
+	ParallelSCC many{ g.view(), 8 };
+	EXPECT_EQ(one.getComponentIds(), many.getComponentIds());
+	EXPECT_EQ(one.memberList(), many.memberList());
+}
+
+TEST(ParallelSCCTest, CondensationIsADag)
+{
+	CSRGraph g{ randomClusteredGraph(5'000, 4'000, 11) };
+	ParallelSCC p{ g.view(), 4 };
+	CSRGraph dag{ p.condensation() };
+	CSRGraphView view{ dag.view() };
+	ASSERT_EQ(view.size(), p.componentCount());
+
+	// no self-loops, no duplicate arcs, and every SCC of the condensation is a single component
+	for (int c{}; c < view.size(); ++c) {
+		std::vector<int> heads(view.neighbors(c).begin(), view.neighbors(c).end());
+		EXPECT_TRUE(std::is_sorted(heads.begin(), heads.end()));
+		EXPECT_EQ(std::adjacent_find(heads.begin(), heads.end()), heads.end());
+		EXPECT_EQ(std::count(heads.begin(), heads.end(), c), 0);
+	}
+	EXPECT_EQ(Tarjan{ view }.getSCC().size(), static_cast<std::size_t>(view.size()));
+
+	// an arc of the input between two components is an arc of the condensation
+	const std::vector<int>& component{ p.getComponentIds() };
+	for (int u{}; u < g.size(); ++u) {
+		for (int v : g.view().neighbors(u)) {
+			if (component[u] == component[v]) continue;
+			auto heads{ view.neighbors(component[u]) };
+			EXPECT_TRUE(std::binary_search(heads.begin(), heads.end(), component[v]));
+		}
+	}
+}
+
+TEST(ParallelSCCTest, LongPathAndCycle)
+{
+	const int n{ 1'000'000 };
+	std::vector<std::pair<int, int>> edges;
+	for (int u{}; u + 1 < n; ++u) edges.push_back({ u, u + 1 });
+
+	CSRGraph path{ CSRGraph::fromEdges(n, edges) };
+	EXPECT_EQ(ParallelSCC{ path.view() }.componentCount(), n);
+
+	edges.push_back({ n - 1, 0 });
+	CSRGraph cycle{ CSRGraph::fromEdges(n, edges) };
+	ParallelSCC p{ cycle.view() };
+	ASSERT_EQ(p.componentCount(), 1);
+	EXPECT_EQ(p.members(0).size(), static_cast<std::size_t>(n));
+}
+
+TEST(ParallelSCCTest, BenchmarkAgainstTarjan)
+{
+	CSRGraph g{ randomClusteredGraph(2'000'000, 3'000'000, 3) };
+
+	auto start{ std::chrono::steady_clock::now() };
+	Tarjan t{ g.view() };
+	auto tarjanTime{ std::chrono::steady_clock::now() - start };
+
+	start = std::chrono::steady_clock::now();
+	ParallelSCC p{ g.view() };
+	auto parallelTime{ std::chrono::steady_clock::now() - start };
+
+	EXPECT_EQ(static_cast<std::size_t>(p.componentCount()), t.getSCC().size());
+	std::cout << "SCCs: " << p.componentCount() << ", Tarjan "
+		<< std::chrono::duration_cast<std::chrono::milliseconds>(tarjanTime).count() << " ms, parallel ("
+		<< defaultThreadCount() << " threads) "
+		<< std::chrono::duration_cast<std::chrono::milliseconds>(parallelTime).count() << " ms" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
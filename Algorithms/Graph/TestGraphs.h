@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <tuple>
+#include <random>
+#include "CSRGraph.h"
+
+/**
+ * @brief Generated graphs and checks shared by the shortest path tests and benchmarks
+ *        (Dijkstra.cpp, DeltaStepping.cpp, ContractionHierarchies.cpp, AStarAlgorithm.cpp).
+ */
+
+// m directed arcs between random endpoints, weights in [0, maxWeight]
+inline CSRGraph randomGraph(int n, int m, int maxWeight, unsigned seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> vertex(0, n - 1), weight(0, maxWeight);
+
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int i{}; i < m; ++i) edges.push_back({vertex(rng), vertex(rng), weight(rng)});
+
+    return CSRGraph::fromEdges(n, edges);
+}
+
+// road-like graph: a grid with random small integer weights, vertex r * side + c at row r, column c
+inline CSRGraph roadGrid(int side, int maxWeight, unsigned seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> weight(1, maxWeight);
+
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int r{}; r < side; ++r) {
+        for (int c{}; c < side; ++c) {
+            int u{r * side + c};
+            if (c + 1 < side) edges.push_back({u, u + 1, weight(rng)});
+            if (r + 1 < side) edges.push_back({u, u + side, weight(rng)});
+        }
+    }
+    return CSRGraph::fromEdges(side * side, edges, true/*undirected*/);
+}
+
+// consecutive vertices joined by edges of g whose weights add up to distance
+inline bool isPath(CSRGraphView g, const std::vector<int>& path, int source, int target, int distance)
+{
+    if (path.empty() || path.front() != source || path.back() != target) return false;
+
+    long long length{};
+    for (std::size_t i{1}; i < path.size(); ++i) {
+        int best{-1};
+        for (int e{g.firstEdge(path[i - 1])}; e < g.lastEdge(path[i - 1]); ++e) {
+            if (g.target(e) == path[i] && (best == -1 || g.weight(e) < best)) best = g.weight(e);
+        }
+        if (best == -1) return false;
+        length += best;
+    }
+    return length == distance;
+}
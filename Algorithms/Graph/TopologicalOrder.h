@@ -0,0 +1,366 @@
+#pragma once
+
+#include <span>
+#include <queue>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @brief Kahn's algorithm: repeatedly take a vertex without incoming edges and remove its out-edges.
+ * @return a topological order; it has fewer than n vertices if the graph has a cycle (the vertices on
+ *         or behind a cycle never reach in-degree 0)
+ */
+inline std::vector<int> topologicalOrder(CSRGraphView graph)
+{
+    int n{graph.size()};
+    std::vector<int> inDegree(n); // Stores the in-degree of each vertex
+
+    for (int e{}; e < graph.numberOfEdges; ++e) {
+        ++inDegree[graph.target(e)]; // Increase in-degree of v for every edge u -> v
+    }
+
+    std::queue<int> q;
+    // Push all nodes with in-degree 0 into the queue (starting points)
+    for (int u{}; u < n; ++u) {
+        if (inDegree[u] == 0) q.push(u);
+    }
+
+    std::vector<int> topSort{}; // Stores topologically sorted order
+    topSort.reserve(n);
+
+    while (!q.empty()) {
+        int u{q.front()};
+        q.pop();
+        topSort.push_back(u); // Add vertex to the topological order
+
+        // Reduce the in-degree of neighboring nodes
+        for (int v : graph.neighbors(u)) {
+            --inDegree[v];
+            if (!inDegree[v]) q.push(v);
+        }
+    }
+
+    return topSort;
+}
+
+/**
+ * @brief Topological levels (wavefronts) as CSR slices: level(0) are the vertices without incoming edges,
+ *        level(i + 1) the vertices whose last predecessor is in level(i). The vertices of a level don't
+ *        depend on each other, so a level can run concurrently once the previous one is done.
+ *
+ * Every level is sorted. If the graph has a cycle, the vertices on or behind it are in no level and
+ * isComplete() is false.
+ */
+struct TopologicalLevels
+{
+    int numberOfVertices{};
+    std::vector<int> offsets{0}; // level i is vertices[offsets[i] .. offsets[i + 1])
+    std::vector<int> vertices;
+
+    int count() const noexcept { return static_cast<int>(offsets.size()) - 1; }
+    bool isComplete() const noexcept { return static_cast<int>(vertices.size()) == numberOfVertices; }
+
+    std::span<const int> level(int i) const noexcept
+    {
+        return {vertices.data() + offsets[i], vertices.data() + offsets[i + 1]};
+    }
+};
+
+/**
+ * @brief Kahn's algorithm one frontier at a time: the in-degrees are counted and decremented atomically,
+ *        so the vertices of a frontier are processed in parallel and each successor is released by
+ *        exactly the thread that removes its last incoming edge.
+ * @param threads number of worker threads, 0 means all hardware threads
+ */
+inline TopologicalLevels topologicalLevels(CSRGraphView graph, unsigned threads = 0)
+{
+    constexpr std::size_t minChunk{1024}; // vertices per thread at least
+    const int n{graph.size()};
+    if (threads == 0) threads = defaultThreadCount();
+
+    std::vector<std::atomic<int>> inDegree(n);
+    parallelFor(n, threads, [&](std::size_t u, unsigned) {
+        for (int v : graph.neighbors(static_cast<int>(u))) inDegree[v].fetch_add(1, std::memory_order_relaxed);
+    }, minChunk);
+
+    TopologicalLevels levels{n, {0}, {}};
+    levels.vertices.reserve(n);
+    for (int u{}; u < n; ++u) {
+        if (inDegree[u].load(std::memory_order_relaxed) == 0) levels.vertices.push_back(u);
+    }
+
+    std::vector<std::vector<int>> local(threads);
+    while (static_cast<int>(levels.vertices.size()) > levels.offsets.back()) {
+        const int begin{levels.offsets.back()}, end{static_cast<int>(levels.vertices.size())};
+        levels.offsets.push_back(end);
+
+        parallelForChunks(end - begin, threads, [&](std::size_t first, std::size_t last, unsigned t) {
+            local[t].clear();
+            for (std::size_t i{first}; i < last; ++i) {
+                for (int v : graph.neighbors(levels.vertices[begin + i])) {
+                    if (inDegree[v].fetch_sub(1, std::memory_order_relaxed) == 1) local[t].push_back(v);
+                }
+            }
+        }, minChunk);
+
+        // the chunks of this level only read vertices[begin, end), the next level goes behind it
+        for (auto& part : local) {
+            levels.vertices.insert(levels.vertices.end(), part.begin(), part.end());
+            part.clear();
+        }
+        std::sort(levels.vertices.begin() + end, levels.vertices.end());
+    }
+
+    return levels;
+}
+
+/**
+ * @class DynamicTopologicalOrder
+ *
+ * @brief A topological order that is kept up to date while edges are inserted (Pearce–Kelly).
+ *
+ * The order is seeded once by Kahn's algorithm. rank(v) is the position of v in order(), and every edge
+ * u -> v has rank(u) < rank(v). Inserting u -> v:
+ *   - rank(u) < rank(v): the order is still valid, nothing moves.
+ *   - otherwise only the vertices with rank in [rank(v), rank(u)] can be out of place, the affected region.
+ *     A forward DFS from v and a backward DFS from u, both limited to that rank window, collect the ones
+ *     that must move: forward finds the vertices v reaches (if it reaches u, the edge closes a cycle and
+ *     is rejected), backward the vertices that reach u. Both sets are placed on the ranks they already
+ *     occupy, the "reaches u" set first, each set keeping its internal order.
+ * The cost is proportional to the edges of the affected region, not to the graph; on typical sparse
+ * insertions it touches a handful of vertices.
+ *
+ * Inserted edges are kept in per-vertex linked lists in two flat pools (forward and backward) next to the
+ * CSR arrays of the seed graph, so an insertion is O(1) memory and no adjacency list is reallocated.
+ */
+
+class DynamicTopologicalOrder
+{
+public:
+    // the graph must be acyclic; it has to outlive this object, nothing is copied but its reverse
+    explicit DynamicTopologicalOrder(CSRGraphView graph)
+        : forward{graph}, reverseStorage{CSRGraph::reverse(graph)}, backward{reverseStorage.view()}, n{graph.size()}
+    {
+        initialize();
+    }
+
+    DynamicTopologicalOrder(int numberOfVertices, const std::vector<std::pair<int, int>>& edges)
+        : forwardStorage{CSRGraph::fromEdges(numberOfVertices, edges)}, forward{forwardStorage.view()},
+          reverseStorage{CSRGraph::reverse(forward)}, backward{reverseStorage.view()}, n{numberOfVertices}
+    {
+        initialize();
+    }
+
+    // forward and backward may point into the storage members, so a copy would view the original's arrays
+    DynamicTopologicalOrder(const DynamicTopologicalOrder&) = delete;
+    DynamicTopologicalOrder& operator=(const DynamicTopologicalOrder&) = delete;
+
+    /**
+     * @brief Inserts u -> v and repairs the order.
+     * @return false (nothing changes) if the edge would close a cycle; cycle() is then that cycle
+     */
+    bool addEdge(int u, int v)
+    {
+        checkVertex(u);
+        checkVertex(v);
+        lastCycle.clear();
+
+        if (u == v) {
+            lastCycle = {u, u};
+            return false;
+        }
+
+        if (ranks[u] < ranks[v]) {
+            insertArc(u, v);
+            return true;
+        }
+
+        const int lowerBound{ranks[v]}, upperBound{ranks[u]};
+        if (!collectForward(v, u, upperBound)) {
+            recordCycle(u, v);
+            clearMarks();
+            return false;
+        }
+        collectBackward(u, lowerBound);
+        reorder();
+        clearMarks();
+
+        insertArc(u, v);
+        return true;
+    }
+
+    const std::vector<int>& order() const noexcept { return vertexAt; }
+    int rank(int v) const { return ranks[checkVertex(v)]; }
+    int size() const noexcept { return n; }
+
+    // u, v, ..., u for the last rejected addEdge(u, v), empty after a successful one
+    const std::vector<int>& cycle() const noexcept { return lastCycle; }
+
+private:
+    // inserted arcs, one linked list per vertex: head[u] -> next[...] -> ... -> -1
+    struct ArcPool
+    {
+        std::vector<int> head;
+        std::vector<int> next;
+        std::vector<int> vertex;
+
+        void add(int u, int v)
+        {
+            next.push_back(head[u]);
+            vertex.push_back(v);
+            head[u] = static_cast<int>(vertex.size()) - 1;
+        }
+    };
+
+    void initialize()
+    {
+        vertexAt = topologicalOrder(forward);
+        if (static_cast<int>(vertexAt.size()) != n) throw std::invalid_argument("Graph contains a cycle");
+
+        ranks.assign(n, 0);
+        for (int r{}; r < n; ++r) ranks[vertexAt[r]] = r;
+
+        addedOut.head.assign(n, -1);
+        addedIn.head.assign(n, -1);
+        mark.assign(n, 0);
+        parent.assign(n, -1);
+    }
+
+    int checkVertex(int u) const
+    {
+        if (u < 0 || u >= n) throw std::out_of_range("Edge contains node outside [0,V)");
+        return u;
+    }
+
+    void insertArc(int u, int v)
+    {
+        addedOut.add(u, v);
+        addedIn.add(v, u);
+    }
+
+    template <typename Visit>
+    static void forEachNeighbor(CSRGraphView g, const ArcPool& added, int u, Visit visit)
+    {
+        for (int w : g.neighbors(u)) visit(w);
+        for (int a{added.head[u]}; a != -1; a = added.next[a]) visit(added.vertex[a]);
+    }
+
+    // vertices reachable from v with rank <= upperBound; false as soon as target (rank == upperBound) shows up
+    bool collectForward(int v, int target, int upperBound)
+    {
+        reachedFromHead.clear();
+        stack.assign(1, v);
+        mark[v] = forwardMark;
+        parent[v] = -1;
+
+        while (!stack.empty()) {
+            int x{stack.back()};
+            stack.pop_back();
+            reachedFromHead.push_back(x);
+
+            bool closesCycle{false};
+            forEachNeighbor(forward, addedOut, x, [&](int w) {
+                if (closesCycle || mark[w] != 0 || ranks[w] > upperBound) return;
+                mark[w] = forwardMark;
+                parent[w] = x;
+                if (w == target) closesCycle = true;
+                stack.push_back(w);
+            });
+            if (closesCycle) return false;
+        }
+        return true;
+    }
+
+    // vertices that reach u with rank >= lowerBound (v itself can't be one, that would be a cycle)
+    void collectBackward(int u, int lowerBound)
+    {
+        reachingTail.clear();
+        stack.assign(1, u);
+        mark[u] = backwardMark;
+
+        while (!stack.empty()) {
+            int x{stack.back()};
+            stack.pop_back();
+            reachingTail.push_back(x);
+
+            forEachNeighbor(backward, addedIn, x, [&](int w) {
+                if (mark[w] != 0 || ranks[w] < lowerBound) return;
+                mark[w] = backwardMark;
+                stack.push_back(w);
+            });
+        }
+    }
+
+    // the vertices that reach u go first, then the ones reached from v, onto the ranks they held
+    void reorder()
+    {
+        auto byRank = [&](int a, int b) { return ranks[a] < ranks[b]; };
+        std::sort(reachingTail.begin(), reachingTail.end(), byRank);
+        std::sort(reachedFromHead.begin(), reachedFromHead.end(), byRank);
+
+        slots.clear();
+        for (int x : reachingTail) slots.push_back(ranks[x]);
+        for (int x : reachedFromHead) slots.push_back(ranks[x]);
+        std::sort(slots.begin(), slots.end());
+
+        std::size_t next{};
+        for (int x : reachingTail) place(x, slots[next++]);
+        for (int x : reachedFromHead) place(x, slots[next++]);
+    }
+
+    void place(int x, int r)
+    {
+        ranks[x] = r;
+        vertexAt[r] = x;
+    }
+
+    // the forward search stopped at u: parent pointers lead back to v
+    void recordCycle(int u, int v)
+    {
+        for (int x{u}; x != v; x = parent[x]) lastCycle.push_back(x);
+        lastCycle.push_back(v);
+        std::reverse(lastCycle.begin(), lastCycle.end()); // v, ..., u
+        lastCycle.insert(lastCycle.begin(), u);           // u, v, ..., u
+    }
+
+    // marks are only set on the vertices of the current search, reset just those
+    void clearMarks()
+    {
+        for (int x : reachedFromHead) mark[x] = 0;
+        for (int x : reachingTail) mark[x] = 0;
+        for (int x : stack) mark[x] = 0;
+        reachingTail.clear();
+        stack.clear();
+    }
+
+private:
+    static constexpr std::uint8_t forwardMark{1};
+    static constexpr std::uint8_t backwardMark{2};
+
+    CSRGraph forwardStorage; // only when built from an edge list
+    CSRGraphView forward;
+    CSRGraph reverseStorage;
+    CSRGraphView backward;
+    int n{};
+
+    ArcPool addedOut;
+    ArcPool addedIn;
+
+    std::vector<int> vertexAt; // the current order
+    std::vector<int> ranks;    // ranks[vertexAt[r]] == r
+    std::vector<int> lastCycle;
+
+    // scratch of one insertion
+    std::vector<std::uint8_t> mark;
+    std::vector<int> parent;
+    std::vector<int> stack;
+    std::vector<int> reachedFromHead;
+    std::vector<int> reachingTail;
+    std::vector<int> slots;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @brief Edge ids of an undirected CSR graph.
+ *
+ * CSRGraph::fromEdges(..., true) stores an undirected edge as two arcs, u -> v and v -> u, and a solver that
+ * needs to know which arcs belong together (to not walk an edge back, or to tell a parallel edge from the
+ * tree edge of a DFS) keeps mate[e], the other arc of the edge of e. The edge id of an arc is then the
+ * smaller of the two, edgeId(e) = min(e, mate[e]).
+ */
+
+/**
+ * @brief Matches the two arcs of every undirected edge: the k-th arc u -> v in the list of u with the k-th
+ * arc v -> u in the list of v, self-loops two by two. Throws if some arc has no reverse.
+ */
+inline std::vector<int> pairUndirectedArcs(CSRGraphView g, unsigned threads = 0)
+{
+    if (threads == 0) threads = defaultThreadCount();
+    const int n{g.size()};
+
+    // arcs u -> v with u < v by head v, in the order of u and of their position
+    std::vector<int> offsets(n + 1, 0);
+    for (int u{}; u < n; ++u) {
+        for (int v : g.neighbors(u)) {
+            if (v > u) ++offsets[v + 1];
+        }
+    }
+    for (int v{}; v < n; ++v) offsets[v + 1] += offsets[v];
+
+    std::vector<int> lower(offsets.back()), tailOf(offsets.back());
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (int u{}; u < n; ++u) {
+        for (int e{g.firstEdge(u)}; e < g.lastEdge(u); ++e) {
+            if (g.target(e) <= u) continue;
+            int slot{cursor[g.target(e)]++};
+            lower[slot] = e;
+            tailOf[slot] = u;
+        }
+    }
+
+    std::vector<int> mate(g.numberOfEdges, -1);
+    std::atomic<bool> broken{false};
+    parallelForChunks(n, threads, [&](std::size_t begin, std::size_t end, unsigned) {
+        std::vector<int> down;
+        for (int v{static_cast<int>(begin)}; v < static_cast<int>(end); ++v) {
+            down.clear();
+            int loop{-1};
+            for (int e{g.firstEdge(v)}; e < g.lastEdge(v); ++e) {
+                if (g.target(e) < v) down.push_back(e);
+                else if (g.target(e) == v && loop == -1) loop = e;
+                else if (g.target(e) == v) {
+                    mate[loop] = e;
+                    mate[e] = loop;
+                    loop = -1;
+                }
+            }
+            std::stable_sort(down.begin(), down.end(), [&g](int a, int b) { return g.target(a) < g.target(b); });
+
+            const int first{offsets[v]};
+            if (loop != -1 || static_cast<int>(down.size()) != offsets[v + 1] - first) {
+                broken = true;
+                continue;
+            }
+            for (std::size_t i{}; i < down.size(); ++i) {
+                if (g.target(down[i]) != tailOf[first + i]) broken = true;
+                mate[down[i]] = lower[first + i];
+                mate[lower[first + i]] = down[i];
+            }
+        }
+    }, 1024);
+
+    if (broken) throw std::invalid_argument("Graph is not undirected: an arc has no reverse arc");
+    return mate;
+}
+
+// the edge of arc e: the smaller of its two arcs
+inline int edgeId(const std::vector<int>& mate, int e) noexcept
+{
+    return std::min(e, mate[e]);
+}
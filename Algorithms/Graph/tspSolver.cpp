@@ -31,11 +31,24 @@
  * ## Time & Space Complexity
  * - **Time**: O(n^2 * 2^n) for both TopDown and BottomUp approaches
  * - **Space**: O(n * 2^n) to store the DP table
+ *
+ * For larger instances `solveTour()` runs HeldKarpSolver (HeldKarp.h): one flat aligned table, masks
+ * processed by popcount layer in parallel, and the optimal tour is returned along with its cost.
+ * `solveTour(LeanHeldKarpOptions)` runs LeanHeldKarpSolver (LeanHeldKarp.h) instead, which keeps two layers
+ * with 16 or 32-bit costs and recovers the tour by recomputation or from a checkpoint file.
  */
 
 #include <iostream>
 #include <vector>
 #include <limits>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include "CSRGraph.h"
+#include "HeldKarp.h"
+#include "LeanHeldKarp.h"
+#include "../Common/MinPlus.h"
 #include "gtest/gtest.h"
 
 class TSPSolver
@@ -50,6 +63,17 @@ public:
         }
     }
 
+    // the DP needs O(1) edge lookups, so the (small) graph is expanded into a dense matrix
+    explicit TSPSolver(CSRGraphView g, int start = 0) : n{g.size()}, startPoint{start}
+    {
+        graph.assign(n, std::vector<int>(n, INF));
+        for (int u{}; u < n; ++u) {
+            for (int e{g.firstEdge(u)}; e < g.lastEdge(u); ++e) {
+                graph[u][g.target(e)] = g.weight(e);
+            }
+        }
+    }
+
     int solveTopDown()
     {
         std::vector<std::vector<int>> dp(1 << n, std::vector<int>(n, -1));
@@ -63,30 +87,43 @@ public:
         std::vector<std::vector<int>> dp(1 << n, std::vector<int>(n, INF));
         dp[1 << startPoint][startPoint] = 0;
 
+        // pull form: dp[mask][v] = min over u of dp[mask without v][u] + graph[u][v]; dp is INF for every
+        // u outside the mask, so it is a dense min-plus reduction over a row of dp and a row of incoming
+        std::vector<std::vector<int>> incoming(n, std::vector<int>(n));
+        for (int u{}; u < n; ++u) {
+            for (int v{}; v < n; ++v) incoming[v][u] = graph[u][v];
+        }
+
         for (int mask{}; mask < (1 << n); ++mask) {
-            for (int u{}; u < n; ++u) {
-                if ((mask & (1 << u)) == 0) continue; // u not in the mask
-                if (dp[mask][u] == INF) continue;
+            if ((mask & (1 << startPoint)) == 0) continue; // every path starts at startPoint
 
-                for (int v{}; v < n; ++v) {
-                    if ((mask & (1 << v)) != 0 || graph[u][v] == INF) continue;
-                    int newMask{mask | (1 << v)};
+            for (int v{}; v < n; ++v) {
+                if (v == startPoint || (mask & (1 << v)) == 0) continue; // v not in the mask
 
-                    dp[newMask][v] = std::min(dp[newMask][v], dp[mask][u] + graph[u][v]);
-                }
+                dp[mask][v] = minPlusReduce(dp[mask ^ (1 << v)].data(), incoming[v].data(), n);
             }
         }
 
-        int minCost{INF};
         int allVisited{(1 << n) - 1};
-        for (int u{}; u < n; ++u) {
-            if (u == startPoint || graph[u][startPoint] == INF) continue;
-            minCost = std::min(minCost, dp[allVisited][u] + graph[u][startPoint]); 
-        }
+        int minCost{minPlusReduce(dp[allVisited].data(), incoming[startPoint].data(), n)};
 
         return minCost == INF ? -1 : minCost;
     }
 
+    // cost and order of an optimal tour, with the flat parallel engine
+    TSPTour solveTour(unsigned threads = 0) const
+    {
+        HeldKarpSolver solver{graph, startPoint, threads};
+        return solver.solve();
+    }
+
+    // same, with the memory-lean engine
+    TSPTour solveTour(const LeanHeldKarpOptions& options) const
+    {
+        LeanHeldKarpSolver solver{graph, startPoint, options};
+        return solver.solve();
+    }
+
 private:
     int dfs(std::vector<std::vector<int>>& dp, int u, int mask)
     {
@@ -114,7 +151,7 @@ private:
     int startPoint{};
 
     int minCost{};
-    const int INF{std::numeric_limits<int>::max() / 2};
+    const int INF{minPlusInfinity}; // INT_MAX / 2, the "unreachable" sentinel of the min-plus kernels
     
     std::vector<std::vector<int>> graph; // matrix
 };
@@ -179,6 +216,19 @@ TEST(TSPSolverTest, SquareGraph)
     EXPECT_EQ(topDown, 4); // minimal cycle cost
 }
 
+TEST(TSPSolverTest, CSRGraphView)
+{
+    std::vector<std::tuple<int, int, int>> edges{
+        {0, 1, 10}, {0, 2, 15}, {0, 3, 20}, {1, 2, 35}, {1, 3, 25}, {2, 3, 30}
+    };
+
+    CSRGraph graph{CSRGraph::fromEdges(4, edges, true/*undirected*/)};
+    TSPSolver solver{graph.view()};
+
+    EXPECT_EQ(solver.solveTopDown(), 80);
+    EXPECT_EQ(solver.solveBottomUp(), 80);
+}
+
 TEST(TSPSolverTest, BenchmarkBigGraph)
 {
     int n{12};
@@ -214,6 +264,247 @@ TEST(TSPSolverTest, BenchmarkBigGraph)
               << " ms\n";
 }
 
+TEST(TSPSolverTest, BenchmarkBottomUpKernels)
+{
+    const MinPlusIsa best{minPlusIsa()};
+    for (int n : {12, 15, 18}) {
+        std::mt19937 rng{static_cast<unsigned>(n)};
+        std::uniform_int_distribution<int> weight(1, 1000);
+
+        std::vector<std::tuple<int, int, int>> edges;
+        for (int i{}; i < n; ++i) {
+            for (int j{i + 1}; j < n; ++j) edges.push_back({i, j, weight(rng)});
+        }
+        TSPSolver solver{n, edges};
+
+        std::cout << "n = " << n << ":";
+        int reference{-1};
+        for (MinPlusIsa isa : {MinPlusIsa::Scalar, MinPlusIsa::Avx2, MinPlusIsa::Avx512}) {
+            if (setMinPlusIsa(isa) != isa) continue; // not supported by this CPU
+
+            auto start{std::chrono::high_resolution_clock::now()};
+            int cost{solver.solveBottomUp()};
+            auto end{std::chrono::high_resolution_clock::now()};
+
+            if (reference == -1) reference = cost;
+            EXPECT_EQ(cost, reference);
+            std::cout << " " << minPlusIsaName(isa) << " "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms";
+        }
+        std::cout << "\n";
+    }
+    setMinPlusIsa(best);
+}
+
+// checks that the tour is a Hamiltonian cycle from the start and returns its cost
+int tourCost(const std::vector<std::vector<int>>& cost, const TSPTour& tour, int start)
+{
+    int n{static_cast<int>(cost.size())};
+    EXPECT_EQ(static_cast<int>(tour.order.size()), n + 1);
+    EXPECT_EQ(tour.order.front(), start);
+    EXPECT_EQ(tour.order.back(), start);
+
+    std::vector<int> sorted(tour.order.begin(), tour.order.end() - 1);
+    std::sort(sorted.begin(), sorted.end());
+    for (int v{}; v < n; ++v) EXPECT_EQ(sorted[v], v);
+
+    int total{};
+    for (std::size_t i{1}; i < tour.order.size(); ++i) total += cost[tour.order[i - 1]][tour.order[i]];
+    return total;
+}
+
+TEST(HeldKarpTest, SmallGraphsReturnTheTour)
+{
+    std::vector<std::tuple<int, int, int>> edges{
+        {0, 1, 10}, {0, 2, 15}, {0, 3, 20}, {1, 2, 35}, {1, 3, 25}, {2, 3, 30}
+    };
+    TSPSolver solver{4, edges};
+    TSPTour tour{solver.solveTour(2)};
+
+    EXPECT_EQ(tour.cost, 80);
+    EXPECT_TRUE(tour.order == (std::vector<int>{0, 1, 3, 2, 0}) || tour.order == (std::vector<int>{0, 2, 3, 1, 0}));
+
+    TSPSolver disconnected{4, {{0, 1, 10}, {2, 3, 20}}};
+    EXPECT_EQ(disconnected.solveTour().cost, -1);
+    EXPECT_TRUE(disconnected.solveTour().order.empty());
+}
+
+TEST(HeldKarpTest, MatchesBottomUpOnRandomAsymmetricGraphs)
+{
+    std::mt19937 rng{5};
+    std::uniform_int_distribution<int> weight(1, 100), percent(0, 99);
+
+    for (int n{1}; n <= 11; ++n) {
+        for (int start : {0, n / 2, n - 1}) {
+            std::vector<std::vector<int>> cost(n, std::vector<int>(n, minPlusInfinity));
+            std::vector<std::tuple<int, int, int>> edges;
+            for (int u{}; u < n; ++u) {
+                for (int v{}; v < n; ++v) {
+                    if (u != v && percent(rng) < 70) cost[u][v] = weight(rng);
+                }
+            }
+
+            // reference: the plain bottom-up DP on the same (directed) matrix
+            std::vector<std::vector<int>> dp(1 << n, std::vector<int>(n, minPlusInfinity));
+            dp[1 << start][start] = 0;
+            for (int mask{}; mask < (1 << n); ++mask) {
+                for (int u{}; u < n; ++u) {
+                    if (dp[mask][u] >= minPlusInfinity) continue;
+                    for (int v{}; v < n; ++v) {
+                        if ((mask >> v & 1) || cost[u][v] >= minPlusInfinity) continue;
+                        dp[mask | 1 << v][v] = std::min(dp[mask | 1 << v][v], dp[mask][u] + cost[u][v]);
+                    }
+                }
+            }
+            int expected{minPlusInfinity};
+            for (int u{}; u < n; ++u) {
+                if (u != start && dp[(1 << n) - 1][u] < minPlusInfinity && cost[u][start] < minPlusInfinity) {
+                    expected = std::min(expected, dp[(1 << n) - 1][u] + cost[u][start]);
+                }
+            }
+            if (expected == minPlusInfinity) expected = -1;
+
+            for (unsigned threads : {1u, 3u}) {
+                TSPTour tour{HeldKarpSolver{cost, start, threads}.solve()};
+                ASSERT_EQ(tour.cost, expected) << "n=" << n << " start=" << start;
+                if (tour.cost != -1 && n > 1) {
+                    EXPECT_EQ(tourCost(cost, tour, start), tour.cost);
+                }
+            }
+        }
+    }
+}
+
+TEST(HeldKarpTest, BenchmarkFlatEngine)
+{
+    for (int n : {16, 18, 21}) {
+        std::mt19937 rng{static_cast<unsigned>(n)};
+        std::uniform_int_distribution<int> weight(1, 1000);
+
+        std::vector<std::tuple<int, int, int>> edges;
+        for (int i{}; i < n; ++i) {
+            for (int j{i + 1}; j < n; ++j) edges.push_back({i, j, weight(rng)});
+        }
+        TSPSolver solver{n, edges};
+
+        std::cout << "n = " << n << " (" << HeldKarpSolver::requiredBytes(n) / (1 << 20) << " MB):";
+        int bottomUp{-1};
+        if (n <= 18) {
+            auto start{std::chrono::high_resolution_clock::now()};
+            bottomUp = solver.solveBottomUp();
+            auto end{std::chrono::high_resolution_clock::now()};
+            std::cout << " BottomUp " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms";
+        }
+
+        auto start{std::chrono::high_resolution_clock::now()};
+        TSPTour tour{solver.solveTour()};
+        auto end{std::chrono::high_resolution_clock::now()};
+        std::cout << ", Held-Karp engine (" << defaultThreadCount() << " threads) "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+        if (bottomUp != -1) {
+            EXPECT_EQ(tour.cost, bottomUp);
+        }
+        EXPECT_EQ(static_cast<int>(tour.order.size()), n + 1);
+    }
+}
+
+TEST(LeanHeldKarpTest, MatchesFlatEngine)
+{
+    std::mt19937 rng{9};
+    std::uniform_int_distribution<int> weight(0, 200), percent(0, 99);
+    const auto checkpoint{std::filesystem::temp_directory_path() / "lean_held_karp_test.bin"};
+
+    for (int n{1}; n <= 12; ++n) {
+        std::vector<std::vector<int>> cost(n, std::vector<int>(n, minPlusInfinity));
+        for (int u{}; u < n; ++u) {
+            for (int v{}; v < n; ++v) {
+                if (u != v && percent(rng) < 75) cost[u][v] = weight(rng);
+            }
+        }
+        int start{n / 3};
+        TSPTour expected{HeldKarpSolver{cost, start, 1}.solve()};
+
+        for (CostWidth width : {CostWidth::Automatic, CostWidth::Bits16, CostWidth::Bits32}) {
+            for (TourRecovery recovery : {TourRecovery::None, TourRecovery::Recompute, TourRecovery::Checkpoint}) {
+                for (unsigned threads : {1u, 3u}) {
+                    LeanHeldKarpSolver solver{cost, start, LeanHeldKarpOptions{width, recovery, checkpoint, threads}};
+                    TSPTour tour{solver.solve()};
+
+                    ASSERT_EQ(tour.cost, expected.cost) << "n=" << n;
+                    if (recovery == TourRecovery::None || tour.cost == -1) {
+                        EXPECT_TRUE(tour.order.empty());
+                    } else if (n > 1) {
+                        EXPECT_EQ(tourCost(cost, tour, start), tour.cost) << "n=" << n;
+                    }
+                    EXPECT_FALSE(std::filesystem::exists(checkpoint));
+                }
+            }
+        }
+    }
+}
+
+TEST(LeanHeldKarpTest, CostWidthAndOverflow)
+{
+    std::vector<std::tuple<int, int, int>> edges{
+        {0, 1, 10}, {0, 2, 15}, {0, 3, 20}, {1, 2, 35}, {1, 3, 25}, {2, 3, 30}
+    };
+    TSPSolver small{4, edges};
+    EXPECT_EQ(small.solveTour(LeanHeldKarpOptions{}).cost, 80);
+
+    // paths of 4 edges of 20000 don't fit 16 bits
+    std::vector<std::vector<int>> cost(5, std::vector<int>(5, 20000));
+    for (int v{}; v < 5; ++v) cost[v][v] = minPlusInfinity;
+
+    LeanHeldKarpSolver automatic{cost};
+    EXPECT_EQ(automatic.costWidth(), CostWidth::Bits32);
+    EXPECT_EQ(automatic.solve().cost, 100000);
+
+    LeanHeldKarpSolver forced{cost, 0, LeanHeldKarpOptions{CostWidth::Bits16}};
+    EXPECT_THROW(forced.solve(), std::overflow_error);
+
+    EXPECT_EQ(LeanHeldKarpSolver(std::vector<std::vector<int>>(4, std::vector<int>(4, 100))).costWidth(), CostWidth::Bits16);
+}
+
+TEST(LeanHeldKarpTest, BenchmarkMemoryAndTime)
+{
+    for (int n : {16, 20, 25, 30}) {
+        std::cout << "n = " << n << ": flat table " << HeldKarpSolver::requiredBytes(n) / (1 << 20) << " MB, two 16-bit layers "
+                  << LeanHeldKarpSolver::peakLayerBytes(n, CostWidth::Bits16) / (1 << 20) << " MB, two 32-bit layers "
+                  << LeanHeldKarpSolver::peakLayerBytes(n, CostWidth::Bits32) / (1 << 20) << " MB\n";
+    }
+
+    const int n{20};
+    std::mt19937 rng{3};
+    std::uniform_int_distribution<int> weight(1, 1000);
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int i{}; i < n; ++i) {
+        for (int j{i + 1}; j < n; ++j) edges.push_back({i, j, weight(rng)});
+    }
+    TSPSolver solver{n, edges};
+
+    auto milliseconds = [](auto start, auto end) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    };
+
+    auto startFlat{std::chrono::high_resolution_clock::now()};
+    TSPTour flat{solver.solveTour()};
+    auto endFlat{std::chrono::high_resolution_clock::now()};
+    std::cout << "n = " << n << ": flat " << milliseconds(startFlat, endFlat) << " ms";
+
+    const auto checkpoint{std::filesystem::temp_directory_path() / "lean_held_karp_benchmark.bin"};
+    for (TourRecovery recovery : {TourRecovery::None, TourRecovery::Recompute, TourRecovery::Checkpoint}) {
+        auto start{std::chrono::high_resolution_clock::now()};
+        TSPTour tour{solver.solveTour(LeanHeldKarpOptions{CostWidth::Automatic, recovery, checkpoint})};
+        auto end{std::chrono::high_resolution_clock::now()};
+
+        EXPECT_EQ(tour.cost, flat.cost);
+        const char* name{recovery == TourRecovery::None ? "cost only" : recovery == TourRecovery::Recompute ? "recompute" : "checkpoint"};
+        std::cout << ", lean (" << name << ") " << milliseconds(start, end) << " ms";
+    }
+    std::cout << "\n";
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
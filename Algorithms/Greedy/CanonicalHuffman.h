@@ -0,0 +1,502 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Canonical Huffman codec over bytes: bit-packed output, table-driven decoding, streaming API.
+ *
+ * ## Canonical codes
+ * Only the code length of every symbol is stored. The codes follow from the lengths: shorter codes first,
+ * and within one length by symbol, consecutive binary numbers. So the code table is the 128-byte header
+ * (HuffmanCode::headerBytes, one 4-bit length per byte value, 0 for unused bytes), and the encoder and the
+ * decoder derive the same codes from it. Lengths are at most maxCodeLength = 15, as in DEFLATE.
+ *
+ * ## Bitstream
+ * Codes are written lowest bit first into a 64-bit accumulator, which is flushed as one little-endian
+ * word whenever it is full, so the stream is the concatenation of 64-bit words plus a last partial one.
+ * The codes are stored bit-reversed for that: the first bit of a code is its lowest bit.
+ *
+ * ## Decoding
+ * The decoder keeps up to 64 bits of input in a register, refilled with one unaligned 8-byte load, and
+ * looks the next symbol up by its low primaryBits = 11 bits: a primary entry gives the symbol and its
+ * length directly, or, for the few longer codes, points to a secondary table indexed by the next up to
+ * 4 bits. After a refill at least 56 bits are buffered, enough for 56 / (longest code) codes without
+ * checks, three at the 15-bit limit.
+ *
+ * ## Streaming
+ * HuffmanEncoder::encode and HuffmanDecoder::decode take the input in pieces of any size and append to an
+ * output buffer; the decoder keeps the bits of an incomplete code across calls. huffmanCompress and
+ * huffmanDecompress wrap them into one buffer: the 64-bit symbol count, the header, the bitstream.
+ *
+ * The byte layout assumes a little-endian host, like the graph file formats.
+ */
+
+static_assert(std::endian::native == std::endian::little, "The Huffman bitstream is read and written as little-endian words");
+
+class HuffmanCode
+{
+public:
+    static constexpr int alphabetSize{256};
+    static constexpr int maxCodeLength{15};
+    static constexpr std::size_t headerBytes{alphabetSize / 2};
+
+    using Lengths = std::array<std::uint8_t, alphabetSize>;
+    using Frequencies = std::array<std::uint64_t, alphabetSize>;
+
+    HuffmanCode() = default; // no symbols
+
+    static Frequencies histogram(std::span<const std::uint8_t> data) noexcept
+    {
+        Frequencies frequencies{};
+        for (std::uint8_t c : data) ++frequencies[c];
+        return frequencies;
+    }
+
+    // the canonical code of the given lengths; throws if they are too long or no prefix code has them
+    static HuffmanCode fromLengths(const Lengths& lengths)
+    {
+        HuffmanCode code;
+        code.lengthOf = lengths;
+        code.assignCodes();
+        return code;
+    }
+
+    /**
+     * @brief An optimal code for the frequencies among those with lengths <= limit.
+     *
+     * No heap allocation: the used symbols are sorted once in a fixed array and merged with the two-queue
+     * method, O(256 log 256). Only if that tree is deeper than the limit, package-merge replaces it, O(limit * 256).
+     */
+    static HuffmanCode fromFrequencies(const Frequencies& frequencies, int limit = maxCodeLength)
+    {
+        if (limit < 1 || limit > maxCodeLength) throw std::invalid_argument("Huffman code length limit should be in [1, 15]");
+        return fromLengths(huffmanLengths(frequencies, limit));
+    }
+
+    int length(int symbol) const noexcept { return lengthOf[symbol]; }
+    const Lengths& lengths() const noexcept { return lengthOf; }
+
+    // the code of symbol, bit-reversed: bit 0 is the first bit of the stream
+    std::uint32_t code(int symbol) const noexcept { return codeOf[symbol]; }
+
+    std::uint64_t encodedBits(const Frequencies& frequencies) const noexcept
+    {
+        std::uint64_t bits{};
+        for (int c{}; c < alphabetSize; ++c) bits += frequencies[c] * lengthOf[c];
+        return bits;
+    }
+
+    void writeHeader(std::vector<std::uint8_t>& out) const
+    {
+        for (int c{}; c < alphabetSize; c += 2) out.push_back(static_cast<std::uint8_t>(lengthOf[c] | (lengthOf[c + 1] << 4)));
+    }
+
+    static HuffmanCode readHeader(std::span<const std::uint8_t> header)
+    {
+        if (header.size() < headerBytes) throw std::invalid_argument("Huffman header is truncated");
+
+        Lengths lengths{};
+        for (std::size_t i{}; i < headerBytes; ++i) {
+            lengths[2 * i] = header[i] & 0x0f;
+            lengths[2 * i + 1] = header[i] >> 4;
+        }
+        return fromLengths(lengths);
+    }
+
+private:
+    void assignCodes()
+    {
+        // count per length, then the first code of every length, MSB first (RFC 1951, 3.2.2)
+        std::array<int, maxCodeLength + 1> count{};
+        for (int len : lengthOf) {
+            if (len > maxCodeLength) throw std::invalid_argument("Huffman code length should be <= 15");
+            ++count[len];
+        }
+        count[0] = 0;
+
+        long long kraft{};
+        for (int len{1}; len <= maxCodeLength; ++len) kraft += static_cast<long long>(count[len]) << (maxCodeLength - len);
+        if (kraft > (1ll << maxCodeLength)) throw std::invalid_argument("Huffman code lengths are over-subscribed");
+
+        std::array<std::uint32_t, maxCodeLength + 2> next{};
+        for (int len{1}, code{}; len <= maxCodeLength; ++len) {
+            code = (code + count[len - 1]) << 1;
+            next[len] = static_cast<std::uint32_t>(code);
+        }
+
+        for (int c{}; c < alphabetSize; ++c) {
+            int len{lengthOf[c]};
+            codeOf[c] = len == 0 ? 0 : reverse(next[len]++, len);
+        }
+    }
+
+    static std::uint32_t reverse(std::uint32_t code, int length) noexcept
+    {
+        std::uint32_t reversed{};
+        for (int i{}; i < length; ++i, code >>= 1) reversed = (reversed << 1) | (code & 1);
+        return reversed;
+    }
+
+    struct Leaf
+    {
+        std::uint64_t weight{};
+        int symbol{};
+    };
+
+    // the used symbols by increasing frequency (ties by symbol), sorted once; returns how many there are
+    static int sortedLeaves(const Frequencies& frequencies, std::array<Leaf, alphabetSize>& leaves) noexcept
+    {
+        int k{};
+        for (int c{}; c < alphabetSize; ++c) {
+            if (frequencies[c] != 0) leaves[k++] = Leaf{frequencies[c], c};
+        }
+        std::sort(leaves.begin(), leaves.begin() + k, [](const Leaf& a, const Leaf& b) {
+            return a.weight != b.weight ? a.weight < b.weight : a.symbol < b.symbol;
+        });
+        return k;
+    }
+
+    // Huffman's algorithm on sorted leaves with two queues (van Leeuwen): merged nodes are made in order of
+    // weight, so the two lightest nodes are always at the front of the leaf queue or of the merged queue.
+    // Nodes are indices, 0 .. k - 1 the leaves and k + i the i-th merge; returns the deepest leaf.
+    static int twoQueueLengths(const std::array<Leaf, alphabetSize>& leaves, int k, Lengths& lengths) noexcept
+    {
+        std::array<std::uint64_t, alphabetSize> merged{};
+        std::array<std::uint16_t, 2 * alphabetSize> parent{};
+        int nextLeaf{}, nextMerged{};
+        auto pop = [&](int made) {
+            if (nextLeaf < k && (nextMerged == made || leaves[nextLeaf].weight <= merged[nextMerged])) {
+                const int leaf{nextLeaf++};
+                return std::pair{leaves[leaf].weight, leaf};
+            }
+            const int node{nextMerged++};
+            return std::pair{merged[node], k + node};
+        };
+
+        for (int made{}; made < k - 1; ++made) {
+            auto [wa, a] = pop(made);
+            auto [wb, b] = pop(made);
+            merged[made] = wa + wb;
+            parent[a] = parent[b] = static_cast<std::uint16_t>(k + made);
+        }
+
+        // a parent comes after its children, so the depths fill in from the root 2k - 2 down
+        std::array<std::uint16_t, 2 * alphabetSize> depth{};
+        int deepest{};
+        for (int i{2 * k - 3}; i >= 0; --i) {
+            depth[i] = static_cast<std::uint16_t>(depth[parent[i]] + 1);
+            if (i < k) {
+                lengths[leaves[i].symbol] = static_cast<std::uint8_t>(std::min<int>(depth[i], maxCodeLength));
+                deepest = std::max<int>(deepest, depth[i]);
+            }
+        }
+        return deepest;
+    }
+
+    // package-merge (Larmore and Hirschberg), optimal among the codes with lengths <= limit: level limit
+    // holds the leaves, every level above merges the leaves with the pairs (packages) of the level below.
+    // The first 2k - 2 items of level 1 are the solution; the items taken at a level are a prefix, its
+    // packages take twice as many items from the level below, and a leaf's code length is the number of
+    // levels that take it -- the leaves taken at a level are a prefix of the sorted leaves.
+    static void packageMergeLengths(const std::array<Leaf, alphabetSize>& leaves, int k, int limit, Lengths& lengths) noexcept
+    {
+        std::array<std::array<bool, 2 * alphabetSize>, maxCodeLength + 1> isPackage{};
+        std::array<std::uint64_t, 2 * alphabetSize> below{}, level{};
+        int belowSize{k};
+        for (int i{}; i < k; ++i) below[i] = leaves[i].weight;
+
+        for (int d{limit - 1}; d >= 1; --d) {
+            int size{}, leaf{}, package{};
+            while (leaf < k || package + 1 < belowSize) {
+                const bool takePackage{package + 1 < belowSize &&
+                                       (leaf == k || below[package] + below[package + 1] < leaves[leaf].weight)};
+                if (takePackage) {
+                    level[size] = below[package] + below[package + 1];
+                    package += 2;
+                } else {
+                    level[size] = leaves[leaf++].weight;
+                }
+                isPackage[d][size++] = takePackage;
+            }
+            below = level;
+            belowSize = size;
+        }
+
+        std::array<int, alphabetSize> count{}; // count[i]: levels that take leaf i
+        for (int d{1}, taken{2 * k - 2}; d <= limit && taken > 0; ++d) {
+            int leavesTaken{};
+            for (int i{}; i < taken; ++i) leavesTaken += d == limit || !isPackage[d][i];
+            for (int i{}; i < leavesTaken; ++i) ++count[i];
+            taken = 2 * (taken - leavesTaken);
+        }
+        for (int i{}; i < k; ++i) lengths[leaves[i].symbol] = static_cast<std::uint8_t>(count[i]);
+    }
+
+    static Lengths huffmanLengths(const Frequencies& frequencies, int limit)
+    {
+        std::array<Leaf, alphabetSize> leaves;
+        const int k{sortedLeaves(frequencies, leaves)};
+        if (k > (1 << limit)) throw std::invalid_argument("Too many symbols for the code length limit");
+
+        Lengths lengths{};
+        if (k == 1) lengths[leaves[0].symbol] = 1;
+        if (k <= 1) return lengths;
+
+        if (twoQueueLengths(leaves, k, lengths) > limit) packageMergeLengths(leaves, k, limit, lengths);
+        return lengths;
+    }
+
+private:
+    Lengths lengthOf{};
+    std::array<std::uint32_t, alphabetSize> codeOf{};
+};
+
+/**
+ * @brief Appends the bit-packed codes of byte buffers to an output buffer.
+ */
+class HuffmanEncoder
+{
+public:
+    explicit HuffmanEncoder(const HuffmanCode& code)
+    {
+        for (int c{}; c < HuffmanCode::alphabetSize; ++c) {
+            entry[c] = code.code(c) | (static_cast<std::uint32_t>(code.length(c)) << 16);
+        }
+    }
+
+    // throws if a byte has no code
+    void encode(std::span<const std::uint8_t> input, std::vector<std::uint8_t>& out)
+    {
+        // at most 15 bits per byte: room for all whole words up front, trimmed at the end
+        const std::size_t start{out.size()};
+        out.resize(start + (input.size() * HuffmanCode::maxCodeLength / 64 + 1) * sizeof(std::uint64_t));
+        std::uint8_t* dst{out.data() + start};
+
+        std::uint64_t acc{accumulator};
+        int bits{used};
+        for (std::uint8_t c : input) {
+            const std::uint64_t code{entry[c] & 0xffff};
+            const int len{static_cast<int>(entry[c] >> 16)};
+            if (len == 0) {
+                out.resize(start);
+                throw std::invalid_argument("Byte has no Huffman code");
+            }
+            acc |= code << bits;
+            bits += len;
+            if (bits >= 64) {
+                std::memcpy(dst, &acc, sizeof acc);
+                dst += sizeof acc;
+                bits -= 64;
+                acc = bits == 0 ? 0 : code >> (len - bits);
+            }
+        }
+        accumulator = acc;
+        used = bits;
+        out.resize(static_cast<std::size_t>(dst - out.data()));
+    }
+
+    // writes the last partial word, padded with zero bits to a whole byte
+    void finish(std::vector<std::uint8_t>& out)
+    {
+        for (int i{}; i < used; i += 8) out.push_back(static_cast<std::uint8_t>(accumulator >> i));
+        accumulator = 0;
+        used = 0;
+    }
+
+private:
+    std::array<std::uint32_t, HuffmanCode::alphabetSize> entry{}; // code | length << 16
+    std::uint64_t accumulator{};
+    int used{}; // bits in the accumulator, < 64
+};
+
+/**
+ * @brief Decodes a known number of symbols from a bitstream that arrives in pieces.
+ */
+class HuffmanDecoder
+{
+public:
+    static constexpr int primaryBits{11};
+
+    HuffmanDecoder(const HuffmanCode& code, std::uint64_t symbols) : remainingSymbols{symbols}
+    {
+        buildTables(code);
+    }
+
+    std::uint64_t remaining() const noexcept { return remainingSymbols; }
+    bool finished() const noexcept { return remainingSymbols == 0; }
+
+    // consumes all of input and appends the symbols it completes; throws on an invalid code
+    void decode(std::span<const std::uint8_t> input, std::vector<std::uint8_t>& out)
+    {
+        const std::size_t start{out.size()};
+        out.resize(start + static_cast<std::size_t>(std::min<std::uint64_t>(remainingSymbols, static_cast<std::uint64_t>(input.size()) * 8 + count)));
+        out.resize(start + decode(input, std::span{out}.subspan(start)));
+    }
+
+    /**
+     * @brief Consumes all of input and writes the symbols it completes to out, at most out.size() of them.
+     *        Input past a full out stays unread, so out should have room for remaining() symbols.
+     * @return number of symbols written
+     */
+    std::size_t decode(std::span<const std::uint8_t> input, std::span<std::uint8_t> out)
+    {
+        const std::uint8_t* in{input.data()};
+        const std::uint8_t* const end{in + input.size()};
+
+        std::uint8_t* dst{out.data()};
+        std::uint8_t* const dstEnd{dst + std::min<std::uint64_t>(remainingSymbols, out.size())};
+
+        std::uint64_t buffer{bits};
+        int available{count};
+
+        // fast path: whole 8-byte refills, as many codes per refill as 56 bits surely hold
+        while (end - in >= 8 && dstEnd - dst >= perRefill) {
+            std::uint64_t word;
+            std::memcpy(&word, in, sizeof word);
+            buffer |= word << available;
+            in += (63 - available) >> 3;
+            available |= 56;
+
+            for (int i{}; i < perRefill; ++i) {
+                std::uint32_t e{lookup(buffer)};
+                if (e == 0) throw std::invalid_argument("Invalid Huffman code in the bitstream");
+                *dst++ = static_cast<std::uint8_t>(e);
+                const int len{static_cast<int>(e >> 8)};
+                buffer >>= len;
+                available -= len;
+            }
+        }
+
+        // the tail, byte by byte, stopping where a code is incomplete
+        while (dst != dstEnd) {
+            while (available <= 56 && in != end) {
+                buffer |= static_cast<std::uint64_t>(*in++) << available;
+                available += 8;
+            }
+            // bits past the end read as zeros, so an invalid entry only proves corruption with a full code buffered
+            std::uint32_t e{lookup(buffer)};
+            if (e == 0 && available >= HuffmanCode::maxCodeLength) throw std::invalid_argument("Invalid Huffman code in the bitstream");
+            const int len{static_cast<int>(e >> 8)};
+            if (e == 0 || len > available) break;
+            *dst++ = static_cast<std::uint8_t>(e);
+            buffer >>= len;
+            available -= len;
+        }
+
+        bits = buffer;
+        count = available;
+        const std::size_t produced{static_cast<std::size_t>(dst - out.data())};
+        remainingSymbols -= produced;
+        return produced;
+    }
+
+private:
+    // symbol | length << 8, 0 for bits that start no code
+    std::uint32_t lookup(std::uint64_t buffer) const noexcept
+    {
+        std::uint32_t e{primary[buffer & primaryMask]};
+        if (e & subtableFlag) {
+            const int subBits{static_cast<int>((e >> 8) & 0xff)};
+            e = secondary[((e >> 16) & offsetMask) + ((buffer >> primaryBits) & ((1u << subBits) - 1))];
+        }
+        return e;
+    }
+
+    void buildTables(const HuffmanCode& code)
+    {
+        // subtable size per primary prefix: 2^(longest code with that prefix - primaryBits)
+        std::array<std::uint8_t, 1 << primaryBits> subBits{};
+        int longest{1};
+        for (int c{}; c < HuffmanCode::alphabetSize; ++c) {
+            const int len{code.length(c)};
+            longest = std::max(longest, len);
+            if (len > primaryBits) {
+                auto& b{subBits[code.code(c) & primaryMask]};
+                b = std::max<std::uint8_t>(b, static_cast<std::uint8_t>(len - primaryBits));
+            }
+        }
+
+        std::uint32_t offset{};
+        for (std::uint32_t prefix{}; prefix <= primaryMask; ++prefix) {
+            if (subBits[prefix] == 0) continue;
+            primary[prefix] = subtableFlag | (offset << 16) | (static_cast<std::uint32_t>(subBits[prefix]) << 8);
+            offset += 1u << subBits[prefix];
+        }
+        secondary.assign(offset, 0);
+        perRefill = 56 / longest;
+
+        for (int c{}; c < HuffmanCode::alphabetSize; ++c) {
+            const int len{code.length(c)};
+            if (len == 0) continue;
+
+            const std::uint32_t bitsOfCode{code.code(c)}, e{static_cast<std::uint32_t>(c) | (static_cast<std::uint32_t>(len) << 8)};
+            if (len <= primaryBits) {
+                for (std::uint32_t k{}; k < (1u << (primaryBits - len)); ++k) primary[bitsOfCode | (k << len)] = e;
+            } else {
+                const std::uint32_t head{primary[bitsOfCode & primaryMask]};
+                const int sub{static_cast<int>((head >> 8) & 0xff)}, rest{len - primaryBits};
+                for (std::uint32_t k{}; k < (1u << (sub - rest)); ++k) {
+                    secondary[((head >> 16) & offsetMask) + ((bitsOfCode >> primaryBits) | (k << rest))] = e;
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint32_t primaryMask{(1u << primaryBits) - 1};
+    static constexpr std::uint32_t subtableFlag{1u << 31};
+    static constexpr std::uint32_t offsetMask{0x7fff};
+
+    std::array<std::uint32_t, 1 << primaryBits> primary{}; // symbol | length << 8, or flag | offset << 16 | subBits << 8
+    std::vector<std::uint32_t> secondary;
+    std::uint64_t remainingSymbols{};
+    int perRefill{};      // codes decoded per fast refill, 56 / longest code
+    std::uint64_t bits{}; // buffered input, next bit lowest
+    int count{};          // number of buffered bits
+};
+
+// size, header, bitstream
+inline std::vector<std::uint8_t> huffmanCompress(std::span<const std::uint8_t> data)
+{
+    const HuffmanCode::Frequencies frequencies{HuffmanCode::histogram(data)};
+    HuffmanCode code{HuffmanCode::fromFrequencies(frequencies)};
+
+    std::vector<std::uint8_t> out(sizeof(std::uint64_t));
+    const std::uint64_t size{data.size()};
+    std::memcpy(out.data(), &size, sizeof size);
+    code.writeHeader(out);
+
+    HuffmanEncoder encoder{code};
+    out.reserve(out.size() + code.encodedBits(frequencies) / 8 + 8);
+    encoder.encode(data, out);
+    encoder.finish(out);
+    return out;
+}
+
+inline std::vector<std::uint8_t> huffmanDecompress(std::span<const std::uint8_t> compressed)
+{
+    if (compressed.size() < sizeof(std::uint64_t) + HuffmanCode::headerBytes) throw std::invalid_argument("Huffman data is truncated");
+
+    std::uint64_t size{};
+    std::memcpy(&size, compressed.data(), sizeof size);
+    HuffmanCode code{HuffmanCode::readHeader(compressed.subspan(sizeof size))};
+
+    // every symbol takes at least one bit, so a larger count is corrupt and must not size the reserve
+    std::span<const std::uint8_t> payload{compressed.subspan(sizeof size + HuffmanCode::headerBytes)};
+    if (size / 8 > payload.size()) throw std::invalid_argument("Huffman symbol count exceeds the bitstream");
+
+    HuffmanDecoder decoder{code, size};
+    std::vector<std::uint8_t> out;
+    out.reserve(size);
+    decoder.decode(payload, out);
+    if (!decoder.finished()) throw std::invalid_argument("Huffman bitstream ends early");
+    return out;
+}
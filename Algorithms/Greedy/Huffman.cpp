@@ -1,9 +1,18 @@
 #include <vector>
 #include <iostream>
-#include <unordered_map>
-#include <queue>
 #include <string>
-#include <memory>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include "CanonicalHuffman.h"
+#include "HuffmanArchive.h"
 
 /*
  * Huffman Coding Implementation
@@ -12,12 +21,15 @@
  * The most frequent characters receive the shortest bit representations, while less frequent characters get longer ones, ensuring optimal compression.
  * 
  * How Huffman Coding Works:
- * 1. Count the frequency of each character in the input text.
- * 2. Build a priority queue (min-heap) where each node represents a character and its frequency.
+ * 1. Count the frequency of each character in the input text (a fixed 256-entry histogram).
+ * 2. Sort the characters by frequency once.
  * 3. Construct a binary tree by repeatedly merging the two least frequent nodes, forming a single parent node with their combined frequency.
- * 4. Assign binary codes: Traverse the tree, assigning '0' to the left branch and '1' to the right branch. Leaf nodes (characters) receive their final binary codes.
+ *    The merged nodes come out in order of frequency, so two queues (sorted leaves, merged nodes) replace the priority queue,
+ *    and the tree is an index array, not one heap node per character.
+ * 4. Assign binary codes: the depth of a leaf is the length of its code, and the codes follow from the lengths (canonical codes).
+ *    If the tree is deeper than 15 levels, package-merge finds the best code with lengths <= 15 instead (as DEFLATE needs).
  * 5. Encode the input text using the generated Huffman codes.
- * 6. Decode by traversing the Huffman tree based on the bit sequence.
+ * 6. Decode with a lookup table over the next bits of the bit sequence.
  * 
  * Why the Most Frequent Characters Get the Shortest Codes:
  * The key idea behind Huffman Coding is to minimize the total number of bits required to represent the text. 
@@ -35,17 +47,26 @@
  * - Network data transmission (efficient storage of HTTP headers in HPACK)
  * - Data structures and algorithms in computer science (optimal prefix codes)
  * 
- * **Note:** This implementation is a demonstration version, where the encoded bits are stored as characters in a string 
- * instead of being packed into actual bit sequences.
+ * The code and the codec are in CanonicalHuffman.h: the bits are packed into 64-bit words instead of one '0'/'1'
+ * character each, and building a code allocates nothing, which matters when many small blocks get their own code.
+ * HuffmanArchive.h codes large inputs (files, mapped) as independent blocks in parallel, with a block index for
+ * random access.
  */
 
 
-struct Node
+// every operator new is counted, to check that building a code allocates nothing; atomic because the
+// archive tests allocate from several threads
+std::atomic<std::size_t> heapAllocations{};
+
+void* operator new(std::size_t size)
 {
-    char c{};
-    int freq{};
-    std::shared_ptr<Node> left{nullptr}, right{nullptr};
-};
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p{std::malloc(size == 0 ? 1 : size)}) return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
 
 class HuffmanCoding
 {
@@ -57,84 +78,301 @@ public:
 
     void constructTree()
     {
-        std::unordered_map<char, int> charToFreq;
-        for (char c : text) ++charToFreq[c];
-
-        auto cmp = [](std::shared_ptr<Node>& a, std::shared_ptr<Node>& b) {
-            return a->freq > b->freq;
-        };
+        code = HuffmanCode::fromFrequencies(HuffmanCode::histogram(bytes()));
+    }
 
- 
-        std::priority_queue<std::shared_ptr<Node>, std::vector<std::shared_ptr<Node>>, decltype(cmp)> pq;
-        for (auto [c, freq] : charToFreq) {
-            pq.push(std::make_shared<Node>(c, freq));
-        }
+    void encode()
+    {
+        encoded.clear();
+        HuffmanEncoder encoder{code};
+        encoder.encode(bytes(), encoded);
+        encoder.finish(encoded);
 
-        while (pq.size() > 1) {
-            std::shared_ptr<Node> left{ pq.top() }; pq.pop();
-            std::shared_ptr<Node> right{ pq.top() }; pq.pop();
+        std::cout << "Encoded: " << text.size() << " bytes -> " << encoded.size() << " bytes" << std::endl;
+    }
 
-            int sum{ left->freq + right->freq };
-            pq.push(std::make_shared<Node>('*', sum, left, right));
-        }
+    std::string decode()
+    {
+        std::vector<std::uint8_t> decoded;
+        HuffmanDecoder decoder{code, text.size()};
+        decoder.decode(encoded, decoded);
 
-        root = pq.top();
+        return std::string(decoded.begin(), decoded.end());
     }
 
-    void encode()
+private:
+    std::span<const std::uint8_t> bytes() const
     {
-        encodeHelper(root, "");
+        return {reinterpret_cast<const std::uint8_t*>(text.data()), text.size()};
+    }
 
-        for (char c : text) {
-            encodedString += huffmanCode[c];
+private:
+    HuffmanCode code;
+    std::string text;
+    std::vector<std::uint8_t> encoded;
+};
+
+std::vector<std::uint8_t> randomBytes(std::size_t size, double skew, std::uint64_t seed)
+{
+    // geometric-like byte distribution, larger skew means more repetitive data
+    std::mt19937_64 rng{seed};
+    std::geometric_distribution<int> symbol(skew);
+    std::vector<std::uint8_t> data(size);
+    for (auto& c : data) c = static_cast<std::uint8_t>(std::min(symbol(rng), 255));
+    return data;
+}
+
+int testCanonicalCodec()
+{
+    int failures{};
+    for (double skew : {0.01, 0.2, 0.6, 0.95}) {
+        for (std::size_t size : {std::size_t{0}, std::size_t{1}, std::size_t{7}, std::size_t{1000}, std::size_t{100'000}}) {
+            std::vector<std::uint8_t> data{randomBytes(size, skew, size)};
+            failures += huffmanDecompress(huffmanCompress(data)) != data;
+
+            // streaming: encode and decode in pieces of odd sizes
+            HuffmanCode code{HuffmanCode::fromFrequencies(HuffmanCode::histogram(data))};
+            std::vector<std::uint8_t> stream, decoded;
+            HuffmanEncoder encoder{code};
+            for (std::size_t i{}; i < data.size(); i += 333) encoder.encode(std::span{data}.subspan(i, std::min<std::size_t>(333, data.size() - i)), stream);
+            encoder.finish(stream);
+
+            HuffmanDecoder decoder{code, data.size()};
+            for (std::size_t i{}; i < stream.size(); i += 5) decoder.decode(std::span{stream}.subspan(i, std::min<std::size_t>(5, stream.size() - i)), decoded);
+            failures += !decoder.finished() || decoded != data;
         }
+    }
+
+    // Fibonacci frequencies make a degenerate tree of depth 40, the codec limits it to 15 bits
+    HuffmanCode::Frequencies fibonacci{};
+    for (int c{}, a{1}, b{1}; c < 40; ++c, b = std::exchange(a, a + b)) fibonacci[c] = a;
+    HuffmanCode limited{HuffmanCode::fromFrequencies(fibonacci)};
+    int longest{};
+    for (int c{}; c < 40; ++c) longest = std::max(longest, limited.length(c));
+    failures += longest != HuffmanCode::maxCodeLength;
+
+    std::vector<std::uint8_t> skewed;
+    for (int c{}; c < 40; ++c) skewed.insert(skewed.end(), std::min<int>(fibonacci[c], 5000), static_cast<std::uint8_t>(c));
+    failures += huffmanDecompress(huffmanCompress(skewed)) != skewed;
+
+    // a symbol count far beyond the bitstream is rejected before anything is allocated for it
+    std::vector<std::uint8_t> inflated{huffmanCompress(skewed)};
+    const std::uint64_t hostile{std::uint64_t{1} << 60};
+    std::memcpy(inflated.data(), &hostile, sizeof hostile);
+    try {
+        (void)huffmanDecompress(inflated);
+        ++failures;
+    } catch (const std::invalid_argument&) { }
+
+    std::cout << "canonical codec: " << failures << " failures" << std::endl;
+    return failures;
+}
+
+// returns 1 if the round trip does not restore the input
+int benchmarkCanonicalCodec()
+{
+    std::vector<std::uint8_t> data{randomBytes(64 << 20, 0.15, 1)};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::uint8_t> compressed{huffmanCompress(data)};
+    auto middle = std::chrono::high_resolution_clock::now();
+    std::vector<std::uint8_t> decompressed{huffmanDecompress(compressed)};
+    auto end = std::chrono::high_resolution_clock::now();
 
-        std::cout << "Encoded string: " << encodedString << std::endl;
+    auto mbPerSecond = [&](auto duration) {
+        return static_cast<double>(data.size()) / std::chrono::duration<double>(duration).count() / (1 << 20);
+    };
+    std::cout << "64 MiB -> " << (compressed.size() >> 20) << " MiB, encode " << static_cast<int>(mbPerSecond(middle - start))
+              << " MB/s, decode " << static_cast<int>(mbPerSecond(end - middle)) << " MB/s"
+              << (decompressed == data ? "" : ", MISMATCH") << std::endl;
+    return decompressed != data;
+}
+
+// the cost of an optimal code without a length limit: the sum of all merged weights of Huffman's algorithm
+std::uint64_t huffmanCost(const HuffmanCode::Frequencies& frequencies)
+{
+    std::priority_queue<std::uint64_t, std::vector<std::uint64_t>, std::greater<>> heap;
+    for (std::uint64_t f : frequencies) {
+        if (f != 0) heap.push(f);
     }
+    if (heap.size() == 1) return heap.top();
 
-    void encodeHelper(std::shared_ptr<Node> node, std::string s)
-    {
-        if (!node) return;
-        if (!node->left && !node->right) {
-            huffmanCode[node->c] = s;
+    std::uint64_t cost{};
+    while (heap.size() > 1) {
+        std::uint64_t a{heap.top()}; heap.pop();
+        std::uint64_t b{heap.top()}; heap.pop();
+        cost += a + b;
+        heap.push(a + b);
+    }
+    return cost;
+}
+
+// the cost of an optimal code with lengths <= limit, by trying every non-decreasing length sequence
+std::uint64_t bruteForceLimitedCost(std::vector<std::uint64_t> weights, int limit)
+{
+    std::sort(weights.begin(), weights.end(), std::greater<>());
+    std::uint64_t best{~std::uint64_t{}};
+    auto search = [&](auto&& self, std::size_t i, int minLength, double kraft, std::uint64_t cost) -> void {
+        if (kraft > 1.0 + 1e-12) return;
+        if (i == weights.size()) {
+            best = std::min(best, cost);
             return;
         }
+        for (int len{minLength}; len <= limit; ++len) self(self, i + 1, len, kraft + std::ldexp(1.0, -len), cost + weights[i] * len);
+    };
+    search(search, 0, 1, 0.0, 0);
+    return best;
+}
+
+int testCodeConstruction()
+{
+    std::mt19937_64 rng{9};
+    int failures{};
+
+    // two-queue lengths are optimal (some of these trees are deeper than 15, then the limit costs a little)
+    for (int round{}; round < 300; ++round) {
+        HuffmanCode::Frequencies frequencies{};
+        const int used{1 + static_cast<int>(rng() % 256)};
+        for (int i{}; i < used; ++i) frequencies[rng() % 256] = 1 + rng() % (round % 2 ? 1000 : 1'000'000);
 
-        encodeHelper(node->left, s + "0");
-        encodeHelper(node->right, s + "1");
+        HuffmanCode code{HuffmanCode::fromFrequencies(frequencies)};
+        int longest{};
+        for (int c{}; c < HuffmanCode::alphabetSize; ++c) longest = std::max(longest, code.length(c));
+        const std::uint64_t cost{code.encodedBits(frequencies)}, optimal{huffmanCost(frequencies)};
+        failures += cost < optimal || (longest < HuffmanCode::maxCodeLength && cost != optimal);
     }
 
-    std::string decode()
-    {
-        int index{ -1 }, n = encodedString.size();
-        while (index < n - 2) {
-            decodeHelper(root, index);
+    // package-merge is optimal under the limit
+    for (int round{}; round < 300; ++round) {
+        const int used{2 + static_cast<int>(rng() % 7)}, limit{3 + static_cast<int>(rng() % 2)};
+        HuffmanCode::Frequencies frequencies{};
+        std::vector<std::uint64_t> weights;
+        for (int i{}; i < used; ++i) {
+            weights.push_back(std::uint64_t{1} << (rng() % 12)); // skewed enough to hit the limit
+            frequencies[i * 17] = weights.back();
         }
 
-        return decodedString;
+        HuffmanCode code{HuffmanCode::fromFrequencies(frequencies, limit)};
+        int longest{};
+        for (int c{}; c < HuffmanCode::alphabetSize; ++c) longest = std::max(longest, code.length(c));
+        failures += longest > limit || code.encodedBits(frequencies) != bruteForceLimitedCost(weights, limit);
     }
 
-    void decodeHelper(std::shared_ptr<Node> node, int& index)
-    {
-        if (!node) return;
-        if (!node->left && !node->right) {
-            decodedString.push_back(node->c);
-            return;
+    // the setup of one block: histogram, sort, merge, canonical codes, with no heap allocation
+    std::vector<std::uint8_t> data{randomBytes(4096 * 1000, 0.05, 5)};
+    const std::size_t before{heapAllocations.load(std::memory_order_relaxed)};
+    std::uint64_t bits{};
+    auto start = std::chrono::high_resolution_clock::now();
+    for (std::size_t block{}; block < 1000; ++block) {
+        std::span<const std::uint8_t> bytes{data.data() + block * 4096, 4096};
+        HuffmanCode::Frequencies frequencies{HuffmanCode::histogram(bytes)};
+        bits += HuffmanCode::fromFrequencies(frequencies).encodedBits(frequencies);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    const std::size_t allocations{heapAllocations.load(std::memory_order_relaxed) - before};
+
+    std::cout << "code construction: " << failures << " failures, "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1000 << " ns per 4 KiB block setup, "
+              << allocations << " heap allocations, " << bits / 8 / 1000 << " bytes per block" << std::endl;
+    return failures;
+}
+
+int testBlockArchive()
+{
+    int failures{};
+    std::vector<std::uint8_t> data{randomBytes(1'000'003, 0.1, 11)};
+    // the second half is different data, so per-block codes should beat the shared one
+    std::vector<std::uint8_t> other{randomBytes(data.size() / 2, 0.7, 12)};
+    std::copy(other.begin(), other.end(), data.begin() + data.size() / 2);
+
+    std::size_t sizes[2]{};
+    for (bool shared : {false, true}) {
+        for (unsigned threads : {1u, 4u}) {
+            HuffmanArchiveOptions options{65536, shared, threads};
+            std::vector<std::uint8_t> archive{huffmanCompressBlocks(data, options)};
+            sizes[shared] = archive.size();
+
+            HuffmanArchiveReader reader{archive};
+            failures += reader.blockCount() != 16 || reader.decompress(threads) != data;
+
+            // any single block, without the others
+            for (std::uint64_t k : {std::uint64_t{0}, std::uint64_t{7}, std::uint64_t{15}}) {
+                std::vector<std::uint8_t> block{reader.decompressBlock(k)};
+                failures += !std::equal(block.begin(), block.end(), data.begin() + reader.blockOffset(k)) || block.size() != reader.blockSize(k);
+            }
+
+            // a buffer one byte short is rejected
+            std::vector<std::uint8_t> tooSmall(reader.blockSize(0) - 1);
+            try {
+                reader.decompressBlock(0, tooSmall);
+                ++failures;
+            } catch (const std::invalid_argument&) { }
         }
+    }
+    failures += sizes[false] >= sizes[true];
 
-        ++index;
+    // empty input, and files through MappedFile
+    failures += !HuffmanArchiveReader{huffmanCompressBlocks({})}.decompress().empty();
 
-        if (encodedString[index] == '0') decodeHelper(node->left, index);
-        else decodeHelper(node->right, index);
+    const std::string input{"huffman_archive_input.bin"}, archivePath{"huffman_archive.hfa"}, output{"huffman_archive_output.bin"};
+    std::ofstream(input, std::ios::binary).write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    huffmanCompressFile(input, archivePath, {100'000, false, 2});
+    huffmanDecompressFile(archivePath, output, 2);
+    {
+        MappedFile restored{output};
+        failures += !std::ranges::equal(restored.bytes(), data);
+
+        // a damaged index is rejected
+        MappedFile archive{archivePath};
+        std::vector<std::uint8_t> damaged(archive.bytes().begin(), archive.bytes().end());
+        damaged[damaged.size() - 16 + 7] ^= 0x40; // top byte of the position of the last block
+        try {
+            HuffmanArchiveReader{damaged};
+            ++failures;
+        } catch (const std::runtime_error&) { }
+
+        // so is an original size the block payloads cannot hold, before anything is allocated for it
+        std::vector<std::uint8_t> inflated{huffmanCompressBlocks(std::span{data}.first(1000), {1 << 16, false, 1})};
+        HuffmanArchiveHeader header;
+        std::memcpy(&header, inflated.data(), sizeof header);
+        header.originalSize = header.blockSize = std::uint64_t{1} << 40;
+        std::memcpy(inflated.data(), &header, sizeof header);
+        try {
+            HuffmanArchiveReader{inflated};
+            ++failures;
+        } catch (const std::runtime_error&) { }
     }
+    std::remove(input.c_str());
+    std::remove(archivePath.c_str());
+    std::remove(output.c_str());
 
-private:
-    std::shared_ptr<Node> root;
-    std::unordered_map<char, std::string> huffmanCode;
-    std::string text;
-    std::string encodedString;
-    std::string decodedString;
-};
+    std::cout << "block archive: " << failures << " failures, " << sizes[false] << " bytes with a code per block, "
+              << sizes[true] << " with a shared code" << std::endl;
+    return failures;
+}
+
+// returns the number of thread counts whose round trip does not restore the input
+int benchmarkBlockArchive()
+{
+    int mismatches{};
+    std::vector<std::uint8_t> data{randomBytes(128 << 20, 0.15, 2)};
+    auto mbPerSecond = [&](auto duration) {
+        return static_cast<int>(static_cast<double>(data.size()) / std::chrono::duration<double>(duration).count() / (1 << 20));
+    };
+
+    for (unsigned threads : {1u, 4u}) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::uint8_t> archive{huffmanCompressBlocks(data, {std::size_t{1} << 20, false, threads})};
+        auto middle = std::chrono::high_resolution_clock::now();
+        std::vector<std::uint8_t> restored{HuffmanArchiveReader{archive}.decompress(threads)};
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "128 MiB in 1 MiB blocks, " << threads << " threads: compress " << mbPerSecond(middle - start)
+                  << " MB/s, decompress " << mbPerSecond(end - middle) << " MB/s" << (restored == data ? "" : ", MISMATCH") << std::endl;
+        mismatches += restored != data;
+    }
+    return mismatches;
+}
 
 int main()
 {
@@ -145,4 +383,12 @@ int main()
     std::string res = hf.decode();
 
     std::cout << "Decoded string: " << res << std::endl;
-}
\ No newline at end of file
+
+    int failures{};
+    failures += testCanonicalCodec();
+    failures += testCodeConstruction();
+    failures += benchmarkCanonicalCodec();
+    failures += testBlockArchive();
+    failures += benchmarkBlockArchive();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include "CanonicalHuffman.h"
+#include "../Common/Parallel.h"
+#include "../Common/MappedFile.h"
+#include "../Common/WorkStealingPool.h"
+
+/**
+ * @brief Framed Huffman archive: the input is cut into blocks that are coded independently, in parallel,
+ *        and can be decoded one at a time.
+ *
+ * Layout (little-endian):
+ *
+ *   +------------------------------+  0
+ *   | HuffmanArchiveHeader         |  64 bytes
+ *   +------------------------------+
+ *   | shared code lengths          |  HuffmanCode::headerBytes, only with the SharedTable flag
+ *   +------------------------------+
+ *   | block 0, block 1, ...        |  per block: its code lengths (without SharedTable), then the bitstream
+ *   +------------------------------+  archive size - 16 * blockCount
+ *   | HuffmanArchiveBlock[count]   |  the block index: position and size of every block
+ *   +------------------------------+
+ *
+ * Block k holds the bytes [k * blockSize, min((k + 1) * blockSize, originalSize)) of the input, so the index
+ * only needs where a block is. The index goes last: the writer streams the blocks out as they are done and
+ * never seeks back, and a reader finds it from the archive size and the block count in the header.
+ *
+ * A code per block adapts to the data and costs 128 bytes per block; one shared code (built from the
+ * histogram of the whole input) costs nothing per block but fits the blocks on average only.
+ *
+ * Compression and decompression run on a WorkStealingPool, a window of a few blocks per thread at a time:
+ * the workers code the blocks of the window into their own buffers and the calling thread writes them out
+ * in order, so memory stays at O(threads * blockSize) for any input size. The file variants map the input
+ * (MappedFile) instead of reading it into a buffer.
+ */
+
+struct HuffmanArchiveHeader
+{
+    static constexpr char expectedMagic[8]{'H', 'U', 'F', 'F', 'B', 'L', 'K', 'S'};
+    static constexpr std::uint32_t currentVersion{1};
+
+    enum Flags : std::uint32_t { SharedTable = 1u << 0 };
+
+    char magic[8]{};
+    std::uint32_t version{};
+    std::uint32_t flags{};
+    std::uint64_t blockSize{};
+    std::uint64_t originalSize{};
+    std::uint64_t blockCount{};
+    std::uint64_t reserved[3]{};
+};
+
+static_assert(sizeof(HuffmanArchiveHeader) == 64);
+
+struct HuffmanArchiveBlock
+{
+    std::uint64_t position{}; // from the start of the archive
+    std::uint64_t bytes{};
+};
+
+struct HuffmanArchiveOptions
+{
+    std::size_t blockSize{std::size_t{1} << 20};
+    bool sharedTable{false}; // one code for all blocks instead of one per block
+    unsigned threads{0};     // 0 means all hardware threads
+};
+
+namespace huffman_archive_detail
+{
+    constexpr std::size_t blocksPerThread{4}; // window of blocks in flight per worker
+
+    inline HuffmanCode::Frequencies parallelHistogram(std::span<const std::uint8_t> data, unsigned threads)
+    {
+        std::vector<HuffmanCode::Frequencies> local(threads);
+        parallelForChunks(data.size(), threads, [&](std::size_t begin, std::size_t end, unsigned t) {
+            local[t] = HuffmanCode::histogram(data.subspan(begin, end - begin));
+        }, std::size_t{1} << 20);
+
+        HuffmanCode::Frequencies total{};
+        for (const auto& part : local) {
+            for (int c{}; c < HuffmanCode::alphabetSize; ++c) total[c] += part[c];
+        }
+        return total;
+    }
+
+    // writes the archive of input through write(span of bytes), sequentially
+    template <typename Write>
+    void writeArchive(std::span<const std::uint8_t> input, const HuffmanArchiveOptions& options, Write&& write)
+    {
+        if (options.blockSize == 0) throw std::invalid_argument("Block size should be > 0");
+
+        WorkStealingPool pool{options.threads};
+        const std::uint64_t blockCount{(input.size() + options.blockSize - 1) / options.blockSize};
+
+        HuffmanArchiveHeader header;
+        std::memcpy(header.magic, HuffmanArchiveHeader::expectedMagic, sizeof header.magic);
+        header.version = HuffmanArchiveHeader::currentVersion;
+        header.flags = options.sharedTable ? std::uint32_t{HuffmanArchiveHeader::SharedTable} : 0;
+        header.blockSize = options.blockSize;
+        header.originalSize = input.size();
+        header.blockCount = blockCount;
+        write(std::span{reinterpret_cast<const std::uint8_t*>(&header), sizeof header});
+        std::uint64_t position{sizeof header};
+
+        HuffmanCode shared;
+        if (options.sharedTable) {
+            shared = HuffmanCode::fromFrequencies(parallelHistogram(input, pool.size()));
+            std::vector<std::uint8_t> table;
+            shared.writeHeader(table);
+            write(std::span<const std::uint8_t>{table});
+            position += table.size();
+        }
+
+        std::vector<HuffmanArchiveBlock> index;
+        index.reserve(blockCount);
+        std::vector<std::vector<std::uint8_t>> window(pool.size() * blocksPerThread);
+        for (std::uint64_t first{}; first < blockCount; first += window.size()) {
+            const std::size_t inFlight{static_cast<std::size_t>(std::min<std::uint64_t>(window.size(), blockCount - first))};
+            for (std::size_t i{}; i < inFlight; ++i) {
+                pool.submit([&, i, block{first + i}] {
+                    std::span<const std::uint8_t> bytes{input.subspan(block * options.blockSize,
+                        std::min<std::uint64_t>(options.blockSize, input.size() - block * options.blockSize))};
+                    std::vector<std::uint8_t>& out{window[i]};
+                    out.clear(); // the buffers keep their capacity from window to window
+
+                    HuffmanCode code{shared};
+                    if (!options.sharedTable) {
+                        code = HuffmanCode::fromFrequencies(HuffmanCode::histogram(bytes));
+                        code.writeHeader(out);
+                    }
+                    HuffmanEncoder encoder{code};
+                    encoder.encode(bytes, out);
+                    encoder.finish(out);
+                });
+            }
+            pool.wait();
+
+            for (std::size_t i{}; i < inFlight; ++i) {
+                write(std::span<const std::uint8_t>{window[i]});
+                index.push_back({position, window[i].size()});
+                position += window[i].size();
+            }
+        }
+
+        write(std::span{reinterpret_cast<const std::uint8_t*>(index.data()), index.size() * sizeof(HuffmanArchiveBlock)});
+    }
+}
+
+inline std::vector<std::uint8_t> huffmanCompressBlocks(std::span<const std::uint8_t> input, const HuffmanArchiveOptions& options = {})
+{
+    std::vector<std::uint8_t> archive;
+    huffman_archive_detail::writeArchive(input, options, [&](std::span<const std::uint8_t> bytes) {
+        archive.insert(archive.end(), bytes.begin(), bytes.end());
+    });
+    return archive;
+}
+
+inline void huffmanCompressFile(const std::string& inputPath, const std::string& archivePath, const HuffmanArchiveOptions& options = {})
+{
+    MappedFile input{inputPath};
+    std::ofstream out(archivePath, std::ios::binary);
+    if (!out) throw std::runtime_error("Cannot open " + archivePath);
+
+    huffman_archive_detail::writeArchive(input.bytes(), options, [&](std::span<const std::uint8_t> bytes) {
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    });
+    if (!out) throw std::runtime_error("Cannot write " + archivePath);
+}
+
+/**
+ * @class HuffmanArchiveReader
+ *
+ * @brief Random and parallel access to an archive in memory, or mapped with MappedFile; the bytes have to
+ *        outlive the reader. The constructor checks the header and the index, and throws std::runtime_error
+ *        if they don't fit together or claim more symbols than the block payloads can hold.
+ */
+class HuffmanArchiveReader
+{
+public:
+    explicit HuffmanArchiveReader(std::span<const std::uint8_t> archiveBytes) : archive{archiveBytes}
+    {
+        validate();
+        if (header.flags & HuffmanArchiveHeader::SharedTable) {
+            shared = HuffmanCode::readHeader(archive.subspan(sizeof(HuffmanArchiveHeader), HuffmanCode::headerBytes));
+        }
+    }
+
+    std::uint64_t originalSize() const noexcept { return header.originalSize; }
+    std::uint64_t blockCount() const noexcept { return header.blockCount; }
+    bool sharedTable() const noexcept { return header.flags & HuffmanArchiveHeader::SharedTable; }
+
+    // the input range of block k
+    std::uint64_t blockOffset(std::uint64_t k) const noexcept { return k * header.blockSize; }
+    std::size_t blockSize(std::uint64_t k) const noexcept
+    {
+        return static_cast<std::size_t>(std::min(header.blockSize, header.originalSize - blockOffset(k)));
+    }
+    // the compressed size of block k, with its code lengths
+    std::uint64_t compressedSize(std::uint64_t k) const { return entry(k).bytes; }
+
+    // decodes block k into the first blockSize(k) bytes of out; reads nothing of the other blocks
+    void decompressBlock(std::uint64_t k, std::span<std::uint8_t> out) const
+    {
+        if (k >= header.blockCount) throw std::out_of_range("Block index is out of range");
+        if (out.size() < blockSize(k)) throw std::invalid_argument("Output is smaller than the block");
+        const HuffmanArchiveBlock e{entry(k)};
+        std::span<const std::uint8_t> payload{archive.subspan(e.position, e.bytes)};
+
+        HuffmanCode code{shared};
+        if (!sharedTable()) {
+            code = HuffmanCode::readHeader(payload);
+            payload = payload.subspan(HuffmanCode::headerBytes);
+        }
+        HuffmanDecoder decoder{code, blockSize(k)};
+        if (decoder.decode(payload, out.first(blockSize(k))) != blockSize(k)) throw std::runtime_error("Corrupted archive block");
+    }
+
+    std::vector<std::uint8_t> decompressBlock(std::uint64_t k) const
+    {
+        if (k >= header.blockCount) throw std::out_of_range("Block index is out of range");
+        std::vector<std::uint8_t> out(blockSize(k));
+        decompressBlock(k, out);
+        return out;
+    }
+
+    // decodes all blocks in parallel into out, which has room for originalSize() bytes
+    void decompress(std::span<std::uint8_t> out, unsigned threads = 0) const
+    {
+        if (out.size() < header.originalSize) throw std::invalid_argument("Output is smaller than the original data");
+
+        WorkStealingPool pool{threads};
+        for (std::uint64_t k{}; k < header.blockCount; ++k) {
+            pool.submit([this, out, k] { decompressBlock(k, out.subspan(blockOffset(k), blockSize(k))); });
+        }
+        pool.wait();
+    }
+
+    std::vector<std::uint8_t> decompress(unsigned threads = 0) const
+    {
+        std::vector<std::uint8_t> out(header.originalSize);
+        decompress(out, threads);
+        return out;
+    }
+
+private:
+    HuffmanArchiveBlock entry(std::uint64_t k) const noexcept
+    {
+        HuffmanArchiveBlock e;
+        std::memcpy(&e, archive.data() + indexPosition + k * sizeof e, sizeof e);
+        return e;
+    }
+
+    void validate()
+    {
+        if (archive.size() < sizeof header) throw std::runtime_error("Huffman archive is too small");
+        std::memcpy(&header, archive.data(), sizeof header);
+
+        if (std::memcmp(header.magic, HuffmanArchiveHeader::expectedMagic, sizeof header.magic) != 0) {
+            throw std::runtime_error("Not a Huffman archive");
+        }
+        if (header.version != HuffmanArchiveHeader::currentVersion) throw std::runtime_error("Unsupported Huffman archive version");
+        if (header.blockSize == 0
+            || header.blockCount != header.originalSize / header.blockSize + (header.originalSize % header.blockSize != 0)) {
+            throw std::runtime_error("Corrupted Huffman archive header");
+        }
+
+        const std::uint64_t dataStart{sizeof header + (sharedTable() ? HuffmanCode::headerBytes : 0)};
+        if (header.blockCount > (archive.size() - std::min<std::uint64_t>(archive.size(), dataStart)) / sizeof(HuffmanArchiveBlock)) {
+            throw std::runtime_error("Huffman archive index is truncated");
+        }
+        indexPosition = archive.size() - header.blockCount * sizeof(HuffmanArchiveBlock);
+
+        for (std::uint64_t k{}; k < header.blockCount; ++k) {
+            const HuffmanArchiveBlock e{entry(k)};
+            if (e.position < dataStart || e.position > indexPosition || e.bytes > indexPosition - e.position) {
+                throw std::runtime_error("Corrupted Huffman archive index");
+            }
+            // every symbol takes at least one bit, which bounds the sizes decompress() allocates
+            const std::uint64_t tableBytes{sharedTable() ? 0 : HuffmanCode::headerBytes};
+            if (e.bytes < tableBytes || blockSize(k) / 8 > e.bytes - tableBytes) {
+                throw std::runtime_error("Corrupted Huffman archive index");
+            }
+        }
+    }
+
+private:
+    std::span<const std::uint8_t> archive;
+    HuffmanArchiveHeader header;
+    std::uint64_t indexPosition{};
+    HuffmanCode shared;
+};
+
+// decodes an archive file into a file, a window of blocks at a time
+inline void huffmanDecompressFile(const std::string& archivePath, const std::string& outputPath, unsigned threads = 0)
+{
+    MappedFile archive{archivePath};
+    HuffmanArchiveReader reader{archive.bytes()};
+    std::ofstream out(outputPath, std::ios::binary);
+    if (!out) throw std::runtime_error("Cannot open " + outputPath);
+
+    WorkStealingPool pool{threads};
+    std::vector<std::vector<std::uint8_t>> window(pool.size() * huffman_archive_detail::blocksPerThread);
+    for (std::uint64_t first{}; first < reader.blockCount(); first += window.size()) {
+        const std::size_t inFlight{static_cast<std::size_t>(std::min<std::uint64_t>(window.size(), reader.blockCount() - first))};
+        for (std::size_t i{}; i < inFlight; ++i) {
+            pool.submit([&, i, block{first + i}] {
+                window[i].resize(reader.blockSize(block));
+                reader.decompressBlock(block, window[i]);
+            });
+        }
+        pool.wait();
+
+        for (std::size_t i{}; i < inFlight; ++i) {
+            out.write(reinterpret_cast<const char*>(window[i].data()), static_cast<std::streamsize>(window[i].size()));
+        }
+    }
+    if (!out) throw std::runtime_error("Cannot write " + outputPath);
+}
@@ -23,4 +23,5 @@ long long binaryPow(long long a, long long b)
 
 /*
 * This algorithm is required in LeetCode: 1922. Count Good Numbers
+* For any odd 64-bit modulus, Montgomery.h has the same loop with Montgomery products instead of %.
 */
\ No newline at end of file
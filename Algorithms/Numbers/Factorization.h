@@ -0,0 +1,174 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <numeric>
+#include <algorithm>
+#include "Montgomery.h"
+#include "PrimeSieve.h"
+#include "../Common/Parallel.h"
+
+/**
+ * @brief Prime factorizations of many numbers, for a batch at a time.
+ *
+ * Values up to the limit of the SmallestPrimeFactors table are a table walk. Larger ones, up to 2^64 - 1, go
+ * through Pollard's rho (Brent's cycle detection, gcds batched over 128 steps) until the cofactors are
+ * below the limit or prime. Primality is Miller-Rabin with the seven bases of Jim Sinclair, which are
+ * deterministic for all 64-bit n. Both run in Montgomery form.
+ *
+ * factorBatch spreads blocks of values over threads and returns the factorizations packed like a CSR
+ * graph: the factors of values[i] are factors[offsets[i], offsets[i + 1]), so a batch costs two arrays
+ * instead of one vector per value.
+ */
+
+struct FactorBatch
+{
+    std::vector<std::size_t> offsets;  // size() + 1 entries
+    std::vector<std::uint64_t> factors;
+
+    std::size_t size() const noexcept { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    std::span<const std::uint64_t> operator[](std::size_t i) const
+    {
+        return std::span<const std::uint64_t>{factors}.subspan(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
+class Factorizer
+{
+public:
+    // 2^24 keeps the table at 32 MB; every value below the limit is then a table walk
+    explicit Factorizer(std::uint32_t tableLimit = 1u << 24) : table{tableLimit} {}
+
+    const SmallestPrimeFactors& getTable() const noexcept { return table; }
+
+    static bool isPrime(std::uint64_t n)
+    {
+        if (n < 2) return false;
+        for (std::uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+            if (n % p == 0) return n == p;
+        }
+        if (n < 41 * 41) return true;
+
+        const Montgomery m{n};
+        const std::uint64_t minusOne{m.subtract(0, m.one())};
+        const int s{std::countr_zero(n - 1)};
+        const std::uint64_t d{(n - 1) >> s};
+        for (std::uint64_t a : {2ull, 325ull, 9375ull, 28178ull, 450775ull, 9780504ull, 1795265022ull}) {
+            if (a % n == 0) continue;
+            std::uint64_t x{m.toMontgomery(binaryPow(m, a, d))};
+            if (x == m.one() || x == minusOne) continue;
+            bool composite{true};
+            for (int r{1}; r < s && composite; ++r) {
+                x = m.multiply(x, x);
+                composite = x != minusOne;
+            }
+            if (composite) return false;
+        }
+        return true;
+    }
+
+    // appends the prime factors of n (with multiplicity, in increasing order); 0 and 1 have none
+    void factor(std::uint64_t n, std::vector<std::uint64_t>& out) const
+    {
+        if (n < 2) return;
+        const std::size_t first{out.size()};
+        const int twos{std::countr_zero(n)};
+        out.insert(out.end(), twos, 2);
+        split(n >> twos, out);
+        std::sort(out.begin() + first, out.end());
+    }
+
+    std::vector<std::uint64_t> factor(std::uint64_t n) const
+    {
+        std::vector<std::uint64_t> result;
+        factor(n, result);
+        return result;
+    }
+
+    FactorBatch factorBatch(std::span<const std::uint64_t> values, unsigned threads = 0) const
+    {
+        constexpr std::size_t blockSize{4096};
+        const std::size_t blocks{(values.size() + blockSize - 1) / blockSize};
+        std::vector<std::vector<std::uint64_t>> blockFactors(blocks);
+        FactorBatch batch;
+        batch.offsets.assign(values.size() + 1, 0);
+
+        parallelFor(blocks, threads == 0 ? defaultThreadCount() : threads, [&](std::size_t b, unsigned) {
+            auto& out{blockFactors[b]};
+            out.reserve(blockSize * 4);
+            const std::size_t end{std::min(values.size(), (b + 1) * blockSize)};
+            for (std::size_t i{b * blockSize}; i < end; ++i) {
+                const std::size_t before{out.size()};
+                factor(values[i], out);
+                batch.offsets[i + 1] = out.size() - before; // counts first, prefix sums below
+            }
+        });
+
+        std::partial_sum(batch.offsets.begin(), batch.offsets.end(), batch.offsets.begin());
+        batch.factors.reserve(batch.offsets.back());
+        for (auto& part : blockFactors) {
+            batch.factors.insert(batch.factors.end(), part.begin(), part.end());
+            std::vector<std::uint64_t>{}.swap(part);
+        }
+        return batch;
+    }
+
+private:
+    // n odd
+    void split(std::uint64_t n, std::vector<std::uint64_t>& out) const
+    {
+        if (n == 1) return;
+        if (n <= table.getLimit()) {
+            table.factor(static_cast<std::uint32_t>(n), out);
+            return;
+        }
+        if (isPrime(n)) {
+            out.push_back(n);
+            return;
+        }
+        const std::uint64_t d{pollardRho(n)};
+        split(d, out);
+        split(n / d, out);
+    }
+
+    // a non-trivial factor of an odd composite n
+    static std::uint64_t pollardRho(std::uint64_t n)
+    {
+        constexpr std::uint64_t batch{128};
+        const Montgomery m{n};
+        auto distance = [](std::uint64_t a, std::uint64_t b) { return a > b ? a - b : b - a; };
+
+        for (std::uint64_t increment{1};; ++increment) {
+            const std::uint64_t c{m.toMontgomery(increment)};
+            auto f = [&](std::uint64_t x) { return m.add(m.multiply(x, x), c); };
+
+            std::uint64_t y{m.toMontgomery(2)}, x{y}, saved{y}, product{m.one()}, g{1};
+            for (std::uint64_t r{1}; g == 1; r *= 2) {
+                x = y;
+                for (std::uint64_t i{}; i < r; ++i) y = f(y);
+                for (std::uint64_t k{}; k < r && g == 1; k += batch) {
+                    saved = y;
+                    for (std::uint64_t i{}; i < std::min(batch, r - k); ++i) {
+                        y = f(y);
+                        product = m.multiply(product, distance(x, y));
+                    }
+                    g = std::gcd(product, n);
+                }
+            }
+            if (g == n) { // the batch overshot: replay it one gcd at a time
+                do {
+                    saved = f(saved);
+                    g = std::gcd(distance(x, saved), n);
+                } while (g == 1);
+            }
+            if (g != n) return g;
+        }
+    }
+
+private:
+    SmallestPrimeFactors table;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @class Montgomery
+ *
+ * @brief Arithmetic modulo an odd 64-bit n without divisions, in Montgomery form.
+ *
+ * A residue a is stored as aR mod n with R = 2^64. The product of two stored values is (aR)(bR) = abR^2,
+ * and REDC divides by R modulo n with two multiplications and a shift: for t < nR, with m = t * n^-1 mod R,
+ * t - mn is divisible by R, and (t - mn) / R is the high half of t minus the high half of mn, corrected by
+ * + n when negative. This form has no carry out of 128 bits, so any odd n < 2^64 works.
+ *
+ * binaryPow is the exponentiation by squaring of BinaryExponentiation.cpp with these products, which is
+ * what Miller-Rabin and Pollard's rho spend their time in: a 128-bit % is some 30-90 cycles, a Montgomery
+ * product a handful.
+ */
+class Montgomery
+{
+public:
+    using u128 = unsigned __int128;
+
+    explicit Montgomery(std::uint64_t modulus) : n{modulus}
+    {
+        if (n % 2 == 0 || n < 3) throw std::invalid_argument("Modulus should be odd and > 1");
+
+        // Newton's iteration doubles the correct low bits of the inverse: n * n = 1 mod 8 to start
+        nInverse = n;
+        for (int i{}; i < 5; ++i) nInverse *= 2 - n * nInverse;
+
+        oneValue = static_cast<std::uint64_t>(-n % n);                // R mod n
+        rSquared = static_cast<std::uint64_t>(static_cast<u128>(oneValue) * oneValue % n);
+    }
+
+    std::uint64_t modulus() const noexcept { return n; }
+    std::uint64_t one() const noexcept { return oneValue; }
+
+    std::uint64_t toMontgomery(std::uint64_t a) const noexcept { return multiply(a % n, rSquared); }
+    std::uint64_t fromMontgomery(std::uint64_t a) const noexcept { return reduce(a); }
+
+    std::uint64_t multiply(std::uint64_t a, std::uint64_t b) const noexcept { return reduce(static_cast<u128>(a) * b); }
+
+    std::uint64_t add(std::uint64_t a, std::uint64_t b) const noexcept
+    {
+        std::uint64_t sum{a + b};
+        return sum >= n || sum < a ? sum - n : sum;
+    }
+
+    std::uint64_t subtract(std::uint64_t a, std::uint64_t b) const noexcept { return a >= b ? a - b : a + (n - b); }
+
+private:
+    // t / R mod n for t < nR
+    std::uint64_t reduce(u128 t) const noexcept
+    {
+        const std::uint64_t m{static_cast<std::uint64_t>(t) * nInverse};
+        const std::uint64_t high{static_cast<std::uint64_t>(t >> 64)};
+        const std::uint64_t mnHigh{static_cast<std::uint64_t>((static_cast<u128>(m) * n) >> 64)};
+        return high >= mnHigh ? high - mnHigh : high + (n - mnHigh);
+    }
+
+private:
+    std::uint64_t n{};
+    std::uint64_t nInverse{};
+    std::uint64_t oneValue{};
+    std::uint64_t rSquared{};
+};
+
+// a^e mod the modulus of m, for a and the result in normal (not Montgomery) form
+inline std::uint64_t binaryPow(const Montgomery& m, std::uint64_t a, std::uint64_t e)
+{
+    std::uint64_t base{m.toMontgomery(a)}, res{m.one()};
+    while (e > 0) {
+        if (e & 1) {
+            res = m.multiply(res, base);
+        }
+
+        base = m.multiply(base, base);
+        e >>= 1;
+    }
+
+    return m.fromMontgomery(res);
+}
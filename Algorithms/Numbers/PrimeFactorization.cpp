@@ -1,4 +1,10 @@
+#include <chrono>
+#include <random>
 #include <vector>
+#include <cstdint>
+#include <numeric>
+#include <iostream>
+#include "Factorization.h"
 
 /**
 * The function getPrimeFactors performs prime factorization of a given integer n.
@@ -12,6 +18,10 @@
 * it must be prime and is added to the list of prime factors. The result is a vector containing the prime factors of n,
 * arranged in ascending order.
 * This approach efficiently finds the prime factorization of n while minimizing the number of division operations.
+*
+* That is still O(sqrt(n)) per call. When many numbers are factored, the overload taking a SmallestPrimeFactors
+* table (PrimeSieve.h) is a walk of O(log n) lookups, and Factorizer (Factorization.h) covers 64-bit values and
+* batches with Pollard's rho and Miller-Rabin.
 */
 
 // Function to get the prime factors of a number
@@ -35,7 +45,134 @@ std::vector<int> getPrimeFactors(int n)
     return factorization;  // Return the list of prime factors
 }
 
+// The same factors by walking a smallest-prime-factor table, for n up to the table's limit
+std::vector<int> getPrimeFactors(int n, const SmallestPrimeFactors& table)
+{
+    std::vector<int> factorization;
+    if (n > 1) table.factor(static_cast<std::uint32_t>(n), factorization);
+    return factorization;
+}
+
+std::vector<std::uint64_t> trialDivision(std::uint64_t n)
+{
+    std::vector<std::uint64_t> factorization;
+    for (std::uint64_t d{2}; d * d <= n; ++d) {
+        while (n % d == 0) {
+            factorization.push_back(d);
+            n /= d;
+        }
+    }
+    if (n > 1) factorization.push_back(n);
+    return factorization;
+}
+
+bool isFactorization(std::uint64_t n, const std::vector<std::uint64_t>& factors)
+{
+    if (!std::is_sorted(factors.begin(), factors.end())) return false;
+    std::uint64_t product{1};
+    for (std::uint64_t p : factors) {
+        if (!Factorizer::isPrime(p)) return false;
+        product *= p;
+    }
+    return product == n;
+}
+
+int testFactorization()
+{
+    int failures{};
+    std::mt19937_64 rng{29};
+
+    SmallestPrimeFactors table{1'000'000};
+    for (int n{1}; n <= 1'000'000; ++n) {
+        if (getPrimeFactors(n, table) != getPrimeFactors(n)) ++failures;
+    }
+
+    // a small table, so that the rho path is taken from 1000 on
+    Factorizer small{1000};
+    Factorizer factorizer;
+    for (std::uint64_t n{}; n < 200'000; ++n) {
+        std::vector<std::uint64_t> expected{n < 2 ? std::vector<std::uint64_t>{} : trialDivision(n)};
+        if (small.factor(n) != expected || factorizer.factor(n) != expected) ++failures;
+        if (Factorizer::isPrime(n) != (n > 1 && table.isPrime(static_cast<std::uint32_t>(n)))) ++failures;
+    }
+
+    // strong pseudoprimes to several bases and Carmichael numbers, then the two largest 64-bit primes
+    for (std::uint64_t n : {2047ull, 3215031751ull, 3825123056546413051ull, 561ull, 41041ull}) {
+        if (Factorizer::isPrime(n) || !isFactorization(n, factorizer.factor(n))) ++failures;
+    }
+    for (std::uint64_t n : {18446744073709551557ull, 18446744073709551533ull}) {
+        if (!Factorizer::isPrime(n) || factorizer.factor(n) != std::vector<std::uint64_t>{n}) ++failures;
+    }
+
+    // products of two or three primes around 2^21 and 2^32, the hard inputs for rho
+    for (int round{}; round < 300; ++round) {
+        std::vector<std::uint64_t> primes;
+        std::uint64_t product{1};
+        const int parts{2 + round % 2};
+        const int bits{parts == 2 ? 32 : 21};
+        for (int k{}; k < parts; ++k) {
+            std::uint64_t p{(rng() >> (64 - bits)) | (1ull << (bits - 1)) | 1};
+            while (!Factorizer::isPrime(p)) p += 2;
+            primes.push_back(p);
+            product *= p;
+        }
+        std::sort(primes.begin(), primes.end());
+        if (factorizer.factor(product) != primes || small.factor(product) != primes) ++failures;
+    }
+
+    std::vector<std::uint64_t> values(20'000);
+    for (std::size_t i{}; i < values.size(); ++i) values[i] = i % 3 == 0 ? i : rng() >> (i % 40);
+    FactorBatch batch{factorizer.factorBatch(values, 3)};
+    if (batch.size() != values.size()) ++failures;
+    for (std::size_t i{}; i < values.size(); ++i) {
+        std::vector<std::uint64_t> factors(batch[i].begin(), batch[i].end());
+        if (factors != factorizer.factor(values[i]) || (values[i] > 1 && !isFactorization(values[i], factors))) ++failures;
+    }
+
+    std::cout << "Factorization: " << failures << " failures" << std::endl;
+    return failures;
+}
+
+// a million IDs below 2^32 by trial division, by the table of the default Factorizer and by a batch over all threads,
+// then random 64-bit values
+void benchmarkFactorization()
+{
+    std::mt19937_64 rng{31};
+    auto seconds = [](auto start) { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+    std::vector<std::uint64_t> ids(1'000'000);
+    for (auto& id : ids) id = rng() >> 41; // below 2^23, inside the default table
+    Factorizer factorizer;
+
+    auto start{std::chrono::steady_clock::now()};
+    std::size_t trialCount{};
+    for (std::uint64_t id : ids) trialCount += getPrimeFactors(static_cast<int>(id)).size();
+    double trialSeconds{seconds(start)};
+
+    start = std::chrono::steady_clock::now();
+    std::size_t tableCount{};
+    for (std::uint64_t id : ids) tableCount += getPrimeFactors(static_cast<int>(id), factorizer.getTable()).size();
+    double tableSeconds{seconds(start)};
+
+    start = std::chrono::steady_clock::now();
+    std::size_t batchCount{factorizer.factorBatch(ids).factors.size()};
+    double batchSeconds{seconds(start)};
+
+    std::cout << "1M values below 2^23: trial division " << trialSeconds << " s, table " << tableSeconds << " s, batch "
+              << batchSeconds << " s (" << trialCount << ", " << tableCount << ", " << batchCount << " factors)" << std::endl;
+
+    std::vector<std::uint64_t> wide(100'000);
+    for (auto& n : wide) n = rng();
+    start = std::chrono::steady_clock::now();
+    std::size_t wideCount{factorizer.factorBatch(wide).factors.size()};
+    std::cout << "100k random 64-bit values: " << seconds(start) << " s (" << wideCount << " factors) on "
+              << defaultThreadCount() << " threads" << std::endl;
+}
+
 int main()
 {
-    getPrimeFactors(15);
+    int failures{};
+    failures += testFactorization();
+    benchmarkFactorization();
+    return failures == 0 ? 0 : 1;
 }
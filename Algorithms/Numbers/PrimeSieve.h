@@ -0,0 +1,288 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "../Common/Parallel.h"
+
+/**
+ * @class SegmentedSieve
+ *
+ * @brief The primes up to a limit (10^10 and beyond) with the sieve of Eratosthenes, a cache-sized segment
+ *        at a time, the segments spread over threads.
+ *
+ * ## Layout
+ * Only odd numbers are stored, one bit each: bit b stands for 2b + 1, so a 32 KiB segment (the L1 data
+ * cache of most cores) covers 2^19 numbers. The base primes up to sqrt(limit) come from a plain sieve; each
+ * thread takes a contiguous run of segments and keeps, for every base prime, the bit of its next odd
+ * multiple, so crossing off continues from one segment to the next without divisions (consecutive odd
+ * multiples of p are p bits apart). Memory is the base primes plus one segment per thread, whatever the
+ * limit.
+ *
+ * ## Pre-sieving
+ * 3, 5, 7, 11 and 13 would do almost half of the crossing off. The multiples of p repeat every p words,
+ * so each segment starts as the AND of five precomputed word patterns, and the bit loops start at 17.
+ *
+ * count() and primes() run the segments in parallel (the per-thread lists of primes() are concatenated in
+ * order); forEachPrime visits them in increasing order on the calling thread, in constant memory. primes()
+ * up to 10^10 is 455 million values, so for large limits visiting or counting is the way to go.
+ */
+class SegmentedSieve
+{
+public:
+    static constexpr std::size_t segmentBytes{32 << 10};
+    static constexpr std::uint64_t segmentBits{segmentBytes * 8};
+
+    explicit SegmentedSieve(std::uint64_t limit, unsigned threads = 0)
+        : limit{limit}, threads{threads == 0 ? defaultThreadCount() : threads}
+    {
+        basePrimes = simpleSieve(static_cast<std::uint32_t>(isqrt(limit)));
+    }
+
+    std::uint64_t getLimit() const noexcept { return limit; }
+
+    std::uint64_t count() const
+    {
+        if (limit < 2) return 0;
+        std::vector<std::uint64_t> counts(threads);
+        forSegmentRuns([&](std::uint64_t beginBit, std::uint64_t endBit, unsigned t) {
+            sieve(beginBit, endBit, [&](std::uint64_t, const std::uint64_t* bits, std::size_t words) {
+                for (std::size_t w{}; w < words; ++w) counts[t] += std::popcount(bits[w]);
+                return true;
+            });
+        });
+        return std::accumulate(counts.begin(), counts.end(), std::uint64_t{1}); // and 2
+    }
+
+    std::vector<std::uint64_t> primes() const
+    {
+        if (limit < 2) return {};
+        std::vector<std::vector<std::uint64_t>> parts(threads);
+        forSegmentRuns([&](std::uint64_t beginBit, std::uint64_t endBit, unsigned t) {
+            sieve(beginBit, endBit, [&](std::uint64_t firstBit, const std::uint64_t* bits, std::size_t words) {
+                return visitBits(firstBit, bits, words, [&](std::uint64_t p) { parts[t].push_back(p); });
+            });
+        });
+
+        std::size_t total{1};
+        for (const auto& part : parts) total += part.size();
+        std::vector<std::uint64_t> result;
+        result.reserve(total);
+        result.push_back(2);
+        for (const auto& part : parts) result.insert(result.end(), part.begin(), part.end());
+        return result;
+    }
+
+    // visit(p) for the primes p <= limit in increasing order; a visitor returning false stops
+    template <typename Visitor>
+    void forEachPrime(Visitor&& visit) const
+    {
+        if (limit < 2 || !call(visit, 2)) return;
+        sieve(0, bitCount(), [&](std::uint64_t firstBit, const std::uint64_t* bits, std::size_t words) {
+            return visitBits(firstBit, bits, words, visit);
+        });
+    }
+
+    // the primes up to sqrt(limit), odd ones only
+    const std::vector<std::uint32_t>& getBasePrimes() const noexcept { return basePrimes; }
+
+    static std::uint64_t isqrt(std::uint64_t n)
+    {
+        std::uint64_t r{static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)))};
+        while (r > 0 && r * r > n) --r;
+        while ((r + 1) * (r + 1) <= n) ++r;
+        return r;
+    }
+
+private:
+    static constexpr std::uint32_t preSieved[]{3, 5, 7, 11, 13};
+
+    template <typename Visitor>
+    static bool call(Visitor& visit, std::uint64_t p)
+    {
+        if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::uint64_t>>) {
+            visit(p);
+            return true;
+        } else {
+            return visit(p);
+        }
+    }
+
+    template <typename Visitor>
+    static bool visitBits(std::uint64_t firstBit, const std::uint64_t* bits, std::size_t words, Visitor&& visit)
+    {
+        for (std::size_t w{}; w < words; ++w) {
+            for (std::uint64_t word{bits[w]}; word != 0; word &= word - 1) {
+                std::uint64_t bit{firstBit + w * 64 + static_cast<std::uint64_t>(std::countr_zero(word))};
+                if (!call(visit, 2 * bit + 1)) return false;
+            }
+        }
+        return true;
+    }
+
+    static std::vector<std::uint32_t> simpleSieve(std::uint32_t n)
+    {
+        std::vector<char> composite(static_cast<std::size_t>(n) + 1);
+        std::vector<std::uint32_t> result;
+        for (std::uint64_t i{3}; i <= n; i += 2) {
+            if (composite[i]) continue;
+            result.push_back(static_cast<std::uint32_t>(i));
+            for (std::uint64_t j{i * i}; j <= n; j += 2 * i) composite[j] = 1;
+        }
+        return result;
+    }
+
+    std::uint64_t bitCount() const noexcept { return (limit + 1) / 2; } // the odd numbers 1, 3, ... <= limit
+
+    // runs of whole segments, one per thread
+    template <typename Body>
+    void forSegmentRuns(Body&& body) const
+    {
+        const std::uint64_t bits{bitCount()}, segments{(bits + segmentBits - 1) / segmentBits};
+        parallelForChunks(segments, threads, [&](std::size_t begin, std::size_t end, unsigned t) {
+            body(begin * segmentBits, std::min<std::uint64_t>(bits, end * segmentBits), t);
+        });
+    }
+
+    // sieves the bits [beginBit, endBit) segment by segment, consume(firstBit, bits, words) returning false stops
+    template <typename Consume>
+    void sieve(std::uint64_t beginBit, std::uint64_t endBit, Consume&& consume) const
+    {
+        const std::size_t firstCrossed{std::min(std::size(preSieved), basePrimes.size())};
+        std::vector<std::uint64_t> next(basePrimes.size()); // bit of the next odd multiple to cross off
+        const std::uint64_t firstNumber{2 * beginBit + 1};
+        for (std::size_t i{firstCrossed}; i < basePrimes.size(); ++i) {
+            const std::uint64_t p{basePrimes[i]};
+            std::uint64_t multiple{std::max(p * p, (firstNumber + p - 1) / p * p)};
+            if (multiple % 2 == 0) multiple += p;
+            next[i] = (multiple - 1) / 2;
+        }
+
+        std::vector<std::uint64_t> bits(segmentBits / 64);
+        for (std::uint64_t segment{beginBit}; segment < endBit; segment += segmentBits) {
+            const std::uint64_t segmentEnd{std::min(endBit, segment + segmentBits)};
+            const std::size_t words{static_cast<std::size_t>((segmentEnd - segment + 63) / 64)};
+            preSieve(bits.data(), segment, words, firstCrossed);
+
+            for (std::size_t i{firstCrossed}; i < basePrimes.size(); ++i) {
+                const std::uint64_t p{basePrimes[i]};
+                if ((p * p - 1) / 2 >= segmentEnd) break; // this and all larger primes start later
+                std::uint64_t j{next[i]};
+                for (; j < segmentEnd; j += p) bits[(j - segment) >> 6] &= ~(std::uint64_t{1} << ((j - segment) & 63));
+                next[i] = j;
+            }
+
+            if (segment == 0) {
+                bits[0] &= ~std::uint64_t{1}; // 1 is not a prime
+                for (std::size_t k{}; k < firstCrossed; ++k) bits[0] |= std::uint64_t{1} << ((preSieved[k] - 1) / 2);
+            }
+            const unsigned tail{static_cast<unsigned>((segmentEnd - segment) & 63)};
+            if (tail != 0) bits[words - 1] &= (std::uint64_t{1} << tail) - 1;
+
+            if (!consume(segment, bits.data(), words)) return;
+        }
+    }
+
+    // every bit set except the odd multiples of the pre-sieved primes (that are base primes)
+    static void preSieve(std::uint64_t* bits, std::uint64_t firstBit, std::size_t words, std::size_t primes)
+    {
+        static const auto patterns{[] {
+            // patterns[k][q]: the word whose first bit is q modulo p
+            std::array<std::array<std::uint64_t, 13>, std::size(preSieved)> result{};
+            for (std::size_t k{}; k < std::size(preSieved); ++k) {
+                const std::uint64_t p{preSieved[k]};
+                for (std::uint64_t q{}; q < p; ++q) {
+                    std::uint64_t word{~std::uint64_t{}};
+                    for (std::uint64_t b{}; b < 64; ++b) {
+                        if ((q + b) % p == (p - 1) / 2) word &= ~(std::uint64_t{1} << b); // 2(q + b) + 1 = 0 mod p
+                    }
+                    result[k][q] = word;
+                }
+            }
+            return result;
+        }()};
+
+        std::fill(bits, bits + words, ~std::uint64_t{});
+        for (std::size_t k{}; k < primes; ++k) {
+            const std::uint64_t p{preSieved[k]}, step{64 % p};
+            std::uint64_t q{firstBit % p};
+            for (std::size_t w{}; w < words; ++w) {
+                bits[w] &= patterns[k][q];
+                q += step;
+                if (q >= p) q -= p;
+            }
+        }
+    }
+
+private:
+    std::uint64_t limit;
+    unsigned threads;
+    std::vector<std::uint32_t> basePrimes;
+};
+
+/**
+ * @class SmallestPrimeFactors
+ *
+ * @brief The smallest prime factor of every number up to a limit, from a linear sieve, so that factoring
+ *        such a number is a walk of O(log n) table lookups.
+ *
+ * The linear sieve writes every composite exactly once, as (its smallest prime) * (a number whose smallest
+ * prime factor is at least that), so it is O(limit). Like SegmentedSieve the table holds odd numbers only,
+ * powers of 2 come off with a shift: 4 bytes per two numbers, 200 MB for a limit of 10^8.
+ */
+class SmallestPrimeFactors
+{
+public:
+    explicit SmallestPrimeFactors(std::uint32_t limit) : limit{limit}, spf(limit / 2 + 1)
+    {
+        std::vector<std::uint32_t> primes;
+        for (std::uint64_t i{3}; i <= limit; i += 2) {
+            if (spf[i / 2] == 0) {
+                spf[i / 2] = static_cast<std::uint32_t>(i);
+                primes.push_back(static_cast<std::uint32_t>(i));
+            }
+            const std::uint32_t smallest{spf[i / 2]};
+            for (std::uint32_t p : primes) {
+                if (p > smallest || i * p > limit) break;
+                spf[i * p / 2] = p;
+            }
+        }
+        if (limit >= 1) spf[0] = 1;
+    }
+
+    std::uint32_t getLimit() const noexcept { return limit; }
+
+    // 2 for even n; n itself for n = 1 or an odd prime
+    std::uint32_t smallestFactor(std::uint32_t n) const
+    {
+        if (n == 0 || n > limit) throw std::out_of_range("Number is out of the table's range");
+        return n % 2 == 0 ? 2 : spf[n / 2];
+    }
+
+    bool isPrime(std::uint32_t n) const { return n == 2 || (n > 2 && n % 2 == 1 && smallestFactor(n) == n); }
+
+    // appends the prime factors of n (with multiplicity, in increasing order)
+    template <typename T>
+    void factor(std::uint32_t n, std::vector<T>& out) const
+    {
+        if (n == 0 || n > limit) throw std::out_of_range("Number is out of the table's range");
+        const int twos{std::countr_zero(n)};
+        out.insert(out.end(), twos, T{2});
+        for (n >>= twos; n > 1;) {
+            const std::uint32_t p{spf[n / 2]};
+            out.push_back(p);
+            n /= p;
+        }
+    }
+
+private:
+    std::uint32_t limit;
+    std::vector<std::uint32_t> spf; // spf[i] is the smallest prime factor of 2i + 1
+};
@@ -1,9 +1,15 @@
+#include <chrono>
 #include <vector>
+#include <cstdint>
+#include <iostream>
+#include "PrimeSieve.h"
 
 //Sieve of Eratosthenes is an algorithm for finding all the prime numbers in a segment [1, n] using O(n log log n) operations.
+// For large n (up to 10^10 and beyond) and for many calls, PrimeSieve.h has the segmented, odd-only, multithreaded
+// version and a smallest-prime-factor table.
 
-// either return or pass by ref the vector
-void initPrimes(int n)
+// primes[i] is true if i is prime
+std::vector<bool> initPrimes(int n)
 {
     std::vector<bool> primes(n + 1, true);
     primes[0] = primes[1] = false;
@@ -14,4 +20,81 @@ void initPrimes(int n)
             } 
         }
     }
-}
\ No newline at end of file
+    return primes;
+}
+
+int testSegmentedSieve()
+{
+    int failures{};
+
+    // every limit around the pre-sieved primes and the segment and word boundaries
+    std::vector<bool> reference{initPrimes(3'000'000)};
+    std::vector<std::uint64_t> limits{0, 1, 2, 3, 4, 5, 168, 169, 170, 288, 289, 1000, 65535, 65536};
+    for (std::uint64_t bits : {SegmentedSieve::segmentBits, 2 * SegmentedSieve::segmentBits}) {
+        for (std::uint64_t delta : {0, 1, 2, 3}) limits.push_back(2 * bits - 1 + delta - 2);
+    }
+    limits.push_back(3'000'000);
+    for (std::uint64_t limit : limits) {
+        std::vector<std::uint64_t> expected;
+        for (std::uint64_t i{}; i <= limit; ++i) {
+            if (reference[i]) expected.push_back(i);
+        }
+        for (unsigned threads : {1u, 3u}) {
+            SegmentedSieve sieve{limit, threads};
+            std::vector<std::uint64_t> visited;
+            sieve.forEachPrime([&](std::uint64_t p) { visited.push_back(p); });
+            if (sieve.primes() != expected || visited != expected || sieve.count() != expected.size()) ++failures;
+        }
+    }
+
+    // pi(10^k)
+    const std::uint64_t pi[]{4, 25, 168, 1229, 9592, 78498, 664579, 5761455, 50847534};
+    std::uint64_t power{10};
+    for (std::uint64_t expected : pi) {
+        if (SegmentedSieve{power}.count() != expected) ++failures;
+        power *= 10;
+    }
+
+    // stopping early
+    std::uint64_t last{};
+    SegmentedSieve{1'000'000}.forEachPrime([&](std::uint64_t p) { last = p; return p < 100; });
+    if (last != 101) ++failures;
+
+    SmallestPrimeFactors spf{1'000'000};
+    for (std::uint32_t n{2}; n <= 1'000'000; ++n) {
+        if (spf.isPrime(n) != reference[n]) ++failures;
+        std::uint32_t smallest{spf.smallestFactor(n)};
+        if (n % smallest != 0 || !reference[smallest]) ++failures;
+    }
+
+    std::cout << "Segmented sieve: " << failures << " failures" << std::endl;
+    return failures;
+}
+
+void benchmarkSegmentedSieve()
+{
+    auto seconds = [](auto start) { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+    auto start{std::chrono::steady_clock::now()};
+    std::vector<bool> plain{initPrimes(1'000'000'000)};
+    std::cout << "initPrimes(10^9): " << seconds(start) << " s" << std::endl;
+
+    for (std::uint64_t limit : {1'000'000'000ull, 10'000'000'000ull}) {
+        start = std::chrono::steady_clock::now();
+        std::uint64_t count{SegmentedSieve{limit}.count()};
+        std::cout << "SegmentedSieve(" << limit << ").count() = " << count << ": " << seconds(start) << " s on "
+                  << defaultThreadCount() << " threads" << std::endl;
+    }
+
+    start = std::chrono::steady_clock::now();
+    SmallestPrimeFactors spf{100'000'000};
+    std::cout << "SmallestPrimeFactors(10^8): " << seconds(start) << " s" << std::endl;
+}
+
+int main()
+{
+    int failures{};
+    failures += testSegmentedSieve();
+    benchmarkSegmentedSieve();
+    return failures == 0 ? 0 : 1;
+}
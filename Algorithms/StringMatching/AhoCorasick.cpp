@@ -0,0 +1,140 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include "AhoCorasick.h"
+#include "KMP.h"
+#include "TestStrings.h"
+
+using Match = std::pair<std::size_t, std::size_t>; // (pattern, begin)
+
+std::vector<Match> bruteForceMatches(const std::string& text, const std::vector<std::string>& patterns)
+{
+    std::vector<Match> result;
+    for (std::size_t k{}; k < patterns.size(); ++k) {
+        for (std::size_t pos{text.find(patterns[k])}; pos != std::string::npos; pos = text.find(patterns[k], pos + 1)) {
+            result.push_back({k, pos});
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+int testAhoCorasick()
+{
+    int failures{};
+    std::mt19937 rng{7};
+
+    // the classic example, with one pattern a suffix of another and one a prefix of a third
+    std::vector<std::string> classic{"he", "she", "his", "hers"};
+    for (auto layout : {AhoCorasick::Layout::Dense, AhoCorasick::Layout::DoubleArray}) {
+        AhoCorasick automaton{classic, layout};
+        std::vector<Match> found;
+        automaton.search("ushers", [&](std::size_t k, std::size_t begin) { found.push_back({k, begin}); });
+        std::sort(found.begin(), found.end());
+        if (found != std::vector<Match>{{0, 2}, {1, 1}, {3, 2}}) ++failures;
+    }
+
+    // random small alphabets give many overlaps, duplicates and patterns inside other patterns
+    for (int round{}; round < 300; ++round) {
+        int alphabet{2 + round % 4};
+        std::vector<std::string> patterns(1 + rng() % 30);
+        for (auto& p : patterns) p = randomText(1 + rng() % 6, alphabet, rng);
+        if (round % 5 == 0) patterns.push_back(patterns.front());
+        std::string text{randomText(rng() % 400, alphabet + 1, rng)};
+        auto expected{bruteForceMatches(text, patterns)};
+
+        for (auto layout : {AhoCorasick::Layout::Dense, AhoCorasick::Layout::DoubleArray}) {
+            AhoCorasick automaton{patterns, layout};
+            std::vector<Match> found;
+            std::size_t reported{automaton.search(text, [&](std::size_t k, std::size_t begin) { found.push_back({k, begin}); })};
+            std::sort(found.begin(), found.end());
+            if (found != expected || reported != expected.size()) ++failures;
+        }
+    }
+
+    // a visitor returning false stops the scan after that match
+    AhoCorasick all_a{std::vector<std::string>{"a", "aa"}};
+    std::size_t seen{};
+    all_a.search(std::string(100, 'a'), [&](std::size_t, std::size_t) { return ++seen < 5; });
+    if (seen != 5) ++failures;
+
+    try {
+        AhoCorasick empty{std::vector<std::string>{"abc", ""}};
+        ++failures;
+    } catch (const std::invalid_argument&) {}
+
+    std::cout << "Aho-Corasick: " << failures << " failures" << std::endl;
+    return failures;
+}
+
+// log lines against a signature set, one pass with the automaton versus one KMP pass per signature
+void benchmarkAhoCorasick()
+{
+    std::mt19937 rng{11};
+    const std::string words[]{"GET", "POST", "/api/v1/", "user", "session", "token", "error", "timeout", "200",
+                              "404", "500", "host=", "agent=", "Mozilla", "curl", "id=", "ms", "ok"};
+    std::string text;
+    text.reserve(16 << 20);
+    while (text.size() < (16 << 20)) {
+        for (int w{}; w < 8; ++w) {
+            text += words[rng() % std::size(words)];
+            text += rng() % 3 == 0 ? std::to_string(rng() % 100000) : " ";
+        }
+        text += '\n';
+    }
+
+    // signatures: random printable strings, some built from the log vocabulary so that they do match
+    std::uniform_int_distribution<int> printable(33, 126);
+    std::vector<std::string> signatures(2000);
+    for (std::size_t k{}; k < signatures.size(); ++k) {
+        if (k % 50 == 0) {
+            signatures[k] = std::string{words[rng() % std::size(words)]} + words[rng() % std::size(words)];
+        } else {
+            signatures[k].resize(8 + rng() % 17);
+            for (char& c : signatures[k]) c = static_cast<char>(printable(rng));
+        }
+    }
+
+    auto time = [](auto&& f) {
+        auto start{std::chrono::steady_clock::now()};
+        std::size_t result{f()};
+        return std::pair{result, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+    };
+    const double mib{text.size() / double(1 << 20)};
+
+    for (auto layout : {AhoCorasick::Layout::Dense, AhoCorasick::Layout::DoubleArray}) {
+        auto [automaton, build]{time([&] { return AhoCorasick{signatures, layout}.stateCount(); })};
+        AhoCorasick ac{signatures, layout};
+        auto [matches, seconds]{time([&] { return ac.count(text); })};
+        std::cout << (layout == AhoCorasick::Layout::Dense ? "Dense" : "DoubleArray") << ": " << signatures.size()
+                  << " patterns, " << automaton << " states, " << ac.classCount() << " classes, "
+                  << ac.memoryBytes() / 1024 << " KiB (" << double(ac.memoryBytes()) / automaton << " bytes per state), built in " << build * 1e3 << " ms, " << matches << " matches, "
+                  << mib / seconds << " MiB/s" << std::endl;
+    }
+
+    // KMP takes one pass per pattern, so it gets a tenth of the signatures and the time is scaled up
+    const std::size_t sample{signatures.size() / 10};
+    auto [kmpMatches, kmpSeconds]{time([&] {
+        std::size_t matches{};
+        for (std::size_t k{}; k < sample; ++k) {
+            matches += KMPSearch(text, signatures[k], getLPS(signatures[k]), [](std::size_t) {});
+        }
+        return matches;
+    })};
+    std::vector<std::string> sampled(signatures.begin(), signatures.begin() + sample);
+    std::size_t expected{AhoCorasick{sampled}.count(text)};
+    std::cout << "KMP per pattern: " << sample << " patterns, " << kmpMatches << " matches"
+              << (kmpMatches == expected ? "" : " (MISMATCH)") << ", "
+              << mib / (kmpSeconds * signatures.size() / sample) << " MiB/s for all " << signatures.size() << std::endl;
+}
+
+int main()
+{
+    int failures{};
+    failures += testAhoCorasick();
+    benchmarkAhoCorasick();
+    return failures == 0 ? 0 : 1;
+}
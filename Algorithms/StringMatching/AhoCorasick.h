@@ -0,0 +1,313 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @class AhoCorasick
+ *
+ * @brief Finds all occurrences of many patterns in one pass over the text.
+ *
+ * ## Automaton
+ * The patterns form a trie. The failure link of a state is the longest proper suffix of its string that is
+ * also a trie state, computed level by level (BFS). The dictionary link is the nearest state on the failure
+ * chain where a pattern ends, so reporting walks only states that produce a match and costs O(matches).
+ * Scanning is O(n + matches) for any number of patterns, where running KMP once per pattern is O(n * k).
+ *
+ * ## Alphabet classes
+ * Bytes that occur in no pattern all behave alike (they send every state back to the root), so the bytes
+ * are mapped to classes first: one class per distinct pattern byte plus class 0 for the rest. A signature
+ * set over printable ASCII has some 60-90 classes instead of 256 columns, which makes a transition row a
+ * few cache lines.
+ *
+ * ## Layouts
+ *  - Dense (default): the full DFA, one int32 row of states x classes, with the failure transitions folded
+ *    in at build time. The scan is one load per byte and no branches except for the output check.
+ *  - DoubleArray: for large pattern sets where states x classes does not fit in memory. Only trie edges are
+ *    stored, in the base/check double array: the child of s on class c is slot base[s] + c if check of that
+ *    slot is s. Misses follow failure links, amortized O(1) per byte. A slot holds five int32 (base, check,
+ *    fail, output, dict) and few slots stay free, so the memory is about 20 bytes per state (20.0 for the
+ *    2000 signatures of the benchmark in AhoCorasick.cpp, against 388 for the dense table).
+ *
+ * The visitor is called as visit(pattern, begin) with the index of the pattern in the constructor's list
+ * and the offset of the occurrence in the text; it may return bool, false stops the search. Patterns must be
+ * non-empty, duplicates are each reported. The text is scanned in place, nothing is copied.
+ */
+class AhoCorasick
+{
+public:
+    enum class Layout { Dense, DoubleArray };
+
+    explicit AhoCorasick(std::span<const std::string_view> patterns, Layout layout = Layout::Dense)
+        : layout{layout}
+    {
+        build(patterns);
+    }
+
+    explicit AhoCorasick(const std::vector<std::string>& patterns, Layout layout = Layout::Dense)
+        : layout{layout}
+    {
+        std::vector<std::string_view> views(patterns.begin(), patterns.end());
+        build(views);
+    }
+
+    Layout getLayout() const noexcept { return layout; }
+    std::size_t patternCount() const noexcept { return patternLength.size(); }
+    std::size_t stateCount() const noexcept { return states; }
+    std::size_t classCount() const noexcept { return classes; }
+
+    // bytes held by the automaton: transitions (table or double array plus failure links) and outputs
+    std::size_t memoryBytes() const noexcept
+    {
+        return sizeof(std::int32_t) * (next.size() + base.size() + check.size() + fail.size() + output.size() + dict.size());
+    }
+
+    template <typename Visitor>
+    std::size_t search(std::string_view text, Visitor&& visit) const
+    {
+        return layout == Layout::Dense ? scanDense(text, visit) : scanDoubleArray(text, visit);
+    }
+
+    std::size_t count(std::string_view text) const
+    {
+        return search(text, [](std::size_t, std::size_t) {});
+    }
+
+private:
+    static constexpr std::int32_t none{-1};
+
+    // a trie under construction, children sorted by class
+    struct Trie
+    {
+        std::vector<std::vector<std::pair<std::uint16_t, std::int32_t>>> children;
+        std::vector<std::int32_t> terminal; // first pattern ending at the state, -1 if none
+
+        std::int32_t child(std::int32_t s, std::uint16_t c) const
+        {
+            auto& list{children[s]};
+            auto it{std::lower_bound(list.begin(), list.end(), std::pair<std::uint16_t, std::int32_t>{c, none})};
+            return it != list.end() && it->first == c ? it->second : none;
+        }
+    };
+
+    void build(std::span<const std::string_view> patterns)
+    {
+        std::array<bool, 256> used{};
+        for (auto p : patterns) {
+            if (p.empty()) throw std::invalid_argument("Patterns should be non-empty");
+            for (unsigned char ch : p) used[ch] = true;
+        }
+        classes = 1;
+        for (int b{}; b < 256; ++b) byteClass[b] = used[b] ? static_cast<std::uint16_t>(classes++) : 0;
+
+        Trie trie;
+        trie.children.emplace_back();
+        trie.terminal.push_back(none);
+        patternLength.resize(patterns.size());
+        samePattern.assign(patterns.size(), none);
+        for (std::size_t k{}; k < patterns.size(); ++k) {
+            std::int32_t s{};
+            for (unsigned char ch : patterns[k]) {
+                std::uint16_t c{byteClass[ch]};
+                std::int32_t t{trie.child(s, c)};
+                if (t == none) {
+                    t = static_cast<std::int32_t>(trie.children.size());
+                    auto& list{trie.children[s]};
+                    list.insert(std::upper_bound(list.begin(), list.end(), std::pair<std::uint16_t, std::int32_t>{c, none}), {c, t});
+                    trie.children.emplace_back();
+                    trie.terminal.push_back(none);
+                }
+                s = t;
+            }
+            patternLength[k] = patterns[k].size();
+            // duplicates chain from the first one, reported in input order
+            std::int32_t& slot{trie.terminal[s]};
+            if (slot == none) {
+                slot = static_cast<std::int32_t>(k);
+            } else {
+                std::int32_t last{slot};
+                while (samePattern[last] != none) last = samePattern[last];
+                samePattern[last] = static_cast<std::int32_t>(k);
+            }
+        }
+        states = trie.children.size();
+
+        // BFS order, failure links and dictionary links over trie state ids
+        std::vector<std::int32_t> order{0}, trieFail(states, 0), trieDict(states, none);
+        order.reserve(states);
+        for (std::size_t head{}; head < order.size(); ++head) {
+            std::int32_t s{order[head]};
+            for (auto [c, t] : trie.children[s]) {
+                std::int32_t f{none};
+                if (s != 0) {
+                    f = trieFail[s];
+                    while (f != 0 && trie.child(f, c) == none) f = trieFail[f];
+                    std::int32_t g{trie.child(f, c)};
+                    f = g == none ? 0 : g;
+                }
+                trieFail[t] = f == none ? 0 : f;
+                const std::int32_t u{trieFail[t]};
+                trieDict[t] = trie.terminal[u] != none ? u : trieDict[u];
+                order.push_back(t);
+            }
+        }
+
+        if (layout == Layout::Dense) {
+            buildDense(trie, order, trieFail, trieDict);
+        } else {
+            buildDoubleArray(trie, order, trieFail, trieDict);
+        }
+    }
+
+    // rows in BFS order, the failure target's row is complete before it is copied from
+    void buildDense(const Trie& trie, const std::vector<std::int32_t>& order,
+                    const std::vector<std::int32_t>& trieFail, const std::vector<std::int32_t>& trieDict)
+    {
+        next.assign(states * classes, 0);
+        for (std::int32_t s : order) {
+            std::int32_t* row{next.data() + s * classes};
+            if (s != 0) std::copy_n(next.data() + trieFail[s] * classes, classes, row);
+            for (auto [c, t] : trie.children[s]) row[c] = t;
+        }
+
+        output = trie.terminal;
+        dict = trieDict;
+    }
+
+    // first-fit placement of each state's children, slots are the state ids of the scan
+    void buildDoubleArray(const Trie& trie, const std::vector<std::int32_t>& order,
+                          const std::vector<std::int32_t>& trieFail, const std::vector<std::int32_t>& trieDict)
+    {
+        std::vector<std::int32_t> slotOf(states, none);
+        std::vector<bool> taken{true};  // slot 0 is the root
+        base.assign(1, 0);
+        check.assign(1, none);
+        slotOf[0] = 0;
+
+        std::size_t firstFree{1};
+        for (std::int32_t s : order) {
+            auto& list{trie.children[s]};
+            if (list.empty()) continue;
+
+            while (firstFree < taken.size() && taken[firstFree]) ++firstFree;
+            // the smallest base that puts the first child at or after the first free slot
+            std::int64_t b{static_cast<std::int64_t>(firstFree) - list.front().first};
+            if (b < 0) b = 0;
+            for (;; ++b) {
+                bool fits{true};
+                for (auto [c, t] : list) {
+                    std::size_t slot{static_cast<std::size_t>(b + c)};
+                    if (slot < taken.size() && taken[slot]) {
+                        fits = false;
+                        break;
+                    }
+                }
+                if (fits) break;
+            }
+
+            const std::size_t end{static_cast<std::size_t>(b + list.back().first) + 1};
+            if (end > taken.size()) {
+                taken.resize(end, false);
+                base.resize(end, 0);
+                check.resize(end, none);
+            }
+            const std::int32_t from{slotOf[s]};
+            base[from] = static_cast<std::int32_t>(b);
+            for (auto [c, t] : list) {
+                std::size_t slot{static_cast<std::size_t>(b + c)};
+                taken[slot] = true;
+                check[slot] = from;
+                slotOf[t] = static_cast<std::int32_t>(slot);
+            }
+        }
+
+        // check covers every slot base[s] + c can reach, so the scan needs no bounds test
+        check.resize(check.size() + classes, none);
+        base.resize(check.size(), 0);
+        fail.assign(check.size(), 0);
+        output.assign(check.size(), none);
+        dict.assign(check.size(), none);
+        for (std::size_t s{}; s < states; ++s) {
+            const std::int32_t slot{slotOf[s]};
+            fail[slot] = slotOf[trieFail[s]];
+            output[slot] = trie.terminal[s];
+            dict[slot] = trieDict[s] == none ? none : slotOf[trieDict[s]];
+        }
+    }
+
+    // the patterns ending at state s: its own (with duplicates), then along the dictionary links
+    template <typename Visitor>
+    bool report(std::int32_t s, std::size_t end, Visitor& visit, std::size_t& matches) const
+    {
+        if (output[s] == none) s = dict[s];
+        for (; s != none; s = dict[s]) {
+            for (std::int32_t k{output[s]}; k != none; k = samePattern[k]) {
+                ++matches;
+                const std::size_t begin{end - patternLength[k]};
+                if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::size_t, std::size_t>>) {
+                    visit(static_cast<std::size_t>(k), begin);
+                } else {
+                    if (!visit(static_cast<std::size_t>(k), begin)) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    template <typename Visitor>
+    std::size_t scanDense(std::string_view text, Visitor& visit) const
+    {
+        std::size_t matches{};
+        const std::int32_t* table{next.data()};
+        std::int32_t s{};
+        for (std::size_t i{}; i < text.size(); ++i) {
+            s = table[static_cast<std::size_t>(s) * classes + byteClass[static_cast<unsigned char>(text[i])]];
+            if ((output[s] & dict[s]) != none && !report(s, i + 1, visit, matches)) break; // both -1 means no match
+        }
+        return matches;
+    }
+
+    template <typename Visitor>
+    std::size_t scanDoubleArray(std::string_view text, Visitor& visit) const
+    {
+        std::size_t matches{};
+        std::int32_t s{};
+        for (std::size_t i{}; i < text.size(); ++i) {
+            const std::uint16_t c{byteClass[static_cast<unsigned char>(text[i])]};
+            if (c == 0) {
+                s = 0;
+                continue;
+            }
+            while (check[base[s] + c] != s && s != 0) s = fail[s];
+            std::int32_t t{base[s] + c};
+            s = check[t] == s ? t : 0;
+            if ((output[s] & dict[s]) != none && !report(s, i + 1, visit, matches)) break;
+        }
+        return matches;
+    }
+
+private:
+    Layout layout;
+    std::array<std::uint16_t, 256> byteClass{};
+    std::size_t classes{};
+    std::size_t states{};
+
+    std::vector<std::int32_t> next;         // Dense: states x classes DFA
+    std::vector<std::int32_t> base;         // DoubleArray: children of s start at base[s]
+    std::vector<std::int32_t> check;        // DoubleArray: parent of the slot, -1 if free
+    std::vector<std::int32_t> fail;         // DoubleArray: failure links
+
+    std::vector<std::int32_t> output;       // first pattern ending exactly at the state, -1 if none
+    std::vector<std::int32_t> dict;         // nearest failure-chain state with an output, -1 if none
+    std::vector<std::int32_t> samePattern;  // next pattern equal to this one, -1 if none
+    std::vector<std::size_t> patternLength;
+};
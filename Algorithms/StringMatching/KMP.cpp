@@ -1,71 +1,115 @@
-#include <vector>
+#include <chrono>
+#include <random>
 #include <string>
+#include <vector>
+#include <sstream>
 #include <iostream>
+#include "KMP.h"
+#include "TestStrings.h"
 
+// The LPS table and the callback search live in KMP.h, this prints the matches of one pattern.
+void KMPSearch(const std::string& text, const std::string& pattern) {
+    KMPSearch(text, pattern, getLPS(pattern), [](std::size_t index) {
+        std::cout << "Found match at: " << index << " index" << std::endl;
+    });
+}
 
-/*
-KMP Algorithm: Overview
-The Knuth-Morris-Pratt (KMP) algorithm is an efficient string-matching (or substring-searching) algorithm that finds all occurrences of a pattern (substring) in a text (string).
-KMP improves upon the naive string-matching approach by using information gained during the search to avoid redundant comparisons.
+// feeds text cut at random points and collects the reported offsets
+template <typename Matcher>
+std::vector<std::size_t> feedInPieces(Matcher& matcher, std::string_view text, std::mt19937& rng)
+{
+    std::vector<std::size_t> found;
+    for (std::size_t at{}; at < text.size();) {
+        std::size_t piece{std::min<std::size_t>(rng() % 8, text.size() - at)};
+        matcher.feed(text.substr(at, piece), [&](std::uint64_t begin) { found.push_back(begin); });
+        at += piece;
+    }
+    return found;
+}
 
-Key Ideas:
-Preprocessing (LPS Array):
-Before starting the search, KMP computes a Longest Prefix Suffix (LPS) array for the pattern.
-This array tells us, for each position in the pattern, the length of the longest proper prefix which is also a suffix.
-It helps in skipping characters in the pattern that are already matched.
+int testStreamingKMP()
+{
+    int failures{};
+    std::mt19937 rng{3};
 
-Search Phase:
-During the actual search, when a mismatch occurs, KMP uses the LPS array to determine how many characters we can skip in both the text and the pattern, based on previous matches.
+    for (int round{}; round < 500; ++round) {
+        int alphabet{1 + round % 4};
+        std::string pattern{randomText(1 + rng() % 7, alphabet, rng)};
+        std::string text{randomText(rng() % 300, alphabet, rng)};
 
-By using the LPS array, the algorithm can avoid unnecessary comparisons, ensuring that the total time complexity remains linear,
-O(n + m), where n is the length of the text and m is the length of the pattern.
-*/
+        std::vector<std::size_t> expected;
+        KMPSearch(text, pattern, getLPS(pattern), [&](std::size_t begin) { expected.push_back(begin); });
 
+        KMPMatcher plain{pattern};
+        KMPDFAMatcher dfa{pattern};
+        if (feedInPieces(plain, text, rng) != expected || plain.position() != text.size()) ++failures;
+        if (feedInPieces(dfa, text, rng) != expected || dfa.position() != text.size()) ++failures;
 
-std::vector<int> getLPS(const std::string& s) {
-    // Initialize the LPS array with size equal to the pattern length
-    std::vector<int> lps(s.size());
+        // the same input through a stream with a tiny buffer, after a reset
+        plain.reset();
+        std::istringstream in{text};
+        std::vector<std::size_t> streamed;
+        plain.feed(in, [&](std::uint64_t begin) { streamed.push_back(begin); }, 3);
+        if (streamed != expected) ++failures;
+    }
 
-    // Variables to track indices for the pattern and LPS array
-    int i{1}, j{};
+    // one byte chunks, a match ending in every chunk
+    KMPDFAMatcher aa{"aa"};
+    std::size_t matches{};
+    for (int i{}; i < 10; ++i) matches += aa.feed(std::string_view{"a"}, [](std::uint64_t) {});
+    if (matches != 9 || aa.state() != 2) ++failures;
 
-    // Build the LPS array using the pattern
-    while (i < s.size()) {
-        if (s[i] == s[j]) {
-            // If characters match, extend the current prefix-suffix match
-            lps[i] = j + 1;
-            ++i; ++j;
-        } else if (j == 0) {
-            // If no prefix-suffix match exists, move to the next character
-            ++i;
-        } else {
-            // Use the LPS array to skip unnecessary comparisons
-            j = lps[j - 1];
-        }
-    }
+    // stopping keeps the offset of the stopping match
+    KMPMatcher ab{"ab"};
+    std::uint64_t last{};
+    ab.feed(std::string_view{"xxab"}, [](std::uint64_t) {});
+    ab.feed(std::string_view{"abab"}, [&](std::uint64_t begin) { last = begin; return false; });
+    if (last != 4 || !ab.stopped() || ab.position() != 6 || ab.feed(std::string_view{"ab"}, [](std::uint64_t) {}) != 0) ++failures;
 
-    return lps;
+    std::cout << "Streaming KMP: " << failures << " failures" << std::endl;
+    return failures;
 }
 
-void KMPSearch(const std::string& text, const std::string& pattern) {
-    // Initialize the LPS array
-    std::vector<int> lps{getLPS(pattern)};
-
-    int i{}, j{}, patternSize = pattern.size();
+// 256 MiB in 64 KiB chunks, on random DNA (frequent partial matches) and on the all-'a' worst case;
+// returns the number of inputs where the two matchers disagree
+int benchmarkStreamingKMP()
+{
+    std::mt19937 rng{5};
+    const std::size_t total{std::size_t{256} << 20}, chunk{64 << 10};
 
-    while (i < text.size()) {
-        if (text[i] == pattern[j]) {
-            // If characters match, move both pointers
-            ++i; ++j;
-            // If the whole pattern matches, store the match index
-            if (j == patternSize) {
-                std::cout << "Found match at: " <<  i - patternSize << " index" << std::endl;
-                j = lps[j - 1]; // Use LPS array to continue searching
+    auto run = [&](const char* name, std::string_view pattern, const std::string& block) {
+        auto measure = [&](auto matcher) {
+            auto start{std::chrono::steady_clock::now()};
+            std::size_t matches{};
+            for (std::size_t at{}; at < total; at += block.size()) {
+                for (std::size_t i{}; i < block.size(); i += chunk) {
+                    matches += matcher.feed(std::string_view{block}.substr(i, chunk), [](std::uint64_t) {});
+                }
             }
-        } else if (j == 0) {
-            ++i;
-        } else {
-            j = lps[j - 1];
-        }
-    }
-}
\ No newline at end of file
+            double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+            return std::pair{matches, (total >> 20) / seconds};
+        };
+        auto [plainMatches, plainRate]{measure(KMPMatcher{pattern})};
+        auto [dfaMatches, dfaRate]{measure(KMPDFAMatcher{pattern})};
+        std::cout << name << ": " << plainMatches << " matches, KMPMatcher " << plainRate << " MiB/s, KMPDFAMatcher "
+                  << dfaRate << " MiB/s" << (plainMatches == dfaMatches ? "" : " (MISMATCH)") << std::endl;
+        return plainMatches != dfaMatches;
+    };
+
+    std::string dna{randomText(16 << 20, 4, rng)};
+    for (char& c : dna) c = "ACGT"[c - 'a'];
+    int mismatches{};
+    mismatches += run("DNA", "ACGTACGAACGT", dna);
+    mismatches += run("all 'a'", "aaaaaaaaaaaaaaab", std::string(16 << 20, 'a'));
+    return mismatches;
+}
+
+int main()
+{
+    KMPSearch("ababcabcabababd", "ababd");
+
+    int failures{};
+    failures += testStreamingKMP();
+    failures += benchmarkStreamingKMP();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <istream>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+/*
+KMP Algorithm: Overview
+The Knuth-Morris-Pratt (KMP) algorithm is an efficient string-matching (or substring-searching) algorithm that finds all occurrences of a pattern (substring) in a text (string).
+KMP improves upon the naive string-matching approach by using information gained during the search to avoid redundant comparisons.
+
+Key Ideas:
+Preprocessing (LPS Array):
+Before starting the search, KMP computes a Longest Prefix Suffix (LPS) array for the pattern.
+This array tells us, for each position in the pattern, the length of the longest proper prefix which is also a suffix.
+It helps in skipping characters in the pattern that are already matched.
+
+Search Phase:
+During the actual search, when a mismatch occurs, KMP uses the LPS array to determine how many characters we can skip in both the text and the pattern, based on previous matches.
+
+By using the LPS array, the algorithm can avoid unnecessary comparisons, ensuring that the total time complexity remains linear,
+O(n + m), where n is the length of the text and m is the length of the pattern.
+*/
+
+
+inline std::vector<int> getLPS(std::string_view s) {
+    // Initialize the LPS array with size equal to the pattern length
+    std::vector<int> lps(s.size());
+
+    // Variables to track indices for the pattern and LPS array
+    std::size_t i{1};
+    int j{};
+
+    // Build the LPS array using the pattern
+    while (i < s.size()) {
+        if (s[i] == s[j]) {
+            // If characters match, extend the current prefix-suffix match
+            lps[i] = j + 1;
+            ++i; ++j;
+        } else if (j == 0) {
+            // If no prefix-suffix match exists, move to the next character
+            ++i;
+        } else {
+            // Use the LPS array to skip unnecessary comparisons
+            j = lps[j - 1];
+        }
+    }
+
+    return lps;
+}
+
+/**
+ * @brief Reports every occurrence of a non-empty pattern in text as visit(begin), nothing is copied.
+ *
+ * lps is getLPS(pattern), computed once by callers that search for the same pattern many times. The visitor
+ * may return bool, false stops the search. Returns the number of matches reported.
+ */
+template <typename Visitor>
+std::size_t KMPSearch(std::string_view text, std::string_view pattern, const std::vector<int>& lps, Visitor&& visit)
+{
+    const int patternSize = static_cast<int>(pattern.size());
+    std::size_t matches{};
+    int j{};
+    if (pattern.empty()) return 0;
+
+    for (std::size_t i{}; i < text.size(); ++i) {
+        while (j > 0 && text[i] != pattern[j]) j = lps[j - 1];
+        if (text[i] == pattern[j]) ++j;
+        if (j == patternSize) {
+            ++matches;
+            if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::size_t>>) {
+                visit(i + 1 - patternSize);
+            } else {
+                if (!visit(i + 1 - patternSize)) break;
+            }
+            j = lps[j - 1]; // Use LPS array to continue searching
+        }
+    }
+
+    return matches;
+}
+
+namespace kmp_detail
+{
+    // reads the stream through one fixed buffer and feeds it chunk by chunk
+    template <typename Matcher, typename Visitor>
+    std::size_t feedStream(Matcher& matcher, std::istream& in, Visitor& visit, std::size_t bufferSize)
+    {
+        std::vector<char> buffer(bufferSize == 0 ? 1 : bufferSize);
+        std::size_t matches{};
+        while (in) {
+            in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            const auto got{static_cast<std::size_t>(in.gcount())};
+            if (got == 0) break;
+            matches += matcher.feed(std::string_view{buffer.data(), got}, visit);
+            if (matcher.stopped()) break;
+        }
+        return matches;
+    }
+
+    template <typename Visitor>
+    bool report(Visitor& visit, std::uint64_t begin)
+    {
+        if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::uint64_t>>) {
+            visit(begin);
+            return true;
+        } else {
+            return visit(begin);
+        }
+    }
+} // namespace kmp_detail
+
+/**
+ * @class KMPMatcher
+ *
+ * @brief KMP over a text that arrives in chunks: network buffers, file blocks, a std::istream.
+ *
+ * The matcher owns the pattern and its LPS table and keeps the KMP state j (the length of the pattern prefix
+ * matched so far) and the number of bytes consumed between calls to feed, so a match split across any number
+ * of chunks is found, and visit(begin) gets its absolute offset in the whole input. Chunks are scanned in
+ * place; the memory is O(m) whatever the length of the input. A visitor returning false stops the matcher,
+ * the rest of that chunk is not consumed and later feeds do nothing until reset().
+ */
+class KMPMatcher
+{
+public:
+    explicit KMPMatcher(std::string_view pattern)
+        : pattern{pattern}, lps{getLPS(pattern)}
+    {
+        if (pattern.empty()) throw std::invalid_argument("Pattern should be non-empty");
+    }
+
+    template <typename Visitor>
+    std::size_t feed(std::string_view chunk, Visitor&& visit)
+    {
+        if (halted) return 0;
+        const int m = static_cast<int>(pattern.size());
+        std::size_t matches{};
+        for (std::size_t i{}; i < chunk.size(); ++i) {
+            while (j > 0 && chunk[i] != pattern[j]) j = lps[j - 1];
+            if (chunk[i] == pattern[j]) ++j;
+            if (j == m) {
+                ++matches;
+                j = lps[j - 1];
+                if (!kmp_detail::report(visit, consumed + i + 1 - m)) {
+                    consumed += i + 1;
+                    halted = true;
+                    return matches;
+                }
+            }
+        }
+        consumed += chunk.size();
+        return matches;
+    }
+
+    template <typename Visitor>
+    std::size_t feed(std::span<const std::uint8_t> chunk, Visitor&& visit)
+    {
+        return feed(std::string_view{reinterpret_cast<const char*>(chunk.data()), chunk.size()}, visit);
+    }
+
+    template <typename Visitor>
+    std::size_t feed(std::istream& in, Visitor&& visit, std::size_t bufferSize = 1 << 16)
+    {
+        return kmp_detail::feedStream(*this, in, visit, bufferSize);
+    }
+
+    // starts over with a new input, offsets count from 0 again
+    void reset() noexcept
+    {
+        j = 0;
+        consumed = 0;
+        halted = false;
+    }
+
+    std::string_view getPattern() const noexcept { return pattern; }
+    std::uint64_t position() const noexcept { return consumed; }
+    int state() const noexcept { return j; }
+    bool stopped() const noexcept { return halted; }
+
+private:
+    std::string pattern;
+    std::vector<int> lps;
+    int j{};
+    std::uint64_t consumed{};
+    bool halted{false};
+};
+
+/**
+ * @class KMPDFAMatcher
+ *
+ * @brief KMPMatcher with the mismatch loop precomputed: one table lookup per byte.
+ *
+ * The KMP automaton has a row per state j = 0..m and a column per byte class, the distinct bytes of the
+ * pattern plus one class for every other byte (which always leads to state 0). Row j on class c is j + 1 if
+ * pattern[j] is c, else the row of lps[j - 1] on c, so rows are filled in increasing j from rows already
+ * complete; row m continues after a match like j = lps[m - 1]. The table is (m + 1) x classes int32, small
+ * for short patterns over small alphabets (DNA, hex, digits), where it removes the data-dependent branches
+ * of the while loop. The interface and the chunk semantics are those of KMPMatcher.
+ */
+class KMPDFAMatcher
+{
+public:
+    explicit KMPDFAMatcher(std::string_view pattern)
+        : pattern{pattern}
+    {
+        if (pattern.empty()) throw std::invalid_argument("Pattern should be non-empty");
+
+        std::array<bool, 256> used{};
+        for (unsigned char ch : pattern) used[ch] = true;
+        classes = 1;
+        for (int b{}; b < 256; ++b) byteClass[b] = used[b] ? static_cast<std::uint16_t>(classes++) : 0;
+
+        const std::vector<int> lps{getLPS(pattern)};
+        const std::size_t m{pattern.size()};
+        if ((m + 1) * classes > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+            throw std::length_error("Pattern is too long for the DFA table");
+        }
+        next.assign((m + 1) * classes, 0);
+        for (std::size_t j{}; j <= m; ++j) {
+            std::int32_t* row{next.data() + j * classes};
+            if (j > 0) {
+                const std::size_t fallback{static_cast<std::size_t>(lps[j - 1])};
+                std::copy_n(next.data() + fallback * classes, classes, row);
+            }
+            if (j < m) row[byteClass[static_cast<unsigned char>(pattern[j])]] = static_cast<std::int32_t>(j + 1);
+        }
+        // entries hold the offset of the target row, the scan then needs no multiplication
+        for (auto& target : next) target *= static_cast<std::int32_t>(classes);
+    }
+
+    template <typename Visitor>
+    std::size_t feed(std::string_view chunk, Visitor&& visit)
+    {
+        if (halted) return 0;
+        const std::size_t m{pattern.size()};
+        const std::int32_t matched{static_cast<std::int32_t>(m * classes)};
+        const std::int32_t* table{next.data()};
+        std::size_t matches{};
+        std::int32_t s{row};
+        for (std::size_t i{}; i < chunk.size(); ++i) {
+            s = table[s + byteClass[static_cast<unsigned char>(chunk[i])]];
+            if (s == matched) {
+                ++matches;
+                if (!kmp_detail::report(visit, consumed + i + 1 - m)) {
+                    row = s;
+                    consumed += i + 1;
+                    halted = true;
+                    return matches;
+                }
+            }
+        }
+        row = s;
+        consumed += chunk.size();
+        return matches;
+    }
+
+    template <typename Visitor>
+    std::size_t feed(std::span<const std::uint8_t> chunk, Visitor&& visit)
+    {
+        return feed(std::string_view{reinterpret_cast<const char*>(chunk.data()), chunk.size()}, visit);
+    }
+
+    template <typename Visitor>
+    std::size_t feed(std::istream& in, Visitor&& visit, std::size_t bufferSize = 1 << 16)
+    {
+        return kmp_detail::feedStream(*this, in, visit, bufferSize);
+    }
+
+    void reset() noexcept
+    {
+        row = 0;
+        consumed = 0;
+        halted = false;
+    }
+
+    std::string_view getPattern() const noexcept { return pattern; }
+    std::uint64_t position() const noexcept { return consumed; }
+    int state() const noexcept { return static_cast<int>(row / static_cast<std::int32_t>(classes)); }
+    bool stopped() const noexcept { return halted; }
+    std::size_t classCount() const noexcept { return classes; }
+
+private:
+    std::string pattern;
+    std::array<std::uint16_t, 256> byteClass{};
+    std::size_t classes{};
+    std::vector<std::int32_t> next; // (m + 1) x classes, targets as row offsets j * classes
+    std::int32_t row{};             // the state j as its row offset
+    std::uint64_t consumed{};
+    bool halted{false};
+};
@@ -0,0 +1,100 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "KMP.h"
+#include "Prefilter.h"
+#include "TestStrings.h"
+
+constexpr PrefilterIsa allIsas[]{PrefilterIsa::Scalar, PrefilterIsa::Sse2, PrefilterIsa::Avx2, PrefilterIsa::Avx512};
+
+int testPrefilter()
+{
+    int failures{};
+    std::mt19937 rng{13};
+
+    for (PrefilterIsa isa : allIsas) {
+        if (setPrefilterIsa(isa) != isa) continue;
+
+        // lengths around the block sizes, so the vector loops and the scalar tails both run
+        for (int round{}; round < 400; ++round) {
+            int alphabet{1 + round % 5};
+            std::string pattern{randomText(1 + rng() % 9, alphabet, rng)};
+            std::string text{randomText(rng() % 300, alphabet, rng)};
+            auto lps{getLPS(pattern)};
+
+            std::vector<std::size_t> expected, found;
+            KMPSearch(text, pattern, lps, [&](std::size_t begin) { expected.push_back(begin); });
+            std::size_t reported{prefilteredKMPSearch(text, pattern, lps, [&](std::size_t begin) { found.push_back(begin); })};
+            if (found != expected || reported != expected.size()) ++failures;
+
+            std::size_t from{text.empty() ? 0 : rng() % text.size()};
+            std::size_t candidate{prefilterCandidate(text, pattern, from)};
+            std::size_t naive{from};
+            while (naive + pattern.size() <= text.size() && (text[naive] != pattern.front() || text[naive + pattern.size() - 1] != pattern.back())) ++naive;
+            if (naive + pattern.size() > text.size()) naive = text.size();
+            if (candidate != naive) ++failures;
+        }
+    }
+    setPrefilterIsa(PrefilterIsa::Avx512);
+
+    // a visitor returning false stops at that match
+    std::string text(1000, 'x');
+    text[100] = text[500] = 'y';
+    std::vector<std::size_t> hits;
+    prefilteredKMPSearch(text, "y", getLPS("y"), [&](std::size_t begin) { hits.push_back(begin); return false; });
+    if (hits != std::vector<std::size_t>{100}) ++failures;
+
+    std::cout << "Prefilter: " << failures << " failures" << std::endl;
+    return failures;
+}
+
+// plain KMP against the filtered search with every kernel the CPU has, MiB/s over the same text
+void benchmarkPrefilter()
+{
+    std::mt19937 rng{17};
+    auto run = [&](const char* name, const std::string& text, const std::string& pattern) {
+        auto lps{getLPS(pattern)};
+        auto measure = [&](auto&& search) {
+            auto start{std::chrono::steady_clock::now()};
+            std::size_t matches{};
+            for (int rep{}; rep < 4; ++rep) matches = search();
+            double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 4};
+            return std::pair{matches, text.size() / double(1 << 20) / seconds};
+        };
+
+        auto [expected, plain]{measure([&] { return KMPSearch(text, pattern, lps, [](std::size_t) {}); })};
+        std::cout << name << ": " << expected << " matches, KMP " << plain << " MiB/s";
+        for (PrefilterIsa isa : allIsas) {
+            if (setPrefilterIsa(isa) != isa) continue;
+            auto [matches, rate]{measure([&] { return prefilteredKMPSearch(text, pattern, lps, [](std::size_t) {}); })};
+            std::cout << ", " << prefilterIsaName(isa) << " " << rate << " MiB/s" << (matches == expected ? "" : " (MISMATCH)");
+        }
+        std::cout << std::endl;
+        setPrefilterIsa(PrefilterIsa::Avx512);
+    };
+
+    // low match density: printable text, a 12 byte signature planted every 64 KiB
+    std::string logs(std::size_t{64} << 20, ' ');
+    std::uniform_int_distribution<int> printable(32, 126);
+    for (char& c : logs) c = static_cast<char>(printable(rng));
+    const std::string signature{"E_TIMEOUT#42"};
+    for (std::size_t at{}; at + signature.size() < logs.size(); at += 1 << 16) logs.replace(at, signature.size(), signature);
+    run("Sparse", logs, signature);
+
+    // test2 of the Z-algorithm demo at scale: every position matches, KMP never leaves a partial match
+    run("All 'a', \"aaaa\"", std::string(std::size_t{64} << 20, 'a'), "aaaa");
+    // a partial match that never completes
+    run("All 'a', \"aaaaaaab\"", std::string(std::size_t{64} << 20, 'a'), "aaaaaaab");
+    // a quarter of the positions are candidates and KMP drops back to 0 on each
+    run("Dense candidates", randomText(std::size_t{64} << 20, 2, rng), "acb");
+}
+
+int main()
+{
+    int failures{};
+    failures += testPrefilter();
+    benchmarkPrefilter();
+    return failures == 0 ? 0 : 1;
+}
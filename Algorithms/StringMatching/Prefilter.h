@@ -0,0 +1,307 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PREFILTER_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFILTER_NOINLINE __attribute__((noinline))
+#else
+#define PREFILTER_NOINLINE
+#endif
+
+/**
+ * @brief Vectorized candidate filter for single-pattern search: KMP only looks at the positions where the
+ *        pattern's first and last bytes are in place.
+ *
+ * For a pattern p of length m, position i is a candidate when text[i] == p[0] and text[i + m - 1] == p[m - 1].
+ * The kernels compare a block of 16 (SSE2), 32 (AVX2) or 64 (AVX-512BW) starting positions at once: two
+ * unaligned loads at i and i + m - 1, two byte compares, an and, and a movemask that is almost always zero
+ * when matches are rare. On natural text two bytes rule out all but a few percent of the positions.
+ *
+ * prefilteredKMPSearch keeps the KMP state and calls the filter only when the state is 0 (no prefix of the
+ * pattern is pending), so skipping ahead to the next candidate can't lose a match, and everything else is
+ * the ordinary KMP step. On inputs where the filter barely skips, like 'a'* against "aaaa", KMP never
+ * leaves a partial match and the filter is not called at all; when candidates come densely but KMP drops
+ * back to 0 at each, short skips make the search stay in plain KMP for a while (doubling up to 4 KiB), so
+ * the filter calls cost a bounded fraction of the scan. Either way the search is O(n + m), and while a prefix
+ * is pending it runs KMPSearch's own loop, so the worst case is plain KMP's speed: 64 MiB of 'a' against
+ * "aaaa" measures the same as KMPSearch (1.6-1.9 GiB/s on a Xeon, within run-to-run noise).
+ *
+ * The kernel is picked at runtime on first use like the min-plus kernels (GCC/Clang on x86, through target
+ * attributes); other targets get the scalar kernel. setPrefilterIsa()
+ * forces one, for benchmarks and tests.
+ */
+
+enum class PrefilterIsa
+{
+    Scalar,
+    Sse2,
+    Avx2,
+    Avx512
+};
+
+namespace prefilter_detail
+{
+    // the first i >= from with text[i] == first and text[i + gap] == last, or n
+    using FindCandidate = std::size_t (*)(const char* text, std::size_t n, std::size_t from, char first, char last, std::size_t gap);
+
+    inline std::size_t findScalar(const char* text, std::size_t n, std::size_t from, char first, char last, std::size_t gap)
+    {
+        if (gap >= n) return n;
+        for (std::size_t i{from}; i < n - gap; ++i) {
+            if (text[i] == first && text[i + gap] == last) return i;
+        }
+        return n;
+    }
+
+#ifdef PREFILTER_X86_DISPATCH
+    __attribute__((target("sse2"))) inline std::size_t findSse2(const char* text, std::size_t n, std::size_t from, char first, char last, std::size_t gap)
+    {
+        const __m128i f{_mm_set1_epi8(first)}, l{_mm_set1_epi8(last)};
+        std::size_t i{from};
+        for (; i + gap + 16 <= n; i += 16) {
+            __m128i a{_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i))};
+            __m128i b{_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + gap))};
+            unsigned mask{static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, f), _mm_cmpeq_epi8(b, l))))};
+            if (mask) return i + __builtin_ctz(mask);
+        }
+        return findScalar(text, n, i, first, last, gap);
+    }
+
+    // 0xff for the candidates among the 32 positions at p
+    __attribute__((target("avx2"))) inline __m256i candidates32(const char* p, std::size_t gap, __m256i f, __m256i l)
+    {
+        __m256i a{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+        __m256i b{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + gap))};
+        return _mm256_and_si256(_mm256_cmpeq_epi8(a, f), _mm256_cmpeq_epi8(b, l));
+    }
+
+    // two blocks of 32 per iteration, the common no-candidate case is one or-and-test for 64 positions
+    __attribute__((target("avx2"))) inline std::size_t findAvx2(const char* text, std::size_t n, std::size_t from, char first, char last, std::size_t gap)
+    {
+        const __m256i f{_mm256_set1_epi8(first)}, l{_mm256_set1_epi8(last)};
+        std::size_t i{from};
+        for (; i + gap + 64 <= n; i += 64) {
+            __m256i low{candidates32(text + i, gap, f, l)}, high{candidates32(text + i + 32, gap, f, l)};
+            if (_mm256_testz_si256(_mm256_or_si256(low, high), _mm256_or_si256(low, high))) continue;
+            unsigned lowMask{static_cast<unsigned>(_mm256_movemask_epi8(low))};
+            if (lowMask) return i + __builtin_ctz(lowMask);
+            return i + 32 + __builtin_ctz(static_cast<unsigned>(_mm256_movemask_epi8(high)));
+        }
+        for (; i + gap + 32 <= n; i += 32) {
+            unsigned mask{static_cast<unsigned>(_mm256_movemask_epi8(candidates32(text + i, gap, f, l)))};
+            if (mask) return i + __builtin_ctz(mask);
+        }
+        return findScalar(text, n, i, first, last, gap);
+    }
+
+    __attribute__((target("avx512f,avx512bw"))) inline std::size_t findAvx512(const char* text, std::size_t n, std::size_t from, char first, char last, std::size_t gap)
+    {
+        const __m512i f{_mm512_set1_epi8(first)}, l{_mm512_set1_epi8(last)};
+        std::size_t i{from};
+        for (; i + gap + 64 <= n; i += 64) {
+            __m512i a{_mm512_loadu_si512(text + i)};
+            __m512i b{_mm512_loadu_si512(text + i + gap)};
+            __mmask64 mask{_mm512_mask_cmpeq_epi8_mask(_mm512_cmpeq_epi8_mask(a, f), b, l)};
+            if (mask) return i + __builtin_ctzll(mask);
+        }
+        return findScalar(text, n, i, first, last, gap);
+    }
+#endif
+
+    struct Kernel
+    {
+        PrefilterIsa isa;
+        FindCandidate find;
+    };
+
+    inline PrefilterIsa bestSupportedIsa()
+    {
+#ifdef PREFILTER_X86_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw")) return PrefilterIsa::Avx512;
+        if (__builtin_cpu_supports("avx2")) return PrefilterIsa::Avx2;
+        if (__builtin_cpu_supports("sse2")) return PrefilterIsa::Sse2;
+#endif
+        return PrefilterIsa::Scalar;
+    }
+
+    inline Kernel kernelFor(PrefilterIsa isa)
+    {
+#ifdef PREFILTER_X86_DISPATCH
+        if (isa == PrefilterIsa::Avx512) return {isa, findAvx512};
+        if (isa == PrefilterIsa::Avx2) return {isa, findAvx2};
+        if (isa == PrefilterIsa::Sse2) return {isa, findSse2};
+#endif
+        return {PrefilterIsa::Scalar, findScalar};
+    }
+
+    inline Kernel& active()
+    {
+        static Kernel kernel{kernelFor(bestSupportedIsa())};
+        return kernel;
+    }
+
+    // after a skip shorter than shortSkip the search stays in plain KMP for backoff bytes, doubling up to max
+    constexpr std::size_t shortSkip{16}, minBackoff{64}, maxBackoff{4096};
+
+    template <typename Visitor>
+    bool report(Visitor& visit, std::size_t begin)
+    {
+        if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::size_t>>) {
+            visit(begin);
+            return true;
+        } else {
+            return visit(begin);
+        }
+    }
+
+    /**
+     * KMPSearch's steps over text[i, n) from state j, until the end, a visitor stop (returns n + 1) or a mismatch
+     * in state 0 at or past plainUntil (returns the next position). Kept out of line, with its state in locals
+     * and a pointer walk like KMPSearch's compiled loop: inlined next to the indirect filter call and indexing
+     * text[i], it ran some 30% slower than KMPSearch on 'a'* against "aaaa", where it is all the search does.
+     */
+    template <typename Visitor>
+    PREFILTER_NOINLINE std::size_t kmpSteps(const char* t, std::size_t i, std::size_t n, std::string_view pattern, const int* lps,
+                                            int& state, std::size_t plainUntil, std::size_t& matches, Visitor& visit)
+    {
+        const char* p{pattern.data()};
+        const std::size_t m{pattern.size()};
+        const int full{static_cast<int>(m)}, restart{lps[m - 1]};
+        const char* const end{t + n};
+        const char* const plainEnd{t + std::max(plainUntil, i + 1) - 1}; // state 0 from here on goes back to the filter
+        std::size_t found{};
+        int j{state};
+        const char* s{t + i};
+        for (; s != end; ++s) {
+            while (j > 0 && *s != p[j]) j = lps[j - 1];
+            if (*s == p[j]) {
+                ++j;
+            } else if (s >= plainEnd) {
+                ++s;
+                break;
+            }
+            if (j == full) {
+                ++found;
+                if (!report(visit, static_cast<std::size_t>(s - t) + 1 - m)) {
+                    matches += found;
+                    return n + 1;
+                }
+                j = restart;
+            }
+        }
+        state = j;
+        matches += found;
+        return static_cast<std::size_t>(s - t);
+    }
+
+    // prefilteredKMPSearch for a one-byte pattern: no prefix is ever pending and every candidate is a match.
+    // Kept out of the general loop, whose code layout it would otherwise disturb.
+    template <typename Visitor>
+    std::size_t searchByte(const char* t, std::size_t n, char c, Visitor& visit)
+    {
+        const FindCandidate find{active().find};
+        std::size_t matches{}, i{}, plainUntil{}, backoff{minBackoff};
+        while (i < n) {
+            if (i >= plainUntil) {
+                std::size_t candidate{find(t, n, i, c, c, 0)};
+                if (candidate == n) break;
+                if (candidate - i < shortSkip) {
+                    plainUntil = candidate + backoff;
+                    backoff = std::min(backoff * 2, maxBackoff);
+                } else {
+                    backoff = minBackoff;
+                }
+                i = candidate;
+            }
+            for (; i < n; ++i) {
+                if (t[i] == c) {
+                    ++matches;
+                    if (!report(visit, i)) return matches;
+                } else if (i + 1 >= plainUntil) {
+                    ++i;
+                    break;
+                }
+            }
+        }
+        return matches;
+    }
+}
+
+inline PrefilterIsa prefilterIsa() { return prefilter_detail::active().isa; }
+
+inline const char* prefilterIsaName(PrefilterIsa isa)
+{
+    switch (isa) {
+        case PrefilterIsa::Avx512: return "AVX-512";
+        case PrefilterIsa::Avx2: return "AVX2";
+        case PrefilterIsa::Sse2: return "SSE2";
+        default: return "scalar";
+    }
+}
+
+/**
+ * Forces a kernel; one the CPU doesn't support falls back to the best supported one below it.
+ * Not thread safe - call it before searching.
+ * @return the kernel actually selected
+ */
+inline PrefilterIsa setPrefilterIsa(PrefilterIsa isa)
+{
+    PrefilterIsa supported{prefilter_detail::bestSupportedIsa()};
+    if (static_cast<int>(isa) > static_cast<int>(supported)) isa = supported;
+
+    prefilter_detail::active() = prefilter_detail::kernelFor(isa);
+    return isa;
+}
+
+// the first position >= from where pattern's first and last bytes are in place, or text.size()
+inline std::size_t prefilterCandidate(std::string_view text, std::string_view pattern, std::size_t from = 0)
+{
+    if (pattern.empty() || from >= text.size()) return text.size();
+    return prefilter_detail::active().find(text.data(), text.size(), from, pattern.front(), pattern.back(), pattern.size() - 1);
+}
+
+/**
+ * @brief KMPSearch (same arguments, visitor and result) with the scan between partial matches done by the
+ *        vectorized candidate filter.
+ */
+template <typename Visitor>
+std::size_t prefilteredKMPSearch(std::string_view text, std::string_view pattern, const std::vector<int>& lps, Visitor&& visit)
+{
+    using prefilter_detail::shortSkip, prefilter_detail::minBackoff, prefilter_detail::maxBackoff;
+    if (pattern.empty() || text.size() < pattern.size()) return 0;
+    if (pattern.size() == 1) return prefilter_detail::searchByte(text.data(), text.size(), pattern.front(), visit);
+
+    const prefilter_detail::FindCandidate find{prefilter_detail::active().find};
+    const char* t{text.data()};
+    const std::size_t n{text.size()}, m{pattern.size()};
+    const char first{pattern.front()}, last{pattern.back()};
+
+    std::size_t matches{}, i{}, plainUntil{}, backoff{minBackoff};
+    int j{};
+    while (i < n) {
+        if (j == 0 && i >= plainUntil) {
+            std::size_t candidate{find(t, n, i, first, last, m - 1)};
+            if (candidate == n) break;
+            if (candidate - i < shortSkip) {
+                plainUntil = candidate + backoff;
+                backoff = std::min(backoff * 2, maxBackoff);
+            } else {
+                backoff = minBackoff;
+            }
+            i = candidate;
+        }
+        i = prefilter_detail::kmpSteps(t, i, n, pattern, lps.data(), j, plainUntil, matches, visit);
+    }
+
+    return matches;
+}
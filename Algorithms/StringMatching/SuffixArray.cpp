@@ -0,0 +1,164 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+#include "SuffixArray.h"
+#include "KMP.h"
+#include "TestStrings.h"
+
+template <typename Index>
+bool matchesNaive(const BasicSuffixArray<Index>& index, std::string_view text)
+{
+    std::vector<std::size_t> expected(text.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    std::sort(expected.begin(), expected.end(), [&](std::size_t a, std::size_t b) { return text.substr(a) < text.substr(b); });
+    if (!std::equal(expected.begin(), expected.end(), index.suffixes().begin(), index.suffixes().end())) return false;
+
+    for (std::size_t k{1}; k < text.size(); ++k) {
+        std::string_view a{text.substr(expected[k - 1])}, b{text.substr(expected[k])};
+        std::size_t h{};
+        while (h < a.size() && h < b.size() && a[h] == b[h]) ++h;
+        if (index.lcp()[k] != h) return false;
+    }
+    return text.empty() || index.lcp()[0] == 0;
+}
+
+int testSuffixArray()
+{
+    int failures{};
+    std::mt19937 rng{19};
+
+    // small alphabets and periodic texts give deep recursions with many equal LMS substrings
+    for (int round{}; round < 400; ++round) {
+        std::string text{randomText(rng() % 200, 1 + round % 4, rng)};
+        if (round % 7 == 0) {
+            std::string unit{randomText(1 + rng() % 4, 3, rng)};
+            text.clear();
+            while (text.size() < 150) text += unit;
+        }
+        SuffixArray index{text};
+        SuffixArray64 wide{text};
+        if (!matchesNaive(index, text) || !matchesNaive(wide, text)) ++failures;
+
+        for (int q{}; q < 10; ++q) {
+            std::string pattern{randomText(1 + rng() % 4, 1 + round % 4, rng)};
+            std::vector<std::uint32_t> expected;
+            KMPSearch(text, pattern, getLPS(pattern), [&](std::size_t begin) { expected.push_back(static_cast<std::uint32_t>(begin)); });
+            if (index.occurrences(pattern) != expected || index.count(pattern) != expected.size()) ++failures;
+        }
+
+        std::string_view largest, smallest{text}, repeated;
+        for (std::size_t i{}; i < text.size(); ++i) {
+            std::string_view suffix{std::string_view{text}.substr(i)};
+            largest = std::max(largest, suffix);
+            smallest = std::min(smallest, suffix);
+            // the longest prefix of this suffix that occurs again later
+            for (std::size_t j{i + 1}; j < text.size(); ++j) {
+                std::size_t h{};
+                while (j + h < text.size() && text[i + h] == text[j + h]) ++h;
+                if (h > repeated.size()) repeated = suffix.substr(0, h);
+            }
+        }
+        if (index.largestSuffix() != largest || index.smallestSuffix() != smallest) ++failures;
+        if (index.longestRepeatedSubstring().size() != repeated.size()) ++failures;
+    }
+
+    // every byte value, the order is unsigned like std::string_view's
+    std::string bytes;
+    for (int round{}; round < 1000; ++round) bytes.push_back(static_cast<char>(rng()));
+    if (!matchesNaive(SuffixArray{bytes}, bytes)) ++failures;
+
+    // round trip through a file, then a truncated and a mislabelled one
+    const std::string path{"suffix_array_test.bin"};
+    std::string text{randomText(5000, 3, rng)};
+    SuffixArray built{text};
+    built.save(path);
+    {
+        SuffixArray loaded{SuffixArray::load(path)};
+        if (loaded.text() != text || !std::equal(loaded.suffixes().begin(), loaded.suffixes().end(), built.suffixes().begin(), built.suffixes().end())
+            || loaded.longestRepeatedSubstring() != built.longestRepeatedSubstring() || loaded.count("abc") != built.count("abc")) ++failures;
+
+        try {
+            (void)SuffixArray64::load(path);
+            ++failures;
+        } catch (const std::runtime_error&) {}
+    }
+    std::vector<std::uint8_t> truncated;
+    {
+        MappedFile mapped{path};
+        truncated.assign(mapped.bytes().begin(), mapped.bytes().end() - 4);
+    }
+    try {
+        (void)SuffixArray::fromBytes(truncated);
+        ++failures;
+    } catch (const std::runtime_error&) {}
+
+    // a 64-bit header whose n makes 64 + padded(n) + 8n wrap around to the 72 bytes given
+    std::uint64_t inverseOfNine{9};
+    for (int k{}; k < 5; ++k) inverseOfNine *= 2 - 9 * inverseOfNine;
+    SuffixArrayHeader crafted;
+    std::memcpy(crafted.magic, SuffixArrayHeader::expectedMagic, sizeof crafted.magic);
+    crafted.version = SuffixArrayHeader::currentVersion;
+    crafted.indexBytes = sizeof(std::uint64_t);
+    crafted.textSize = 8 * inverseOfNine;
+    std::vector<std::uint8_t> wrapped(sizeof crafted + 8);
+    std::memcpy(wrapped.data(), &crafted, sizeof crafted);
+    try {
+        (void)SuffixArray64::fromBytes(wrapped);
+        ++failures;
+    } catch (const std::runtime_error&) {}
+    std::remove(path.c_str());
+
+    std::cout << "Suffix array: " << failures << " failures" << std::endl;
+    return failures;
+}
+
+// construction on 64 MiB, then a million substring queries against the index versus rescanning the text
+void benchmarkSuffixArray()
+{
+    std::mt19937 rng{23};
+    auto seconds = [](auto start) { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+    for (int alphabet : {4, 26}) {
+        std::string text{randomText(std::size_t{64} << 20, alphabet, rng)};
+
+        auto start{std::chrono::steady_clock::now()};
+        SuffixArray withoutLcp{text, false};
+        double saSeconds{seconds(start)};
+        start = std::chrono::steady_clock::now();
+        SuffixArray index{text};
+        double bothSeconds{seconds(start)};
+
+        std::vector<std::string> queries(1'000'000);
+        for (auto& q : queries) {
+            std::size_t at{rng() % (text.size() - 16)};
+            q = text.substr(at, 8 + rng() % 9);
+        }
+        start = std::chrono::steady_clock::now();
+        std::size_t found{};
+        for (const auto& q : queries) found += index.count(q);
+        double querySeconds{seconds(start)};
+
+        start = std::chrono::steady_clock::now();
+        std::size_t rescanned{};
+        for (int q{}; q < 10; ++q) rescanned += KMPSearch(text, queries[q], getLPS(queries[q]), [](std::size_t) {});
+        double scanSeconds{seconds(start) / 10};
+
+        std::cout << "alphabet " << alphabet << ": SA-IS " << (text.size() >> 20) / saSeconds << " MiB/s, with LCP "
+                  << (text.size() >> 20) / bothSeconds << " MiB/s, " << querySeconds * 1e3 << " ns per query ("
+                  << found << " occurrences), " << scanSeconds * 1e3 << " ms per query by rescanning (" << rescanned << ")" << std::endl;
+    }
+}
+
+int main()
+{
+    int failures{};
+    failures += testSuffixArray();
+    benchmarkSuffixArray();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <random>
+
+/**
+ * @brief Generated strings shared by the string search tests and benchmarks
+ *        (KMP.cpp, Prefilter.cpp, SuffixArray.cpp, AhoCorasick.cpp).
+ */
+
+// size letters drawn uniformly from the first alphabet letters of 'a'..'z'
+inline std::string randomText(std::size_t size, int alphabet, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> letter(0, alphabet - 1);
+    std::string s(size, 'a');
+    for (char& c : s) c = static_cast<char>('a' + letter(rng));
+    return s;
+}
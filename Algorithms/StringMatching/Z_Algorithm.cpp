@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 
 /*
  * What is the Z-algorithm and which problem does it solve?
@@ -81,42 +82,59 @@ std::vector<int> z_function(const std::string& s)
     return z;
 }
 
+/*
+ * Searching without the pattern + "$" + text copy:
+ *   z of the pattern alone is enough. The window [l, r) is now a stretch of the
+ *   text that matches a prefix of the pattern, text[l..r-1] == pattern[0..r-l-1],
+ *   and for i inside it the pattern's own z-value z[i - l] gives the same lower
+ *   bound as before. Position i is a match when the extension reaches m.
+ *   Time stays O(n + m), the memory is the m values of z and nothing is copied.
+ */
+template <typename Visitor>
+void z_search(std::string_view text, std::string_view pattern, Visitor&& visit)
+{
+    int n = text.size(), m = pattern.size();
+    if (m == 0) return;
+
+    std::vector<int> z{z_function(std::string{pattern})};
+    z[0] = m;
+    int l{}, r{};
+
+    for (int i{}; i < n; ++i) {
+        int k{};
+        if (i < r) {
+            k = std::min(r - i, z[i - l]);
+        }
+
+        while (k < m && i + k < n && text[i + k] == pattern[k]) ++k;
+
+        if (k == m) visit(i);
+
+        if (i + k > r) {
+            l = i;
+            r = i + k;
+        }
+    }
+}
+
 void test1()
 {
     std::string text{"aaabbbbabbabaabababbabbbbbaababaabbababbaaa"};
     std::string pattern{"aba"};
-    std::string s{pattern + "$" + text};
-    
-    auto z = z_function(s);
-    int offset = pattern.size() + 1;
-    int n = pattern.size() + 1 + text.size();
-    
-    for (int i{offset}; i < n; ++i) {
-        if (z[i] == pattern.size()) {
-            std::cout << "Found match at: " << i - offset << std::endl;
-        }
-    }
+
+    z_search(text, pattern, [](int i) { std::cout << "Found match at: " << i << std::endl; });
 }
 
 void test2()
 {
     std::string text{"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
     std::string pattern{"aaaa"};
-    std::string s{pattern + "$" + text};
-    
-    auto z = z_function(s);
-    int offset = pattern.size() + 1;
-    int n = pattern.size() + 1 + text.size();
-    
-    for (int i{offset}; i < n; ++i) {
-        if (z[i] == pattern.size()) {
-            std::cout << "Found match at: " << i - offset << std::endl;
-        }
-    }
+
+    z_search(text, pattern, [](int i) { std::cout << "Found match at: " << i << std::endl; });
 }
 
 int main()
 {
     test1();
     test2();
-}
\ No newline at end of file
+}
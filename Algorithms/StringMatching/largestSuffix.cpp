@@ -232,6 +232,8 @@ We skipped s[2...] as a comparison candidate because we knew it couldn't be the
 */
 
 // related problems in LeetCode: 1163, 3406
+// For many queries over one text, SuffixArray.h builds the index once: largestSuffix() is then O(1),
+// next to smallestSuffix(), substring search and the longest repeated substring.
 
 std::string getLargestSuffix(const std::string& s)
 {